@@ -0,0 +1,211 @@
+import Foundation
+import Ably.Private
+
+private let publishPrefix = "load."
+
+/// One realtime client of the load test, with its channels and the timers that drive its publishes, presence changes and
+/// history requests. Everything but `start` and `stop` runs on its callback queue.
+final class LoadTestClient {
+
+    let index: Int
+    let realtime: ARTRealtime
+    let queue: DispatchQueue
+    let internalQueue: DispatchQueue
+
+    private let configuration: LoadTestConfiguration
+    private let recorder: LoadTestRecorder
+    private let channels: [ARTRealtimeChannel]
+    private let payload: String
+    private var random: SeededRandomNumberGenerator
+    private var timers: [DispatchSourceTimer] = []
+    private var nextChannel = 0
+    private var enteredMembers: [Set<Int>]
+
+    init(index: Int, configuration: LoadTestConfiguration, recorder: LoadTestRecorder) {
+        self.index = index
+        self.configuration = configuration
+        self.recorder = recorder
+        queue = DispatchQueue(label: "io.ably.loadTest.client\(index)")
+        internalQueue = DispatchQueue(label: "io.ably.loadTest.client\(index).internal")
+        random = SeededRandomNumberGenerator(seed: configuration.seed &+ index)
+        payload = String(repeating: "x", count: configuration.payloadSize)
+
+        let options = ARTClientOptions(key: "loadTest.key:secret")
+        options.autoConnect = false
+        options.useBinaryProtocol = configuration.useBinaryProtocol
+        options.logLevel = .error
+        options.logExceptionReportingUrl = nil
+        options.dispatchQueue = queue
+        options.internalDispatchQueue = internalQueue
+        realtime = ARTRealtime(options: options)
+
+        var pool = Array(0 ..< configuration.channelPool)
+        pool.shuffle(using: &random)
+        channels = pool.prefix(configuration.channelsPerClient).map { realtime.channels.get("loadTest\($0)") }
+        enteredMembers = Array(repeating: [], count: channels.count)
+    }
+
+    func start() {
+        queue.async {
+            self.realtime.connection.on { [recorder] change in
+                recorder.count("connection.\(ARTRealtimeConnectionStateToStr(change.current))")
+            }
+            for channel in self.channels {
+                channel.subscribe { [recorder] message in
+                    recorder.count("received")
+                    if let name = message.name, name.hasPrefix(publishPrefix), let sent = UInt64(name.dropFirst(publishPrefix.count)) {
+                        recorder.recordLatency(loadTestNow() - sent)
+                    }
+                }
+                channel.attach()
+            }
+            self.realtime.connect()
+
+            self.schedule(perSecond: self.configuration.publishesPerSecond) { $0.publish() }
+            self.schedule(perSecond: self.configuration.presenceChangesPerSecond) { $0.changePresence() }
+            self.schedule(perSecond: self.configuration.historyRequestsPerSecond) { $0.requestHistory() }
+        }
+    }
+
+    func stop(completion: @escaping () -> Void) {
+        queue.async {
+            self.timers.forEach { $0.cancel() }
+            self.timers.removeAll()
+            self.realtime.connection.once(.closed) { _ in
+                completion()
+            }
+            self.realtime.close()
+        }
+    }
+
+    /// Clients start at a random phase, so that their timers don't fire in lockstep.
+    private func schedule(perSecond rate: Double, _ body: @escaping (LoadTestClient) -> Void) {
+        guard rate > 0 else {
+            return
+        }
+        let interval = 1 / rate
+        let timer = DispatchSource.makeTimerSource(queue: queue)
+        timer.schedule(deadline: .now() + Double.random(in: 0 ..< interval, using: &random), repeating: interval, leeway: .milliseconds(Int(interval * 100)))
+        timer.setEventHandler { [weak self] in
+            if let self = self {
+                body(self)
+            }
+        }
+        timer.resume()
+        timers.append(timer)
+    }
+
+    private func publish() {
+        let channel = channels[nextChannel % channels.count]
+        nextChannel += 1
+        recorder.count("published")
+        channel.publish("\(publishPrefix)\(loadTestNow())", data: payload) { [recorder] error in
+            recorder.count(error == nil ? "acked" : "publishFailed")
+        }
+    }
+
+    private func changePresence() {
+        let channelIndex = Int.random(in: 0 ..< channels.count, using: &random)
+        let member = Int.random(in: 0 ..< max(configuration.presenceMembersPerClient, 1), using: &random)
+        let clientId = "client\(index).member\(member)"
+        let presence = channels[channelIndex].presence
+        if enteredMembers[channelIndex].remove(member) != nil {
+            recorder.count("presenceLeaves")
+            presence.leaveClient(clientId, data: nil) { [recorder] error in
+                if error != nil {
+                    recorder.count("presenceFailed")
+                }
+            }
+        }
+        else {
+            enteredMembers[channelIndex].insert(member)
+            recorder.count("presenceEnters")
+            presence.enterClient(clientId, data: payload) { [recorder] error in
+                if error != nil {
+                    recorder.count("presenceFailed")
+                }
+            }
+        }
+    }
+
+    private func requestHistory() {
+        let channel = channels[Int.random(in: 0 ..< channels.count, using: &random)]
+        recorder.count("historyRequests")
+        channel.history { [recorder] result, error in
+            recorder.count(error == nil ? "historyPages" : "historyFailed")
+        }
+    }
+
+}
+
+/// Runs `configuration.clients` clients against `LoadTestServer` for `configuration.duration`, sampling them with a
+/// `LoadTestRecorder` every `configuration.sampleInterval`.
+final class LoadGenerator {
+
+    let configuration: LoadTestConfiguration
+    let recorder: LoadTestRecorder
+
+    /// Called on the recorder's queue after each sample, and with `finished` set after the last one.
+    var onSample: ((_ sample: [String: Any], _ finished: Bool) -> Void)?
+
+    private var clients: [LoadTestClient] = []
+    private var sampler: DispatchSourceTimer?
+
+    init(configuration: LoadTestConfiguration) {
+        self.configuration = configuration
+        recorder = LoadTestRecorder(configuration: configuration)
+    }
+
+    func start() {
+        LoadTestServer.install()
+        LoadTestServer.shared.queue.sync {
+            LoadTestServer.shared.reconnectInterval = configuration.reconnectInterval
+            LoadTestServer.shared.random = SeededRandomNumberGenerator(seed: configuration.seed)
+        }
+
+        clients = (0 ..< configuration.clients).map { LoadTestClient(index: $0, configuration: configuration, recorder: recorder) }
+        clients.forEach { $0.start() }
+
+        let sampler = DispatchSource.makeTimerSource(queue: recorder.queue)
+        sampler.schedule(deadline: .now() + configuration.sampleInterval, repeating: configuration.sampleInterval)
+        sampler.setEventHandler { [weak self] in
+            self?.takeSample()
+        }
+        sampler.resume()
+        self.sampler = sampler
+    }
+
+    /// Called on the recorder's queue.
+    private func takeSample() {
+        let finished = recorder.elapsed >= configuration.duration
+        if finished {
+            sampler?.cancel()
+            sampler = nil
+        }
+        let forcedDisconnects = LoadTestServer.shared.queue.sync { LoadTestServer.shared.forcedDisconnects }
+        recorder.sample(clients: clients, forcedDisconnects: forcedDisconnects) { [weak self] sample in
+            guard let self = self else {
+                return
+            }
+            if finished {
+                self.stop()
+            }
+            self.onSample?(sample, finished)
+        }
+    }
+
+    /// Closes every client, then writes the summary.
+    private func stop() {
+        let group = DispatchGroup()
+        for client in clients {
+            group.enter()
+            client.stop {
+                group.leave()
+            }
+        }
+        group.notify(queue: recorder.queue) {
+            self.recorder.finish()
+        }
+    }
+
+}
@@ -0,0 +1,111 @@
+import Foundation
+
+/// The shape of a load test run, read from the app's user defaults so that each value can be overridden with a launch
+/// argument, e.g. `-clients 50 -channelsPerClient 10 -duration 28800`.
+struct LoadTestConfiguration {
+
+    /// Realtime clients, each with its own internal and callback queues.
+    var clients = 10
+
+    /// Channels attached by each client, picked from `channelPool`. Clients that share a channel receive each other's messages.
+    var channelsPerClient = 5
+    var channelPool = 20
+
+    /// Messages published by each client per second, spread over its channels.
+    var publishesPerSecond = 2.0
+    var payloadSize = 256
+
+    /// Presence enters or leaves per second by each client, cycling through `presenceMembersPerClient` member ids.
+    var presenceChangesPerSecond = 0.5
+    var presenceMembersPerClient = 3
+
+    /// History requests per second by each client, served by the REST stand-in.
+    var historyRequestsPerSecond = 0.05
+
+    /// The stand-in drops each connection at a random time between half and one and a half times this interval, so that the
+    /// client resumes it. `0` keeps connections up.
+    var reconnectInterval: TimeInterval = 300
+
+    var duration: TimeInterval = 4 * 60 * 60
+
+    /// How often memory, queue depths and latencies are sampled.
+    var sampleInterval: TimeInterval = 30
+
+    /// Samples taken before this time are reported but left out of the leak growth estimate, while caches fill up.
+    var warmup: TimeInterval = 5 * 60
+
+    var useBinaryProtocol = true
+    var seed = 13
+
+    init(defaults: UserDefaults = .standard) {
+        func read<T>(_ key: String, _ value: inout T) {
+            guard defaults.object(forKey: key) != nil else {
+                return
+            }
+            switch value {
+            case is Int:
+                value = defaults.integer(forKey: key) as! T
+            case is Double:
+                value = defaults.double(forKey: key) as! T
+            case is Bool:
+                value = defaults.bool(forKey: key) as! T
+            default:
+                break
+            }
+        }
+        read("clients", &clients)
+        read("channelsPerClient", &channelsPerClient)
+        read("channelPool", &channelPool)
+        read("publishesPerSecond", &publishesPerSecond)
+        read("payloadSize", &payloadSize)
+        read("presenceChangesPerSecond", &presenceChangesPerSecond)
+        read("presenceMembersPerClient", &presenceMembersPerClient)
+        read("historyRequestsPerSecond", &historyRequestsPerSecond)
+        read("reconnectInterval", &reconnectInterval)
+        read("duration", &duration)
+        read("sampleInterval", &sampleInterval)
+        read("warmup", &warmup)
+        read("useBinaryProtocol", &useBinaryProtocol)
+        read("seed", &seed)
+        channelsPerClient = min(channelsPerClient, channelPool)
+    }
+
+    var dictionary: [String: Any] {
+        return [
+            "clients": clients,
+            "channelsPerClient": channelsPerClient,
+            "channelPool": channelPool,
+            "publishesPerSecond": publishesPerSecond,
+            "payloadSize": payloadSize,
+            "presenceChangesPerSecond": presenceChangesPerSecond,
+            "presenceMembersPerClient": presenceMembersPerClient,
+            "historyRequestsPerSecond": historyRequestsPerSecond,
+            "reconnectInterval": reconnectInterval,
+            "duration": duration,
+            "sampleInterval": sampleInterval,
+            "warmup": warmup,
+            "useBinaryProtocol": useBinaryProtocol,
+            "seed": seed,
+        ]
+    }
+
+}
+
+/// SplitMix64, so that a run with the same seed makes the same choices.
+struct SeededRandomNumberGenerator: RandomNumberGenerator {
+
+    private var state: UInt64
+
+    init(seed: Int) {
+        state = UInt64(bitPattern: Int64(seed))
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+
+}
@@ -0,0 +1,227 @@
+import Foundation
+import Ably
+
+/// Monotonic time in nanoseconds.
+func loadTestNow() -> UInt64 {
+    return DispatchTime.now().uptimeNanoseconds
+}
+
+/// The app's physical memory footprint in bytes, as reported by Xcode and used by the OS to decide when to terminate it.
+func memoryFootprint() -> UInt64 {
+    var info = task_vm_info_data_t()
+    var count = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<natural_t>.size)
+    let result = withUnsafeMutablePointer(to: &info) {
+        $0.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+            task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &count)
+        }
+    }
+    return result == KERN_SUCCESS ? info.phys_footprint : 0
+}
+
+/// Collects what the load generator observes and writes one JSON object per sample to a report in the app's Documents
+/// directory, followed by a summary with the memory high-water mark and leak growth estimate.
+///
+/// Counters and latencies are recorded from the clients' callback queues; everything else happens on `queue`.
+final class LoadTestRecorder {
+
+    let queue = DispatchQueue(label: "io.ably.loadTest.recorder", qos: .utility)
+    let reportURL: URL
+
+    private let configuration: LoadTestConfiguration
+    private let start = loadTestNow()
+    private let lock = NSLock()
+    private var report: FileHandle?
+
+    // Guarded by `lock`.
+    private var latencies: [UInt64] = []
+    private var counters: [String: Int] = [:]
+
+    // Only touched on `queue`.
+    private var footprintHighWaterMark: UInt64 = 0
+    private var footprints: [(elapsed: Double, bytes: UInt64)] = []
+    private var previousAckBuckets: [Int] = []
+
+    private(set) var lastSample: [String: Any] = [:]
+
+    init(configuration: LoadTestConfiguration) {
+        self.configuration = configuration
+        let documents = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        let formatter = DateFormatter()
+        formatter.locale = Locale(identifier: "en_US_POSIX")
+        formatter.dateFormat = "yyyyMMdd-HHmmss"
+        reportURL = documents.appendingPathComponent("load-test-\(formatter.string(from: Date())).jsonl")
+        FileManager.default.createFile(atPath: reportURL.path, contents: nil)
+        report = try? FileHandle(forWritingTo: reportURL)
+        write(["configuration": configuration.dictionary])
+    }
+
+    var elapsed: TimeInterval {
+        return Double(loadTestNow() - start) / Double(NSEC_PER_SEC)
+    }
+
+    func count(_ counter: String, by value: Int = 1) {
+        lock.lock()
+        counters[counter, default: 0] += value
+        lock.unlock()
+    }
+
+    /// The time from publishing a message to receiving it on a subscribed client.
+    func recordLatency(_ nanoseconds: UInt64) {
+        lock.lock()
+        latencies.append(nanoseconds)
+        lock.unlock()
+    }
+
+    /// Takes a sample of the process and of `clients`, then calls `completion` with it on `queue`.
+    func sample(clients: [LoadTestClient], forcedDisconnects: Int, completion: @escaping ([String: Any]) -> Void) {
+        // How long a block waits for each client's internal queue, as a measure of the work queued on it.
+        let group = DispatchGroup()
+        let queueDelays = UnsafeMutableBufferPointer<UInt64>.allocate(capacity: max(clients.count, 1))
+        for (index, client) in clients.enumerated() {
+            group.enter()
+            let enqueued = loadTestNow()
+            client.internalQueue.async {
+                queueDelays[index] = loadTestNow() - enqueued
+                group.leave()
+            }
+        }
+
+        group.notify(queue: queue) {
+            let delays = Array(queueDelays.prefix(clients.count))
+            queueDelays.deallocate()
+            let metrics = clients.map { $0.realtime.metrics() }
+            let footprints = clients.map { $0.realtime.memoryFootprint() }
+
+            self.lock.lock()
+            let latencies = self.latencies
+            let counters = self.counters
+            self.latencies.removeAll(keepingCapacity: true)
+            self.lock.unlock()
+
+            let elapsed = self.elapsed
+            let footprint = memoryFootprint()
+            self.footprintHighWaterMark = max(self.footprintHighWaterMark, footprint)
+            self.footprints.append((elapsed, footprint))
+
+            var sample: [String: Any] = counters
+            sample["elapsed"] = elapsed
+            sample["footprintBytes"] = footprint
+            sample["footprintHighWaterMarkBytes"] = self.footprintHighWaterMark
+            sample["leakGrowthBytesPerHour"] = self.leakGrowth() ?? 0
+            sample["queuedMessages"] = metrics.reduce(0) { $0 + $1.queuedMessages }
+            sample["pendingMessages"] = metrics.reduce(0) { $0 + $1.pendingMessages }
+            sample["maxPendingMessages"] = metrics.map { $0.pendingMessages }.max() ?? 0
+            sample["reconnects"] = metrics.reduce(0) { $0 + $1.reconnects }
+            sample["clientEstimatedBytes"] = footprints.reduce(0) { $0 + $1.totalBytes }
+            sample["maxClientEstimatedBytes"] = footprints.map { $0.totalBytes }.max() ?? 0
+            sample["forcedDisconnects"] = forcedDisconnects
+            sample["internalQueueDelay"] = LoadTestRecorder.percentiles(delays)
+            sample["endToEndLatency"] = LoadTestRecorder.percentiles(latencies)
+            sample["ackLatency"] = self.ackLatencySinceLastSample(metrics)
+
+            // Percentiles above the last histogram bucket are infinite, which isn't valid JSON.
+            sample = LoadTestRecorder.finite(sample) as! [String: Any]
+            self.lastSample = sample
+            self.write(["sample": sample])
+            completion(sample)
+        }
+    }
+
+    /// Writes the summary and closes the report. Call on `queue`.
+    func finish() {
+        write(["summary": [
+            "elapsed": elapsed,
+            "samples": footprints.count,
+            "footprintHighWaterMarkBytes": footprintHighWaterMark,
+            "leakGrowthBytesPerHour": leakGrowth() ?? 0,
+            "lastSample": lastSample,
+        ]])
+        report?.closeFile()
+        report = nil
+    }
+
+    /// The slope of a least-squares fit of the footprint over the samples taken after the warmup, in bytes per hour.
+    private func leakGrowth() -> Double? {
+        let points = footprints.filter { $0.elapsed >= configuration.warmup }
+        guard points.count >= 2 else {
+            return nil
+        }
+        let n = Double(points.count)
+        let meanX = points.reduce(0) { $0 + $1.elapsed } / n
+        let meanY = points.reduce(0) { $0 + Double($1.bytes) } / n
+        var covariance = 0.0
+        var variance = 0.0
+        for point in points {
+            covariance += (point.elapsed - meanX) * (Double(point.bytes) - meanY)
+            variance += (point.elapsed - meanX) * (point.elapsed - meanX)
+        }
+        return variance > 0 ? covariance / variance * 3600 : nil
+    }
+
+    /// Percentiles of the acknowledgements received since the previous sample, from the clients' cumulative histograms.
+    private func ackLatencySinceLastSample(_ metrics: [ARTClientMetrics]) -> [String: Any] {
+        guard let bounds = metrics.first?.ackLatency.bucketUpperBounds else {
+            return [:]
+        }
+        var buckets = [Int](repeating: 0, count: bounds.count + 1)
+        for snapshot in metrics {
+            for (index, count) in snapshot.ackLatency.bucketCounts.enumerated() where index < buckets.count {
+                buckets[index] += count.intValue
+            }
+        }
+        let interval = previousAckBuckets.count == buckets.count ? zip(buckets, previousAckBuckets).map { max(0, $0 - $1) } : buckets
+        previousAckBuckets = buckets
+
+        let total = interval.reduce(0, +)
+        func percentile(_ p: Double) -> Double {
+            guard total > 0 else { return 0 }
+            let rank = max(1, Int((p / 100 * Double(total)).rounded(.up)))
+            var seen = 0
+            for (index, count) in interval.enumerated() {
+                seen += count
+                if seen >= rank {
+                    return index < bounds.count ? bounds[index].doubleValue * 1000 : .infinity
+                }
+            }
+            return .infinity
+        }
+        return ["count": total, "p50Ms": percentile(50), "p90Ms": percentile(90), "p99Ms": percentile(99)]
+    }
+
+    private static func percentiles(_ nanoseconds: [UInt64]) -> [String: Any] {
+        let sorted = nanoseconds.sorted()
+        func percentile(_ p: Double) -> Double {
+            guard !sorted.isEmpty else { return 0 }
+            let index = min(sorted.count - 1, max(0, Int((p / 100 * Double(sorted.count)).rounded(.up)) - 1))
+            return Double(sorted[index]) / 1_000_000
+        }
+        return [
+            "count": sorted.count,
+            "p50Ms": percentile(50),
+            "p90Ms": percentile(90),
+            "p99Ms": percentile(99),
+            "maxMs": Double(sorted.last ?? 0) / 1_000_000,
+        ]
+    }
+
+    private func write(_ object: [String: Any]) {
+        guard let data = try? JSONSerialization.data(withJSONObject: object) else {
+            return
+        }
+        report?.write(data)
+        report?.write("\n".data(using: .utf8)!)
+        print("LoadTest: \(String(data: data, encoding: .utf8)!)")
+    }
+
+    private static func finite(_ value: Any) -> Any {
+        switch value {
+        case let dictionary as [String: Any]:
+            return dictionary.mapValues(finite)
+        case let double as Double where !double.isFinite:
+            return "inf"
+        default:
+            return value
+        }
+    }
+
+}
@@ -0,0 +1,459 @@
+import Foundation
+import Ably.Private
+
+private let jsonEncoder = ARTJsonLikeEncoder(delegate: ARTJsonEncoder())
+private let msgPackEncoder = ARTJsonLikeEncoder(delegate: ARTMsgPackEncoder())
+
+/// An in-process stand-in for the realtime and REST endpoints that behaves like a well-behaved server.
+///
+/// It acknowledges every publish and presence change, fans messages and presence out to every connection attached to the
+/// channel, syncs presence on attach, resumes dropped connections and serves channel history and presence from memory.
+/// Unlike the randomized stand-ins in the UI tests, it only fails on purpose: with `reconnectInterval` set it drops each
+/// connection from time to time, so that clients go through resumes for the whole run.
+///
+/// Its own state is bounded (history is capped per channel and connections that aren't resumed are forgotten), so memory
+/// growth over a run is the client's.
+final class LoadTestServer {
+
+    static let shared = LoadTestServer()
+
+    static let historyLimit = 100
+    static let connectionStateTtl: TimeInterval = 120
+
+    /// Install before creating any client.
+    static func install() {
+        ARTWebSocketTransport.setWebSocketClass(LoadTestWebSocket.self)
+        ARTHttp.setURLSessionClass(LoadTestURLSession.self)
+    }
+
+    let queue = DispatchQueue(label: "io.ably.loadTest.server", qos: .userInitiated)
+
+    /// Set before clients connect; see `LoadTestConfiguration.reconnectInterval`.
+    var reconnectInterval: TimeInterval = 0
+    var random = SeededRandomNumberGenerator(seed: 0)
+
+    private class Connection {
+        let id: String
+        var socket: LoadTestWebSocket?
+
+        init(id: String) {
+            self.id = id
+        }
+    }
+
+    private class Channel {
+        var connections: Set<String> = []
+        var members: [String: ARTPresenceMessage] = [:]
+        var history: [ARTMessage] = []
+        var serial: Int64 = 0
+    }
+
+    private var connections: [String: Connection] = [:]
+    private var channels: [String: Channel] = [:]
+    private var nextConnectionId = 0
+
+    private(set) var forcedDisconnects = 0
+
+    // MARK: Realtime
+
+    fileprivate func open(_ socket: LoadTestWebSocket) {
+        queue.async {
+            let query = URLComponents(url: socket.request.url!, resolvingAgainstBaseURL: false)?.queryItems ?? []
+            let resumeKey = query.first { $0.name == "resume" }?.value
+
+            let connection: Connection
+            if let resumeKey = resumeKey, let resumed = self.connections[resumeKey] {
+                connection = resumed
+                connection.socket?.drop(code: ARTSRStatusCode.codeGoingAway.rawValue, reason: "superseded", clean: true)
+            }
+            else {
+                self.nextConnectionId += 1
+                connection = Connection(id: "loadTestConnection\(self.nextConnectionId)")
+                self.connections[connection.id] = connection
+            }
+            connection.socket = socket
+            socket.connectionId = connection.id
+
+            socket.didOpen()
+            let connected = ARTProtocolMessage()
+            connected.action = .connected
+            connected.connectionId = connection.id
+            connected.connectionKey = connection.id
+            connected.connectionDetails = ARTConnectionDetails(clientId: nil,
+                                                               connectionKey: connection.id,
+                                                               maxMessageSize: 65536,
+                                                               maxFrameSize: 524288,
+                                                               maxInboundRate: 0,
+                                                               connectionStateTtl: LoadTestServer.connectionStateTtl,
+                                                               serverId: "loadTestServer",
+                                                               maxIdleInterval: 0)
+            self.send(connected, to: connection)
+            self.scheduleDrop(of: socket)
+        }
+    }
+
+    private func scheduleDrop(of socket: LoadTestWebSocket) {
+        guard reconnectInterval > 0 else {
+            return
+        }
+        let delay = Double.random(in: 0.5 ... 1.5, using: &random) * reconnectInterval
+        queue.asyncAfter(deadline: .now() + delay) { [weak socket] in
+            guard let socket = socket, let id = socket.connectionId, self.connections[id]?.socket === socket else {
+                return
+            }
+            self.forcedDisconnects += 1
+            self.disconnect(socket, code: ARTSRStatusCode.codeAbnormal.rawValue, reason: "forced reconnect", clean: false)
+        }
+    }
+
+    /// The connection outlives the socket for `connectionStateTtl`, so that the client can resume it.
+    private func disconnect(_ socket: LoadTestWebSocket, code: Int, reason: String, clean: Bool) {
+        socket.drop(code: code, reason: reason, clean: clean)
+        guard let id = socket.connectionId, let connection = connections[id], connection.socket === socket else {
+            return
+        }
+        connection.socket = nil
+        queue.asyncAfter(deadline: .now() + LoadTestServer.connectionStateTtl) {
+            if connection.socket == nil {
+                self.remove(connection)
+            }
+        }
+    }
+
+    private func remove(_ connection: Connection) {
+        let memberKeyPrefix = "\(connection.id):"
+        for channel in channels.values {
+            channel.connections.remove(connection.id)
+            channel.members = channel.members.filter { !$0.key.hasPrefix(memberKeyPrefix) }
+        }
+        connections.removeValue(forKey: connection.id)
+    }
+
+    fileprivate func receive(_ frame: Any, from socket: LoadTestWebSocket) {
+        queue.async {
+            guard let id = socket.connectionId, let connection = self.connections[id], connection.socket === socket else {
+                return
+            }
+            let data = (frame as? Data) ?? (frame as? String)?.data(using: .utf8) ?? Data()
+            guard let message = try? socket.encoder.decodeProtocolMessage(data) else {
+                return
+            }
+            self.handle(message, from: connection)
+        }
+    }
+
+    private func handle(_ message: ARTProtocolMessage, from connection: Connection) {
+        switch message.action {
+        case .heartbeat:
+            let heartbeat = ARTProtocolMessage()
+            heartbeat.action = .heartbeat
+            heartbeat.id = message.id
+            send(heartbeat, to: connection)
+        case .attach:
+            let name = message.channel!
+            let channel = self.channel(name)
+            channel.connections.insert(connection.id)
+
+            let attached = ARTProtocolMessage()
+            attached.action = .attached
+            attached.channel = name
+            attached.channelSerial = "\(name):\(channel.serial)"
+            if !channel.members.isEmpty {
+                attached.flags = Int64(ARTProtocolMessageFlag.hasPresence.rawValue)
+            }
+            send(attached, to: connection)
+
+            if !channel.members.isEmpty {
+                let sync = ARTProtocolMessage()
+                sync.action = .sync
+                sync.channel = name
+                sync.channelSerial = "\(name):"
+                sync.presence = Array(channel.members.values)
+                send(sync, to: connection)
+            }
+        case .detach:
+            let name = message.channel!
+            channels[name]?.connections.remove(connection.id)
+
+            let detached = ARTProtocolMessage()
+            detached.action = .detached
+            detached.channel = name
+            send(detached, to: connection)
+        case .message:
+            ack(message, to: connection)
+            broadcast(message, from: connection) { channel, outgoing in
+                for (index, item) in (message.messages ?? []).enumerated() {
+                    item.id = "\(outgoing.id!):\(index)"
+                    item.connectionId = connection.id
+                    item.timestamp = outgoing.timestamp
+                    channel.history.append(item)
+                }
+                if channel.history.count > LoadTestServer.historyLimit {
+                    channel.history.removeFirst(channel.history.count - LoadTestServer.historyLimit)
+                }
+                outgoing.messages = message.messages
+            }
+        case .presence:
+            ack(message, to: connection)
+            broadcast(message, from: connection) { channel, outgoing in
+                for (index, item) in (message.presence ?? []).enumerated() {
+                    item.id = "\(outgoing.id!):\(index)"
+                    item.connectionId = connection.id
+                    item.timestamp = outgoing.timestamp
+                    let key = "\(connection.id):\(item.clientId ?? "")"
+                    if item.action == .leave {
+                        channel.members.removeValue(forKey: key)
+                    }
+                    else {
+                        let member = item.copy() as! ARTPresenceMessage
+                        member.action = .present
+                        channel.members[key] = member
+                    }
+                }
+                outgoing.presence = message.presence
+            }
+        case .close:
+            let closed = ARTProtocolMessage()
+            closed.action = .closed
+            send(closed, to: connection)
+            if let socket = connection.socket {
+                socket.drop(code: ARTSRStatusCode.codeNormal.rawValue, reason: "closed", clean: true)
+            }
+            remove(connection)
+        default:
+            break
+        }
+    }
+
+    private func channel(_ name: String) -> Channel {
+        if let channel = channels[name] {
+            return channel
+        }
+        let channel = Channel()
+        channels[name] = channel
+        return channel
+    }
+
+    private func ack(_ message: ARTProtocolMessage, to connection: Connection) {
+        guard message.ackRequired, let serial = message.msgSerial else {
+            return
+        }
+        let ack = ARTProtocolMessage()
+        ack.action = .ack
+        ack.msgSerial = serial
+        ack.count = 1
+        send(ack, to: connection)
+    }
+
+    /// Builds the outgoing message with `prepare` and sends it, encoded once per format, to every connection attached to the channel.
+    private func broadcast(_ message: ARTProtocolMessage, from connection: Connection, prepare: (Channel, ARTProtocolMessage) -> Void) {
+        guard let name = message.channel, let channel = channels[name] else {
+            return
+        }
+        channel.serial += 1
+        let outgoing = ARTProtocolMessage()
+        outgoing.action = message.action
+        outgoing.channel = name
+        outgoing.channelSerial = "\(name):\(channel.serial)"
+        outgoing.id = "\(connection.id):\(message.msgSerial ?? 0)"
+        outgoing.connectionId = connection.id
+        outgoing.timestamp = Date()
+        prepare(channel, outgoing)
+
+        var frames: [ARTEncoderFormat: Data] = [:]
+        for id in channel.connections {
+            guard let recipient = connections[id], let socket = recipient.socket else {
+                continue
+            }
+            let format = socket.encoder.format()
+            if frames[format] == nil {
+                frames[format] = try? socket.encoder.encode(outgoing)
+            }
+            if let frame = frames[format] {
+                socket.deliver(frame)
+            }
+        }
+    }
+
+    private func send(_ message: ARTProtocolMessage, to connection: Connection) {
+        guard let socket = connection.socket, let frame = try? socket.encoder.encode(message) else {
+            return
+        }
+        socket.deliver(frame)
+    }
+
+    // MARK: REST
+
+    /// Answers `GET /time`, `GET /channels/<name>/messages` and `GET /channels/<name>/presence`; anything else is a 404.
+    fileprivate func respond(to request: URLRequest, completion: @escaping (HTTPURLResponse?, Data?, Error?) -> Void) {
+        queue.async {
+            let url = request.url!
+            let components = url.path.split(separator: "/").map { $0.removingPercentEncoding ?? String($0) }
+            var status = 200
+            var body: Any
+
+            if components == ["time"] {
+                body = [Int(Date().timeIntervalSince1970 * 1000)]
+            }
+            else if components.count == 3, components[0] == "channels", components[2] == "messages", request.httpMethod ?? "GET" == "GET" {
+                body = (self.channels[components[1]]?.history ?? []).reversed().map(LoadTestServer.dictionary(for:))
+            }
+            else if components.count == 3, components[0] == "channels", components[2] == "presence" {
+                body = (self.channels[components[1]]?.members.values.map { $0 } ?? []).map(LoadTestServer.dictionary(for:))
+            }
+            else {
+                status = 404
+                body = ["error": ["code": 40400, "statusCode": 404, "message": "\(url.path) is not served by the load test stand-in"]]
+            }
+
+            let data = try! JSONSerialization.data(withJSONObject: body)
+            let response = HTTPURLResponse(url: url, statusCode: status, httpVersion: "HTTP/1.1", headerFields: [
+                "Content-Type": "application/json",
+                "Content-Length": "\(data.count)",
+            ])
+            completion(response, data, nil)
+        }
+    }
+
+    private static func dictionary(for message: ARTBaseMessage) -> [String: Any] {
+        var dictionary: [String: Any] = [:]
+        dictionary["id"] = message.id
+        dictionary["clientId"] = message.clientId
+        dictionary["connectionId"] = message.connectionId
+        dictionary["timestamp"] = message.timestamp.map { Int($0.timeIntervalSince1970 * 1000) }
+        if let data = message.data as? Data {
+            dictionary["data"] = data.base64EncodedString()
+            dictionary["encoding"] = message.encoding.map { "\($0)/base64" } ?? "base64"
+        }
+        else {
+            dictionary["data"] = message.data
+            dictionary["encoding"] = message.encoding
+        }
+        if let message = message as? ARTMessage {
+            dictionary["name"] = message.name
+        }
+        if let message = message as? ARTPresenceMessage {
+            dictionary["action"] = message.action.rawValue
+        }
+        return dictionary
+    }
+
+}
+
+/// The socket end of a `LoadTestServer` connection. Frames from the client are handed to the server's queue; frames from
+/// the server are delivered on the client's internal queue, as `ARTSRWebSocket` does.
+final class LoadTestWebSocket: NSObject, ARTWebSocket {
+
+    weak var delegate: ARTWebSocketDelegate?
+    var delegateDispatchQueue: DispatchQueue?
+    private(set) var readyState: ARTSRReadyState = .CONNECTING
+
+    let request: URLRequest
+    let encoder: ARTEncoder
+
+    /// Only touched on the server's queue.
+    fileprivate var connectionId: String?
+
+    init(urlRequest request: URLRequest, logger: ARTLog?) {
+        self.request = request
+        let format = URLComponents(url: request.url!, resolvingAgainstBaseURL: false)?.queryItems?.first { $0.name == "format" }?.value
+        encoder = format == "json" ? jsonEncoder : msgPackEncoder
+        super.init()
+    }
+
+    func open() {
+        LoadTestServer.shared.open(self)
+    }
+
+    func close(withCode code: Int, reason: String?) {
+        drop(code: code, reason: reason ?? "", clean: true)
+    }
+
+    func send(_ message: Any?) {
+        guard readyState == .OPEN, let message = message else {
+            return
+        }
+        LoadTestServer.shared.receive(message, from: self)
+    }
+
+    fileprivate func didOpen() {
+        delegateDispatchQueue?.async {
+            guard self.readyState == .CONNECTING else {
+                return
+            }
+            self.readyState = .OPEN
+            self.delegate?.webSocketDidOpen(self)
+        }
+    }
+
+    fileprivate func deliver(_ frame: Data) {
+        delegateDispatchQueue?.async {
+            guard self.readyState == .OPEN else {
+                return
+            }
+            // Text frames reach the transport as strings, as they do from `ARTSRWebSocket`.
+            if self.encoder.format() == .json {
+                self.delegate?.webSocket(self, didReceiveMessage: String(data: frame, encoding: .utf8)!)
+            }
+            else {
+                self.delegate?.webSocket(self, didReceiveMessage: frame)
+            }
+        }
+    }
+
+    fileprivate func drop(code: Int, reason: String, clean: Bool) {
+        delegateDispatchQueue?.async {
+            guard self.readyState != .CLOSED else {
+                return
+            }
+            self.readyState = .CLOSED
+            self.delegate?.webSocket(self, didCloseWithCode: code, reason: reason, wasClean: clean)
+        }
+    }
+
+}
+
+/// Routes every REST request to `LoadTestServer`.
+final class LoadTestURLSession: NSObject, ARTURLSession {
+
+    let queue: DispatchQueue
+
+    init(_ queue: DispatchQueue) {
+        self.queue = queue
+    }
+
+    func get(_ request: URLRequest, completion callback: @escaping (HTTPURLResponse?, Data?, Error?) -> Void) -> ARTCancellable & NSObjectProtocol {
+        let cancellable = LoadTestCancellable()
+        LoadTestServer.shared.respond(to: request) { response, data, error in
+            self.queue.async {
+                if !cancellable.cancelled {
+                    callback(response, data, error)
+                }
+            }
+        }
+        return cancellable
+    }
+
+    func finishTasksAndInvalidate() {
+    }
+
+}
+
+private final class LoadTestCancellable: NSObject, ARTCancellable {
+
+    private let lock = NSLock()
+    private var _cancelled = false
+
+    var cancelled: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return _cancelled
+    }
+
+    func cancel() {
+        lock.lock()
+        _cancelled = true
+        lock.unlock()
+    }
+
+}
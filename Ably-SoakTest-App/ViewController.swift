@@ -8,13 +8,31 @@
 
 import UIKit
 
+/// Starts a `LoadGenerator` configured from the launch arguments and shows its latest sample.
 class ViewController: UIViewController {
 
+    private let generator = LoadGenerator(configuration: LoadTestConfiguration())
+    private let status = UITextView()
+
     override func viewDidLoad() {
         super.viewDidLoad()
-        // Do any additional setup after loading the view.
-    }
 
+        status.frame = view.bounds
+        status.autoresizingMask = [.flexibleWidth, .flexibleHeight]
+        status.isEditable = false
+        status.font = UIFont.monospacedDigitSystemFont(ofSize: 12, weight: .regular)
+        status.text = "Load test starting, writing to \(generator.recorder.reportURL.lastPathComponent)"
+        view.addSubview(status)
 
-}
+        UIApplication.shared.isIdleTimerDisabled = true
+        generator.onSample = { [weak self] sample, finished in
+            let data = try? JSONSerialization.data(withJSONObject: sample, options: [.prettyPrinted, .sortedKeys])
+            let text = (finished ? "Finished\n" : "") + (data.flatMap { String(data: $0, encoding: .utf8) } ?? "\(sample)")
+            DispatchQueue.main.async {
+                self?.status.text = text
+            }
+        }
+        generator.start()
+    }
 
+}
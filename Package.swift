@@ -61,6 +61,9 @@ let package = Package(
                 .headerSearchPath("PrivateHeaders"),
                 .headerSearchPath("PrivateHeaders/Ably"),
                 .headerSearchPath("include/Ably")
+            ],
+            linkerSettings: [
+                .linkedLibrary("z")
             ]
         )
     ]
@@ -44,6 +44,11 @@ typedef NS_ENUM(NSInteger, ARTSRStatusCode) {
     // 4000-4999: Available for use by applications.
 };
 
+typedef NS_ENUM(NSInteger, ARTSRMessageTraceEvent) {
+    ARTSRMessageTraceEventFramed,
+    ARTSRMessageTraceEventWritten,
+};
+
 @class ARTSRWebSocket;
 @class ARTSRSecurityPolicy;
 @class ARTLog;
@@ -97,6 +102,13 @@ extern NSString *const ARTSRHTTPResponseErrorKey;
  */
 @property (atomic, assign, readonly) ARTSRReadyState readyState;
 
+/**
+ An optional handler for tracing outgoing messages, called on the socket's internal work queue.
+
+ Only messages passed to `send:traceNumber:` with a non-zero number are traced. Each is reported with that number once when its frame has been built, and once when the last byte of that frame has been written to the socket stream.
+ */
+@property (nullable, atomic, copy) void (^messageTraceHandler)(ARTSRMessageTraceEvent event, uint64_t messageNumber);
+
 /**
  An instance of `NSURL` that this socket connects to.
  */
@@ -269,6 +281,14 @@ extern NSString *const ARTSRHTTPResponseErrorKey;
  */
 - (void)send:(nullable id)message;
 
+/**
+ Send a UTF-8 string or binary data to the server, reporting it to `messageTraceHandler` under `traceNumber` unless that is 0.
+
+ @param message     UTF-8 String or Data to send.
+ @param traceNumber The number the message is traced under, or 0 not to trace it.
+ */
+- (void)send:(nullable id)message traceNumber:(uint64_t)traceNumber;
+
 /**
  Send a UTF-8 String to the server.
 
@@ -102,6 +102,11 @@ NSString *const ARTSRHTTPResponseErrorKey = @"HTTPResponseStatusCode";
     dispatch_data_t _outputBuffer;
     NSUInteger _outputBufferOffset;
 
+    // Message tracing; only maintained for messages sent with a trace number.
+    uint64_t _outputBytesQueued;
+    uint64_t _outputBytesWritten;
+    NSMutableArray<NSArray<NSNumber *> *> *_tracedMessageEnds; // [messageNumber, end offset in output bytes]
+
     uint8_t _currentFrameOpcode;
     size_t _currentFrameCount;
     size_t _readOpCount;
@@ -594,23 +599,34 @@ NSString *const ARTSRHTTPResponseErrorKey = @"HTTPResponseStatusCode";
         strongData = nil;
     });
     _outputBuffer = dispatch_data_create_concat(_outputBuffer, newData);
+    _outputBytesQueued += data.length;
     [self _pumpWriting];
 }
 
 - (void)send:(nullable id)message
+{
+    [self send:message traceNumber:0];
+}
+
+- (void)send:(nullable id)message traceNumber:(uint64_t)traceNumber
 {
     if (!message) {
-        [self sendData:nil error:nil]; // Send Data, but it doesn't matter since we are going to send the same text frame with 0 length.
+        [self _sendDataNoCopy:nil traceNumber:traceNumber error:nil]; // Send Data, but it doesn't matter since we are going to send the same text frame with 0 length.
     } else if ([message isKindOfClass:[NSString class]]) {
-        [self sendString:message error:nil];
+        [self _sendString:message traceNumber:traceNumber error:nil];
     } else if ([message isKindOfClass:[NSData class]]) {
-        [self sendData:message error:nil];
+        [self _sendDataNoCopy:[message copy] traceNumber:traceNumber error:nil];
     } else {
         NSAssert(NO, @"Unrecognized message. Not able to send anything other than a String or NSData.");
     }
 }
 
 - (BOOL)sendString:(NSString *)string error:(NSError **)error
+{
+    return [self _sendString:string traceNumber:0 error:error];
+}
+
+- (BOOL)_sendString:(NSString *)string traceNumber:(uint64_t)traceNumber error:(NSError **)error
 {
     if (self.readyState != ARTSR_OPEN) {
         NSString *message = @"Invalid State: Cannot call `sendString:error:` until connection is open.";
@@ -623,7 +639,7 @@ NSString *const ARTSRHTTPResponseErrorKey = @"HTTPResponseStatusCode";
 
     string = [string copy];
     dispatch_async(_workQueue, ^{
-        [self _sendFrameWithOpcode:ARTSROpCodeTextFrame data:[string dataUsingEncoding:NSUTF8StringEncoding]];
+        [self _sendFrameWithOpcode:ARTSROpCodeTextFrame data:[string dataUsingEncoding:NSUTF8StringEncoding] traceNumber:traceNumber];
     });
     return YES;
 }
@@ -635,6 +651,11 @@ NSString *const ARTSRHTTPResponseErrorKey = @"HTTPResponseStatusCode";
 }
 
 - (BOOL)sendDataNoCopy:(nullable NSData *)data error:(NSError **)error
+{
+    return [self _sendDataNoCopy:data traceNumber:0 error:error];
+}
+
+- (BOOL)_sendDataNoCopy:(nullable NSData *)data traceNumber:(uint64_t)traceNumber error:(NSError **)error
 {
     if (self.readyState != ARTSR_OPEN) {
         NSString *message = @"Invalid State: Cannot call `sendDataNoCopy:error:` until connection is open.";
@@ -647,9 +668,9 @@ NSString *const ARTSRHTTPResponseErrorKey = @"HTTPResponseStatusCode";
 
     dispatch_async(_workQueue, ^{
         if (data) {
-            [self _sendFrameWithOpcode:ARTSROpCodeBinaryFrame data:data];
+            [self _sendFrameWithOpcode:ARTSROpCodeBinaryFrame data:data traceNumber:traceNumber];
         } else {
-            [self _sendFrameWithOpcode:ARTSROpCodeTextFrame data:nil];
+            [self _sendFrameWithOpcode:ARTSROpCodeTextFrame data:nil traceNumber:traceNumber];
         }
     });
     return YES;
@@ -1074,6 +1095,8 @@ static const uint8_t ARTSRPayloadLenMask   = 0x7F;
         }
 
         _outputBufferOffset += bytesWritten;
+        _outputBytesWritten += bytesWritten;
+        [self _traceWrittenMessages];
 
         if (_outputBufferOffset > ARTSRDefaultBufferSize() && _outputBufferOffset > dataLength / 2) {
             _outputBuffer = dispatch_data_create_subrange(_outputBuffer, _outputBufferOffset, dataLength - _outputBufferOffset);
@@ -1336,6 +1359,11 @@ static const char CRLFCRLFBytes[] = {'\r', '\n', '\r', '\n'};
 static const size_t ARTSRFrameHeaderOverhead = 32;
 
 - (void)_sendFrameWithOpcode:(ARTSROpCode)opCode data:(NSData *)data
+{
+    [self _sendFrameWithOpcode:opCode data:data traceNumber:0];
+}
+
+- (void)_sendFrameWithOpcode:(ARTSROpCode)opCode data:(NSData *)data traceNumber:(uint64_t)traceNumber
 {
     [self assertOnWorkQueue];
 
@@ -1402,9 +1430,31 @@ static const size_t ARTSRFrameHeaderOverhead = 32;
     assert(frameBufferSize <= frameData.length);
     frameData.length = frameBufferSize;
 
+    // Untraced frames, the vast majority, cost nothing beyond this check.
+    void (^traceHandler)(ARTSRMessageTraceEvent, uint64_t) = traceNumber != 0 ? self.messageTraceHandler : nil;
+    if (traceHandler) {
+        traceHandler(ARTSRMessageTraceEventFramed, traceNumber);
+        if (!_tracedMessageEnds) {
+            _tracedMessageEnds = [NSMutableArray array];
+        }
+        [_tracedMessageEnds addObject:@[@(traceNumber), @(_outputBytesQueued + frameData.length)]];
+    }
+
     [self _writeData:frameData];
 }
 
+- (void)_traceWrittenMessages
+{
+    void (^traceHandler)(ARTSRMessageTraceEvent, uint64_t) = self.messageTraceHandler;
+    while (_tracedMessageEnds.count > 0 && _tracedMessageEnds[0][1].unsignedLongLongValue <= _outputBytesWritten) {
+        uint64_t messageNumber = _tracedMessageEnds[0][0].unsignedLongLongValue;
+        [_tracedMessageEnds removeObjectAtIndex:0];
+        if (traceHandler) {
+            traceHandler(ARTSRMessageTraceEventWritten, messageNumber);
+        }
+    }
+}
+
 - (void)stream:(NSStream *)aStream handleEvent:(NSStreamEvent)eventCode
 {
     __weak typeof(self) wself = self;
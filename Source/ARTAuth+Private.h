@@ -3,6 +3,7 @@
 #import "ARTQueuedDealloc.h"
 
 @class ARTRestInternal;
+@class ARTTokenDetailsCache;
 
 typedef NS_ENUM(NSUInteger, ARTAuthorizationState) {
     ARTAuthorizationSucceeded, //ItemType: nil
@@ -38,6 +39,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nullable, nonatomic, readonly, strong) NSNumber *timeOffset;
 
+// Only set when `ARTClientOptions.persistTokenDetails` is enabled.
+@property (nullable, nonatomic, strong) ARTTokenDetailsCache *tokenDetailsCache;
+
 @property (nullable, weak) id<ARTAuthDelegate> delegate; // weak because delegates outlive their counterpart
 @property (readonly) BOOL authorizing;
 @property (readonly) BOOL authorizing_nosync;
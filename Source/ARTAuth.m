@@ -20,6 +20,9 @@
 #import "ARTPushActivationEvent.h"
 #import "ARTPushActivationState.h"
 #import "ARTFormEncode.h"
+#import "ARTTokenDetailsCache.h"
+#import "ARTLocalDeviceStorage.h"
+#import "ARTDeviceStorageWriter.h"
 
 @implementation ARTAuth {
     ARTQueuedDealloc *_dealloc;
@@ -80,6 +83,14 @@
 
 @end
 
+@interface ARTAuthInternal ()
+
+// The result of `clientId_nosync`, republished on the internal queue whenever one of its inputs changes, so that
+// `clientId` can be read from any thread without a `dispatch_sync`.
+@property (nullable, readwrite, strong) NSString *clientId;
+
+@end
+
 @implementation ARTAuthInternal {
     __weak ARTRestInternal *_rest; // weak because rest owns auth
     dispatch_queue_t _userQueue;
@@ -88,6 +99,8 @@
     NSString *_protocolClientId;
     NSInteger _authorizationsCount;
     ARTEventEmitter<ARTEvent *, ARTErrorInfo *> *_cancelationEventEmitter;
+    // Whether the cached token details have been read, or no longer need to be.
+    BOOL _cachedTokenDetailsRestored;
 }
 
 - (instancetype)init:(ARTRestInternal *)rest withOptions:(ARTClientOptions *)options {
@@ -103,6 +116,8 @@
         _tokenParams = options.defaultTokenParams ? : [[ARTTokenParams alloc] initWithOptions:self.options];
         _authorizationsCount = 0;
         [self validate:options];
+        [self setUpTokenDetailsCache:options];
+        [self updateClientId_nosync];
 
         [[NSNotificationCenter defaultCenter] addObserver:self
                                                  selector:@selector(didReceiveCurrentLocaleDidChangeNotification:)
@@ -189,6 +204,48 @@
     }
 }
 
+- (void)setUpTokenDetailsCache:(ARTClientOptions *)options {
+    // Only called from constructor, no need to synchronize.
+    if (!options.persistTokenDetails || _method != ARTAuthMethodToken || options.tokenDetails) {
+        // A token supplied explicitly always takes precedence over the cached one.
+        _cachedTokenDetailsRestored = YES;
+    }
+    if (!options.persistTokenDetails || _method != ARTAuthMethodToken) {
+        return;
+    }
+    // Written behind the client, so that token changes don't wait for the Keychain on the client's queue.
+    #if TARGET_OS_IOS
+    __weak ARTRestInternal *rest = _rest;
+    ARTTokenDetailsCacheStorageProvider storageProvider = ^id<ARTDeviceStorage>{
+        return rest.storageWriter;
+    };
+    #else
+    ARTDeviceStorageWriter *storageWriter = [[ARTDeviceStorageWriter alloc] initWithStorage:[ARTLocalDeviceStorage newWithLogger:_logger] logger:_logger];
+    ARTTokenDetailsCacheStorageProvider storageProvider = ^id<ARTDeviceStorage>{
+        return storageWriter;
+    };
+    #endif
+    _tokenDetailsCache = [[ARTTokenDetailsCache alloc] initWithStorageProvider:storageProvider options:options logger:_logger];
+}
+
+- (void)restoreCachedTokenDetails_nosync {
+    // Read on the first use of the token rather than in the constructor, so that the Keychain is never read on the
+    // thread that creates the client.
+    if (_cachedTokenDetailsRestored) {
+        return;
+    }
+    _cachedTokenDetailsRestored = YES;
+
+    NSNumber *timeOffset = nil;
+    ARTTokenDetails *tokenDetails = [_tokenDetailsCache loadTokenDetailsForClientId:self.options.clientId timeOffset:&timeOffset];
+    if (tokenDetails) {
+        [self.logger debug:__FILE__ line:__LINE__ message:@"RS:%p restored cached token details %@ (time offset %@)", _rest, tokenDetails, timeOffset];
+        _tokenDetails = tokenDetails;
+        _timeOffset = timeOffset;
+        [self updateClientId_nosync];
+    }
+}
+
 - (ARTAuthOptions *)mergeOptions:(ARTAuthOptions *)customOptions {
     return customOptions ? [self.options mergeWith:customOptions] : self.options;
 }
@@ -212,6 +269,7 @@
 - (void)storeParams:(ARTTokenParams *)customOptions {
     _options.clientId = customOptions.clientId;
     _options.defaultTokenParams = customOptions;
+    [self updateClientId_nosync];
 }
 
 - (NSURL *)buildURL:(ARTAuthOptions *)options withParams:(ARTTokenParams *)params {
@@ -282,6 +340,7 @@
 }
 
 - (BOOL)tokenRemainsValid {
+    [self restoreCachedTokenDetails_nosync];
     if (self.tokenDetails && self.tokenDetails.token) {
         if (self.tokenDetails.expires == nil) {
             return YES;
@@ -545,6 +604,8 @@ dispatch_async(_queue, ^{
 - (nullable NSObject<ARTCancellable> *)_authorize:(ARTTokenParams *)tokenParams
                                           options:(ARTAuthOptions *)authOptions
                                          callback:(ARTTokenDetailsCallback)callback {
+    // For the time offset, so that a token request doesn't have to query the server time again.
+    [self restoreCachedTokenDetails_nosync];
     ARTAuthOptions *replacedOptions = [authOptions copy] ? : [self.options copy];
     [self storeOptions:replacedOptions];
 
@@ -718,17 +779,14 @@ dispatch_async(_queue, ^{
 
 - (void)setProtocolClientId:(NSString *)clientId {
     _protocolClientId = clientId;
+    [self updateClientId_nosync];
     #if TARGET_OS_IOS
     [self setLocalDeviceClientId_nosync:_protocolClientId];
     #endif
 }
 
-- (NSString *)clientId {
-    __block NSString *clientId;
-dispatch_sync(_queue, ^{
-    clientId = self.clientId_nosync;
-});
-    return clientId;
+- (void)updateClientId_nosync {
+    self.clientId = [self clientId_nosync];
 }
 
 - (NSString *)clientId_nosync {
@@ -774,7 +832,14 @@ dispatch_sync(_queue, ^{
 }
 
 - (void)setTokenDetails:(ARTTokenDetails *)tokenDetails {
+    _cachedTokenDetailsRestored = YES;
     _tokenDetails = tokenDetails;
+    [self updateClientId_nosync];
+    if (tokenDetails) {
+        [_tokenDetailsCache storeTokenDetails:tokenDetails timeOffset:_timeOffset];
+    } else {
+        [_tokenDetailsCache clear];
+    }
     #if TARGET_OS_IOS
     [self setLocalDeviceClientId_nosync:tokenDetails.clientId];
     #endif
@@ -809,14 +874,19 @@ dispatch_sync(_queue, ^{
 
 #if TARGET_OS_IOS
 - (void)setLocalDeviceClientId_nosync:(NSString *)clientId {
-    if (clientId == nil || [clientId isEqualToString:@"*"] || [clientId isEqualToString:_rest.device_nosync.clientId]) {
+    if (clientId == nil || [clientId isEqualToString:@"*"]) {
         return;
     }
-    [_rest.device_nosync setClientId:clientId];
-    [_rest.push getActivationMachine:^(ARTPushActivationStateMachine *stateMachine) {
-        if (![stateMachine.current_nosync isKindOfClass:[ARTPushActivationStateNotActivated class]]) {
-            [stateMachine sendEvent:[[ARTPushActivationEventGotPushDeviceDetails alloc] init]];
+    [_rest loadDevice_nosync:^(ARTLocalDevice *device) {
+        if ([clientId isEqualToString:device.clientId]) {
+            return;
         }
+        [device setClientId:clientId];
+        [self->_rest.push getActivationMachine:^(ARTPushActivationStateMachine *stateMachine) {
+            if (![stateMachine.current_nosync isKindOfClass:[ARTPushActivationStateNotActivated class]]) {
+                [stateMachine sendEvent:[[ARTPushActivationEventGotPushDeviceDetails alloc] init]];
+            }
+        }];
     }];
 }
 #endif
@@ -8,10 +8,15 @@ ART_ASSUME_NONNULL_BEGIN
 @interface ARTBaseMessage ()
 
 @property (nonatomic, assign, readonly) BOOL isIdEmpty;
+/// Identifies the publish in `ARTPublishTracer`; zero when it isn't traced. Not sent to Ably.
+@property (nonatomic, assign) uint64_t traceId;
 
 - (id __art_nonnull)decodeWithEncoder:(ARTDataEncoder*)encoder error:(NSError *__art_nullable*__art_nullable)error;
 - (id __art_nonnull)encodeWithEncoder:(ARTDataEncoder*)encoder error:(NSError *__art_nullable*__art_nullable)error;
 
 @end
 
+/// The size of a message with these fields, as `-[ARTBaseMessage messageSize]` computes it (TO3l8).
+NSInteger ARTMessageSize(NSString *__art_nullable clientId, id __art_nullable data, id<ARTJsonCompatible> __art_nullable extras);
+
 ART_ASSUME_NONNULL_END
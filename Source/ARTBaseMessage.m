@@ -22,6 +22,7 @@
     message->_data = [self.data copy];
     message->_connectionId = self.connectionId;
     message->_encoding = self.encoding;
+    message->_traceId = self.traceId;
     return message;
 }
 
@@ -62,16 +63,26 @@
 }
 
 - (NSInteger)messageSize {
+    return ARTMessageSize(self.clientId, self.data, self.extras);
+}
+
+- (BOOL)isIdEmpty {
+    return self.id == nil || [self.id isEqualToString:@""];
+}
+
+@end
+
+NSInteger ARTMessageSize(NSString *clientId, id data, id<ARTJsonCompatible> extras) {
     // TO3l8*
     NSInteger finalResult = 0;
-    finalResult += [[self.extras toJSONString] lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
-    finalResult += [self.clientId lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
-    if (self.data) {
-        if ([self.data isKindOfClass:[NSString class]]) {
-            finalResult += [self.data lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    finalResult += [[extras toJSONString] lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    finalResult += [clientId lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    if (data) {
+        if ([data isKindOfClass:[NSString class]]) {
+            finalResult += [data lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
         }
-        else if ([self.data isKindOfClass:[NSData class]]) {
-            finalResult += [self.data length];
+        else if ([data isKindOfClass:[NSData class]]) {
+            finalResult += [data length];
         }
         else {
             NSError *error = nil;
@@ -82,7 +93,7 @@
             else {
                 options = 0; //no specific format
             }
-            NSData *jsonData = [NSJSONSerialization dataWithJSONObject:self.data
+            NSData *jsonData = [NSJSONSerialization dataWithJSONObject:data
                                                                options:options
                                                                  error:&error];
             if (!error) {
@@ -92,9 +103,3 @@
     }
     return finalResult;
 }
-
-- (BOOL)isIdEmpty {
-    return self.id == nil || [self.id isEqualToString:@""];
-}
-
-@end
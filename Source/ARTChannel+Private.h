@@ -4,6 +4,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class ARTRestInternal;
+@class ARTPublishTracer;
 
 @interface ARTChannel()
 
@@ -13,9 +14,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly, getter=getLogger) ARTLog *logger;
 @property (nonatomic, strong, readonly) ARTDataEncoder *dataEncoder;
+// Samples publishes when set; only realtime channels set it.
+@property (nullable, nonatomic, strong) ARTPublishTracer *publishTracer;
 
 - (void)internalPostMessages:(id)data callback:(nullable ARTCallback)callback;
 - (BOOL)exceedMaxSize:(NSArray<ARTBaseMessage *> *)messages;
+- (ARTMessage *)encodeMessageIfNeeded:(ARTMessage *)message error:(NSError *_Nullable *_Nullable)error;
 
 - (nullable ARTChannelOptions *)options;
 - (nullable ARTChannelOptions *)options_nosync;
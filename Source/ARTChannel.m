@@ -9,10 +9,12 @@
 #import "ARTRest+Private.h"
 #import "ARTDefault.h"
 #import "ARTClientOptions+Private.h"
+#import "ARTPublishTracer.h"
 
 @implementation ARTChannel {
     dispatch_queue_t _queue;
     ARTChannelOptions *_options;
+    ARTDecodeCache *_decodeCache;
 }
 
 - (instancetype)initWithName:(NSString *)name andOptions:(ARTChannelOptions *)options rest:(ARTRestInternal *)rest {
@@ -21,11 +23,12 @@
         _logger = rest.logger;
         _queue = rest.queue;
         _options = options;
+        _decodeCache = rest.decodeCache;
         NSError *error = nil;
-        _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:_options.cipher error:&error];
+        _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:_options.cipher decodeCache:_decodeCache error:&error];
         if (error != nil) {
             [_logger warn:@"creating ARTDataEncoder: %@", error];
-            _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:nil error:nil];
+            _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:nil decodeCache:_decodeCache error:nil];
         }
     }
     return self;
@@ -56,11 +59,11 @@
 
 - (void)recreateDataEncoderWith:(ARTCipherParams*)cipher {
     NSError *error = nil;
-    _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:cipher error:&error];
+    _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:cipher decodeCache:_decodeCache error:&error];
     
     if (error != nil) {
         [_logger warn:@"creating ARTDataEncoder: %@", error];
-        _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:nil error:nil];
+        _dataEncoder = [[ARTDataEncoder alloc] initWithCipherParams:nil decodeCache:_decodeCache error:nil];
     }
 }
 
@@ -97,6 +100,7 @@
 }
 
 - (void)publish:(NSString *)name message:(ARTMessage *)message extras:(id<ARTJsonCompatible>)extras callback:(ARTCallback)callback {
+    uint64_t traceId = [self.publishTracer startTrace];
     NSError *error = nil;
     message.extras = extras;
     ARTMessage *messagesWithDataEncoded = [self encodeMessageIfNeeded:message error:&error];
@@ -104,6 +108,8 @@
         if (callback) callback([ARTErrorInfo createFromNSError:error]);
         return;
     }
+    messagesWithDataEncoded.traceId = traceId;
+    [self.publishTracer record:ARTPublishTraceStageEncoded traceId:traceId];
     
     // Checked after encoding, so that the client can receive callback with encoding errors
     if ([self exceedMaxSize:@[message]]) {
@@ -123,11 +129,14 @@
 }
 
 - (void)publish:(__GENERIC(NSArray, ARTMessage *) *)messages callback:(nullable ARTCallback)callback {
+    uint64_t traceId = [self.publishTracer startTrace];
     NSError *error = nil;
 
     NSMutableArray<ARTMessage *> *messagesWithDataEncoded = [NSMutableArray new];
     for (ARTMessage *message in messages) {
-        [messagesWithDataEncoded addObject:[self encodeMessageIfNeeded:message error:&error]];
+        ARTMessage *messageWithDataEncoded = [self encodeMessageIfNeeded:message error:&error];
+        messageWithDataEncoded.traceId = traceId;
+        [messagesWithDataEncoded addObject:messageWithDataEncoded];
     }
     
     if (error) {
@@ -136,6 +145,7 @@
         }
         return;
     }
+    [self.publishTracer record:ARTPublishTraceStageEncoded traceId:traceId];
     
     // Checked after encoding, so that the client can receive callback with encoding errors
     if ([self exceedMaxSize:messages]) {
@@ -8,6 +8,10 @@
 @interface ARTChannels() {
     __weak id<ARTChannelsDelegate> _delegate; // weak because delegates outlive their counterpart
     dispatch_queue_t _queue;
+    // The keys of `channels`, updated on the internal queue whenever a channel is added or released, so that
+    // `exists:` can be answered from any thread without a `dispatch_sync`. Guarded by `_channelNamesLock`.
+    NSMutableSet<NSString *> *_channelNames;
+    NSLock *_channelNamesLock;
 }
 
 @end
@@ -18,6 +22,8 @@
     if (self = [super init]) {
         _queue = queue;
         _channels = [[NSMutableDictionary alloc] init];
+        _channelNames = [NSMutableSet set];
+        _channelNamesLock = [[NSLock alloc] init];
         _delegate = delegate;
         _prefix = prefix;
     }
@@ -41,11 +47,11 @@ dispatch_sync(_queue, ^{
 }
 
 - (BOOL)exists:(NSString *)name {
-    __block BOOL ret;
-dispatch_sync(_queue, ^{
-    ret = [self _exists:name];
-});
-    return ret;
+    name = [self addPrefix:name];
+    [_channelNamesLock lock];
+    BOOL exists = [_channelNames containsObject:name];
+    [_channelNamesLock unlock];
+    return exists;
 }
 
 - (BOOL)_exists:(NSString *)name {
@@ -67,7 +73,11 @@ dispatch_sync(_queue, ^{
 }
 
 - (void)_release:(NSString *)name {
-    [self->_channels removeObjectForKey:[self addPrefix:name]];
+    name = [self addPrefix:name];
+    [self->_channels removeObjectForKey:name];
+    [_channelNamesLock lock];
+    [_channelNames removeObject:name];
+    [_channelNamesLock unlock];
 }
 
 - (ARTRestChannel *)getChannel:(NSString *)name options:(ARTChannelOptions *)options {
@@ -86,6 +96,9 @@ dispatch_sync(_queue, ^{
     if (!channel) {
         channel = [_delegate makeChannel:name options:options];
         [self->_channels setObject:channel forKey:name];
+        [_channelNamesLock lock];
+        [_channelNames addObject:name];
+        [_channelNamesLock unlock];
     } else if (options) {
         [channel setOptions_nosync:options];
     }
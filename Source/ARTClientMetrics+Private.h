@@ -0,0 +1,31 @@
+#import <Ably/ARTClientMetrics.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ARTLatencyHistogram ()
+
+- (instancetype)initWithBucketUpperBounds:(NSArray<NSNumber *> *)bucketUpperBounds bucketCounts:(NSArray<NSNumber *> *)bucketCounts count:(NSUInteger)count sum:(NSTimeInterval)sum;
+
+@end
+
+@interface ARTClientMetrics ()
+
+@property (nonatomic, readwrite) NSUInteger framesReceived;
+@property (nonatomic, readwrite) NSUInteger framesSent;
+@property (nonatomic, readwrite) NSUInteger bytesReceived;
+@property (nonatomic, readwrite) NSUInteger bytesSent;
+@property (nonatomic, readwrite) NSUInteger httpRequests;
+@property (nonatomic, readwrite) NSUInteger fallbackHostRequests;
+@property (nonatomic, readwrite) NSUInteger reconnects;
+@property (nonatomic, readwrite) NSUInteger decodeCacheHits;
+@property (nonatomic, readwrite) NSUInteger decodeCacheMisses;
+@property (nonatomic, readwrite) NSUInteger queuedMessages;
+@property (nonatomic, readwrite) NSUInteger pendingMessages;
+@property (nonatomic, readwrite, strong) ARTLatencyHistogram *decodeTime;
+@property (nonatomic, readwrite, strong) ARTLatencyHistogram *ackLatency;
+
+- (instancetype)initWithTimestamp:(NSDate *)timestamp;
+
+@end
+
+NS_ASSUME_NONNULL_END
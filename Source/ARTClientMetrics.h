@@ -0,0 +1,124 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A latency distribution recorded into fixed buckets.
+ */
+@interface ARTLatencyHistogram : NSObject
+
+/**
+ * The inclusive upper bound of each bucket, in seconds, in ascending order.
+ */
+@property (nonatomic, readonly) NSArray<NSNumber *> *bucketUpperBounds;
+
+/**
+ * The number of samples in each bucket. It has one more element than `bucketUpperBounds`, counting the samples above the last bound.
+ */
+@property (nonatomic, readonly) NSArray<NSNumber *> *bucketCounts;
+
+/**
+ * The total number of samples.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * The sum of all samples, in seconds.
+ */
+@property (nonatomic, readonly) NSTimeInterval sum;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+/**
+ * Estimates a percentile of the recorded samples as the upper bound of the bucket it falls in.
+ *
+ * @param percentile A value between 0 and 100.
+ *
+ * @return The estimate in seconds, `0` if nothing was recorded, or `INFINITY` if it falls above the last bucket.
+ */
+- (NSTimeInterval)valueAtPercentile:(double)percentile;
+
+@end
+
+/**
+ * A point-in-time snapshot of a client's internal counters, retrieved with `-[ARTRest metrics]` or `-[ARTRealtime metrics]`, or delivered periodically to `ARTClientOptions.metricsHandler`. Counters are cumulative since the client was created.
+ */
+@interface ARTClientMetrics : NSObject
+
+/**
+ * The time at which the snapshot was taken.
+ */
+@property (nonatomic, readonly) NSDate *timestamp;
+
+/**
+ * The number of realtime transport frames received.
+ */
+@property (nonatomic, readonly) NSUInteger framesReceived;
+
+/**
+ * The number of realtime transport frames sent.
+ */
+@property (nonatomic, readonly) NSUInteger framesSent;
+
+/**
+ * The number of encoded bytes received in realtime frames and REST responses.
+ */
+@property (nonatomic, readonly) NSUInteger bytesReceived;
+
+/**
+ * The number of encoded bytes sent in realtime frames and REST request bodies.
+ */
+@property (nonatomic, readonly) NSUInteger bytesSent;
+
+/**
+ * The number of REST requests sent, including retries.
+ */
+@property (nonatomic, readonly) NSUInteger httpRequests;
+
+/**
+ * The number of REST requests and realtime connection attempts made against a fallback host.
+ */
+@property (nonatomic, readonly) NSUInteger fallbackHostRequests;
+
+/**
+ * The number of times the realtime connection started reconnecting after being disconnected or suspended.
+ */
+@property (nonatomic, readonly) NSUInteger reconnects;
+
+/**
+ * The number of message payloads whose decoded data was shared from the decode cache. Always 0 unless `ARTClientOptions.decodeCacheCapacity` is set.
+ */
+@property (nonatomic, readonly) NSUInteger decodeCacheHits;
+
+/**
+ * The number of message payloads looked up in the decode cache and decoded because they weren't in it.
+ */
+@property (nonatomic, readonly) NSUInteger decodeCacheMisses;
+
+/**
+ * The number of realtime messages waiting for the connection to be sent.
+ */
+@property (nonatomic, readonly) NSUInteger queuedMessages;
+
+/**
+ * The number of realtime messages sent and awaiting an acknowledgement.
+ */
+@property (nonatomic, readonly) NSUInteger pendingMessages;
+
+/**
+ * The time taken to decode each received realtime frame into a `ProtocolMessage`.
+ */
+@property (nonatomic, readonly) ARTLatencyHistogram *decodeTime;
+
+/**
+ * The time from sending a realtime `ProtocolMessage` that requires an acknowledgement to processing its `ACK` or `NACK`.
+ */
+@property (nonatomic, readonly) ARTLatencyHistogram *ackLatency;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,56 @@
+#import "ARTClientMetrics+Private.h"
+
+@implementation ARTLatencyHistogram
+
+- (instancetype)initWithBucketUpperBounds:(NSArray<NSNumber *> *)bucketUpperBounds bucketCounts:(NSArray<NSNumber *> *)bucketCounts count:(NSUInteger)count sum:(NSTimeInterval)sum {
+    if (self = [super init]) {
+        _bucketUpperBounds = bucketUpperBounds;
+        _bucketCounts = bucketCounts;
+        _count = count;
+        _sum = sum;
+    }
+    return self;
+}
+
+- (NSTimeInterval)valueAtPercentile:(double)percentile {
+    if (_count == 0) {
+        return 0;
+    }
+    double rank = MAX(1.0, ceil(MIN(MAX(percentile, 0.0), 100.0) / 100.0 * _count));
+    NSUInteger seen = 0;
+    for (NSUInteger i = 0; i < _bucketUpperBounds.count; i++) {
+        seen += _bucketCounts[i].unsignedIntegerValue;
+        if (seen >= rank) {
+            return _bucketUpperBounds[i].doubleValue;
+        }
+    }
+    return INFINITY;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p count: %lu, sum: %f, p50: %f, p99: %f>", self.class, self, (unsigned long)_count, _sum, [self valueAtPercentile:50], [self valueAtPercentile:99]];
+}
+
+@end
+
+@implementation ARTClientMetrics
+
+- (instancetype)initWithTimestamp:(NSDate *)timestamp {
+    if (self = [super init]) {
+        _timestamp = timestamp;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p frames in/out: %lu/%lu, bytes in/out: %lu/%lu, http requests: %lu, fallback requests: %lu, reconnects: %lu, decode cache hits/misses: %lu/%lu, queued: %lu, pending: %lu, decode time: %@, ack latency: %@>",
+            self.class, self,
+            (unsigned long)_framesReceived, (unsigned long)_framesSent,
+            (unsigned long)_bytesReceived, (unsigned long)_bytesSent,
+            (unsigned long)_httpRequests, (unsigned long)_fallbackHostRequests, (unsigned long)_reconnects,
+            (unsigned long)_decodeCacheHits, (unsigned long)_decodeCacheMisses,
+            (unsigned long)_queuedMessages, (unsigned long)_pendingMessages,
+            _decodeTime, _ackLatency];
+}
+
+@end
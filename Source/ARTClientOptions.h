@@ -4,6 +4,7 @@
 #import <Ably/ARTLog.h>
 
 @class ARTPlugin;
+@class ARTClientMetrics;
 @class ARTStringifiable;
 @protocol ARTPushRegistererDelegate;
 
@@ -132,6 +133,91 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (readwrite, assign, nonatomic) NSTimeInterval httpMaxRetryDuration;
 
+/**
+ * When greater than zero, enables hedged REST requests: if the primary host hasn't responded to an idempotent request (a `GET`, or a publish whose messages carry idempotent IDs) after the 95th percentile of recently observed response times, a duplicate request is sent to a fallback host. The first successful response is used and the outstanding request is cancelled. Until enough response times have been observed, this value is used as the delay. The default is 0, meaning hedging is disabled.
+ */
+@property (readwrite, assign, nonatomic) NSTimeInterval httpHedgingDelay;
+
+/**
+ * When greater than zero, REST request bodies of at least this many bytes are gzip-compressed before being sent, with a `Content-Encoding: gzip` header. Compression happens off the client's internal queue. Responses are always negotiated and decompressed by the system URL loading stack. The default is 0, meaning request bodies are sent uncompressed.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger httpRequestCompressionThreshold;
+
+/**
+ * When greater than zero, realtime `publish` calls return without waiting for the client's internal queue: messages are appended to a lock-free submission queue, which the internal queue drains in batches. If a channel already has this many submissions waiting, `publish` fails immediately with an `ARTStatePublishQueueFull` error instead of blocking. The default is 0, meaning `publish` hands messages to the internal queue synchronously.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger realtimePublishHighWaterMark;
+
+/**
+ * When greater than zero, messages published while connected are held for up to this many seconds so that publishes to the same channel can be sent as a single `ProtocolMessage`, even when publishes to other channels are interleaved with them, following the same bundling rules as messages queued while disconnected (RTL6d). Fewer frames are sent and fewer acknowledgements processed, at the cost of this added latency. The default is 0, meaning each publish is sent immediately.
+ */
+@property (readwrite, assign, nonatomic) NSTimeInterval realtimePublishCoalescingDelay;
+
+/**
+ * The maximum number of messages bundled into a single `ProtocolMessage` when `realtimePublishCoalescingDelay` is set; a bundle is sent as soon as it reaches this number. Bundles are also limited by `ARTConnectionDetails.maxMessageSize` (RTL6d1). The default is 100.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger realtimePublishCoalescingMaxMessages;
+
+/**
+ * The maximum size in bytes, as computed for `ARTConnectionDetails.maxMessageSize` (TO3l8), of the messages bundled into a single `ProtocolMessage` when `realtimePublishCoalescingDelay` is set; a bundle is sent as soon as it reaches this size, and a message that would take it over the size is bundled separately. The default is 0, meaning bundles are only limited by `realtimePublishCoalescingMaxMessages` and `ARTConnectionDetails.maxMessageSize`.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger realtimePublishCoalescingMaxBytes;
+
+/**
+ * When `true`, each realtime channel decodes the payloads of inbound messages and presence messages on its own serial queue, so that decoding for different channels runs in parallel instead of on the client's internal queue. Channel state, presence maps and event emission stay on the internal queue, and a channel's protocol messages are still applied in the order they were received; connection state changes that affect channels are applied on the internal queue as they happen, so they may take effect before messages still being decoded for a channel. Channels whose options request deltas still decode on the internal queue, since each payload is decoded against the one before it. The default is `false`, meaning all work is done on the internal queue in a single deterministic order.
+ */
+@property (readwrite, assign, nonatomic) BOOL decodeChannelMessagesConcurrently;
+
+/**
+ * When greater than zero and `metricsHandler` is set, the client calls `metricsHandler` with a snapshot of its metrics at this interval, in seconds. The default is 0, meaning no periodic snapshots are taken; metrics can still be retrieved with `-[ARTRest metrics]` or `-[ARTRealtime metrics]`.
+ */
+@property (readwrite, assign, nonatomic) NSTimeInterval metricsInterval;
+
+/**
+ * A callback that receives an `ARTClientMetrics` snapshot every `metricsInterval` seconds, on the `dispatchQueue`.
+ */
+@property (nullable, nonatomic, copy) void (^metricsHandler)(ARTClientMetrics *metrics);
+
+/**
+ * The fraction of realtime publishes, between 0 and 1, whose progress through the client is traced from `publish` to acknowledgement, for retrieval with `-[ARTRealtime publishTraceEvents]`. The default is 0, meaning no publishes are traced.
+ */
+@property (readwrite, assign, nonatomic) double publishTraceSampleRate;
+
+/**
+ * The number of trace points kept when `publishTraceSampleRate` is greater than zero; once reached, the oldest points are discarded. Each traced publish records up to seven points. The default is 4096.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger publishTraceCapacity;
+
+/**
+ * When greater than zero, at most this many realtime channels retain the payload of their last message as the base for decoding the next delta. Beyond that, the base of the least recently used channel is released; if a delta then arrives on that channel, it fails to decode and the channel recovers by reattaching (RTL18). The default is 0, meaning every channel retains its base.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger maxRetainedDeltaBases;
+
+/**
+ * When greater than zero, the estimated bytes of realtime messages queued while the connection is not yet connected are limited to this many; a publish or presence update that would exceed it fails immediately with an `ARTStatePublishQueueFull` error. See `ARTClientMemoryFootprint` for how bytes are estimated. The default is 0, meaning the queue is unbounded.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger maxQueuedMessagesBytes;
+
+/**
+ * When greater than zero, the client's `logHandler` keeps at most this many captured log lines, discarding the oldest. The default is 0, meaning captured lines are kept for the lifetime of the `logHandler`.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger maxCapturedLogLines;
+
+/**
+ * When `true`, realtime channels store the members of their presence set compactly: clientId and connectionId strings are shared between members and channels, and ids and timestamps are stored as integers. The `ARTPresenceMessage` objects of members are then only created when handed to the application, such as by `-[ARTRealtimePresenceProtocol get:]`. This lowers the memory held by large presence sets, at the cost of creating those objects on each such call. The default is `false`.
+ */
+@property (readwrite, assign, nonatomic) BOOL compactPresenceMembers;
+
+/**
+ * When greater than zero, the client keeps the decoded data of up to this many distinct message payloads, shared by all its channels, so that identical payloads received on several channels are decoded once and share the same immutable data objects. Only payloads whose encoding is made of `json`, `utf-8` and `base64` steps are cached; encrypted payloads and deltas are always decoded. Hits and misses are counted in the client's `ARTClientMetrics`. The default is 0, meaning payloads aren't cached.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger decodeCacheCapacity;
+
+/**
+ * When `true` and `useBinaryProtocol` is set, each inbound realtime frame is parsed in place into a buffer the connection reuses from frame to frame, and its protocol message and messages are read from it directly, without first creating the dictionaries, arrays, keys and numbers of the whole decoded frame. Frames the in-place parser doesn't support are decoded as usual. The default is `false`.
+ */
+@property (readwrite, assign, nonatomic) BOOL decodeFramesInPlace;
+
 /**
  * An array of fallback hosts to be used in the case of an error necessitating the use of an alternative host. If you have been provided a set of custom fallback hosts by Ably, please specify them here.
  */
@@ -173,6 +259,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (readwrite, assign, nonatomic) BOOL addRequestIds;
 
+/**
+ * When `true`, the most recently obtained Ably Token and the computed server time offset are persisted in secure storage (the Keychain) and, if still valid for the configured key and `clientId`, reused by the next client that is instantiated with equivalent options. This removes the token request (and any `/time` request when `queryTime` is set) from the critical path of the first REST request or connection attempt after an app launch. The cached token is read on the client's internal queue before its first request or connection attempt, so `ARTAuth.tokenDetails` is only set from then on. The default is `false`.
+ */
+@property (readwrite, assign, nonatomic) BOOL persistTokenDetails;
+
 /**
  * A set of key-value pairs that can be used to pass in arbitrary connection parameters, such as [`heartbeatInterval`](https://ably.com/docs/realtime/connection#heartbeats) or [`remainPresentFor`](https://ably.com/docs/realtime/presence#unstable-connections).
  */
@@ -9,13 +9,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface ARTConnectionInternal : NSObject<ARTConnectionProtocol>
 
-@property (nullable, readonly, strong, nonatomic) NSString *id;
+@property (nullable, readonly, strong) NSString *id;
 @property (nullable, readonly, strong, nonatomic) NSString *key;
 @property (nullable, readonly) NSString *recoveryKey;
-@property (readonly, assign, nonatomic) int64_t serial;
+@property (readonly, assign) int64_t serial;
 @property (readonly, assign, nonatomic) NSInteger maxMessageSize;
-@property (readonly, assign, nonatomic) ARTRealtimeConnectionState state;
-@property (nullable, readonly, strong, nonatomic) ARTErrorInfo *errorReason;
+@property (readonly, assign) ARTRealtimeConnectionState state;
+@property (nullable, readonly, strong) ARTErrorInfo *errorReason;
 
 - (instancetype)initWithRealtime:(ARTRealtimeInternal *)realtime;
 
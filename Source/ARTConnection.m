@@ -91,6 +91,17 @@
 
 @end
 
+// These are written on the internal queue at state transitions and read through their atomic accessors from
+// any thread, so that the public getters don't `dispatch_sync` behind whatever the queue is processing.
+@interface ARTConnectionInternal ()
+
+@property (nullable, readwrite, strong) NSString *id;
+@property (readwrite, assign) int64_t serial;
+@property (readwrite, assign) ARTRealtimeConnectionState state;
+@property (nullable, readwrite, strong) ARTErrorInfo *errorReason;
+
+@end
+
 @implementation ARTConnectionInternal {
     _Nonnull dispatch_queue_t _queue;
     NSString *_id;
@@ -123,14 +134,6 @@
     [_realtime ping:cb];
 }
 
-- (NSString *)id {
-    __block NSString *ret;   
-dispatch_sync(_queue, ^{
-    ret = [self id_nosync];
-});
-    return ret;
-} 
-
 - (NSString *)key {
     __block NSString *ret;   
 dispatch_sync(_queue, ^{
@@ -139,30 +142,6 @@ dispatch_sync(_queue, ^{
     return ret;
 } 
 
-- (int64_t)serial {
-    __block int64_t ret;   
-dispatch_sync(_queue, ^{
-    ret = [self serial_nosync];
-});
-    return ret;
-} 
-
-- (ARTRealtimeConnectionState)state {
-    __block ARTRealtimeConnectionState ret;   
-dispatch_sync(_queue, ^{
-    ret = [self state_nosync];
-});
-    return ret;
-}
-
-- (ARTErrorInfo *)errorReason {
-    __block ARTErrorInfo *ret;   
-dispatch_sync(_queue, ^{
-    ret = [self errorReason_nosync];
-});
-    return ret;
-}
-
 - (ARTErrorInfo *)error_nosync {
     if (self.errorReason_nosync) {
         return self.errorReason_nosync;
@@ -207,30 +186,14 @@ dispatch_sync(_queue, ^{
     return _errorReason;
 }
 
-- (void)setId:(NSString *)newId {
-    _id = newId;
-}
-
 - (void)setKey:(NSString *)key {
     _key = key;
 }
 
-- (void)setSerial:(int64_t)serial {
-    _serial = serial;
-}
-
 - (void)setMaxMessageSize:(NSInteger)maxMessageSize {
     _maxMessageSize = maxMessageSize;
 }
 
-- (void)setState:(ARTRealtimeConnectionState)state {
-    _state = state;
-}
-
-- (void)setErrorReason:(ARTErrorInfo *_Nullable)errorReason {
-    _errorReason = errorReason;
-}
-
 - (NSString *)recoveryKey {
     __block NSString *ret;
 dispatch_sync(_queue, ^{
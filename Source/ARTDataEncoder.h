@@ -5,6 +5,7 @@
 
 @class ARTCipherParams;
 @class ARTPlugin;
+@class ARTDecodeCache;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -23,10 +24,18 @@ NS_ASSUME_NONNULL_BEGIN
 @interface ARTDataEncoder : NSObject
 
 - (instancetype)initWithCipherParams:(ARTCipherParams *_Nullable)params error:(NSError *_Nullable*_Nullable)error;
+/// Shares the decoded data of payloads that `decodeCache` can cache with the other encoders using it.
+- (instancetype)initWithCipherParams:(ARTCipherParams *_Nullable)params decodeCache:(ARTDecodeCache *_Nullable)decodeCache error:(NSError *_Nullable*_Nullable)error;
 - (ARTDataEncoderOutput *)encode:(id _Nullable)data;
 - (ARTDataEncoderOutput *)decode:(id _Nullable)data encoding:(NSString *_Nullable)encoding;
 - (ARTDataEncoderOutput *)decode:(id _Nullable)data identifier:(NSString *)identifier encoding:(NSString *_Nullable)encoding;
 
+/// The size of the payload retained as the base for the next delta, or `0` if none is retained. Safe to read from any thread.
+@property (readonly, atomic) NSUInteger deltaBaseLength;
+
+/// Discards the retained delta base. The next delta then fails to decode with `ARTErrorUnableToDecodeMessage`, which channels recover from by reattaching (RTL18). Must be called on the queue that decodes with this encoder.
+- (void)releaseDeltaBase;
+
 @end
 
 /// :nodoc:
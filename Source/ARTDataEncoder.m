@@ -2,6 +2,7 @@
 #import "ARTLog.h"
 #import "ARTDataEncoder.h"
 #import "ARTDeltaCodec.h"
+#import "ARTDecodeCache.h"
 
 @implementation ARTDataEncoderOutput
 
@@ -17,15 +18,27 @@
 
 @end
 
+@interface ARTDataEncoder ()
+
+@property (readwrite, atomic) NSUInteger deltaBaseLength;
+
+@end
+
 @implementation ARTDataEncoder {
     id<ARTChannelCipher> _cipher;
     ARTDeltaCodec *_deltaCodec;
     NSString *_baseId;
+    ARTDecodeCache *_decodeCache;
 }
 
 - (instancetype)initWithCipherParams:(ARTCipherParams *)params error:(NSError **)error {
+    return [self initWithCipherParams:params decodeCache:nil error:error];
+}
+
+- (instancetype)initWithCipherParams:(ARTCipherParams *)params decodeCache:(ARTDecodeCache *)decodeCache error:(NSError **)error {
     self = [super init];
     if (self) {
+        _decodeCache = decodeCache;
         if (params) {
             _cipher = [ARTCrypto cipherWithParams:params];
             if (!_cipher) {
@@ -48,10 +61,21 @@
     _baseId = identifier;
     if ([data isKindOfClass:[NSData class]]) {
         [_deltaCodec setBase:data withId:identifier];
+        self.deltaBaseLength = [data length];
     }
     else if ([data isKindOfClass:[NSString class]]) {
-        [_deltaCodec setBase:[data dataUsingEncoding:NSUTF8StringEncoding] withId:identifier];
+        NSData *base = [data dataUsingEncoding:NSUTF8StringEncoding];
+        [_deltaCodec setBase:base withId:identifier];
+        self.deltaBaseLength = base.length;
+    }
+}
+
+- (void)releaseDeltaBase {
+    if (self.deltaBaseLength == 0) {
+        return;
     }
+    _deltaCodec = [[ARTDeltaCodec alloc] init];
+    self.deltaBaseLength = 0;
 }
 
 - (ARTDataEncoderOutput *)encode:(id)data {
@@ -135,7 +159,18 @@
         [self setDeltaCodecBase:data identifier:identifier];
         return [[ARTDataEncoderOutput alloc] initWithData:data encoding:encoding errorInfo:nil];
     }
-    
+
+    const BOOL cacheable = _decodeCache && [ARTDecodeCache canCachePayload:data encoding:encoding];
+    if (cacheable) {
+        ARTDecodeCacheEntry *entry = [_decodeCache entryForPayload:data encoding:encoding];
+        if (entry) {
+            [self setDeltaCodecBase:entry.deltaBase identifier:identifier];
+            return entry.output;
+        }
+    }
+    id payload = data;
+    id deltaBase = nil;
+
     ARTErrorInfo *errorInfo = nil;
     NSArray *encodings = [encoding componentsSeparatedByString:@"/"];
     NSString *outputEncoding = [NSString stringWithString:encoding];
@@ -198,6 +233,9 @@
         }
 
         [self setDeltaCodecBase:data identifier:identifier];
+        if ([data isKindOfClass:[NSData class]] || [data isKindOfClass:[NSString class]]) {
+            deltaBase = data;
+        }
 
         if (errorInfo == nil) {
             outputEncoding = [outputEncoding artRemoveLastEncoding];
@@ -206,9 +244,13 @@
         }
     }
     
-    return [[ARTDataEncoderOutput alloc] initWithData:data
-                                             encoding:outputEncoding
-                                            errorInfo:errorInfo];
+    ARTDataEncoderOutput *output = [[ARTDataEncoderOutput alloc] initWithData:data
+                                                                     encoding:outputEncoding
+                                                                    errorInfo:errorInfo];
+    if (cacheable && errorInfo == nil) {
+        [_decodeCache setEntry:[[ARTDecodeCacheEntry alloc] initWithOutput:output deltaBase:deltaBase] forPayload:payload encoding:encoding];
+    }
+    return output;
 }
 
 - (NSString *)cipherEncoding {
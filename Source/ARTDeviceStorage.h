@@ -11,6 +11,11 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)setObject:(nullable id)value forKey:(NSString *)key;
 - (nullable NSString *)secretForDevice:(ARTDeviceId *)deviceId;
 - (void)setSecret:(nullable NSString *)value forDevice:(ARTDeviceId *)deviceId;
+@optional
+// Entries of the token details cache (`ARTClientOptions.persistTokenDetails`), kept apart from device secrets.
+// Without these, tokens aren't persisted.
+- (nullable NSString *)cachedTokenDetailsForKey:(NSString *)key;
+- (void)setCachedTokenDetails:(nullable NSString *)value forKey:(NSString *)key;
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,32 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTDeviceStorage.h>
+
+@class ARTLog;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The default delay between a write to an `ARTDeviceStorageWriter` and the write to its storage.
+extern const NSTimeInterval ARTDeviceStorageWriterDefaultDelay;
+
+/// :nodoc:
+/// Writes to an `ARTDeviceStorage` behind its callers.
+///
+/// Written values are kept in memory as dirty, and written to `storage` together on a background queue after `delay`, so that repeated writes of a key are coalesced into one. Reads return values not yet written. Dirty values are also written when the writer is flushed and, on iOS, when the app enters the background, within a background task, or terminates. A writer is kept alive until its scheduled write has happened.
+@interface ARTDeviceStorageWriter : NSObject<ARTDeviceStorage>
+
+@property (nonatomic, readonly) id<ARTDeviceStorage> storage;
+@property (nonatomic, readonly) NSTimeInterval delay;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithStorage:(id<ARTDeviceStorage>)storage delay:(NSTimeInterval)delay logger:(nullable ARTLog *)logger NS_DESIGNATED_INITIALIZER;
+- (instancetype)initWithStorage:(id<ARTDeviceStorage>)storage logger:(nullable ARTLog *)logger;
+
+/// Whether there are values not yet written to `storage`.
+@property (nonatomic, readonly) BOOL isDirty;
+
+/// Writes all dirty values to `storage` before returning.
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
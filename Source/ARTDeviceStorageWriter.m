@@ -0,0 +1,214 @@
+#import "ARTDeviceStorageWriter.h"
+#import "ARTLog.h"
+
+#if TARGET_OS_IOS
+#import <UIKit/UIKit.h>
+#endif
+
+const NSTimeInterval ARTDeviceStorageWriterDefaultDelay = 0.1;
+
+@implementation ARTDeviceStorageWriter {
+    ARTLog *_logger;
+    // Guards the dirty and in-flight values.
+    dispatch_queue_t _stateQueue;
+    // Writes to `_storage` happen here, one batch at a time.
+    dispatch_queue_t _writeQueue;
+    // Values not yet taken by a write, with `NSNull` for removed values.
+    NSMutableDictionary<NSString *, id> *_dirtyObjects;
+    NSMutableDictionary<ARTDeviceId *, id> *_dirtySecrets;
+    NSMutableDictionary<NSString *, id> *_dirtyTokens;
+    // Values taken by the write in progress, so that reads still see them until it's done.
+    NSDictionary<NSString *, id> *_writingObjects;
+    NSDictionary<ARTDeviceId *, id> *_writingSecrets;
+    NSDictionary<NSString *, id> *_writingTokens;
+    BOOL _writeScheduled;
+    NSArray<id<NSObject>> *_observers;
+}
+
+- (instancetype)initWithStorage:(id<ARTDeviceStorage>)storage delay:(NSTimeInterval)delay logger:(ARTLog *)logger {
+    if (self = [super init]) {
+        _storage = storage;
+        _delay = delay;
+        _logger = logger;
+        _stateQueue = dispatch_queue_create("io.ably.deviceStorage.state", DISPATCH_QUEUE_SERIAL);
+        _writeQueue = dispatch_queue_create("io.ably.deviceStorage.write", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+        _dirtyObjects = [NSMutableDictionary dictionary];
+        _dirtySecrets = [NSMutableDictionary dictionary];
+        _dirtyTokens = [NSMutableDictionary dictionary];
+#if TARGET_OS_IOS
+        __weak ARTDeviceStorageWriter *weakSelf = self;
+        NSNotificationCenter *center = NSNotificationCenter.defaultCenter;
+        _observers = @[
+            [center addObserverForName:UIApplicationDidEnterBackgroundNotification object:nil queue:nil usingBlock:^(NSNotification *notification) {
+                [weakSelf flushInBackgroundTask];
+            }],
+            [center addObserverForName:UIApplicationWillTerminateNotification object:nil queue:nil usingBlock:^(NSNotification *notification) {
+                [weakSelf flush];
+            }],
+        ];
+#endif
+    }
+    return self;
+}
+
+- (instancetype)initWithStorage:(id<ARTDeviceStorage>)storage logger:(ARTLog *)logger {
+    return [self initWithStorage:storage delay:ARTDeviceStorageWriterDefaultDelay logger:logger];
+}
+
+- (void)dealloc {
+    for (id<NSObject> observer in _observers) {
+        [NSNotificationCenter.defaultCenter removeObserver:observer];
+    }
+}
+
+- (BOOL)isDirty {
+    __block BOOL dirty;
+    dispatch_sync(_stateQueue, ^{
+        dirty = self->_dirtyObjects.count > 0 || self->_dirtySecrets.count > 0 || self->_dirtyTokens.count > 0 ||
+            self->_writingObjects != nil || self->_writingSecrets != nil || self->_writingTokens != nil;
+    });
+    return dirty;
+}
+
+#pragma mark - ARTDeviceStorage
+
+- (id)objectForKey:(NSString *)key {
+    __block id value;
+    dispatch_sync(_stateQueue, ^{
+        value = self->_dirtyObjects[key] ?: self->_writingObjects[key];
+    });
+    if (value) {
+        return value == [NSNull null] ? nil : value;
+    }
+    return [_storage objectForKey:key];
+}
+
+- (void)setObject:(id)value forKey:(NSString *)key {
+    dispatch_sync(_stateQueue, ^{
+        self->_dirtyObjects[key] = value ?: [NSNull null];
+        [self scheduleWrite_onStateQueue];
+    });
+}
+
+- (NSString *)secretForDevice:(ARTDeviceId *)deviceId {
+    __block id value;
+    dispatch_sync(_stateQueue, ^{
+        value = self->_dirtySecrets[deviceId] ?: self->_writingSecrets[deviceId];
+    });
+    if (value) {
+        return value == [NSNull null] ? nil : value;
+    }
+    return [_storage secretForDevice:deviceId];
+}
+
+- (void)setSecret:(NSString *)value forDevice:(ARTDeviceId *)deviceId {
+    dispatch_sync(_stateQueue, ^{
+        self->_dirtySecrets[deviceId] = value ?: [NSNull null];
+        [self scheduleWrite_onStateQueue];
+    });
+}
+
+- (NSString *)cachedTokenDetailsForKey:(NSString *)key {
+    __block id value;
+    dispatch_sync(_stateQueue, ^{
+        value = self->_dirtyTokens[key] ?: self->_writingTokens[key];
+    });
+    if (value) {
+        return value == [NSNull null] ? nil : value;
+    }
+    if (![_storage respondsToSelector:@selector(cachedTokenDetailsForKey:)]) {
+        return nil;
+    }
+    return [_storage cachedTokenDetailsForKey:key];
+}
+
+- (void)setCachedTokenDetails:(NSString *)value forKey:(NSString *)key {
+    dispatch_sync(_stateQueue, ^{
+        self->_dirtyTokens[key] = value ?: [NSNull null];
+        [self scheduleWrite_onStateQueue];
+    });
+}
+
+#pragma mark - Writing
+
+- (void)scheduleWrite_onStateQueue {
+    if (_writeScheduled) {
+        return;
+    }
+    _writeScheduled = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_delay * NSEC_PER_SEC)), _writeQueue, ^{
+        [self write_onWriteQueue];
+    });
+}
+
+- (void)flush {
+    dispatch_sync(_writeQueue, ^{
+        [self write_onWriteQueue];
+    });
+}
+
+#if TARGET_OS_IOS
+// Writes the dirty values off the main thread, asking for time to finish them before the app is suspended.
+- (void)flushInBackgroundTask {
+    UIApplication *application = UIApplication.sharedApplication;
+    __block UIBackgroundTaskIdentifier task = [application beginBackgroundTaskWithName:@"io.ably.deviceStorage.flush" expirationHandler:^{
+        [application endBackgroundTask:task];
+        task = UIBackgroundTaskInvalid;
+    }];
+    dispatch_async(_writeQueue, ^{
+        [self write_onWriteQueue];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (task != UIBackgroundTaskInvalid) {
+                [application endBackgroundTask:task];
+                task = UIBackgroundTaskInvalid;
+            }
+        });
+    });
+}
+#endif
+
+- (void)write_onWriteQueue {
+    __block NSDictionary<NSString *, id> *objects;
+    __block NSDictionary<ARTDeviceId *, id> *secrets;
+    __block NSDictionary<NSString *, id> *tokens;
+    dispatch_sync(_stateQueue, ^{
+        self->_writeScheduled = NO;
+        if (self->_dirtyObjects.count > 0) {
+            objects = self->_writingObjects = [self->_dirtyObjects copy];
+            [self->_dirtyObjects removeAllObjects];
+        }
+        if (self->_dirtySecrets.count > 0) {
+            secrets = self->_writingSecrets = [self->_dirtySecrets copy];
+            [self->_dirtySecrets removeAllObjects];
+        }
+        if (self->_dirtyTokens.count > 0) {
+            tokens = self->_writingTokens = [self->_dirtyTokens copy];
+            [self->_dirtyTokens removeAllObjects];
+        }
+    });
+    if (!objects && !secrets && !tokens) {
+        return;
+    }
+
+    [_logger verbose:@"%@: writing %lu keys, %lu secrets and %lu cached tokens", NSStringFromClass(self.class), (unsigned long)objects.count, (unsigned long)secrets.count, (unsigned long)tokens.count];
+    // Secrets first, so that a stored device id always has its secret stored too.
+    [secrets enumerateKeysAndObjectsUsingBlock:^(ARTDeviceId *deviceId, id value, BOOL *stop) {
+        [self->_storage setSecret:(value == [NSNull null] ? nil : value) forDevice:deviceId];
+    }];
+    [objects enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+        [self->_storage setObject:(value == [NSNull null] ? nil : value) forKey:key];
+    }];
+    if ([_storage respondsToSelector:@selector(setCachedTokenDetails:forKey:)]) {
+        [tokens enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+            [self->_storage setCachedTokenDetails:(value == [NSNull null] ? nil : value) forKey:key];
+        }];
+    }
+
+    dispatch_sync(_stateQueue, ^{
+        self->_writingObjects = nil;
+        self->_writingSecrets = nil;
+        self->_writingTokens = nil;
+    });
+}
+
+@end
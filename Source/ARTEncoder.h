@@ -51,6 +51,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSData *)encodeMessages:(NSArray<ARTMessage *> *)messages error:(NSError *_Nullable *_Nullable)error;
 - (nullable NSArray<ARTMessage *> *)decodeMessages:(NSData *)data error:(NSError *_Nullable *_Nullable)error;
 
+// Batch publish: one BatchPublishSpec per list of messages, to the channel name at the same index
+- (nullable NSData *)encodeBatchMessages:(NSArray<NSArray<ARTMessage *> *> *)messages channels:(NSArray<NSString *> *)channelNames error:(NSError *_Nullable *_Nullable)error;
+
 // PresenceMessage
 - (nullable NSData *)encodePresenceMessage:(ARTPresenceMessage *)message error:(NSError *_Nullable *_Nullable)error;
 - (nullable ARTPresenceMessage *)decodePresenceMessage:(NSData *)data error:(NSError *_Nullable *_Nullable)error;
@@ -71,6 +74,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable ARTChannelDetails *)decodeChannelDetails:(NSData *)data error:(NSError *_Nullable *_Nullable)error;
 
 - (nullable NSArray<ARTDeviceDetails *> *)decodeDevicesDetails:(NSData *)data error:(NSError * __autoreleasing *)error;
+// Skips the items without a device id, counting them in `invalidCount`, and decodes only `fields` of the others (all fields when `nil`); `id` is always decoded.
+- (nullable NSArray<ARTDeviceDetails *> *)decodeDevicesDetails:(NSData *)data fields:(nullable NSSet<NSString *> *)fields invalidCount:(nullable NSUInteger *)invalidCount error:(NSError * __autoreleasing *)error;
 - (nullable ARTDeviceIdentityTokenDetails *)decodeDeviceIdentityTokenDetails:(NSData *)data error:(NSError * __autoreleasing *)error;
 
 // DevicePushDetails
@@ -81,6 +86,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSData *)encodePushChannelSubscription:(ARTPushChannelSubscription *)channelSubscription error:(NSError * __autoreleasing *)error;
 - (nullable ARTPushChannelSubscription *)decodePushChannelSubscription:(NSData *)data error:(NSError * __autoreleasing *)error;
 - (nullable NSArray<ARTPushChannelSubscription *> *)decodePushChannelSubscriptions:(NSData *)data error:(NSError * __autoreleasing *)error;
+// Skips the items that aren't valid subscriptions, counting them in `invalidCount`.
+- (nullable NSArray<ARTPushChannelSubscription *> *)decodePushChannelSubscriptions:(NSData *)data invalidCount:(nullable NSUInteger *)invalidCount error:(NSError * __autoreleasing *)error;
 
 // Others
 - (nullable NSDate *)decodeTime:(NSData *)data error:(NSError *_Nullable *_Nullable)error;
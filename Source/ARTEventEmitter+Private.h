@@ -39,6 +39,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, atomic) NSMutableDictionary<NSString *, NSMutableArray<ARTEventListener *> *> *listeners;
 @property (readonly, atomic) NSMutableArray<ARTEventListener *> *anyListeners;
 
+/// The number of listeners registered for specific events and for all events.
+@property (nonatomic, readonly) NSUInteger listenerCount;
+
 @end
 
 @interface ARTPublicEventEmitter<EventType:id<ARTEventIdentification>, ItemType> : ARTEventEmitter<EventType, ItemType>
@@ -257,6 +257,14 @@
     [self resetListeners];
 }
 
+- (NSUInteger)listenerCount {
+    NSUInteger count = _anyListeners.count;
+    for (NSArray<ARTEventListener *> *items in [_listeners allValues]) {
+        count += items.count;
+    }
+    return count;
+}
+
 - (void)resetListeners {
     for (NSArray<ARTEventListener *> *items in [_listeners allValues]) {
         for (ARTEventListener *item in items) {
@@ -70,6 +70,10 @@
         };
     }
 
+    [self next_nosync:callback];
+}
+
+- (void)next_nosync:(ARTHTTPPaginatedCallback)callback {
     if (!self.relNext) {
         // If there is no next page, we can't make a request, so we answer the callback
         // with a nil PaginatedResult. That's why the callback has the result as nullable
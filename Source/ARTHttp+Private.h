@@ -8,4 +8,29 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface ARTHttp ()
+
+/// Request bodies of at least this many bytes are gzip-compressed by `compressRequest:send:callback:`. 0 disables compression.
+@property (nonatomic) NSUInteger requestCompressionThreshold;
+
+/// Whether the body of `request` is over `requestCompressionThreshold` and hasn't been through `compressRequest:send:callback:` yet.
+- (BOOL)shouldCompressRequest:(NSURLRequest *)request;
+
+/**
+ Compresses the body of `request` on a utility queue, then calls `send` on the queue with a copy of the request that carries the compressed body and a `Content-Encoding` header, or the original body if gzip didn't make it smaller. The copy can be sent and resent, to fallback hosts for instance, without being compressed again.
+
+ The returned task stands in for the one `send` returns. If it is cancelled before then, `send` isn't called and `callback` gets a cancellation error.
+ */
+- (NSObject<ARTCancellable> *)compressRequest:(NSURLRequest *)request
+                                         send:(NSObject<ARTCancellable> *_Nullable (^)(NSMutableURLRequest *compressedRequest))send
+                                     callback:(ARTURLRequestCallback)callback;
+
+// Totals across all completed requests, as sent/received on the wire and before compression/after decompression.
+@property (readonly) unsigned long long requestWireBytes;
+@property (readonly) unsigned long long requestLogicalBytes;
+@property (readonly) unsigned long long responseWireBytes;
+@property (readonly) unsigned long long responseLogicalBytes;
+
+@end
+
 NS_ASSUME_NONNULL_END
@@ -1,6 +1,7 @@
 #import "ARTHttp+Private.h"
 #import "ARTURLSessionServerTrust.h"
 #import "ARTConstants.h"
+#import "ARTNSData+ARTCompression.h"
 
 @interface ARTHttp ()
 
@@ -10,6 +11,25 @@
 
 Class configuredUrlSessionClass = nil;
 
+static NSString *const ARTHttpUncompressedBodyLengthKey = @"ARTHttpUncompressedBodyLength";
+
+/// Stands in for the URL session task while the request body is being compressed.
+@interface ARTHttpCompressingTask : NSObject <ARTCancellable>
+
+@property (atomic) BOOL cancelled;
+@property (atomic, nullable) NSObject<ARTCancellable> *task;
+
+@end
+
+@implementation ARTHttpCompressingTask
+
+- (void)cancel {
+    self.cancelled = YES;
+    [self.task cancel];
+}
+
+@end
+
 #pragma mark - ARTHttp
 
 @implementation ARTHttp {
@@ -42,7 +62,44 @@ Class configuredUrlSessionClass = nil;
     [_urlSession finishTasksAndInvalidate];
 }
 
-- (NSObject<ARTCancellable> *)executeRequest:(NSMutableURLRequest *)request completion:(ARTURLRequestCallback)callback {
+- (BOOL)shouldCompressRequest:(NSURLRequest *)request {
+    return _requestCompressionThreshold > 0 &&
+        request.HTTPBody.length >= _requestCompressionThreshold &&
+        ![request valueForHTTPHeaderField:@"Content-Encoding"] &&
+        ![NSURLProtocol propertyForKey:ARTHttpUncompressedBodyLengthKey inRequest:request];
+}
+
+- (NSObject<ARTCancellable> *)compressRequest:(NSURLRequest *)request
+                                         send:(NSObject<ARTCancellable> *_Nullable (^)(NSMutableURLRequest *))send
+                                     callback:(ARTURLRequestCallback)callback {
+    NSData *body = request.HTTPBody;
+    ARTHttpCompressingTask *compressingTask = [[ARTHttpCompressingTask alloc] init];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSData *compressedBody = [body artGzipCompressed];
+        dispatch_async(self.queue, ^{
+            if (compressingTask.cancelled) {
+                if (callback) callback(nil, nil, [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]);
+                return;
+            }
+            NSMutableURLRequest *compressedRequest = [request mutableCopy];
+            if (compressedBody && compressedBody.length < body.length) {
+                compressedRequest.HTTPBody = compressedBody;
+                [compressedRequest setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+            }
+            // Also marks a body that gzip didn't shrink, so that it isn't compressed again when resent.
+            [NSURLProtocol setProperty:@(body.length) forKey:ARTHttpUncompressedBodyLengthKey inRequest:compressedRequest];
+            compressingTask.task = send(compressedRequest);
+        });
+    });
+    return compressingTask;
+}
+
+- (NSObject<ARTCancellable> *)executeRequest:(NSURLRequest *)request completion:(ARTURLRequestCallback)callback {
+    NSNumber *uncompressedBodyLength = [NSURLProtocol propertyForKey:ARTHttpUncompressedBodyLengthKey inRequest:request];
+    return [self sendRequest:request logicalBodyLength:uncompressedBodyLength ? uncompressedBodyLength.unsignedIntegerValue : request.HTTPBody.length completion:callback];
+}
+
+- (NSObject<ARTCancellable> *)sendRequest:(NSURLRequest *)request logicalBodyLength:(NSUInteger)logicalBodyLength completion:(ARTURLRequestCallback)callback {
     [self.logger debug:@"--> %@ %@\n  Body: %@\n  Headers: %@", request.HTTPMethod, request.URL.absoluteString, [self debugDescriptionOfBodyWithData:request.HTTPBody], request.allHTTPHeaderFields];
 
     return [_urlSession get:request completion:^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
@@ -50,7 +107,17 @@ Class configuredUrlSessionClass = nil;
         if (error) {
             [self.logger error:@"<-- %@ %@: error %@", request.HTTPMethod, request.URL.absoluteString, error];
         } else {
-            [self.logger debug:@"<-- %@ %@: statusCode %ld\n  Data: %@\n  Headers: %@\n", request.HTTPMethod, request.URL.absoluteString, (long)httpResponse.statusCode, [self debugDescriptionOfBodyWithData:data], httpResponse.allHeaderFields];
+            // The URL loading system decompresses response bodies transparently; Content-Length is still the size on the wire.
+            NSUInteger responseWireLength = data.length;
+            if (httpResponse.allHeaderFields[@"Content-Encoding"] && httpResponse.expectedContentLength >= 0) {
+                responseWireLength = (NSUInteger)httpResponse.expectedContentLength;
+            }
+            self->_requestWireBytes += request.HTTPBody.length;
+            self->_requestLogicalBytes += logicalBodyLength;
+            self->_responseWireBytes += responseWireLength;
+            self->_responseLogicalBytes += data.length;
+
+            [self.logger debug:@"<-- %@ %@: statusCode %ld\n  Data: %@\n  Headers: %@\n  Bytes: sent %lu (%lu uncompressed), received %lu (%lu decompressed)\n", request.HTTPMethod, request.URL.absoluteString, (long)httpResponse.statusCode, [self debugDescriptionOfBodyWithData:data], httpResponse.allHeaderFields, (unsigned long)request.HTTPBody.length, (unsigned long)logicalBodyLength, (unsigned long)responseWireLength, (unsigned long)data.length];
             NSString *headerErrorMessage = httpResponse.allHeaderFields[ARTHttpHeaderFieldErrorMessageKey];
             if (headerErrorMessage && ![headerErrorMessage isEqualToString:@""]) {
                 [self.logger warn:@"%@", headerErrorMessage];
@@ -8,6 +8,8 @@
 #import <Ably/ARTAuthDetails.h>
 #import <Ably/ARTStats.h>
 
+@class ARTMsgPackArena;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @protocol ARTJsonLikeEncoderDelegate <NSObject>
@@ -47,6 +49,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSDictionary *)protocolMessageToDictionary:(ARTProtocolMessage *)message;
 - (nullable ARTProtocolMessage *)protocolMessageFromDictionary:(NSDictionary *)input;
+/// The protocol message of the frame parsed by `arena`, read from its nodes without creating the dictionaries of the decoded frame.
+- (nullable ARTProtocolMessage *)protocolMessageFromArena:(ARTMsgPackArena *)arena;
 
 - (NSDictionary *)tokenRequestToDictionary:(ARTTokenRequest *)tokenRequest;
 
@@ -23,6 +23,7 @@
 #import "ARTRest+Private.h"
 #import "ARTJsonEncoder.h"
 #import "ARTPushChannelSubscription.h"
+#import "ARTMsgPackArena.h"
 
 @implementation ARTJsonLikeEncoder {
     __weak ARTRestInternal *_rest; // weak because rest owns self
@@ -88,6 +89,17 @@
     return [self encode:[self messagesToArray:messages] error:error];
 }
 
+- (NSData *)encodeBatchMessages:(NSArray<NSArray<ARTMessage *> *> *)messages channels:(NSArray<NSString *> *)channelNames error:(NSError **)error {
+    NSMutableArray *specs = [NSMutableArray arrayWithCapacity:messages.count];
+    [messages enumerateObjectsUsingBlock:^(NSArray<ARTMessage *> *specMessages, NSUInteger i, BOOL *stop) {
+        [specs addObject:@{
+            @"channels": @[channelNames[i]],
+            @"messages": [self messagesToArray:specMessages],
+        }];
+    }];
+    return [self encode:specs error:error];
+}
+
 - (ARTPresenceMessage *)decodePresenceMessage:(NSData *)data error:(NSError **)error {
     return [self presenceMessageFromDictionary:[self decodeDictionary:data error:error]];
 }
@@ -156,6 +168,28 @@
     return output;
 }
 
+- (NSArray<ARTDeviceDetails *> *)decodeDevicesDetails:(NSData *)data fields:(NSSet<NSString *> *)fields invalidCount:(NSUInteger *)invalidCount error:(NSError * __autoreleasing *)error {
+    NSArray *input = [self decodeListPage:data error:error];
+    if (!input) {
+        return nil;
+    }
+    NSMutableArray<ARTDeviceDetails *> *output = [NSMutableArray arrayWithCapacity:input.count];
+    NSUInteger invalid = 0;
+    for (NSDictionary *item in input) {
+        ARTDeviceDetails *deviceDetails = [self deviceDetailsFromDictionary:item fields:fields];
+        if (deviceDetails) {
+            [output addObject:deviceDetails];
+        }
+        else {
+            invalid++;
+        }
+    }
+    if (invalidCount) {
+        *invalidCount = invalid;
+    }
+    return output;
+}
+
 - (ARTDeviceIdentityTokenDetails *)decodeDeviceIdentityTokenDetails:(NSData *)data error:(NSError * __autoreleasing *)error {
     return [self deviceIdentityTokenDetailsFromDictionary:[self decodeDictionary:data error:nil] error:error];
 }
@@ -192,6 +226,28 @@
     return output;
 }
 
+- (NSArray<ARTPushChannelSubscription *> *)decodePushChannelSubscriptions:(NSData *)data invalidCount:(NSUInteger *)invalidCount error:(NSError * __autoreleasing *)error {
+    NSArray *input = [self decodeListPage:data error:error];
+    if (!input) {
+        return nil;
+    }
+    NSMutableArray<ARTPushChannelSubscription *> *output = [NSMutableArray arrayWithCapacity:input.count];
+    NSUInteger invalid = 0;
+    for (NSDictionary *item in input) {
+        ARTPushChannelSubscription *subscription = [self pushChannelSubscriptionFromDictionary:item error:nil];
+        if (subscription) {
+            [output addObject:subscription];
+        }
+        else {
+            invalid++;
+        }
+    }
+    if (invalidCount) {
+        *invalidCount = invalid;
+    }
+    return output;
+}
+
 - (NSDictionary *)pushChannelSubscriptionToDictionary:(ARTPushChannelSubscription *)channelSubscription {
     NSMutableDictionary *output = [NSMutableDictionary dictionary];
 
@@ -660,6 +716,40 @@
     return deviceDetails;
 }
 
+- (ARTDeviceDetails *)deviceDetailsFromDictionary:(NSDictionary *)input fields:(NSSet<NSString *> *)fields {
+    if (![input isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    NSString *deviceId = [input artString:@"id"];
+    if (!deviceId) {
+        return nil;
+    }
+
+    ARTDeviceDetails *deviceDetails = [[ARTDeviceDetails alloc] initWithId:deviceId];
+    if (!fields || [fields containsObject:@"clientId"]) {
+        deviceDetails.clientId = [input artString:@"clientId"];
+    }
+    if (!fields || [fields containsObject:@"platform"]) {
+        deviceDetails.platform = [input artString:@"platform"];
+    }
+    if (!fields || [fields containsObject:@"formFactor"]) {
+        deviceDetails.formFactor = [input artString:@"formFactor"];
+    }
+    if (!fields || [fields containsObject:@"metadata"]) {
+        NSDictionary *metadata = [input artDictionary:@"metadata"];
+        if (metadata) {
+            deviceDetails.metadata = metadata;
+        }
+    }
+    if (!fields || [fields containsObject:@"push"]) {
+        ARTDevicePushDetails *push = [self devicePushDetailsFromDictionary:input[@"push"] error:nil];
+        if (push) {
+            deviceDetails.push = push;
+        }
+    }
+    return deviceDetails;
+}
+
 - (ARTDeviceIdentityTokenDetails *)deviceIdentityTokenDetailsFromDictionary:(NSDictionary *)input error:(NSError * __autoreleasing *)error {
     [_logger verbose:@"RS:%p ARTJsonLikeEncoder<%@>: deviceIdentityTokenDetailsFromDictionary %@", _rest, [_delegate formatAsString], input];
 
@@ -742,6 +832,159 @@
     return message;
 }
 
+- (ARTProtocolMessage *)protocolMessageFromArena:(ARTMsgPackArena *)arena {
+    [_logger verbose:@"RS:%p ARTJsonLikeEncoder<%@>: protocolMessageFromArena with %lu nodes", _rest, [_delegate formatAsString], (unsigned long)arena.count];
+    if (arena.count == 0 || [arena nodeAtIndex:0]->type != ARTMsgPackTypeMap) {
+        return nil;
+    }
+
+    ARTProtocolMessage *message = [[ARTProtocolMessage alloc] init];
+    const NSUInteger end = [arena nodeAtIndex:0]->next;
+    for (NSUInteger key = 1; key < end; key = [arena nodeAtIndex:[arena nodeAtIndex:key]->next]->next) {
+        const NSUInteger value = [arena nodeAtIndex:key]->next;
+        const ARTMsgPackNode *node = [arena nodeAtIndex:value];
+        if ([arena isString:key equalTo:"action"]) {
+            message.action = (ARTProtocolMessageAction)ARTMsgPackNodeInt64Value(node);
+        } else if ([arena isString:key equalTo:"count"]) {
+            message.count = (int)ARTMsgPackNodeInt64Value(node);
+        } else if ([arena isString:key equalTo:"channel"]) {
+            message.channel = [arena stringAtIndex:value];
+        } else if ([arena isString:key equalTo:"channelSerial"]) {
+            message.channelSerial = [arena stringAtIndex:value];
+        } else if ([arena isString:key equalTo:"connectionId"]) {
+            message.connectionId = [arena stringAtIndex:value];
+        } else if ([arena isString:key equalTo:"connectionSerial"]) {
+            if (ARTMsgPackNodeIsNumber(node)) {
+                message.connectionSerial = ARTMsgPackNodeInt64Value(node);
+            }
+        } else if ([arena isString:key equalTo:"id"]) {
+            message.id = [arena stringAtIndex:value];
+        } else if ([arena isString:key equalTo:"msgSerial"]) {
+            message.msgSerial = [arena numberAtIndex:value];
+        } else if ([arena isString:key equalTo:"timestamp"]) {
+            message.timestamp = [self timestampFromArena:arena atIndex:value];
+        } else if ([arena isString:key equalTo:"messages"]) {
+            message.messages = [self messagesFromArena:arena atIndex:value];
+        } else if ([arena isString:key equalTo:"presence"]) {
+            message.presence = [self presenceMessagesFromArena:arena atIndex:value];
+        } else if ([arena isString:key equalTo:"connectionKey"]) {
+            message.connectionKey = [arena stringAtIndex:value];
+        } else if ([arena isString:key equalTo:"flags"]) {
+            message.flags = ARTMsgPackNodeInt64Value(node);
+        } else if ([arena isString:key equalTo:"connectionDetails"]) {
+            // This and the fields below are rare and small, so they go through the same code as decoded dictionaries.
+            message.connectionDetails = [self connectionDetailsFromDictionary:[self dictionaryFromArena:arena atIndex:value]];
+        } else if ([arena isString:key equalTo:"auth"]) {
+            message.auth = [self authDetailsFromDictionary:[self dictionaryFromArena:arena atIndex:value]];
+        } else if ([arena isString:key equalTo:"params"]) {
+            message.params = [self dictionaryFromArena:arena atIndex:value];
+        } else if ([arena isString:key equalTo:"error"]) {
+            NSDictionary *error = [self dictionaryFromArena:arena atIndex:value];
+            if (error) {
+                message.error = [ARTErrorInfo createWithCode:[[error artNumber:@"code"] intValue] status:[[error artNumber:@"statusCode"] intValue] message:[error artString:@"message"]];
+            }
+        }
+    }
+    return message;
+}
+
+- (NSArray *)messagesFromArena:(ARTMsgPackArena *)arena atIndex:(NSUInteger)index {
+    const ARTMsgPackNode *array = [arena nodeAtIndex:index];
+    if (array->type != ARTMsgPackTypeArray) {
+        return nil;
+    }
+
+    NSMutableArray *output = [NSMutableArray arrayWithCapacity:array->count];
+    for (NSUInteger item = index + 1; item < array->next; item = [arena nodeAtIndex:item]->next) {
+        const ARTMsgPackNode *map = [arena nodeAtIndex:item];
+        if (map->type != ARTMsgPackTypeMap) {
+            [_logger error:@"RS:%p ARTJsonLikeEncoder<%@>: skipping message that isn't a map: %@", _rest, [_delegate formatAsString], [arena objectAtIndex:item]];
+            continue;
+        }
+        ARTMessage *message = [[ARTMessage alloc] init];
+        for (NSUInteger key = item + 1; key < map->next; key = [arena nodeAtIndex:[arena nodeAtIndex:key]->next]->next) {
+            const NSUInteger value = [arena nodeAtIndex:key]->next;
+            if ([arena isString:key equalTo:"id"]) {
+                message.id = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"name"]) {
+                message.name = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"clientId"]) {
+                message.clientId = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"data"]) {
+                message.data = [arena objectAtIndex:value];
+            } else if ([arena isString:key equalTo:"encoding"]) {
+                message.encoding = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"timestamp"]) {
+                message.timestamp = [self timestampFromArena:arena atIndex:value];
+            } else if ([arena isString:key equalTo:"connectionId"]) {
+                message.connectionId = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"extras"]) {
+                message.extras = [arena objectAtIndex:value];
+            }
+        }
+        [output addObject:message];
+    }
+    return output;
+}
+
+- (NSArray *)presenceMessagesFromArena:(ARTMsgPackArena *)arena atIndex:(NSUInteger)index {
+    const ARTMsgPackNode *array = [arena nodeAtIndex:index];
+    if (array->type != ARTMsgPackTypeArray) {
+        return nil;
+    }
+
+    NSMutableArray *output = [NSMutableArray arrayWithCapacity:array->count];
+    for (NSUInteger item = index + 1; item < array->next; item = [arena nodeAtIndex:item]->next) {
+        const ARTMsgPackNode *map = [arena nodeAtIndex:item];
+        if (map->type != ARTMsgPackTypeMap) {
+            [_logger error:@"RS:%p ARTJsonLikeEncoder<%@>: skipping presence message that isn't a map: %@", _rest, [_delegate formatAsString], [arena objectAtIndex:item]];
+            continue;
+        }
+        ARTPresenceMessage *message = [[ARTPresenceMessage alloc] init];
+        message.action = ARTPresenceAbsent;
+        for (NSUInteger key = item + 1; key < map->next; key = [arena nodeAtIndex:[arena nodeAtIndex:key]->next]->next) {
+            const NSUInteger value = [arena nodeAtIndex:key]->next;
+            const ARTMsgPackNode *node = [arena nodeAtIndex:value];
+            if ([arena isString:key equalTo:"id"]) {
+                message.id = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"action"]) {
+                message.action = [self presenceActionFromInt:ARTMsgPackNodeIsNumber(node) ? (int)ARTMsgPackNodeInt64Value(node) : 0];
+            } else if ([arena isString:key equalTo:"clientId"]) {
+                message.clientId = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"data"]) {
+                message.data = [arena objectAtIndex:value];
+            } else if ([arena isString:key equalTo:"encoding"]) {
+                message.encoding = [arena stringAtIndex:value];
+            } else if ([arena isString:key equalTo:"timestamp"]) {
+                message.timestamp = [self timestampFromArena:arena atIndex:value];
+            } else if ([arena isString:key equalTo:"connectionId"]) {
+                message.connectionId = [arena stringAtIndex:value];
+            }
+        }
+        [output addObject:message];
+    }
+    return output;
+}
+
+- (NSDictionary *)dictionaryFromArena:(ARTMsgPackArena *)arena atIndex:(NSUInteger)index {
+    if ([arena nodeAtIndex:index]->type != ARTMsgPackTypeMap) {
+        return nil;
+    }
+    return [arena objectAtIndex:index];
+}
+
+- (NSDate *)timestampFromArena:(ARTMsgPackArena *)arena atIndex:(NSUInteger)index {
+    const ARTMsgPackNode *node = [arena nodeAtIndex:index];
+    if (ARTMsgPackNodeIsNumber(node)) {
+        return [NSDate artDateFromIntegerMs:ARTMsgPackNodeInt64Value(node)];
+    }
+    NSString *string = [arena stringAtIndex:index];
+    if (string) {
+        return [NSDate artDateFromIntegerMs:[string longLongValue]];
+    }
+    return nil;
+}
+
 - (ARTConnectionDetails *)connectionDetailsFromDictionary:(NSDictionary *)input {
     if (!input) {
         return nil;
@@ -850,6 +1093,9 @@
     
     NSNumber *count = [input artTyped:[NSNumber class] key:@"count"];
     NSNumber *data = [input artTyped:[NSNumber class] key:@"data"];
+    if (!count && !data) {
+        return [ARTStatsMessageCount empty];
+    }
     
     return [[ARTStatsMessageCount alloc] initWithCount:count.doubleValue data:data.doubleValue];
 }
@@ -900,6 +1146,9 @@
     NSNumber *mean = [input artTyped:[NSNumber class] key:@"mean"];
     NSNumber *min = [input artTyped:[NSNumber class] key:@"min"];
     NSNumber *refused = [input artTyped:[NSNumber class] key:@"refused"];
+    if (!opened && !peak && !mean && !min && !refused) {
+        return [ARTStatsResourceCount empty];
+    }
     
     return [[ARTStatsResourceCount alloc] initWithOpened:opened.doubleValue
                                                     peak:peak.doubleValue
@@ -925,6 +1174,9 @@
     NSNumber *succeeded = [input artTyped:[NSNumber class] key:@"succeeded"];
     NSNumber *failed = [input artTyped:[NSNumber class] key:@"failed"];
     NSNumber *refused = [input artTyped:[NSNumber class] key:@"refused"];
+    if (!succeeded && !failed && !refused) {
+        return [ARTStatsRequestCount empty];
+    }
     
     return [[ARTStatsRequestCount alloc] initWithSucceeded:succeeded.doubleValue
                                                     failed:failed.doubleValue
@@ -977,6 +1229,23 @@
     return obj;
 }
 
+// Like decodeArray:error:, but a page that isn't an array is an error rather than an empty result.
+- (NSArray *)decodeListPage:(NSData *)data error:(NSError **)error {
+    id obj = [self decode:data error:error];
+    if (!obj) {
+        return nil;
+    }
+    if (![obj isKindOfClass:[NSArray class]]) {
+        if (error) {
+            *error = [NSError errorWithDomain:ARTAblyErrorDomain
+                                         code:ARTErrorUnableToDecodeMessage
+                                     userInfo:@{NSLocalizedDescriptionKey: @"expected an array of items"}];
+        }
+        return nil;
+    }
+    return obj;
+}
+
 - (NSArray<NSDictionary *> *)decodeToArray:(NSData *)data error:(NSError **)error {
     id obj = [self decode:data error:error];
     if ([obj isKindOfClass:[NSDictionary class]]) {
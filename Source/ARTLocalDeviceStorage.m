@@ -2,6 +2,9 @@
 #import "ARTLog.h"
 #import "ARTLocalDevice+Private.h"
 
+// The Keychain service of token details cache entries, whose accounts are the entries' keys.
+static NSString *const ARTTokenDetailsCacheKeychainService = @"ARTTokenDetailsCache";
+
 @implementation ARTLocalDeviceStorage {
     ARTLog *_logger;
 }
@@ -60,6 +63,34 @@
     }
 }
 
+- (NSString *)cachedTokenDetailsForKey:(NSString *)key {
+    NSError *error = nil;
+    NSString *value = [self keychainGetPasswordForService:ARTTokenDetailsCacheKeychainService account:key error:&error];
+
+    if (error && [error code] != errSecItemNotFound) {
+        [_logger error:@"Cached token details couldn't be read (%@)", [error localizedDescription]];
+    }
+
+    return value;
+}
+
+- (void)setCachedTokenDetails:(NSString *)value forKey:(NSString *)key {
+    NSError *error = nil;
+    if (value == nil) {
+        [self keychainDeletePasswordForService:ARTTokenDetailsCacheKeychainService account:key error:&error];
+        if ([error code] == errSecItemNotFound) {
+            error = nil;
+        }
+    }
+    else {
+        [self keychainSetPassword:value forService:ARTTokenDetailsCacheKeychainService account:key error:&error];
+    }
+
+    if (error) {
+        [_logger error:@"Cached token details couldn't be updated (%@)", [error localizedDescription]];
+    }
+}
+
 #pragma mark - Keychain
 
 - (nonnull NSMutableDictionary *)newKeychainQueryForService:(nonnull NSString *)serviceName account:(nonnull NSString *)account {
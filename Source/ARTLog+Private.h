@@ -1,5 +1,7 @@
 #import <Ably/ARTLog.h>
 
+@class ARTClientMemoryFootprint;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface ARTLogLine : NSObject
@@ -19,9 +21,15 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly) NSArray<ARTLogLine *> *captured;
 @property (readonly) NSArray<ARTLogLine *> *history;
 
+/// When greater than zero, the oldest captured lines are discarded once this many are held. The default is 0, meaning captured lines are kept for the lifetime of the log.
+@property (atomic) NSUInteger capturedLinesLimit;
+
 - (instancetype)initCapturingOutput:(BOOL)capturing;
 - (instancetype)initCapturingOutput:(BOOL)capturing historyLines:(NSUInteger)historyLines;
 
+/// Fills in the log lines and bytes of `footprint`.
+- (void)fillMemoryFootprint:(ARTClientMemoryFootprint *)footprint;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -1,5 +1,6 @@
 #import "ARTLog+Private.h"
 #import "ARTNSDate+ARTUtil.h"
+#import "ARTMemoryFootprint+Private.h"
 
 static const char *logLevelName(ARTLogLevel level) {
     switch(level) {
@@ -97,6 +98,10 @@ static const char *logLevelName(ARTLogLevel level) {
             NSLog(@"%@", [logLine toString]);
             if (self->_captured) {
                 [self->_captured addObject:logLine];
+                NSUInteger limit = self.capturedLinesLimit;
+                if (limit > 0 && self->_captured.count > limit) {
+                    [self->_captured removeObjectsInRange:NSMakeRange(0, self->_captured.count - limit)];
+                }
             }
         }
         if (self->_historyLines > 0) {
@@ -116,6 +121,23 @@ static const char *logLevelName(ARTLogLevel level) {
     return _history;
 }
 
+static NSUInteger logLinesBytes(NSArray<ARTLogLine *> *lines) {
+    NSUInteger bytes = 0;
+    for (ARTLogLine *line in lines) {
+        bytes += ARTMemoryFootprintObjectOverhead + [line.message lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    }
+    return bytes;
+}
+
+- (void)fillMemoryFootprint:(ARTClientMemoryFootprint *)footprint {
+    dispatch_sync(_queue, ^{
+        footprint.logHistoryLines = self->_history.count;
+        footprint.logHistoryBytes = logLinesBytes(self->_history);
+        footprint.logCapturedLines = self->_captured.count;
+        footprint.logCapturedBytes = logLinesBytes(self->_captured);
+    });
+}
+
 - (NSArray *)captured {
     if (!_captured) {
         [ARTException raise:NSInternalInconsistencyException format:@"tried to get captured output in non-capturing instance; use initCapturingOutput:true if you want captured output."];
@@ -0,0 +1,47 @@
+#import <Ably/ARTMemoryFootprint.h>
+
+@class ARTProtocolMessage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The allowance added for each object held, beyond the bytes of its payload, for its object header, ivars and short strings such as ids.
+extern const NSUInteger ARTMemoryFootprintObjectOverhead;
+
+/// The estimated bytes held by `messages`, a collection of `ARTBaseMessage` objects.
+NSUInteger ARTMemoryFootprintOfMessages(id<NSFastEnumeration> _Nullable messages);
+
+/// The estimated bytes held by the messages and presence messages of `protocolMessage`.
+NSUInteger ARTMemoryFootprintOfProtocolMessage(ARTProtocolMessage *protocolMessage);
+
+@interface ARTChannelMemoryFootprint ()
+
+@property (nonatomic, readwrite) NSUInteger presenceMembers;
+@property (nonatomic, readwrite) NSUInteger presenceMembersBytes;
+@property (nonatomic, readwrite) NSUInteger localPresenceMembers;
+@property (nonatomic, readwrite) NSUInteger localPresenceMembersBytes;
+@property (nonatomic, readwrite) NSUInteger deltaBaseBytes;
+@property (nonatomic, readwrite) NSUInteger listeners;
+
+- (instancetype)initWithName:(NSString *)name;
+
+@end
+
+@interface ARTClientMemoryFootprint ()
+
+@property (nonatomic, readwrite) NSUInteger queuedMessages;
+@property (nonatomic, readwrite) NSUInteger queuedMessagesBytes;
+@property (nonatomic, readwrite) NSUInteger pendingMessages;
+@property (nonatomic, readwrite) NSUInteger pendingMessagesBytes;
+@property (nonatomic, readwrite) NSUInteger logHistoryLines;
+@property (nonatomic, readwrite) NSUInteger logHistoryBytes;
+@property (nonatomic, readwrite) NSUInteger logCapturedLines;
+@property (nonatomic, readwrite) NSUInteger logCapturedBytes;
+@property (nonatomic, readwrite) NSUInteger connectionListeners;
+@property (nonatomic, readwrite) NSUInteger retainedDeltaBases;
+@property (nonatomic, readwrite, strong) NSArray<ARTChannelMemoryFootprint *> *channels;
+
+- (instancetype)initWithTimestamp:(NSDate *)timestamp;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,137 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * An estimate of the memory held by a realtime channel, retrieved with `-[ARTRealtimeChannel memoryFootprint]` or as part of `-[ARTRealtime memoryFootprint]`.
+ *
+ * Byte counts are estimates: they add up the payload, client ID and extras of each message, as counted towards the maximum message size (TO3l8), plus a fixed allowance for each object held. They are meant for spotting growth, not for exact accounting.
+ */
+@interface ARTChannelMemoryFootprint : NSObject
+
+/**
+ * The name of the channel.
+ */
+@property (nonatomic, readonly) NSString *name;
+
+/**
+ * The number of members in the channel's presence set.
+ */
+@property (nonatomic, readonly) NSUInteger presenceMembers;
+
+/**
+ * The estimated bytes held by the channel's presence set.
+ */
+@property (nonatomic, readonly) NSUInteger presenceMembersBytes;
+
+/**
+ * The number of members entered by this client, kept so that they can be re-entered after a loss of continuity (RTP17).
+ */
+@property (nonatomic, readonly) NSUInteger localPresenceMembers;
+
+/**
+ * The estimated bytes held by the members entered by this client.
+ */
+@property (nonatomic, readonly) NSUInteger localPresenceMembersBytes;
+
+/**
+ * The size of the last message payload, retained as the base for decoding the next delta-encoded message. `0` if none is retained.
+ */
+@property (nonatomic, readonly) NSUInteger deltaBaseBytes;
+
+/**
+ * The number of listeners registered with the channel and its presence, including the client's own.
+ */
+@property (nonatomic, readonly) NSUInteger listeners;
+
+/**
+ * The estimated bytes held by the channel's listeners.
+ */
+@property (nonatomic, readonly) NSUInteger listenersBytes;
+
+/**
+ * The sum of all the byte estimates of the channel.
+ */
+@property (nonatomic, readonly) NSUInteger totalBytes;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+@end
+
+/**
+ * An estimate of the memory held by a realtime client, retrieved with `-[ARTRealtime memoryFootprint]`. See `ARTChannelMemoryFootprint` for how bytes are estimated.
+ */
+@interface ARTClientMemoryFootprint : NSObject
+
+/**
+ * The time at which the estimate was taken.
+ */
+@property (nonatomic, readonly) NSDate *timestamp;
+
+/**
+ * The number of realtime messages waiting for the connection to be sent.
+ */
+@property (nonatomic, readonly) NSUInteger queuedMessages;
+
+/**
+ * The estimated bytes held by queued messages. Bounded by `ARTClientOptions.maxQueuedMessagesBytes` when set.
+ */
+@property (nonatomic, readonly) NSUInteger queuedMessagesBytes;
+
+/**
+ * The number of realtime messages sent and awaiting an acknowledgement.
+ */
+@property (nonatomic, readonly) NSUInteger pendingMessages;
+
+/**
+ * The estimated bytes held by messages awaiting an acknowledgement.
+ */
+@property (nonatomic, readonly) NSUInteger pendingMessagesBytes;
+
+/**
+ * The number of recent log lines kept by the client's `ARTLog` regardless of the log level.
+ */
+@property (nonatomic, readonly) NSUInteger logHistoryLines;
+
+/**
+ * The estimated bytes held by the recent log lines.
+ */
+@property (nonatomic, readonly) NSUInteger logHistoryBytes;
+
+/**
+ * The number of log lines captured by the client's `ARTLog`. Bounded by `ARTClientOptions.maxCapturedLogLines` when set.
+ */
+@property (nonatomic, readonly) NSUInteger logCapturedLines;
+
+/**
+ * The estimated bytes held by the captured log lines.
+ */
+@property (nonatomic, readonly) NSUInteger logCapturedBytes;
+
+/**
+ * The number of listeners registered with the connection, including the client's own.
+ */
+@property (nonatomic, readonly) NSUInteger connectionListeners;
+
+/**
+ * The number of channels that retain a delta base. Bounded by `ARTClientOptions.maxRetainedDeltaBases` when set.
+ */
+@property (nonatomic, readonly) NSUInteger retainedDeltaBases;
+
+/**
+ * An estimate for each channel of the client.
+ */
+@property (nonatomic, readonly) NSArray<ARTChannelMemoryFootprint *> *channels;
+
+/**
+ * The sum of all the byte estimates of the client and its channels.
+ */
+@property (nonatomic, readonly) NSUInteger totalBytes;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+@end
+
+NS_ASSUME_NONNULL_END
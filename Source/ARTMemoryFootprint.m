@@ -0,0 +1,79 @@
+#import "ARTMemoryFootprint+Private.h"
+#import "ARTBaseMessage.h"
+#import "ARTProtocolMessage.h"
+
+const NSUInteger ARTMemoryFootprintObjectOverhead = 64;
+
+// An event listener holds itself, its notification center observer and the callback block.
+static const NSUInteger ARTMemoryFootprintListenerObjects = 3;
+
+NSUInteger ARTMemoryFootprintOfMessages(id<NSFastEnumeration> messages) {
+    NSUInteger bytes = 0;
+    for (ARTBaseMessage *message in messages) {
+        bytes += ARTMemoryFootprintObjectOverhead + MAX([message messageSize], 0);
+    }
+    return bytes;
+}
+
+NSUInteger ARTMemoryFootprintOfProtocolMessage(ARTProtocolMessage *protocolMessage) {
+    return ARTMemoryFootprintObjectOverhead + ARTMemoryFootprintOfMessages(protocolMessage.messages) + ARTMemoryFootprintOfMessages(protocolMessage.presence);
+}
+
+@implementation ARTChannelMemoryFootprint
+
+- (instancetype)initWithName:(NSString *)name {
+    if (self = [super init]) {
+        _name = name;
+    }
+    return self;
+}
+
+- (NSUInteger)listenersBytes {
+    return _listeners * ARTMemoryFootprintListenerObjects * ARTMemoryFootprintObjectOverhead;
+}
+
+- (NSUInteger)totalBytes {
+    return _presenceMembersBytes + _localPresenceMembersBytes + _deltaBaseBytes + self.listenersBytes;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p name: %@, presence members: %lu (%lu bytes), local members: %lu (%lu bytes), delta base: %lu bytes, listeners: %lu, total: %lu bytes>",
+            self.class, self, _name,
+            (unsigned long)_presenceMembers, (unsigned long)_presenceMembersBytes,
+            (unsigned long)_localPresenceMembers, (unsigned long)_localPresenceMembersBytes,
+            (unsigned long)_deltaBaseBytes, (unsigned long)_listeners, (unsigned long)self.totalBytes];
+}
+
+@end
+
+@implementation ARTClientMemoryFootprint
+
+- (instancetype)initWithTimestamp:(NSDate *)timestamp {
+    if (self = [super init]) {
+        _timestamp = timestamp;
+        _channels = @[];
+    }
+    return self;
+}
+
+- (NSUInteger)totalBytes {
+    NSUInteger bytes = _queuedMessagesBytes + _pendingMessagesBytes + _logHistoryBytes + _logCapturedBytes;
+    bytes += _connectionListeners * ARTMemoryFootprintListenerObjects * ARTMemoryFootprintObjectOverhead;
+    for (ARTChannelMemoryFootprint *channel in _channels) {
+        bytes += channel.totalBytes;
+    }
+    return bytes;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p queued: %lu (%lu bytes), pending: %lu (%lu bytes), log history: %lu (%lu bytes), log captured: %lu (%lu bytes), connection listeners: %lu, delta bases: %lu, channels: %lu, total: %lu bytes>",
+            self.class, self,
+            (unsigned long)_queuedMessages, (unsigned long)_queuedMessagesBytes,
+            (unsigned long)_pendingMessages, (unsigned long)_pendingMessagesBytes,
+            (unsigned long)_logHistoryLines, (unsigned long)_logHistoryBytes,
+            (unsigned long)_logCapturedLines, (unsigned long)_logCapturedBytes,
+            (unsigned long)_connectionListeners, (unsigned long)_retainedDeltaBases,
+            (unsigned long)_channels.count, (unsigned long)self.totalBytes];
+}
+
+@end
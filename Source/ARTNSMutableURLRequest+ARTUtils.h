@@ -11,6 +11,20 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)replaceHostWith:(NSString *)host;
 - (void)appendQueryItem:(NSURLQueryItem *)item;
 
+/**
+ Flags the request as safe to send more than once (e.g. a publish whose messages carry idempotent IDs).
+ */
+- (void)markAsIdempotent;
+
+@end
+
+@interface NSURLRequest (ARTUtils)
+
+/**
+ `YES` for `GET`/`HEAD` requests and requests flagged with `-[NSMutableURLRequest markAsIdempotent]`.
+ */
+@property (nonatomic, readonly) BOOL isIdempotent;
+
 @end
 
 NS_ASSUME_NONNULL_END
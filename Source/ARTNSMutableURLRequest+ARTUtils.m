@@ -1,5 +1,7 @@
 #import "ARTNSMutableURLRequest+ARTUtils.h"
 
+static NSString *const ARTURLRequestIdempotentKey = @"io.ably.idempotent";
+
 @implementation NSMutableURLRequest (ARTUtils)
 
 - (void)appendQueryItem:(NSURLQueryItem *)item {
@@ -27,4 +29,19 @@
     }
 }
 
+- (void)markAsIdempotent {
+    [NSURLProtocol setProperty:@YES forKey:ARTURLRequestIdempotentKey inRequest:self];
+}
+
+@end
+
+@implementation NSURLRequest (ARTUtils)
+
+- (BOOL)isIdempotent {
+    if ([self.HTTPMethod isEqualToString:@"GET"] || [self.HTTPMethod isEqualToString:@"HEAD"]) {
+        return YES;
+    }
+    return [[NSURLProtocol propertyForKey:ARTURLRequestIdempotentKey inRequest:self] boolValue];
+}
+
 @end
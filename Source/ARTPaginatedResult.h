@@ -2,6 +2,7 @@
 
 #import <Ably/ARTTypes.h>
 #import <Ably/ARTStatus.h>
+#import <Ably/ARTPaginatedResultIterator.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -42,6 +43,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)next:(void (^)(ARTPaginatedResult<ItemType> *_Nullable result, ARTErrorInfo *_Nullable error))callback;
 
+/**
+ * Returns an `ARTPaginatedResultIterator` which yields the items of this page followed by those of each subsequent page, fetching up to `prefetchLimit` pages ahead of the caller.
+ *
+ * @param prefetchLimit The maximum number of pages fetched ahead of the caller. Pass `0` to only fetch a page when it is requested.
+ */
+- (ARTPaginatedResultIterator<ItemType> *)iteratorWithPrefetchLimit:(NSUInteger)prefetchLimit;
+
 @end
 
 NS_ASSUME_NONNULL_END
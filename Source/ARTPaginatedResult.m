@@ -1,4 +1,5 @@
 #import "ARTPaginatedResult+Private.h"
+#import "ARTPaginatedResultIterator+Private.h"
 
 #import "ARTHttp.h"
 #import "ARTAuth.h"
@@ -86,6 +87,10 @@
         };
     }
 
+    [self next_nosync:callback];
+}
+
+- (void)next_nosync:(void (^)(ARTPaginatedResult<id> *_Nullable result, ARTErrorInfo *_Nullable error))callback {
     if (!_relNext) {
         // If there is no next page, we can't make a request, so we answer the callback
         // with a nil PaginatedResult. That's why the callback has the result as nullable
@@ -96,6 +101,10 @@
     [self.class executePaginated:_rest withRequest:_relNext andResponseProcessor:_responseProcessor callback:callback];
 }
 
+- (ARTPaginatedResultIterator<id> *)iteratorWithPrefetchLimit:(NSUInteger)prefetchLimit {
+    return [[ARTPaginatedResultIterator alloc] initWithPage:self prefetchLimit:prefetchLimit];
+}
+
 + (void)executePaginated:(ARTRestInternal *)rest withRequest:(NSMutableURLRequest *)request andResponseProcessor:(ARTPaginatedResultResponseProcessor)responseProcessor callback:(void (^)(ARTPaginatedResult<id> *_Nullable result, ARTErrorInfo *_Nullable error))callback {
     [rest.logger debug:__FILE__ line:__LINE__ message:@"Paginated request: %@", request];
 
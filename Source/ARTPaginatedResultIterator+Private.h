@@ -0,0 +1,13 @@
+#import <Ably/ARTPaginatedResultIterator.h>
+
+@class ARTPaginatedResult;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ARTPaginatedResultIterator<ItemType> ()
+
+- (instancetype)initWithPage:(ARTPaginatedResult<ItemType> *)page prefetchLimit:(NSUInteger)prefetchLimit;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,37 @@
+#import <Foundation/Foundation.h>
+
+#import <Ably/ARTTypes.h>
+#import <Ably/ARTStatus.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Iterates over the pages of a paginated query, such as channel history or stats, starting from an `ARTPaginatedResult`.
+ *
+ * While the caller consumes a page, the iterator fetches and decodes up to `prefetchLimit` following pages in the background, so that long backfills are not bound by a request round trip per page.
+ */
+@interface ARTPaginatedResultIterator<ItemType> : NSObject
+
+/**
+ * The maximum number of pages fetched ahead of the caller.
+ */
+@property (nonatomic, readonly) NSUInteger prefetchLimit;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+/**
+ * Retrieves the items of the next page. When all pages have been consumed, the callback is invoked with `nil` items and a `nil` error.
+ *
+ * @param callback A callback for retrieving an array of `ItemType` objects.
+ */
+- (void)next:(void (^)(NSArray<ItemType> *_Nullable items, ARTErrorInfo *_Nullable error))callback;
+
+/**
+ * Stops fetching further pages. Pages already fetched are still returned by `next:`.
+ */
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,105 @@
+#import "ARTPaginatedResultIterator+Private.h"
+#import "ARTPaginatedResult+Private.h"
+
+typedef void (^ARTPaginatedResultIteratorCallback)(NSArray *_Nullable items, ARTErrorInfo *_Nullable error);
+
+@implementation ARTPaginatedResultIterator {
+    dispatch_queue_t _queue;
+    dispatch_queue_t _userQueue;
+    // The last page fetched; its `relNext` is the next request to make.
+    ARTPaginatedResult *_lastPage;
+    NSMutableArray<NSArray *> *_pages;
+    NSMutableArray<ARTPaginatedResultIteratorCallback> *_waiting;
+    ARTErrorInfo *_error;
+    BOOL _fetching;
+    BOOL _cancelled;
+}
+
+- (instancetype)initWithPage:(ARTPaginatedResult *)page prefetchLimit:(NSUInteger)prefetchLimit {
+    if (self = [super init]) {
+        _queue = page.queue;
+        _userQueue = page.userQueue;
+        _prefetchLimit = prefetchLimit;
+        _lastPage = page;
+        _pages = [NSMutableArray arrayWithObject:page.items];
+        _waiting = [NSMutableArray array];
+        dispatch_async(_queue, ^{
+            [self fill_nosync];
+        });
+    }
+    return self;
+}
+
+- (void)next:(ARTPaginatedResultIteratorCallback)callback {
+    ARTPaginatedResultIteratorCallback userCallback = callback;
+    callback = ^(NSArray *_Nullable items, ARTErrorInfo *_Nullable error) {
+        dispatch_async(self->_userQueue, ^{
+            userCallback(items, error);
+        });
+    };
+
+dispatch_async(_queue, ^{
+    [self->_waiting addObject:callback];
+    [self drain_nosync];
+    [self fill_nosync];
+});
+}
+
+- (void)cancel {
+dispatch_async(_queue, ^{
+    self->_cancelled = YES;
+    [self drain_nosync];
+});
+}
+
+- (BOOL)isExhausted_nosync {
+    return _cancelled || _error || (!_fetching && !_lastPage.hasNext);
+}
+
+- (void)drain_nosync {
+    while (_waiting.count > 0) {
+        if (_pages.count > 0) {
+            ARTPaginatedResultIteratorCallback callback = _waiting.firstObject;
+            NSArray *items = _pages.firstObject;
+            [_waiting removeObjectAtIndex:0];
+            [_pages removeObjectAtIndex:0];
+            callback(items, nil);
+        }
+        else if ([self isExhausted_nosync]) {
+            ARTPaginatedResultIteratorCallback callback = _waiting.firstObject;
+            [_waiting removeObjectAtIndex:0];
+            callback(nil, _cancelled ? nil : _error);
+        }
+        else {
+            break;
+        }
+    }
+}
+
+- (void)fill_nosync {
+    if (_fetching || [self isExhausted_nosync]) {
+        return;
+    }
+    // Pages beyond the window are only fetched on demand.
+    if (_pages.count >= _prefetchLimit && _waiting.count <= _pages.count) {
+        return;
+    }
+
+    _fetching = YES;
+    [_lastPage next_nosync:^(ARTPaginatedResult *result, ARTErrorInfo *error) {
+        self->_fetching = NO;
+        if (error) {
+            self->_error = error;
+        }
+        else if (result) {
+            self->_lastPage = result;
+            if (!self->_cancelled) {
+                [self->_pages addObject:result.items];
+            }
+        }
+        [self drain_nosync];
+        [self fill_nosync];
+    }];
+}
+
+@end
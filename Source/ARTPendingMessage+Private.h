@@ -0,0 +1,12 @@
+#import <Ably/ARTPendingMessage.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ARTPendingMessage ()
+
+/// The `ARTMetricsNow()` time at which the message was written to the transport, 0 until then.
+@property (nonatomic) uint64_t sentAt;
+
+@end
+
+NS_ASSUME_NONNULL_END
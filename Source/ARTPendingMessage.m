@@ -1,4 +1,4 @@
-#import "ARTPendingMessage.h"
+#import "ARTPendingMessage+Private.h"
 
 @implementation ARTPendingMessage
 
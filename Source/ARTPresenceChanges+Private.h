@@ -0,0 +1,11 @@
+#import <Ably/ARTPresenceChanges.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ARTPresenceChanges ()
+
+- (instancetype)initWithVersion:(NSUInteger)version isSnapshot:(BOOL)isSnapshot updated:(NSArray<ARTPresenceMessage *> *)updated removed:(NSArray<ARTPresenceMessage *> *)removed;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,41 @@
+#import <Foundation/Foundation.h>
+
+@class ARTPresenceMessage;
+@class ARTErrorInfo;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The changes to the members present on a channel since a version of the presence set, as returned by `-[ARTRealtimePresenceProtocol changesSinceVersion:callback:]`.
+ */
+@interface ARTPresenceChanges : NSObject
+
+/**
+ * The version of the presence set these changes bring a copy up to. Pass it to the next call to get only the changes made after it.
+ */
+@property (nonatomic, readonly) NSUInteger version;
+
+/**
+ * Whether the version asked for was too old to still have its changes, in which case `updated` has all the members and a copy of the presence set should be replaced rather than updated.
+ */
+@property (nonatomic, readonly) BOOL isSnapshot;
+
+/**
+ * The latest `ARTPresenceMessage` of each member that entered or changed, one per member however many times it changed.
+ */
+@property (nonatomic, readonly) NSArray<ARTPresenceMessage *> *updated;
+
+/**
+ * The last `ARTPresenceMessage` of each member that left. Always empty when `isSnapshot` is `true`.
+ */
+@property (nonatomic, readonly) NSArray<ARTPresenceMessage *> *removed;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+@end
+
+/// :nodoc:
+typedef void (^ARTPresenceChangesCallback)(ARTPresenceChanges *_Nullable changes, ARTErrorInfo *_Nullable error);
+
+NS_ASSUME_NONNULL_END
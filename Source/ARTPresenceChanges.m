@@ -0,0 +1,19 @@
+#import "ARTPresenceChanges+Private.h"
+
+@implementation ARTPresenceChanges
+
+- (instancetype)initWithVersion:(NSUInteger)version isSnapshot:(BOOL)isSnapshot updated:(NSArray<ARTPresenceMessage *> *)updated removed:(NSArray<ARTPresenceMessage *> *)removed {
+    if (self = [super init]) {
+        _version = version;
+        _isSnapshot = isSnapshot;
+        _updated = updated;
+        _removed = removed;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p version: %lu, isSnapshot: %d, updated: %lu, removed: %lu>", self.class, self, (unsigned long)_version, _isSnapshot, (unsigned long)_updated.count, (unsigned long)_removed.count];
+}
+
+@end
@@ -3,11 +3,16 @@
 
 @class ARTPresenceMap;
 @class ARTPresenceMessage;
+@class ARTPresenceChanges;
 @class ARTErrorInfo;
 @class ARTLog;
+@class ARTStringInterner;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// :nodoc:
+extern const NSUInteger ARTPresenceMapDefaultMaxChangeLogLength;
+
 /// :nodoc:
 @protocol ARTPresenceMapDelegate <NSObject>
 @property (nonatomic, readonly) NSString *connectionId;
@@ -24,6 +29,15 @@ NS_ASSUME_NONNULL_BEGIN
 /// The key is the memberKey and the value is the latest relevant ARTPresenceMessage for that clientId.
 @property (readonly, atomic) NSDictionary<NSString *, ARTPresenceMessage *> *members;
 
+/// The number of members, without creating `members`.
+@property (readonly, nonatomic) NSUInteger memberCount;
+
+/// Whether members are stored as `ARTPresenceMember` objects, in which case `members` and the other accessors create the `ARTPresenceMessage` objects they return. `members` and `memberValues` are then reused until the map changes, as long as a caller still holds them.
+@property (readonly, nonatomic) BOOL compactMembers;
+
+/// The values of `members`, kept until the map changes, so that it's only copied once per change however many times it's read. With `compactMembers`, only while a caller holds them.
+@property (readonly, nonatomic) NSArray<ARTPresenceMessage *> *memberValues;
+
 /// List of internal members.
 /// The key is the clientId and the value is the latest relevant ARTPresenceMessage for that clientId.
 @property (readonly, atomic) NSMutableSet<ARTPresenceMessage *> *localMembers;
@@ -36,10 +50,28 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, nonatomic, getter=syncComplete) BOOL syncComplete;
 @property (readonly, nonatomic, getter=syncInProgress) BOOL syncInProgress;
 
+/// Increased by each change to `members`.
+@property (readonly, nonatomic) NSUInteger version;
+
+/// The most changes kept for `changesSinceVersion:`, older ones being dropped. The default is `ARTPresenceMapDefaultMaxChangeLogLength`.
+@property (nonatomic) NSUInteger maxChangeLogLength;
+
 - (instancetype)init UNAVAILABLE_ATTRIBUTE;
 - (instancetype)initWithQueue:(_Nonnull dispatch_queue_t)queue logger:(ARTLog *)logger;
+/// Stores members compactly, with their strings interned by `stringInterner`, when it isn't nil.
+- (instancetype)initWithQueue:(_Nonnull dispatch_queue_t)queue logger:(ARTLog *)logger stringInterner:(nullable ARTStringInterner *)stringInterner;
 
 - (BOOL)add:(ARTPresenceMessage *)message;
+
+/// The members with the given clientId and connectionId, either of which matches any member when nil. Looked up in indexes by clientId and by connectionId, so it takes time proportional to the members returned rather than to all of them.
+- (NSArray<ARTPresenceMessage *> *)membersWithClientId:(nullable NSString *)clientId connectionId:(nullable NSString *)connectionId;
+
+/// The changes made after `version`, with the latest state of each changed member, or all the members if those changes are no longer kept.
+- (ARTPresenceChanges *)changesSinceVersion:(NSUInteger)version;
+
+/// The estimated bytes held by the members, as by `ARTMemoryFootprintOfMessages`.
+- (NSUInteger)memoryFootprintOfMembers;
+
 - (void)reset;
 
 - (void)startSync;
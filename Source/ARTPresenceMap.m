@@ -1,6 +1,9 @@
 #import "ARTPresenceMap.h"
 #import "ARTPresenceMessage.h"
 #import "ARTPresenceMessage+Private.h"
+#import "ARTPresenceChanges+Private.h"
+#import "ARTPresenceMember.h"
+#import "ARTMemoryFootprint+Private.h"
 #import "ARTEventEmitter+Private.h"
 #import "ARTLog.h"
 
@@ -24,6 +27,8 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
     }
 }
 
+const NSUInteger ARTPresenceMapDefaultMaxChangeLogLength = 1000;
+
 #pragma mark - ARTEvent
 
 @interface ARTEvent (PresenceSyncState)
@@ -33,25 +38,68 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
 
 @end
 
+#pragma mark - ARTPresenceMapChange
+
+/// An entry of the change log of `ARTPresenceMap`.
+@interface ARTPresenceMapChange : NSObject
+
+@property (nonatomic, readonly) NSString *memberKey;
+@property (nonatomic, readonly) id<ARTPresenceMapEntry> member;
+@property (nonatomic, readonly) BOOL removed;
+
+@end
+
+@implementation ARTPresenceMapChange
+
+- (instancetype)initWithMemberKey:(NSString *)memberKey member:(id<ARTPresenceMapEntry>)member removed:(BOOL)removed {
+    if (self = [super init]) {
+        _memberKey = memberKey;
+        _member = member;
+        _removed = removed;
+    }
+    return self;
+}
+
+@end
+
 #pragma mark - ARTPresenceMap
 
 @interface ARTPresenceMap () {
     ARTPresenceSyncState _syncState;
     ARTEventEmitter<ARTEvent * /*ARTSyncState*/, id> *_syncEventEmitter;
-    NSMutableDictionary<NSString *, ARTPresenceMessage *> *_members;
+    // `ARTPresenceMessage` objects, or `ARTPresenceMember` objects when `_stringInterner` is set.
+    NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *_members;
     NSMutableSet<ARTPresenceMessage *> *_localMembers;
+    // The members by clientId and by connectionId, each of them keyed by memberKey.
+    NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *> *_membersByClientId;
+    NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *> *_membersByConnectionId;
+    // Cleared whenever `_members` changes. Only weakly kept for compact members, as keeping them would hold all of them
+    // as full messages: they're reused while a caller holds on to them, rather than created on each read.
+    NSArray<ARTPresenceMessage *> *_memberValues;
+    __weak NSArray<ARTPresenceMessage *> *_compactMemberValues;
+    __weak NSDictionary<NSString *, ARTPresenceMessage *> *_compactMembers;
+    // The changes from version `_version - _changeLog.count + 1` to `_version`, oldest first.
+    NSMutableArray<ARTPresenceMapChange *> *_changeLog;
 }
 
 @end
 
 @implementation ARTPresenceMap {
     ARTLog *_logger;
+    ARTStringInterner *_stringInterner;
 }
 
-- (instancetype)initWithQueue:(_Nonnull dispatch_queue_t)queue logger:(ARTLog *)logger { 
+- (instancetype)initWithQueue:(_Nonnull dispatch_queue_t)queue logger:(ARTLog *)logger {
+    return [self initWithQueue:queue logger:logger stringInterner:nil];
+}
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue logger:(ARTLog *)logger stringInterner:(ARTStringInterner *)stringInterner {
     self = [super init];
     if(self) {
         _logger = logger;
+        _stringInterner = stringInterner;
+        _maxChangeLogLength = ARTPresenceMapDefaultMaxChangeLogLength;
+        _changeLog = [NSMutableArray array];
         [self reset];
         _syncSessionId = 0;
         _syncState = ARTPresenceSyncInitialized;
@@ -61,16 +109,98 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
 }
 
 - (NSDictionary<NSString *, ARTPresenceMessage *> *)members {
-    return _members;
+    if (!_stringInterner) {
+        return (NSDictionary<NSString *, ARTPresenceMessage *> *)_members;
+    }
+    NSDictionary<NSString *, ARTPresenceMessage *> *members = _compactMembers;
+    if (members) {
+        return members;
+    }
+    NSMutableDictionary<NSString *, ARTPresenceMessage *> *compactMembers = [NSMutableDictionary dictionaryWithCapacity:_members.count];
+    [_members enumerateKeysAndObjectsUsingBlock:^(NSString *memberKey, id<ARTPresenceMapEntry> member, BOOL *stop) {
+        compactMembers[memberKey] = member.presenceMessage;
+    }];
+    members = [compactMembers copy];
+    _compactMembers = members;
+    return members;
+}
+
+- (NSUInteger)memberCount {
+    return _members.count;
+}
+
+- (NSUInteger)memoryFootprintOfMembers {
+    return ARTMemoryFootprintOfMessages(_members.objectEnumerator);
+}
+
+- (BOOL)compactMembers {
+    return _stringInterner != nil;
+}
+
+- (NSArray<ARTPresenceMessage *> *)memberValues {
+    NSArray<ARTPresenceMessage *> *memberValues = _memberValues ?: _compactMemberValues;
+    if (memberValues) {
+        return memberValues;
+    }
+    memberValues = [self presenceMessagesOf:_members];
+    if (_stringInterner) {
+        _compactMemberValues = memberValues;
+    }
+    else {
+        _memberValues = memberValues;
+    }
+    return memberValues;
+}
+
+- (NSArray<ARTPresenceMessage *> *)presenceMessagesOf:(NSDictionary<NSString *, id<ARTPresenceMapEntry>> *)members {
+    if (!_stringInterner) {
+        return (NSArray<ARTPresenceMessage *> *)members.allValues ?: @[];
+    }
+    NSMutableArray<ARTPresenceMessage *> *messages = [NSMutableArray arrayWithCapacity:members.count];
+    for (id<ARTPresenceMapEntry> member in members.objectEnumerator) {
+        [messages addObject:member.presenceMessage];
+    }
+    return messages;
 }
 
 - (NSMutableSet<ARTPresenceMessage *> *)localMembers {
     return _localMembers;
 }
 
+- (NSArray<ARTPresenceMessage *> *)membersWithClientId:(NSString *)clientId connectionId:(NSString *)connectionId {
+    if (!clientId && !connectionId) {
+        return self.memberValues;
+    }
+    NSDictionary<NSString *, id<ARTPresenceMapEntry>> *withClientId = clientId ? _membersByClientId[clientId] : nil;
+    NSDictionary<NSString *, id<ARTPresenceMapEntry>> *withConnectionId = connectionId ? _membersByConnectionId[connectionId] : nil;
+    if (!clientId) {
+        return [self presenceMessagesOf:withConnectionId];
+    }
+    if (!connectionId) {
+        return [self presenceMessagesOf:withClientId];
+    }
+    // Both are given: go through the smaller of the two.
+    NSMutableArray<ARTPresenceMessage *> *result = [NSMutableArray array];
+    if (withClientId.count <= withConnectionId.count) {
+        [withClientId enumerateKeysAndObjectsUsingBlock:^(NSString *memberKey, id<ARTPresenceMapEntry> member, BOOL *stop) {
+            if (withConnectionId[memberKey]) {
+                [result addObject:member.presenceMessage];
+            }
+        }];
+    }
+    else {
+        [withConnectionId enumerateKeysAndObjectsUsingBlock:^(NSString *memberKey, id<ARTPresenceMapEntry> member, BOOL *stop) {
+            if (withClientId[memberKey]) {
+                [result addObject:member.presenceMessage];
+            }
+        }];
+    }
+    return result;
+}
+
 - (BOOL)add:(ARTPresenceMessage *)message {
-    ARTPresenceMessage *latest = [_members objectForKey:message.memberKey];
-    if ([message isNewerThan:latest]) {
+    id<ARTPresenceMapEntry> latest = [_members objectForKey:message.memberKey];
+    if (!latest || [latest isOlderThan:message]) {
         ARTPresenceMessage *messageCopy = [message copy];
         switch (message.action) {
             case ARTPresenceEnter:
@@ -89,7 +219,13 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
         return YES;
     }
     [_logger debug:__FILE__ line:__LINE__ message:@"Presence member \"%@\" with action %@ has been ignored", message.memberKey, ARTPresenceActionToStr(message.action)];
+    if (_stringInterner && latest.syncSessionId != _syncSessionId) {
+        // Compact members' snapshots are copies, so they would keep the old session id.
+        [self clearMemberValues];
+    }
     latest.syncSessionId = _syncSessionId;
+    // A local member is kept as a message of its own, which is seen in the sync too (RTP17).
+    [_localMembers member:message].syncSessionId = _syncSessionId;
     return NO;
 }
 
@@ -99,9 +235,16 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
 
 - (void)internalAdd:(ARTPresenceMessage *)message withSessionId:(NSUInteger)sessionId {
     message.syncSessionId = sessionId;
-    [_members setObject:message forKey:message.memberKey];
+    NSString *memberKey = message.memberKey;
+    id<ARTPresenceMapEntry> member = _stringInterner ? [[ARTPresenceMember alloc] initWithMessage:message stringInterner:_stringInterner] : message;
+    [_members setObject:member forKey:memberKey];
+    [self addMember:member forKey:memberKey toIndex:_membersByClientId withValue:message.clientId];
+    [self addMember:member forKey:memberKey toIndex:_membersByConnectionId withValue:message.connectionId];
+    [self recordChangeOfMember:member forKey:memberKey removed:NO];
     // Local member
     if ([message.connectionId isEqualToString:self.delegate.connectionId]) {
+        // Messages of the same member are equal, so the set would otherwise keep the earlier one and its session id.
+        [_localMembers removeObject:message];
         [_localMembers addObject:message];
         [_logger debug:__FILE__ line:__LINE__ message:@"local member %@ with action %@ has been added", message.memberKey, ARTPresenceActionToStr(message.action).uppercaseString];
     }
@@ -124,25 +267,30 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
         [self internalAdd:message withSessionId:message.syncSessionId];
     }
     else {
-        [_members removeObjectForKey:message.memberKey];
+        NSString *memberKey = message.memberKey;
+        [_members removeObjectForKey:memberKey];
+        [self removeMemberForKey:memberKey fromIndex:_membersByClientId withValue:message.clientId];
+        [self removeMemberForKey:memberKey fromIndex:_membersByConnectionId withValue:message.connectionId];
+        [self recordChangeOfMember:message forKey:memberKey removed:YES];
     }
 }
 
 - (void)cleanUpAbsentMembers {
     [_logger debug:__FILE__ line:__LINE__ message:@"%p cleaning up absent members (syncSessionId=%lu)", self, (unsigned long)_syncSessionId];
-    NSSet<NSString *> *filteredMembers = [_members keysOfEntriesPassingTest:^BOOL(NSString *key, ARTPresenceMessage *message, BOOL *stop) {
-        return message.action == ARTPresenceAbsent;
+    NSSet<NSString *> *filteredMembers = [_members keysOfEntriesPassingTest:^BOOL(NSString *key, id<ARTPresenceMapEntry> member, BOOL *stop) {
+        return member.action == ARTPresenceAbsent;
     }];
     for (NSString *key in filteredMembers) {
-        [self internalRemove:[_members objectForKey:key] force:true];
+        [self internalRemove:[_members objectForKey:key].presenceMessage force:true];
     }
 }
 
 - (void)leaveMembersNotPresentInSync {
     [_logger debug:__FILE__ line:__LINE__ message:@"%p leaving members not present in sync (syncSessionId=%lu)", self, (unsigned long)_syncSessionId];
-    for (ARTPresenceMessage *member in [_members allValues]) {
-        if (member.syncSessionId != _syncSessionId) {
+    for (id<ARTPresenceMapEntry> entry in [_members allValues]) {
+        if (entry.syncSessionId != _syncSessionId) {
             // Handle members that have not been added or updated in the PresenceMap during the sync process
+            ARTPresenceMessage *member = entry.presenceMessage;
             ARTPresenceMessage *leave = [member copy];
             [self internalRemove:member];
             [self.delegate map:self didRemovedMemberNoLongerPresent:leave];
@@ -164,6 +312,37 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
 - (void)reset {
     _members = [NSMutableDictionary dictionary];
     _localMembers = [NSMutableSet set];
+    _membersByClientId = [NSMutableDictionary dictionary];
+    _membersByConnectionId = [NSMutableDictionary dictionary];
+    [self clearMemberValues];
+    // The log can't tell which members a reset removed, so versions before it get all the members.
+    _version++;
+    [_changeLog removeAllObjects];
+}
+
+- (void)setMaxChangeLogLength:(NSUInteger)maxChangeLogLength {
+    _maxChangeLogLength = maxChangeLogLength;
+    [self trimChangeLogToLength:maxChangeLogLength];
+}
+
+- (ARTPresenceChanges *)changesSinceVersion:(NSUInteger)version {
+    const NSUInteger oldestVersion = _version - _changeLog.count;
+    if (version < oldestVersion || version > _version) {
+        return [[ARTPresenceChanges alloc] initWithVersion:_version isSnapshot:YES updated:self.memberValues removed:@[]];
+    }
+
+    // Only the latest change of each member.
+    NSMutableDictionary<NSString *, ARTPresenceMapChange *> *latestChanges = [NSMutableDictionary dictionary];
+    for (NSUInteger i = version - oldestVersion; i < _changeLog.count; i++) {
+        ARTPresenceMapChange *change = _changeLog[i];
+        latestChanges[change.memberKey] = change;
+    }
+    NSMutableArray<ARTPresenceMessage *> *updated = [NSMutableArray array];
+    NSMutableArray<ARTPresenceMessage *> *removed = [NSMutableArray array];
+    for (ARTPresenceMapChange *change in latestChanges.objectEnumerator) {
+        [(change.removed ? removed : updated) addObject:change.member.presenceMessage];
+    }
+    return [[ARTPresenceChanges alloc] initWithVersion:_version isSnapshot:NO updated:updated removed:removed];
 }
 
 - (void)startSync {
@@ -179,7 +358,7 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
     [self leaveMembersNotPresentInSync];
     _syncState = ARTPresenceSyncEnded;
     [self reenterLocalMembersMissingFromSync];
-    [_syncEventEmitter emit:[ARTEvent newWithPresenceSyncState:ARTPresenceSyncEnded] with:[_members allValues]];
+    [_syncEventEmitter emit:[ARTEvent newWithPresenceSyncState:ARTPresenceSyncEnded] with:self.memberValues];
     [_syncEventEmitter off];
     [_logger debug:__FILE__ line:__LINE__ message:@"%p PresenceMap sync ended", self];
 }
@@ -213,6 +392,51 @@ NSString *ARTPresenceSyncStateToStr(ARTPresenceSyncState state) {
     return [NSString stringWithFormat:@"%@:%@", message.connectionId, message.clientId];
 }
 
+- (void)addMember:(id<ARTPresenceMapEntry>)member forKey:(NSString *)memberKey toIndex:(NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *> *)index withValue:(NSString *)value {
+    if (!value) {
+        return;
+    }
+    NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *members = index[value];
+    if (!members) {
+        members = [NSMutableDictionary dictionary];
+        index[value] = members;
+    }
+    members[memberKey] = member;
+}
+
+- (void)clearMemberValues {
+    _memberValues = nil;
+    _compactMemberValues = nil;
+    _compactMembers = nil;
+}
+
+- (void)recordChangeOfMember:(id<ARTPresenceMapEntry>)member forKey:(NSString *)memberKey removed:(BOOL)removed {
+    _version++;
+    [self clearMemberValues];
+    if (_maxChangeLogLength == 0) {
+        return;
+    }
+    [self trimChangeLogToLength:_maxChangeLogLength - 1];
+    [_changeLog addObject:[[ARTPresenceMapChange alloc] initWithMemberKey:memberKey member:member removed:removed]];
+}
+
+- (void)trimChangeLogToLength:(NSUInteger)length {
+    if (_changeLog.count > length) {
+        [_changeLog removeObjectsInRange:NSMakeRange(0, _changeLog.count - length)];
+    }
+}
+
+- (void)removeMemberForKey:(NSString *)memberKey fromIndex:(NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *> *)index withValue:(NSString *)value {
+    if (!value) {
+        return;
+    }
+    NSMutableDictionary<NSString *, id<ARTPresenceMapEntry>> *members = index[value];
+    [members removeObjectForKey:memberKey];
+    if (members.count == 0) {
+        [index removeObjectForKey:value];
+    }
+}
+
 @end
 
 #pragma mark - ARTEvent
@@ -16,6 +16,7 @@
 #import "ARTPushAdmin+Private.h"
 #import "ARTLocalDevice+Private.h"
 #import "ARTDeviceStorage.h"
+#import "ARTDeviceStorageWriter.h"
 #import "ARTRealtime+Private.h"
 
 @implementation ARTPush {
@@ -179,16 +180,18 @@ NSString *const ARTAPNSDeviceTokenKey = @"ARTAPNSDeviceToken";
     NSString *deviceToken = [hexString copy];
 
     [rest.logger info:@"ARTPush: device token: %@", deviceToken];
-    NSString *currentDeviceToken = [rest.storage objectForKey:ARTAPNSDeviceTokenKey];
+    NSString *currentDeviceToken = [rest.storageWriter objectForKey:ARTAPNSDeviceTokenKey];
     if ([currentDeviceToken isEqualToString:deviceToken]) {
         // Already stored.
         return;
     }
 
-    [rest.device_nosync setAndPersistAPNSDeviceToken:deviceToken];
-    [rest.logger debug:@"ARTPush: device token stored"];
-    [rest.push getActivationMachine:^(ARTPushActivationStateMachine *stateMachine) {
-        [stateMachine sendEvent:[ARTPushActivationEventGotPushDeviceDetails new]];
+    [rest loadDevice_nosync:^(ARTLocalDevice *device) {
+        [device setAndPersistAPNSDeviceToken:deviceToken];
+        [rest.logger debug:@"ARTPush: device token stored"];
+        [rest.push getActivationMachine:^(ARTPushActivationStateMachine *stateMachine) {
+            [stateMachine sendEvent:[ARTPushActivationEventGotPushDeviceDetails new]];
+        }];
     }];
 }
 
@@ -7,6 +7,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 extern NSString *const ARTPushActivationCurrentStateKey;
 extern NSString *const ARTPushActivationPendingEventsKey;
+extern NSString *const ARTPushActivationStateRecordKey;
 
 @interface ARTPushActivationStateMachine ()
 
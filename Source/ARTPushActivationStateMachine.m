@@ -9,6 +9,7 @@
 #import "ARTTypes.h"
 #import "ARTLocalDevice+Private.h"
 #import "ARTDeviceStorage.h"
+#import "ARTDeviceStorageWriter.h"
 #import "ARTDevicePushDetails.h"
 #import "ARTDeviceIdentityTokenDetails.h"
 #import "ARTNSMutableRequest+ARTPush.h"
@@ -20,10 +21,251 @@
 
 NSString *const ARTPushActivationCurrentStateKey = @"ARTPushActivationCurrentState";
 NSString *const ARTPushActivationPendingEventsKey = @"ARTPushActivationPendingEvents";
+NSString *const ARTPushActivationStateRecordKey = @"ARTPushActivationStateRecord";
+
+#pragma mark - Record
+
+// The state and the pending events are persisted together as one record under `ARTPushActivationStateRecordKey`,
+// so that one storage write replaces both. Earlier versions stored a keyed archive under each of the legacy keys;
+// these are only read when there's no record, to migrate them, and are removed when the first record is written.
+//
+// A record is the magic bytes, a version byte, the state's code, the number of pending events, then each event:
+// its code followed, for error events, by the error and, for identity events, by the identity token details if any.
+// Integers are LEB128 varints; strings are their UTF-8 length plus one, then the bytes, with 0 for nil.
+
+static const uint8_t ARTPushActivationRecordMagic[] = { 'A', 'R', 'T', 'P' };
+static const uint8_t ARTPushActivationRecordVersion = 1;
+
+// The index of each class is its code minus one. Only ever append to these.
+static NSArray<Class> *recordStateClasses(void) {
+    static NSArray<Class> *classes;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        classes = @[
+            [ARTPushActivationStateNotActivated class],
+            [ARTPushActivationStateWaitingForPushDeviceDetails class],
+            [ARTPushActivationStateWaitingForNewPushDeviceDetails class],
+            [ARTPushActivationStateAfterRegistrationSyncFailed class],
+        ];
+    });
+    return classes;
+}
+
+static NSArray<Class> *recordEventClasses(void) {
+    static NSArray<Class> *classes;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        classes = @[
+            [ARTPushActivationEventCalledActivate class],
+            [ARTPushActivationEventCalledDeactivate class],
+            [ARTPushActivationEventGotPushDeviceDetails class],
+            [ARTPushActivationEventGettingPushDeviceDetailsFailed class],
+            [ARTPushActivationEventGotDeviceRegistration class],
+            [ARTPushActivationEventGettingDeviceRegistrationFailed class],
+            [ARTPushActivationEventRegistrationSynced class],
+            [ARTPushActivationEventSyncRegistrationFailed class],
+            [ARTPushActivationEventDeregistered class],
+            [ARTPushActivationEventDeregistrationFailed class],
+        ];
+    });
+    return classes;
+}
+
+static void writeRecordUInt(NSMutableData *data, uint64_t value) {
+    uint8_t bytes[10];
+    NSUInteger length = 0;
+    do {
+        bytes[length] = value & 0x7f;
+        value >>= 7;
+        if (value) {
+            bytes[length] |= 0x80;
+        }
+        length++;
+    } while (value);
+    [data appendBytes:bytes length:length];
+}
+
+static void writeRecordInt(NSMutableData *data, int64_t value) {
+    writeRecordUInt(data, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void writeRecordString(NSMutableData *data, NSString *string) {
+    if (!string) {
+        writeRecordUInt(data, 0);
+        return;
+    }
+    NSData *utf8 = [string dataUsingEncoding:NSUTF8StringEncoding];
+    writeRecordUInt(data, utf8.length + 1);
+    [data appendData:utf8];
+}
+
+// Milliseconds since 1970 plus one, with 0 for nil.
+static void writeRecordDate(NSMutableData *data, NSDate *date) {
+    writeRecordInt(data, date ? (int64_t)llround(date.timeIntervalSince1970 * 1000) + 1 : 0);
+}
+
+typedef struct {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+    BOOL failed;
+} ARTPushActivationRecordReader;
+
+static uint64_t readRecordUInt(ARTPushActivationRecordReader *reader) {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (reader->offset >= reader->length) {
+            break;
+        }
+        const uint8_t byte = reader->bytes[reader->offset++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    reader->failed = YES;
+    return 0;
+}
+
+static int64_t readRecordInt(ARTPushActivationRecordReader *reader) {
+    const uint64_t value = readRecordUInt(reader);
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static NSString *readRecordString(ARTPushActivationRecordReader *reader) {
+    const uint64_t length = readRecordUInt(reader);
+    if (length == 0 || reader->failed) {
+        return nil;
+    }
+    if (length - 1 > reader->length - reader->offset) {
+        reader->failed = YES;
+        return nil;
+    }
+    NSString *string = [[NSString alloc] initWithBytes:reader->bytes + reader->offset length:(NSUInteger)(length - 1) encoding:NSUTF8StringEncoding];
+    reader->offset += (NSUInteger)(length - 1);
+    if (!string) {
+        reader->failed = YES;
+    }
+    return string;
+}
+
+static NSDate *readRecordDate(ARTPushActivationRecordReader *reader) {
+    const int64_t value = readRecordInt(reader);
+    return value == 0 ? nil : [NSDate dateWithTimeIntervalSince1970:(value - 1) / 1000.0];
+}
+
+static BOOL isRecord(id data) {
+    return [data isKindOfClass:[NSData class]]
+        && ((NSData *)data).length > sizeof(ARTPushActivationRecordMagic)
+        && memcmp(((NSData *)data).bytes, ARTPushActivationRecordMagic, sizeof(ARTPushActivationRecordMagic)) == 0;
+}
+
+static NSData *encodeRecord(Class _Nullable stateClass, NSArray<ARTPushActivationEvent *> *pendingEvents, ARTLog *logger) {
+    NSMutableData *data = [NSMutableData dataWithCapacity:16];
+    [data appendBytes:ARTPushActivationRecordMagic length:sizeof(ARTPushActivationRecordMagic)];
+    [data appendBytes:&ARTPushActivationRecordVersion length:1];
+    const NSUInteger stateIndex = stateClass ? [recordStateClasses() indexOfObject:stateClass] : NSNotFound;
+    writeRecordUInt(data, stateIndex == NSNotFound ? 0 : stateIndex + 1);
+
+    NSArray<Class> *eventClasses = recordEventClasses();
+    NSMutableData *events = [NSMutableData data];
+    NSUInteger eventCount = 0;
+    for (ARTPushActivationEvent *event in pendingEvents) {
+        const NSUInteger eventIndex = [eventClasses indexOfObject:event.class];
+        if (eventIndex == NSNotFound) {
+            [logger error:@"ARTPushActivationStateMachine: can't persist pending event %@", NSStringFromClass(event.class)];
+            continue;
+        }
+        writeRecordUInt(events, eventIndex + 1);
+        if ([event isKindOfClass:[ARTPushActivationErrorEvent class]]) {
+            ARTErrorInfo *error = ((ARTPushActivationErrorEvent *)event).error;
+            writeRecordInt(events, error.code);
+            writeRecordInt(events, error.statusCode);
+            writeRecordString(events, error.message);
+        }
+        else if ([event isKindOfClass:[ARTPushActivationDeviceIdentityEvent class]]) {
+            ARTDeviceIdentityTokenDetails *details = ((ARTPushActivationDeviceIdentityEvent *)event).identityTokenDetails;
+            writeRecordUInt(events, details ? 1 : 0);
+            if (details) {
+                writeRecordString(events, details.token);
+                writeRecordDate(events, details.issued);
+                writeRecordDate(events, details.expires);
+                writeRecordString(events, details.capability);
+                writeRecordString(events, details.clientId);
+            }
+        }
+        eventCount++;
+    }
+    writeRecordUInt(data, eventCount);
+    [data appendData:events];
+    return data;
+}
+
+static BOOL decodeRecord(NSData *data, Class _Nullable *stateClass, NSMutableArray<ARTPushActivationEvent *> **pendingEvents) {
+    ARTPushActivationRecordReader reader = { .bytes = data.bytes, .length = data.length, .offset = sizeof(ARTPushActivationRecordMagic) };
+    if (reader.bytes[reader.offset++] != ARTPushActivationRecordVersion) {
+        return NO;
+    }
+    NSArray<Class> *stateClasses = recordStateClasses();
+    const uint64_t stateCode = readRecordUInt(&reader);
+    if (stateCode > stateClasses.count) {
+        return NO;
+    }
+    *stateClass = stateCode == 0 ? nil : stateClasses[(NSUInteger)stateCode - 1];
+
+    NSArray<Class> *eventClasses = recordEventClasses();
+    const uint64_t eventCount = readRecordUInt(&reader);
+    NSMutableArray<ARTPushActivationEvent *> *events = [NSMutableArray array];
+    for (uint64_t i = 0; i < eventCount && !reader.failed; i++) {
+        const uint64_t eventCode = readRecordUInt(&reader);
+        if (eventCode == 0 || eventCode > eventClasses.count) {
+            return NO;
+        }
+        Class eventClass = eventClasses[(NSUInteger)eventCode - 1];
+        if ([eventClass isSubclassOfClass:[ARTPushActivationErrorEvent class]]) {
+            const int64_t code = readRecordInt(&reader);
+            const int64_t statusCode = readRecordInt(&reader);
+            NSString *message = readRecordString(&reader);
+            [events addObject:[eventClass newWithError:[ARTErrorInfo createWithCode:(NSInteger)code status:(NSInteger)statusCode message:message ?: @""]]];
+        }
+        else if ([eventClass isSubclassOfClass:[ARTPushActivationDeviceIdentityEvent class]]) {
+            ARTDeviceIdentityTokenDetails *details = nil;
+            if (readRecordUInt(&reader)) {
+                NSString *token = readRecordString(&reader);
+                NSDate *issued = readRecordDate(&reader);
+                NSDate *expires = readRecordDate(&reader);
+                NSString *capability = readRecordString(&reader);
+                NSString *clientId = readRecordString(&reader);
+                details = [[ARTDeviceIdentityTokenDetails alloc] initWithToken:token issued:issued expires:expires capability:capability clientId:clientId];
+            }
+            [events addObject:[eventClass newWithIdentityTokenDetails:details]];
+        }
+        else {
+            [events addObject:[eventClass new]];
+        }
+    }
+    if (reader.failed || reader.offset != reader.length) {
+        return NO;
+    }
+    *pendingEvents = events;
+    return YES;
+}
 
 @implementation ARTPushActivationStateMachine {
     ARTPushActivationEvent *_lastHandledEvent;
     ARTPushActivationState *_current;
+    // The state written with the pending events: the last persistent state, since other states aren't persisted.
+    Class _persistedStateClass;
+    NSData *_persistedRecord;
+    // Whether keyed archives of an earlier version were found, to be removed with the first record write.
+    BOOL _hasLegacyArchives;
+    // Sent events waiting for the local device to be loaded, in the order they were sent.
+    NSMutableArray<ARTPushActivationEvent *> *_eventsAwaitingDevice;
+    // Whether the local device is being waited for, and done when it's loaded and the events have been handled.
+    BOOL _waitingForDevice;
+    dispatch_group_t _deviceWait;
+    // Whether the stored device token is still to be checked for, once the local device is loaded; see bug #966.
+    BOOL _checksStoredDeviceToken;
     dispatch_queue_t _queue;
     dispatch_queue_t _userQueue;
 }
@@ -35,29 +277,49 @@ NSString *const ARTPushActivationPendingEventsKey = @"ARTPushActivationPendingEv
         _delegate = delegate;
         _queue = _rest.queue;
         _userQueue = _rest.userQueue;
-        // Unarchiving
-        NSData *stateData = [rest.storage objectForKey:ARTPushActivationCurrentStateKey];
-        _current = [ARTPushActivationState art_unarchiveFromData:stateData withLogger:rest.logger];
-        if (!_current) {
-            _current = [[ARTPushActivationStateNotActivated alloc] initWithMachine:self];
-        } else {
+        _eventsAwaitingDevice = [NSMutableArray array];
+        _deviceWait = dispatch_group_create();
+        NSData *recordData = [rest.storageWriter objectForKey:ARTPushActivationStateRecordKey];
+        BOOL restored = NO;
+        if (isRecord(recordData)) {
+            Class stateClass = nil;
+            NSMutableArray<ARTPushActivationEvent *> *pendingEvents = nil;
+            if (decodeRecord(recordData, &stateClass, &pendingEvents)) {
+                _current = [stateClass newWithMachine:self];
+                _pendingEvents = pendingEvents;
+                _persistedRecord = recordData;
+                restored = YES;
+            } else {
+                [rest.logger error:@"%@: ignoring persisted state record that can't be decoded", NSStringFromClass(self.class)];
+            }
+        }
+        if (!restored) {
+            // Unarchiving
+            NSData *stateData = [rest.storageWriter objectForKey:ARTPushActivationCurrentStateKey];
+            _current = [ARTPushActivationState art_unarchiveFromData:stateData withLogger:rest.logger];
             if ([_current isKindOfClass:[ARTPushActivationDeprecatedPersistentState class]]) {
                 _current = [((ARTPushActivationDeprecatedPersistentState *) _current) migrate];
             }
             _current.machine = self;
+            NSData *pendingEventsData = [rest.storageWriter objectForKey:ARTPushActivationPendingEventsKey];
+            _pendingEvents = [ARTPushActivationEvent art_unarchiveFromData:pendingEventsData withLogger:rest.logger];
+            _hasLegacyArchives = stateData != nil || pendingEventsData != nil;
+        }
+        if (!_current) {
+            _current = [[ARTPushActivationStateNotActivated alloc] initWithMachine:self];
         }
-        NSData *pendingEventsData = [rest.storage objectForKey:ARTPushActivationPendingEventsKey];
-        _pendingEvents = [ARTPushActivationEvent art_unarchiveFromData:pendingEventsData withLogger:rest.logger];
         if (!_pendingEvents) {
             _pendingEvents = [NSMutableArray array];
         }
+        if ([_current isKindOfClass:[ARTPushActivationPersistentState class]]) {
+            _persistedStateClass = _current.class;
+        }
 
-        // Due to bug #966, old versions of the library might have led us to an illegal
-        // persisted state: we have a deviceToken, but the persisted push state is WaitingForPushDeviceDetails.
-        // So we need to re-emit the GotPushDeviceDetails event that led us there.
-        if ([_current isKindOfClass:[ARTPushActivationStateWaitingForPushDeviceDetails class]] && rest.device_nosync.apnsDeviceToken != nil) {
-            [rest.logger debug:@"ARTPush: re-emitting stored device details for stuck state machine"];
-            [self handleEvent:[ARTPushActivationEventGotPushDeviceDetails new]];
+        if ([_current isKindOfClass:[ARTPushActivationStateWaitingForPushDeviceDetails class]]) {
+            _checksStoredDeviceToken = YES;
+            dispatch_async(_queue, ^{
+                [self handleEventsAwaitingDevice];
+            });
         }
     }
     return self;
@@ -65,9 +327,18 @@ NSString *const ARTPushActivationPendingEventsKey = @"ARTPushActivationPendingEv
 
 - (ARTPushActivationEvent *)lastEvent {
     __block ARTPushActivationEvent *ret;
+    __block BOOL waitingForDevice;
     dispatch_sync(_queue, ^{
         ret = [self lastEvent_nosync];
+        waitingForDevice = self->_waitingForDevice;
     });
+    if (waitingForDevice) {
+        // So that events sent before are reflected.
+        dispatch_group_wait(_deviceWait, DISPATCH_TIME_FOREVER);
+        dispatch_sync(_queue, ^{
+            ret = [self lastEvent_nosync];
+        });
+    }
     return ret;
 }
 
@@ -77,9 +348,18 @@ NSString *const ARTPushActivationPendingEventsKey = @"ARTPushActivationPendingEv
 
 - (ARTPushActivationState *)current {
     __block ARTPushActivationState *ret;
+    __block BOOL waitingForDevice;
     dispatch_sync(_queue, ^{
         ret = [self current_nosync];
+        waitingForDevice = self->_waitingForDevice;
     });
+    if (waitingForDevice) {
+        // So that events sent before are reflected.
+        dispatch_group_wait(_deviceWait, DISPATCH_TIME_FOREVER);
+        dispatch_sync(_queue, ^{
+            ret = [self current_nosync];
+        });
+    }
     return ret;
 }
 
@@ -89,10 +369,39 @@ NSString *const ARTPushActivationPendingEventsKey = @"ARTPushActivationPendingEv
 
 - (void)sendEvent:(ARTPushActivationEvent *)event {
 dispatch_async(_queue, ^{
-    [self handleEvent:event];
+    [self->_eventsAwaitingDevice addObject:event];
+    [self handleEventsAwaitingDevice];
 });
 }
 
+// States read the local device as they handle events, so events are handled once it's loaded instead of waiting for it on the queue.
+- (void)handleEventsAwaitingDevice {
+    if (_waitingForDevice) {
+        // Handled with the events already waiting.
+        return;
+    }
+    _waitingForDevice = YES;
+    dispatch_group_enter(_deviceWait);
+    [_rest loadDevice_nosync:^(ARTLocalDevice *device) {
+        self->_waitingForDevice = NO;
+        if (self->_checksStoredDeviceToken) {
+            self->_checksStoredDeviceToken = NO;
+            // Due to bug #966, old versions of the library might have led us to an illegal
+            // persisted state: we have a deviceToken, but the persisted push state is WaitingForPushDeviceDetails.
+            // So we need to re-emit the GotPushDeviceDetails event that led us there.
+            if ([self->_current isKindOfClass:[ARTPushActivationStateWaitingForPushDeviceDetails class]] && device.apnsDeviceToken != nil) {
+                [self->_rest.logger debug:@"ARTPush: re-emitting stored device details for stuck state machine"];
+                [self handleEvent:[ARTPushActivationEventGotPushDeviceDetails new]];
+            }
+        }
+        ARTPushActivationEvent *event;
+        while ((event = [self->_eventsAwaitingDevice art_dequeue])) {
+            [self handleEvent:event];
+        }
+        dispatch_group_leave(self->_deviceWait);
+    }];
+}
+
 - (void)handleEvent:(nonnull ARTPushActivationEvent *)event {
     [_rest.logger debug:@"%@: handling event %@ from %@", NSStringFromClass(self.class), NSStringFromClass(event.class), NSStringFromClass(_current.class)];
     _lastHandledEvent = event;
@@ -130,13 +439,23 @@ dispatch_async(_queue, ^{
 }
 
 - (void)persist {
-    // Archiving
     if ([_current isKindOfClass:[ARTPushActivationPersistentState class]]) {
-        [self.rest.storage setObject:[_current art_archiveWithLogger:self.rest.logger]
-                              forKey:ARTPushActivationCurrentStateKey];
+        _persistedStateClass = _current.class;
+    }
+    // Most events change neither the persisted state nor the pending events.
+    NSData *record = encodeRecord(_persistedStateClass, _pendingEvents, _rest.logger);
+    if ([record isEqualToData:_persistedRecord]) {
+        return;
+    }
+    _persistedRecord = record;
+    [self.rest.storageWriter setObject:record forKey:ARTPushActivationStateRecordKey];
+
+    if (_hasLegacyArchives) {
+        // The record now holds what was migrated from them.
+        [self.rest.storageWriter setObject:nil forKey:ARTPushActivationCurrentStateKey];
+        [self.rest.storageWriter setObject:nil forKey:ARTPushActivationPendingEventsKey];
+        _hasLegacyArchives = NO;
     }
-    [self.rest.storage setObject:[_pendingEvents art_archiveWithLogger:self.rest.logger]
-                          forKey:ARTPushActivationPendingEventsKey];
 }
 
 - (void)deviceRegistration:(ARTErrorInfo *)error {
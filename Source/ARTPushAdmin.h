@@ -2,6 +2,7 @@
 #import <Ably/ARTTypes.h>
 #import <Ably/ARTPushDeviceRegistrations.h>
 #import <Ably/ARTPushChannelSubscriptions.h>
+#import <Ably/ARTPushBatch.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -22,6 +23,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)publish:(ARTPushRecipient *)recipient data:(ARTJsonObject *)data callback:(nullable ARTCallback)callback;
 
+/**
+ * Sends the same push notification to each of a collection of recipients, in requests of up to `options.maxItemsPerRequest` recipients each to the batch publish endpoint.
+ *
+ * @param recipients An array of JSON objects containing the recipient details, as for `-[ARTPushAdmin publish:data:callback:]`.
+ * @param data A JSON object containing the push notification payload.
+ * @param options An `ARTPushBatchOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for receiving the outcome of each recipient, by its index in `recipients`.
+ */
+- (void)publishBatch:(NSArray<ARTPushRecipient *> *)recipients data:(ARTJsonObject *)data options:(nullable ARTPushBatchOptions *)options callback:(nullable ARTPushBatchCallback)callback;
+
 @end
 
 /**
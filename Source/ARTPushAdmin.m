@@ -6,6 +6,8 @@
 #import "ARTLog.h"
 #import "ARTJsonEncoder.h"
 #import "ARTJsonLikeEncoder.h"
+#import "ARTPushBatch+Private.h"
+#import "ARTNSArray+ARTFunctional.h"
 
 @implementation ARTPushAdmin {
     ARTQueuedDealloc *_dealloc;
@@ -24,6 +26,10 @@
     [_internal publish:recipient data:data callback:callback];
 }
 
+- (void)publishBatch:(NSArray<ARTPushRecipient *> *)recipients data:(ARTJsonObject *)data options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    [_internal publishBatch:recipients data:data options:options callback:callback];
+}
+
 - (ARTPushDeviceRegistrations *)deviceRegistrations {
     return [[ARTPushDeviceRegistrations alloc] initWithInternal:_internal.deviceRegistrations queuedDealloc:_dealloc];
 }
@@ -94,4 +100,82 @@
     });
 }
 
+- (void)publishBatch:(NSArray<ARTPushRecipient *> *)recipients data:(ARTJsonObject *)data options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    if (callback) {
+        ARTPushBatchCallback userCallback = callback;
+        callback = ^(ARTPushBatchResult *result) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(result);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushBatchOptions alloc] init];
+
+dispatch_async(_queue, ^{
+    if (![[data allKeys] count]) {
+        NSMutableDictionary<NSNumber *, ARTErrorInfo *> *errors = [NSMutableDictionary dictionary];
+        for (NSUInteger i = 0; i < recipients.count; i++) {
+            errors[@(i)] = [ARTErrorInfo createWithCode:0 message:@"Data payload is missing"];
+        }
+        if (callback) callback([[ARTPushBatchResult alloc] initWithCount:recipients.count errors:errors]);
+        return;
+    }
+
+    [self->_logger debug:__FILE__ line:__LINE__ message:@"push notification to %lu recipients", (unsigned long)recipients.count];
+    ARTPushBatchRequests *requests = [[ARTPushBatchRequests alloc] initWithCount:recipients.count maxItemsPerRequest:options.maxItemsPerRequest maxConcurrentRequests:options.maxConcurrentRequests send:^(NSRange range, ARTPushBatchRequestCallback requestCallback) {
+        [self publishBatch_nosync:[recipients subarrayWithRange:range] data:data callback:requestCallback];
+    }];
+    [requests start:^(ARTPushBatchResult *result) {
+        if (callback) callback(result);
+    }];
+});
+}
+
+- (void)publishBatch_nosync:(NSArray<ARTPushRecipient *> *)recipients data:(ARTJsonObject *)data callback:(ARTPushBatchRequestCallback)callback {
+    // Recipients without details fail without being sent.
+    NSMutableArray *itemErrors = [NSMutableArray arrayWithCapacity:recipients.count];
+    NSMutableArray<NSNumber *> *sentIndexes = [NSMutableArray arrayWithCapacity:recipients.count];
+    NSMutableArray<NSDictionary *> *items = [NSMutableArray arrayWithCapacity:recipients.count];
+    [recipients enumerateObjectsUsingBlock:^(ARTPushRecipient *recipient, NSUInteger i, BOOL *stop) {
+        if (![[recipient allKeys] count]) {
+            [itemErrors addObject:[ARTErrorInfo createWithCode:0 message:@"Recipient is missing"]];
+            return;
+        }
+        [itemErrors addObject:[NSNull null]];
+        [sentIndexes addObject:@(i)];
+        [items addObject:@{@"recipient": recipient, @"payload": data}];
+    }];
+    if (items.count == 0) {
+        callback(itemErrors, nil);
+        return;
+    }
+
+    NSError *encodeError = nil;
+    NSData *body = [[_rest defaultEncoder] encode:items error:&encodeError];
+    if (encodeError) {
+        callback(nil, [ARTErrorInfo createFromNSError:encodeError]);
+        return;
+    }
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"/push/batch/publish"]];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = body;
+    [request setValue:[[_rest defaultEncoder] mimeType] forHTTPHeaderField:@"Content-Type"];
+
+    [_logger debug:__FILE__ line:__LINE__ message:@"push notification to %lu recipients in one request", (unsigned long)items.count];
+    [_rest executeRequest:request withAuthOption:ARTAuthenticationOn completion:^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
+        id decoded = data.length > 0 && response.MIMEType ? [self->_rest.encoders[response.MIMEType] decode:data error:nil] : nil;
+        NSArray *sentErrors = [ARTPushBatchRequests itemErrorsFromResponse:decoded count:items.count];
+        if (!sentErrors && error) {
+            [self->_logger error:@"%@: push notification to %lu recipients failed (%@)", NSStringFromClass(self.class), (unsigned long)items.count, error.localizedDescription];
+            ARTErrorInfo *errorInfo = [ARTErrorInfo createFromNSError:error];
+            sentErrors = [items artMap:^id(id item) { return errorInfo; }];
+        }
+        [sentIndexes enumerateObjectsUsingBlock:^(NSNumber *index, NSUInteger i, BOOL *stop) {
+            itemErrors[index.unsignedIntegerValue] = sentErrors ? sentErrors[i] : [NSNull null];
+        }];
+        callback(itemErrors, nil);
+    }];
+}
+
 @end
@@ -0,0 +1,34 @@
+#import <Ably/ARTPushBatch.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ARTPushBatchResult ()
+
+- (instancetype)initWithCount:(NSUInteger)count errors:(NSDictionary<NSNumber *, ARTErrorInfo *> *)errors;
+
+@end
+
+/// Reports the outcome of one request of a batch: either an `ARTErrorInfo` or `NSNull` for each of its items, or `nil` and the error of all of them.
+typedef void (^ARTPushBatchRequestCallback)(NSArray *_Nullable itemErrors, ARTErrorInfo *_Nullable error);
+
+/// Sends a request for the items of `range`, calling `callback` once on the client's queue when it's done.
+typedef void (^ARTPushBatchSendBlock)(NSRange range, ARTPushBatchRequestCallback callback);
+
+/**
+ * Splits `count` items into requests of at most `maxItemsPerRequest` items, with at most `maxConcurrentRequests` of them in progress at once, and collects the outcome of each item.
+ *
+ * Must be started, and have its requests complete, on the client's queue. It's kept alive by its requests until the last one is done.
+ */
+@interface ARTPushBatchRequests : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithCount:(NSUInteger)count maxItemsPerRequest:(NSUInteger)maxItemsPerRequest maxConcurrentRequests:(NSUInteger)maxConcurrentRequests send:(ARTPushBatchSendBlock)send;
+
+- (void)start:(ARTPushBatchCallback)callback;
+
+/// The per-item errors of a batch endpoint's response, either an array of results or a `batchResponse` partial failure, with `NSNull` for the items without an error; `nil` if the response doesn't have `count` results.
++ (nullable NSArray *)itemErrorsFromResponse:(nullable id)decoded count:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,56 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTTypes.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Limits applied when a collection of push admin operations is split into requests, such as by `-[ARTPushAdmin publishBatch:data:options:callback:]`.
+ */
+@interface ARTPushBatchOptions : NSObject <NSCopying>
+
+/**
+ * The most items sent in a single request to an endpoint that takes several items. Operations without such an endpoint send one request per item. The default is 100.
+ */
+@property (nonatomic) NSUInteger maxItemsPerRequest;
+
+/**
+ * The most requests of a batch in progress at the same time. The default is 4.
+ */
+@property (nonatomic) NSUInteger maxConcurrentRequests;
+
+@end
+
+/**
+ * The outcome of each item of a batch of push admin operations.
+ */
+@interface ARTPushBatchResult : NSObject
+
+/**
+ * The number of items in the batch.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * The number of items that succeeded.
+ */
+@property (nonatomic, readonly) NSUInteger successCount;
+
+/**
+ * The errors of the items that failed, by their index in the collection passed to the batch operation.
+ */
+@property (nonatomic, readonly) NSDictionary<NSNumber *, ARTErrorInfo *> *errors;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+/**
+ * The error of the item at `index`, or `nil` if it succeeded.
+ */
+- (nullable ARTErrorInfo *)errorAtIndex:(NSUInteger)index;
+
+@end
+
+/// :nodoc:
+typedef void (^ARTPushBatchCallback)(ARTPushBatchResult *result);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,150 @@
+#import "ARTPushBatch+Private.h"
+#import "ARTNSDictionary+ARTDictionaryUtil.h"
+
+@implementation ARTPushBatchOptions
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _maxItemsPerRequest = 100;
+        _maxConcurrentRequests = 4;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    ARTPushBatchOptions *options = [[[self class] allocWithZone:zone] init];
+    options.maxItemsPerRequest = self.maxItemsPerRequest;
+    options.maxConcurrentRequests = self.maxConcurrentRequests;
+    return options;
+}
+
+@end
+
+@implementation ARTPushBatchResult
+
+- (instancetype)initWithCount:(NSUInteger)count errors:(NSDictionary<NSNumber *, ARTErrorInfo *> *)errors {
+    if (self = [super init]) {
+        _count = count;
+        _errors = errors;
+    }
+    return self;
+}
+
+- (NSUInteger)successCount {
+    return _count - _errors.count;
+}
+
+- (ARTErrorInfo *)errorAtIndex:(NSUInteger)index {
+    return _errors[@(index)];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p count: %lu, successCount: %lu, errors: %@>", self.class, self, (unsigned long)_count, (unsigned long)self.successCount, _errors];
+}
+
+@end
+
+@implementation ARTPushBatchRequests {
+    NSUInteger _count;
+    NSUInteger _maxItemsPerRequest;
+    NSUInteger _maxConcurrentRequests;
+    ARTPushBatchSendBlock _send;
+    ARTPushBatchCallback _callback;
+    NSUInteger _nextIndex;
+    NSUInteger _completedCount;
+    NSUInteger _requestsInProgress;
+    // Set while sending, so that requests completing synchronously don't send the next ones recursively.
+    BOOL _sending;
+    NSMutableDictionary<NSNumber *, ARTErrorInfo *> *_errors;
+}
+
+- (instancetype)initWithCount:(NSUInteger)count maxItemsPerRequest:(NSUInteger)maxItemsPerRequest maxConcurrentRequests:(NSUInteger)maxConcurrentRequests send:(ARTPushBatchSendBlock)send {
+    if (self = [super init]) {
+        _count = count;
+        _maxItemsPerRequest = MAX(maxItemsPerRequest, 1);
+        _maxConcurrentRequests = MAX(maxConcurrentRequests, 1);
+        _send = send;
+        _errors = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void)start:(ARTPushBatchCallback)callback {
+    _callback = callback;
+    if (_count == 0) {
+        [self finish];
+        return;
+    }
+    [self sendRequests];
+}
+
+- (void)sendRequests {
+    if (_sending) {
+        return;
+    }
+    _sending = YES;
+    while (_requestsInProgress < _maxConcurrentRequests && _nextIndex < _count) {
+        const NSRange range = NSMakeRange(_nextIndex, MIN(_maxItemsPerRequest, _count - _nextIndex));
+        _nextIndex = NSMaxRange(range);
+        _requestsInProgress++;
+        _send(range, ^(NSArray *itemErrors, ARTErrorInfo *error) {
+            [self completeRange:range itemErrors:itemErrors error:error];
+        });
+    }
+    _sending = NO;
+}
+
+- (void)completeRange:(NSRange)range itemErrors:(NSArray *)itemErrors error:(ARTErrorInfo *)error {
+    for (NSUInteger i = 0; i < range.length; i++) {
+        id itemError = itemErrors.count == range.length ? itemErrors[i] : error;
+        if ([itemError isKindOfClass:[ARTErrorInfo class]]) {
+            _errors[@(range.location + i)] = itemError;
+        }
+    }
+    _requestsInProgress--;
+    _completedCount += range.length;
+
+    if (_completedCount == _count) {
+        [self finish];
+    }
+    else {
+        [self sendRequests];
+    }
+}
+
+- (void)finish {
+    ARTPushBatchCallback callback = _callback;
+    // Releases the blocks retaining this object.
+    _callback = nil;
+    _send = nil;
+    if (callback) {
+        callback([[ARTPushBatchResult alloc] initWithCount:_count errors:[_errors copy]]);
+    }
+}
+
++ (NSArray *)itemErrorsFromResponse:(id)decoded count:(NSUInteger)count {
+    NSArray *results = nil;
+    if ([decoded isKindOfClass:[NSArray class]]) {
+        results = decoded;
+    }
+    else if ([decoded isKindOfClass:[NSDictionary class]]) {
+        results = [decoded artArray:@"batchResponse"];
+    }
+    if (results.count != count) {
+        return nil;
+    }
+
+    NSMutableArray *itemErrors = [NSMutableArray arrayWithCapacity:count];
+    for (NSDictionary *result in results) {
+        NSDictionary *resultError = [result isKindOfClass:[NSDictionary class]] ? [result artDictionary:@"error"] : nil;
+        if (resultError) {
+            [itemErrors addObject:[ARTErrorInfo createWithCode:[resultError artInteger:@"code"] status:[resultError artInteger:@"statusCode"] message:[resultError artString:@"message"] ?: @""]];
+        }
+        else {
+            [itemErrors addObject:[NSNull null]];
+        }
+    }
+    return itemErrors;
+}
+
+@end
@@ -113,7 +113,7 @@ const NSUInteger ARTDefaultLimit = 100;
         };
     }
 
-dispatch_async(_queue, ^{
+[self dispatchWithLoadedDevice:^{
     ARTLocalDevice *device = [self getDevice:callback];
     if (![device isRegistered]) {
         return;
@@ -136,7 +136,7 @@ dispatch_async(_queue, ^{
         }
         if (callback) callback(error ? [ARTErrorInfo createFromNSError:error] : nil);
     }];
-});
+}];
 }
 
 - (void)subscribeClient:(ARTCallback)callback {
@@ -149,7 +149,7 @@ dispatch_async(_queue, ^{
         };
     }
 
-dispatch_async(_queue, ^{
+[self dispatchWithLoadedDevice:^{
     NSString *clientId = [self getClientId:callback];
     if (!clientId) {
         return;
@@ -170,7 +170,7 @@ dispatch_async(_queue, ^{
         }
         if (callback) callback(error ? [ARTErrorInfo createFromNSError:error] : nil);
     }];
-});
+}];
 }
 
 - (void)unsubscribeDevice:(ARTCallback)callback {
@@ -183,7 +183,7 @@ dispatch_async(_queue, ^{
         };
     }
 
-dispatch_async(_queue, ^{
+[self dispatchWithLoadedDevice:^{
     ARTLocalDevice *device = [self getDevice:callback];
     if (![device isRegistered]) {
         return;
@@ -207,7 +207,7 @@ dispatch_async(_queue, ^{
         }
         if (callback) callback(error ? [ARTErrorInfo createFromNSError:error] : nil);
     }];
-});
+}];
 }
 
 - (void)unsubscribeClient:(ARTCallback)callback {
@@ -220,7 +220,7 @@ dispatch_async(_queue, ^{
         };
     }
 
-dispatch_async(_queue, ^{
+[self dispatchWithLoadedDevice:^{
     NSString *clientId = [self getClientId:callback];
     if (!clientId) {
         return;
@@ -242,7 +242,7 @@ dispatch_async(_queue, ^{
         }
         if (callback) callback(error ? [ARTErrorInfo createFromNSError:error] : nil);
     }];
-});
+}];
 }
 
 - (BOOL)listSubscriptions:(NSStringDictionary *)params
@@ -297,6 +297,19 @@ dispatch_sync(_queue, ^{
     return ret;
 }
 
+// Runs `block` on the queue once the local device is loaded, so that loading it doesn't block the queue.
+- (void)dispatchWithLoadedDevice:(dispatch_block_t)block {
+dispatch_async(_queue, ^{
+    #if TARGET_OS_IOS
+    [self->_rest loadDevice_nosync:^(ARTLocalDevice *device) {
+        block();
+    }];
+    #else
+    block();
+    #endif
+});
+}
+
 - (ARTLocalDevice *)getDevice:(ARTCallback)callback {
     #if TARGET_OS_IOS
     ARTLocalDevice *device = [_rest device_nosync];
@@ -1,8 +1,11 @@
 #import <Foundation/Foundation.h>
 #import <Ably/ARTTypes.h>
+#import <Ably/ARTPushBatch.h>
+#import <Ably/ARTPushListOptions.h>
 
 @class ARTPushChannelSubscription;
 @class ARTPaginatedResult;
+@class ARTPaginatedResultIterator<ItemType>;
 @class ARTRest;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -39,6 +42,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)list:(NSStringDictionary *)params callback:(ARTPaginatedPushChannelCallback)callback;
 
+/**
+ * Retrieves all channels with at least one device subscribed to push notifications, as an iterator over their pages that fetches following pages ahead of the caller. A channel name that can't be decoded is skipped instead of failing its page.
+ *
+ * @param options An `ARTPushListOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for retrieving an `ARTPaginatedResultIterator` over channel names, once the first page has been fetched.
+ */
+- (void)iterateChannels:(nullable ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<NSString *> *_Nullable iterator, ARTErrorInfo *_Nullable error))callback;
+
+/**
+ * Retrieves all push channel subscriptions matching the filter `params` provided, as an iterator over their pages that fetches following pages ahead of the caller. Unlike `-[ARTPushChannelSubscriptions list:callback:]`, a subscription that can't be decoded is skipped instead of failing its page.
+ *
+ * @param params An object containing key-value pairs to filter subscriptions by, as for `-[ARTPushChannelSubscriptions list:callback:]`.
+ * @param options An `ARTPushListOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for retrieving an `ARTPaginatedResultIterator` over `ARTPushChannelSubscription` objects, once the first page has been fetched.
+ */
+- (void)iterate:(NSStringDictionary *)params options:(nullable ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<ARTPushChannelSubscription *> *_Nullable iterator, ARTErrorInfo *_Nullable error))callback;
+
 /**
  * Unsubscribes a device, or a group of devices sharing the same `clientId` from receiving push notifications on a channel.
  *
@@ -55,6 +75,24 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)removeWhere:(NSStringDictionary *)params callback:(ARTCallback)callback;
 
+/**
+ * Subscribes each of a collection of devices, or groups of devices sharing the same `clientId`, to push notifications on a channel, with up to `options.maxConcurrentRequests` requests in progress at once.
+ *
+ * @param channelSubscriptions An array of `ARTPushChannelSubscription` objects.
+ * @param options An `ARTPushBatchOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for receiving the outcome of each subscription, by its index in `channelSubscriptions`.
+ */
+- (void)saveBatch:(NSArray<ARTPushChannelSubscription *> *)channelSubscriptions options:(nullable ARTPushBatchOptions *)options callback:(nullable ARTPushBatchCallback)callback;
+
+/**
+ * Unsubscribes each of a collection of devices, or groups of devices sharing the same `clientId`, from receiving push notifications on a channel, with up to `options.maxConcurrentRequests` requests in progress at once.
+ *
+ * @param subscriptions An array of `ARTPushChannelSubscription` objects.
+ * @param options An `ARTPushBatchOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for receiving the outcome of each subscription, by its index in `subscriptions`.
+ */
+- (void)removeBatch:(NSArray<ARTPushChannelSubscription *> *)subscriptions options:(nullable ARTPushBatchOptions *)options callback:(nullable ARTPushBatchCallback)callback;
+
 @end
 
 /**
@@ -9,6 +9,8 @@
 #import "ARTRest+Private.h"
 #import "ARTTypes.h"
 #import "ARTNSMutableRequest+ARTPush.h"
+#import "ARTPushBatch+Private.h"
+#import "ARTPaginatedResultIterator.h"
 
 @implementation ARTPushChannelSubscriptions {
     ARTQueuedDealloc *_dealloc;
@@ -35,6 +37,14 @@
     [_internal list:params callback:callback];
 }
 
+- (void)iterateChannels:(ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<NSString *> *, ARTErrorInfo *))callback {
+    [_internal iterateChannels:options callback:callback];
+}
+
+- (void)iterate:(NSStringDictionary *)params options:(ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<ARTPushChannelSubscription *> *, ARTErrorInfo *))callback {
+    [_internal iterate:params options:options callback:callback];
+}
+
 - (void)remove:(ARTPushChannelSubscription *)subscription callback:(ARTCallback)callback {
     [_internal remove:subscription callback:callback];
 }
@@ -43,6 +53,14 @@
     [_internal removeWhere:params callback:callback];
 }
 
+- (void)saveBatch:(NSArray<ARTPushChannelSubscription *> *)channelSubscriptions options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    [_internal saveBatch:channelSubscriptions options:options callback:callback];
+}
+
+- (void)removeBatch:(NSArray<ARTPushChannelSubscription *> *)subscriptions options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    [_internal removeBatch:subscriptions options:options callback:callback];
+}
+
 @end
 
 @implementation ARTPushChannelSubscriptionsInternal {
@@ -72,40 +90,38 @@
         };
     }
     
-#if TARGET_OS_IOS
-    ARTLocalDevice *local = _rest.device;
-#else
-    ARTLocalDevice *local = nil;
-#endif
+    [_rest dispatchWithLocalDevice:^(ARTLocalDevice *local) {
+        [self _save:channelSubscription localDevice:local callback:callback];
+    }];
+}
+
+- (void)_save:(ARTPushChannelSubscription *)channelSubscription localDevice:(ARTLocalDevice *)local callback:(ARTCallback)callback {
+    NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[NSURL URLWithString:@"/push/channelSubscriptions"] resolvingAgainstBaseURL:NO];
+    if (_rest.options.pushFullWait) {
+        components.queryItems = @[[NSURLQueryItem queryItemWithName:@"fullWait" value:@"true"]];
+    }
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[components URL]];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = [[_rest defaultEncoder] encodePushChannelSubscription:channelSubscription error:nil];
+    [request setValue:[[_rest defaultEncoder] mimeType] forHTTPHeaderField:@"Content-Type"];
+    [request setDeviceAuthentication:channelSubscription.deviceId localDevice:local];
     
-    dispatch_async(_queue, ^{
-        NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[NSURL URLWithString:@"/push/channelSubscriptions"] resolvingAgainstBaseURL:NO];
-        if (self->_rest.options.pushFullWait) {
-            components.queryItems = @[[NSURLQueryItem queryItemWithName:@"fullWait" value:@"true"]];
+    [_logger debug:__FILE__ line:__LINE__ message:@"save channel subscription with request %@", request];
+    [_rest executeRequest:request withAuthOption:ARTAuthenticationOn completion:^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
+        if (response.statusCode == 200 /*Ok*/ || response.statusCode == 201 /*Created*/) {
+            [self->_logger debug:__FILE__ line:__LINE__ message:@"channel subscription saved successfully"];
+            callback(nil);
         }
-        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[components URL]];
-        request.HTTPMethod = @"POST";
-        request.HTTPBody = [[self->_rest defaultEncoder] encodePushChannelSubscription:channelSubscription error:nil];
-        [request setValue:[[self->_rest defaultEncoder] mimeType] forHTTPHeaderField:@"Content-Type"];
-        [request setDeviceAuthentication:channelSubscription.deviceId localDevice:local];
-        
-        [self->_logger debug:__FILE__ line:__LINE__ message:@"save channel subscription with request %@", request];
-        [self->_rest executeRequest:request withAuthOption:ARTAuthenticationOn completion:^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
-            if (response.statusCode == 200 /*Ok*/ || response.statusCode == 201 /*Created*/) {
-                [self->_logger debug:__FILE__ line:__LINE__ message:@"channel subscription saved successfully"];
-                callback(nil);
-            }
-            else if (error) {
-                [self->_logger error:@"%@: save channel subscription failed (%@)", NSStringFromClass(self.class), error.localizedDescription];
-                callback([ARTErrorInfo createFromNSError:error]);
-            }
-            else {
-                [self->_logger error:@"%@: save channel subscription failed with status code %ld", NSStringFromClass(self.class), (long)response.statusCode];
-                NSString *plain = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-                callback([ARTErrorInfo createWithCode:response.statusCode*100 status:response.statusCode message:[plain art_shortString]]);
-            }
-        }];
-    });
+        else if (error) {
+            [self->_logger error:@"%@: save channel subscription failed (%@)", NSStringFromClass(self.class), error.localizedDescription];
+            callback([ARTErrorInfo createFromNSError:error]);
+        }
+        else {
+            [self->_logger error:@"%@: save channel subscription failed with status code %ld", NSStringFromClass(self.class), (long)response.statusCode];
+            NSString *plain = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+            callback([ARTErrorInfo createWithCode:response.statusCode*100 status:response.statusCode message:[plain art_shortString]]);
+        }
+    }];
 }
 
 - (void)listChannels:(ARTPaginatedTextCallback)callback {
@@ -153,6 +169,79 @@
     });
 }
 
+- (void)iterateChannels:(ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<NSString *> *, ARTErrorInfo *))callback {
+    if (callback) {
+        void (^userCallback)(ARTPaginatedResultIterator *, ARTErrorInfo *error) = callback;
+        callback = ^(ARTPaginatedResultIterator *iterator, ARTErrorInfo *error) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(iterator, error);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushListOptions alloc] init];
+    
+    dispatch_async(_queue, ^{
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"/push/channels"]];
+        request.HTTPMethod = @"GET";
+        
+        ARTPaginatedResultResponseProcessor responseProcessor = ^NSArray *(NSHTTPURLResponse *response, NSData *data, NSError **error) {
+            id decoded = [self->_rest.encoders[response.MIMEType] decode:data error:error];
+            if (!decoded) {
+                return nil;
+            }
+            if (![decoded isKindOfClass:[NSArray class]]) {
+                if (error) {
+                    *error = [NSError errorWithDomain:ARTAblyErrorDomain
+                                                 code:ARTErrorUnableToDecodeMessage
+                                             userInfo:@{NSLocalizedDescriptionKey: @"expected an array of channel names"}];
+                }
+                return nil;
+            }
+            NSArray<NSString *> *channels = [(NSArray *)decoded artFilter:^BOOL(id item) {
+                return [item isKindOfClass:[NSString class]];
+            }];
+            if (channels.count < [decoded count]) {
+                [self->_logger warn:@"%@: skipped %lu channel names that couldn't be decoded", NSStringFromClass(self.class), (unsigned long)([decoded count] - channels.count)];
+            }
+            return channels;
+        };
+        [ARTPaginatedResult executePaginated:self->_rest withRequest:request andResponseProcessor:responseProcessor callback:^(ARTPaginatedResult *result, ARTErrorInfo *error) {
+            if (callback) callback([result iteratorWithPrefetchLimit:options.prefetchLimit], error);
+        }];
+    });
+}
+
+- (void)iterate:(NSStringDictionary *)params options:(ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<ARTPushChannelSubscription *> *, ARTErrorInfo *))callback {
+    if (callback) {
+        void (^userCallback)(ARTPaginatedResultIterator *, ARTErrorInfo *error) = callback;
+        callback = ^(ARTPaginatedResultIterator *iterator, ARTErrorInfo *error) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(iterator, error);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushListOptions alloc] init];
+    
+    dispatch_async(_queue, ^{
+        NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[NSURL URLWithString:@"/push/channelSubscriptions"] resolvingAgainstBaseURL:NO];
+        components.queryItems = [params art_asURLQueryItems];
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[components URL]];
+        request.HTTPMethod = @"GET";
+        
+        ARTPaginatedResultResponseProcessor responseProcessor = ^(NSHTTPURLResponse *response, NSData *data, NSError **error) {
+            NSUInteger invalidCount = 0;
+            NSArray<ARTPushChannelSubscription *> *subscriptions = [self->_rest.encoders[response.MIMEType] decodePushChannelSubscriptions:data invalidCount:&invalidCount error:error];
+            if (invalidCount > 0) {
+                [self->_logger warn:@"%@: skipped %lu channel subscriptions that couldn't be decoded", NSStringFromClass(self.class), (unsigned long)invalidCount];
+            }
+            return subscriptions;
+        };
+        [ARTPaginatedResult executePaginated:self->_rest withRequest:request andResponseProcessor:responseProcessor callback:^(ARTPaginatedResult *result, ARTErrorInfo *error) {
+            if (callback) callback([result iteratorWithPrefetchLimit:options.prefetchLimit], error);
+        }];
+    });
+}
+
 - (void)remove:(ARTPushChannelSubscription *)subscription callback:(ARTCallback)callback {
     if (callback) {
         ARTCallback userCallback = callback;
@@ -164,21 +253,25 @@
     }
     
     dispatch_async(_queue, ^{
-        if ((subscription.deviceId && subscription.clientId) || (!subscription.deviceId && !subscription.clientId)) {
-            callback([ARTErrorInfo createWithCode:0 message:@"ARTChannelSubscription cannot be for both a deviceId and a clientId"]);
-            return;
-        }
-        NSMutableDictionary *where = [[NSMutableDictionary alloc] init];
-        where[@"channel"] = subscription.channel;
-        if (subscription.deviceId) {
-            where[@"deviceId"] = subscription.deviceId;
-        } else {
-            where[@"clientId"] = subscription.clientId;
-        }
-        [self _removeWhere:where callback:callback];
+        [self _remove:subscription callback:callback];
     });
 }
 
+- (void)_remove:(ARTPushChannelSubscription *)subscription callback:(ARTCallback)callback {
+    if ((subscription.deviceId && subscription.clientId) || (!subscription.deviceId && !subscription.clientId)) {
+        callback([ARTErrorInfo createWithCode:0 message:@"ARTChannelSubscription cannot be for both a deviceId and a clientId"]);
+        return;
+    }
+    NSMutableDictionary *where = [[NSMutableDictionary alloc] init];
+    where[@"channel"] = subscription.channel;
+    if (subscription.deviceId) {
+        where[@"deviceId"] = subscription.deviceId;
+    } else {
+        where[@"clientId"] = subscription.clientId;
+    }
+    [self _removeWhere:where callback:callback];
+}
+
 - (void)removeWhere:(NSStringDictionary *)params callback:(ARTCallback)callback {
     if (callback) {
         ARTCallback userCallback = callback;
@@ -194,7 +287,66 @@
     });
 }
 
+- (void)saveBatch:(NSArray<ARTPushChannelSubscription *> *)channelSubscriptions options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    if (callback) {
+        ARTPushBatchCallback userCallback = callback;
+        callback = ^(ARTPushBatchResult *result) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(result);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushBatchOptions alloc] init];
+    
+    [_rest dispatchWithLocalDevice:^(ARTLocalDevice *local) {
+        [self->_logger debug:__FILE__ line:__LINE__ message:@"save %lu channel subscriptions", (unsigned long)channelSubscriptions.count];
+        // There's no endpoint saving several subscriptions, so each is saved by its own request.
+        ARTPushBatchRequests *requests = [[ARTPushBatchRequests alloc] initWithCount:channelSubscriptions.count maxItemsPerRequest:1 maxConcurrentRequests:options.maxConcurrentRequests send:^(NSRange range, ARTPushBatchRequestCallback requestCallback) {
+            [self _save:channelSubscriptions[range.location] localDevice:local callback:^(ARTErrorInfo *error) {
+                requestCallback(nil, error);
+            }];
+        }];
+        [requests start:^(ARTPushBatchResult *result) {
+            if (callback) callback(result);
+        }];
+    }];
+}
+
+- (void)removeBatch:(NSArray<ARTPushChannelSubscription *> *)subscriptions options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    if (callback) {
+        ARTPushBatchCallback userCallback = callback;
+        callback = ^(ARTPushBatchResult *result) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(result);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushBatchOptions alloc] init];
+    
+    dispatch_async(_queue, ^{
+        [self->_logger debug:__FILE__ line:__LINE__ message:@"remove %lu channel subscriptions", (unsigned long)subscriptions.count];
+        ARTPushBatchRequests *requests = [[ARTPushBatchRequests alloc] initWithCount:subscriptions.count maxItemsPerRequest:1 maxConcurrentRequests:options.maxConcurrentRequests send:^(NSRange range, ARTPushBatchRequestCallback requestCallback) {
+            [self _remove:subscriptions[range.location] callback:^(ARTErrorInfo *error) {
+                requestCallback(nil, error);
+            }];
+        }];
+        [requests start:^(ARTPushBatchResult *result) {
+            if (callback) callback(result);
+        }];
+    });
+}
+
 - (void)_removeWhere:(NSStringDictionary *)params callback:(ARTCallback)callback {
+#if TARGET_OS_IOS
+    [_rest loadDevice_nosync:^(ARTLocalDevice *local) {
+        [self _removeWhere:params localDevice:local callback:callback];
+    }];
+#else
+    [self _removeWhere:params localDevice:nil callback:callback];
+#endif
+}
+
+- (void)_removeWhere:(NSStringDictionary *)params localDevice:(ARTLocalDevice *)local callback:(ARTCallback)callback {
     NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[NSURL URLWithString:@"/push/channelSubscriptions"] resolvingAgainstBaseURL:NO];
     components.queryItems = [params art_asURLQueryItems];
     if (_rest.options.pushFullWait) {
@@ -203,7 +355,7 @@
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[components URL]];
     request.HTTPMethod = @"DELETE";
 #if TARGET_OS_IOS
-    [request setDeviceAuthentication:[params objectForKey:@"deviceId"] localDevice:_rest.device_nosync];
+    [request setDeviceAuthentication:[params objectForKey:@"deviceId"] localDevice:local];
 #endif
     
     [_logger debug:__FILE__ line:__LINE__ message:@"remove channel subscription with request %@", request];
@@ -1,8 +1,11 @@
 #import <Foundation/Foundation.h>
 #import <Ably/ARTTypes.h>
+#import <Ably/ARTPushBatch.h>
+#import <Ably/ARTPushListOptions.h>
 
 @class ARTDeviceDetails;
 @class ARTPaginatedResult;
+@class ARTPaginatedResultIterator<ItemType>;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -38,6 +41,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)list:(NSStringDictionary *)params callback:(ARTPaginatedDeviceDetailsCallback)callback;
 
+/**
+ * Retrieves all devices matching the filter `params` provided, as an iterator over their pages that fetches following pages ahead of the caller. Unlike `-[ARTPushDeviceRegistrations list:callback:]`, a device that can't be decoded is skipped instead of failing its page.
+ *
+ * @param params An object containing key-value pairs to filter devices by, as for `-[ARTPushDeviceRegistrations list:callback:]`.
+ * @param options An `ARTPushListOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for retrieving an `ARTPaginatedResultIterator` over `ARTDeviceDetails` objects, once the first page has been fetched.
+ */
+- (void)iterate:(NSStringDictionary *)params options:(nullable ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<ARTDeviceDetails *> *_Nullable iterator, ARTErrorInfo *_Nullable error))callback;
+
 /**
  * Removes a device registered to receive push notifications from Ably using its `deviceId`.
  *
@@ -54,6 +66,24 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)removeWhere:(NSStringDictionary *)params callback:(ARTCallback)callback;
 
+/**
+ * Registers or updates each of a collection of `ARTDeviceDetails` objects with Ably, with up to `options.maxConcurrentRequests` requests in progress at once.
+ *
+ * @param devicesDetails An array of `ARTDeviceDetails` objects to create or update.
+ * @param options An `ARTPushBatchOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for receiving the outcome of each device, by its index in `devicesDetails`.
+ */
+- (void)saveBatch:(NSArray<ARTDeviceDetails *> *)devicesDetails options:(nullable ARTPushBatchOptions *)options callback:(nullable ARTPushBatchCallback)callback;
+
+/**
+ * Removes each of a collection of devices registered to receive push notifications from Ably, with up to `options.maxConcurrentRequests` requests in progress at once.
+ *
+ * @param deviceIds An array of unique device IDs.
+ * @param options An `ARTPushBatchOptions` object, or `nil` to use the defaults.
+ * @param callback A callback for receiving the outcome of each device, by its index in `deviceIds`.
+ */
+- (void)removeBatch:(NSArray<NSString *> *)deviceIds options:(nullable ARTPushBatchOptions *)options callback:(nullable ARTPushBatchCallback)callback;
+
 @end
 
 /**
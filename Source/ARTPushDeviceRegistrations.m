@@ -10,6 +10,8 @@
 #import "ARTRest+Private.h"
 #import "ARTLocalDevice.h"
 #import "ARTNSMutableRequest+ARTPush.h"
+#import "ARTPushBatch+Private.h"
+#import "ARTPaginatedResultIterator.h"
 
 @implementation ARTPushDeviceRegistrations {
     ARTQueuedDealloc *_dealloc;
@@ -36,6 +38,10 @@
     [_internal list:params callback:callback];
 }
 
+- (void)iterate:(NSStringDictionary *)params options:(ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<ARTDeviceDetails *> *, ARTErrorInfo *))callback {
+    [_internal iterate:params options:options callback:callback];
+}
+
 - (void)remove:(NSString *)deviceId callback:(ARTCallback)callback {
     [_internal remove:deviceId callback:callback];
 }
@@ -44,6 +50,14 @@
     [_internal removeWhere:params callback:callback];
 }
 
+- (void)saveBatch:(NSArray<ARTDeviceDetails *> *)devicesDetails options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    [_internal saveBatch:devicesDetails options:options callback:callback];
+}
+
+- (void)removeBatch:(NSArray<NSString *> *)deviceIds options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    [_internal removeBatch:deviceIds options:options callback:callback];
+}
+
 @end
 
 @implementation ARTPushDeviceRegistrationsInternal {
@@ -73,13 +87,12 @@
         };
     }
 
-    #if TARGET_OS_IOS
-    ARTLocalDevice *local = _rest.device;
-    #else
-    ARTLocalDevice *local = nil;
-    #endif
+[_rest dispatchWithLocalDevice:^(ARTLocalDevice *local) {
+    [self _save:deviceDetails localDevice:local callback:callback];
+}];
+}
 
-dispatch_async(_queue, ^{
+- (void)_save:(ARTDeviceDetails *)deviceDetails localDevice:(ARTLocalDevice *)local callback:(ARTCallback)callback {
     NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[[NSURL URLWithString:@"/push/deviceRegistrations"] URLByAppendingPathComponent:deviceDetails.id] resolvingAgainstBaseURL:NO];
     if (self->_rest.options.pushFullWait) {
         components.queryItems = @[[NSURLQueryItem queryItemWithName:@"fullWait" value:@"true"]];
@@ -114,7 +127,6 @@ dispatch_async(_queue, ^{
             callback([ARTErrorInfo createWithCode:response.statusCode*100 status:response.statusCode message:[plain art_shortString]]);
         }
     }];
-});
 }
 
 - (void)get:(ARTDeviceId *)deviceId callback:(void (^)(ARTDeviceDetails *, ARTErrorInfo *))callback {
@@ -127,13 +139,7 @@ dispatch_async(_queue, ^{
         };
     }
 
-    #if TARGET_OS_IOS
-    ARTLocalDevice *local = _rest.device;
-    #else
-    ARTLocalDevice *local = nil;
-    #endif
-
-dispatch_async(_queue, ^{
+[_rest dispatchWithLocalDevice:^(ARTLocalDevice *local) {
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[[NSURL URLWithString:@"/push/deviceRegistrations"] URLByAppendingPathComponent:deviceId]];
     request.HTTPMethod = @"GET";
     [request setDeviceAuthentication:deviceId localDevice:local logger:self->_logger];
@@ -166,7 +172,7 @@ dispatch_async(_queue, ^{
             callback(nil, [ARTErrorInfo createWithCode:response.statusCode*100 status:response.statusCode message:[plain art_shortString]]);
         }
     }];
-});
+}];
 }
 
 - (void)list:(NSStringDictionary *)params callback:(ARTPaginatedDeviceDetailsCallback)callback {
@@ -192,6 +198,38 @@ dispatch_async(_queue, ^{
 });
 }
 
+- (void)iterate:(NSStringDictionary *)params options:(ARTPushListOptions *)options callback:(void (^)(ARTPaginatedResultIterator<ARTDeviceDetails *> *, ARTErrorInfo *))callback {
+    if (callback) {
+        void (^userCallback)(ARTPaginatedResultIterator *, ARTErrorInfo *error) = callback;
+        callback = ^(ARTPaginatedResultIterator *iterator, ARTErrorInfo *error) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(iterator, error);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushListOptions alloc] init];
+    NSSet<NSString *> *fields = options.fields ? [NSSet setWithArray:options.fields] : nil;
+
+dispatch_async(_queue, ^{
+    NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[NSURL URLWithString:@"/push/deviceRegistrations"] resolvingAgainstBaseURL:NO];
+    components.queryItems = [params art_asURLQueryItems];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[components URL]];
+    request.HTTPMethod = @"GET";
+
+    ARTPaginatedResultResponseProcessor responseProcessor = ^(NSHTTPURLResponse *response, NSData *data, NSError **error) {
+        NSUInteger invalidCount = 0;
+        NSArray<ARTDeviceDetails *> *devices = [self->_rest.encoders[response.MIMEType] decodeDevicesDetails:data fields:fields invalidCount:&invalidCount error:error];
+        if (invalidCount > 0) {
+            [self->_logger warn:@"%@: skipped %lu devices that couldn't be decoded", NSStringFromClass(self.class), (unsigned long)invalidCount];
+        }
+        return devices;
+    };
+    [ARTPaginatedResult executePaginated:self->_rest withRequest:request andResponseProcessor:responseProcessor callback:^(ARTPaginatedResult *result, ARTErrorInfo *error) {
+        if (callback) callback([result iteratorWithPrefetchLimit:options.prefetchLimit], error);
+    }];
+});
+}
+
 - (void)remove:(NSString *)deviceId callback:(ARTCallback)callback {
     if (callback) {
         ARTCallback userCallback = callback;
@@ -203,6 +241,11 @@ dispatch_async(_queue, ^{
     }
 
 dispatch_async(_queue, ^{
+    [self _remove:deviceId callback:callback];
+});
+}
+
+- (void)_remove:(NSString *)deviceId callback:(ARTCallback)callback {
     NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[[NSURL URLWithString:@"/push/deviceRegistrations"] URLByAppendingPathComponent:deviceId] resolvingAgainstBaseURL:NO];
         if (self->_rest.options.pushFullWait) {
         components.queryItems = @[[NSURLQueryItem queryItemWithName:@"fullWait" value:@"true"]];
@@ -227,6 +270,54 @@ dispatch_async(_queue, ^{
             callback([ARTErrorInfo createWithCode:response.statusCode*100 status:response.statusCode message:[plain art_shortString]]);
         }
     }];
+}
+
+- (void)saveBatch:(NSArray<ARTDeviceDetails *> *)devicesDetails options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    if (callback) {
+        ARTPushBatchCallback userCallback = callback;
+        callback = ^(ARTPushBatchResult *result) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(result);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushBatchOptions alloc] init];
+
+[_rest dispatchWithLocalDevice:^(ARTLocalDevice *local) {
+    [self->_logger debug:__FILE__ line:__LINE__ message:@"save %lu devices", (unsigned long)devicesDetails.count];
+    // There's no endpoint saving several devices, so each is saved by its own request.
+    ARTPushBatchRequests *requests = [[ARTPushBatchRequests alloc] initWithCount:devicesDetails.count maxItemsPerRequest:1 maxConcurrentRequests:options.maxConcurrentRequests send:^(NSRange range, ARTPushBatchRequestCallback requestCallback) {
+        [self _save:devicesDetails[range.location] localDevice:local callback:^(ARTErrorInfo *error) {
+            requestCallback(nil, error);
+        }];
+    }];
+    [requests start:^(ARTPushBatchResult *result) {
+        if (callback) callback(result);
+    }];
+}];
+}
+
+- (void)removeBatch:(NSArray<NSString *> *)deviceIds options:(ARTPushBatchOptions *)options callback:(ARTPushBatchCallback)callback {
+    if (callback) {
+        ARTPushBatchCallback userCallback = callback;
+        callback = ^(ARTPushBatchResult *result) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(result);
+            });
+        };
+    }
+    options = options ? [options copy] : [[ARTPushBatchOptions alloc] init];
+
+dispatch_async(_queue, ^{
+    [self->_logger debug:__FILE__ line:__LINE__ message:@"remove %lu devices", (unsigned long)deviceIds.count];
+    ARTPushBatchRequests *requests = [[ARTPushBatchRequests alloc] initWithCount:deviceIds.count maxItemsPerRequest:1 maxConcurrentRequests:options.maxConcurrentRequests send:^(NSRange range, ARTPushBatchRequestCallback requestCallback) {
+        [self _remove:deviceIds[range.location] callback:^(ARTErrorInfo *error) {
+            requestCallback(nil, error);
+        }];
+    }];
+    [requests start:^(ARTPushBatchResult *result) {
+        if (callback) callback(result);
+    }];
 });
 }
 
@@ -240,13 +331,7 @@ dispatch_async(_queue, ^{
         };
     }
 
-    #if TARGET_OS_IOS
-    ARTLocalDevice *local = _rest.device;
-    #else
-    ARTLocalDevice *local = nil;
-    #endif
-
-dispatch_async(_queue, ^{
+[_rest dispatchWithLocalDevice:^(ARTLocalDevice *local) {
     NSURLComponents *components = [[NSURLComponents alloc] initWithURL:[NSURL URLWithString:@"/push/deviceRegistrations"] resolvingAgainstBaseURL:NO];
     components.queryItems = [params art_asURLQueryItems];
     if (self->_rest.options.pushFullWait) {
@@ -272,7 +357,7 @@ dispatch_async(_queue, ^{
             callback([ARTErrorInfo createWithCode:response.statusCode*100 status:response.statusCode message:[plain art_shortString]]);
         }
     }];
-});
+}];
 }
 
 @end
@@ -0,0 +1,24 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Options for iterating over push device registrations or channel subscriptions, such as with `-[ARTPushDeviceRegistrations iterate:options:callback:]`.
+ *
+ * Items the iterator can't decode are skipped and logged, instead of failing the page they're in.
+ */
+@interface ARTPushListOptions : NSObject <NSCopying>
+
+/**
+ * The maximum number of pages fetched ahead of the caller, as for `-[ARTPaginatedResult iteratorWithPrefetchLimit:]`. The default is 2.
+ */
+@property (nonatomic) NSUInteger prefetchLimit;
+
+/**
+ * The names of the `ARTDeviceDetails` properties to decode, such as `clientId` or `push`; the others are left to their default values. A device's `id` is always decoded. Ignored for channel subscriptions. The default is `nil`, which decodes all of them.
+ */
+@property (nullable, nonatomic, copy) NSArray<NSString *> *fields;
+
+@end
+
+NS_ASSUME_NONNULL_END
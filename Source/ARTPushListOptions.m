@@ -0,0 +1,19 @@
+#import "ARTPushListOptions.h"
+
+@implementation ARTPushListOptions
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _prefetchLimit = 2;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    ARTPushListOptions *options = [[[self class] allocWithZone:zone] init];
+    options.prefetchLimit = self.prefetchLimit;
+    options.fields = self.fields;
+    return options;
+}
+
+@end
@@ -15,6 +15,8 @@
 @class ARTProtocolMessage;
 @class ARTConnectionInternal;
 @class ARTRealtimeChannelsInternal;
+@class ARTClientMemoryFootprint;
+@class ARTStringInterner;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -40,6 +42,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly, nonatomic) dispatch_queue_t queue;
 
+/// Shared by the presence sets of all channels when `ClientOptions.compactPresenceMembers` is set, nil otherwise.
+@property (readonly, nonatomic, nullable) ARTStringInterner *presenceStringInterner;
+
+/// The concurrent queue that the inbound queues of all channels target when `ClientOptions.decodeChannelMessagesConcurrently` is set, nil otherwise.
+@property (readonly, nonatomic, nullable) dispatch_queue_t channelInboundQueue;
+
+- (ARTClientMemoryFootprint *)memoryFootprint;
+- (ARTClientMemoryFootprint *)memoryFootprint_nosync;
+
 @end
 
 @interface ARTRealtimeInternal () <ARTRealtimeTransportDelegate, ARTAuthDelegate>
@@ -22,6 +22,8 @@
 @class ARTPush;
 @class ARTProtocolMessage;
 @class ARTRealtimeChannels;
+@class ARTClientMetrics;
+@class ARTClientMemoryFootprint;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -126,6 +128,27 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (readonly) ARTAuth *auth;
 
+/**
+ * Takes a snapshot of the client's metrics, such as frames and bytes sent and received, decode times and acknowledgement latency.
+ *
+ * @return An `ARTClientMetrics` object.
+ */
+- (ARTClientMetrics *)metrics;
+
+/**
+ * Estimates the memory held by the client, such as queued and unacknowledged messages, captured log lines and, for each channel, its presence set, delta base and listeners.
+ *
+ * @return An `ARTClientMemoryFootprint` object.
+ */
+- (ARTClientMemoryFootprint *)memoryFootprint;
+
+/**
+ * Exports the timings of the publishes sampled with `ARTClientOptions.publishTraceSampleRate`, from `publish` through encoding, the internal queue, serialization, framing and the socket write to acknowledgement.
+ *
+ * @return A JSON object in the Chrome trace event format, with a row per publish, or `nil` if tracing is disabled.
+ */
+- (nullable NSData *)publishTraceEvents;
+
 /// :nodoc:
 + (instancetype)createWithOptions:(ARTClientOptions *)options NS_SWIFT_UNAVAILABLE("Use instance initializer instead");
 
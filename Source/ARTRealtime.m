@@ -23,7 +23,11 @@
 #import "ARTProtocolMessage+Private.h"
 #import "ARTEventEmitter+Private.h"
 #import "ARTQueuedMessage.h"
-#import "ARTPendingMessage.h"
+#import "ARTPendingMessage+Private.h"
+#import "ARTMetricsRegistry.h"
+#import "ARTMemoryFootprint+Private.h"
+#import "ARTPublishTracer.h"
+#import "ARTStringInterner.h"
 #import "ARTConnection+Private.h"
 #import "ARTConnectionDetails.h"
 #import "ARTStats.h"
@@ -75,9 +79,24 @@
 }
 
 - (ARTPush *)push {
+#if TARGET_OS_IOS
+    [_internal.rest startLoadingDevice];
+#endif
     return [[ARTPush alloc] initWithInternal:_internal.push queuedDealloc:_dealloc];
 }
 
+- (ARTClientMetrics *)metrics {
+    return [_internal.rest metrics];
+}
+
+- (ARTClientMemoryFootprint *)memoryFootprint {
+    return [_internal memoryFootprint];
+}
+
+- (NSData *)publishTraceEvents {
+    return [_internal.rest.publishTracer chromeTraceEventJSON];
+}
+
 #if TARGET_OS_IOS
 - (ARTLocalDevice *)device {
     return _internal.device;
@@ -174,6 +193,11 @@
     ARTScheduledBlockHandle *_authenitcatingTimeoutWork;
     NSObject<ARTCancellable> *_authTask;
     ARTScheduledBlockHandle *_idleTimer;
+    // Publishes held while connected, at most one bundle per channel, in the order the bundles were started.
+    NSMutableArray<ARTQueuedMessage *> *_coalescedMessages;
+    ARTScheduledBlockHandle *_coalescingTimer;
+    // Estimated bytes of `queuedMessages`, kept only when `ClientOptions.maxQueuedMessagesBytes` is set.
+    NSUInteger _queuedMessagesBytes;
     dispatch_queue_t _userQueue;
     dispatch_queue_t _queue;
 }
@@ -189,12 +213,17 @@
         _internalEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_rest.queue];
         _connectedEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_rest.queue];
         _pingEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_rest.queue];
+        _presenceStringInterner = options.compactPresenceMembers ? [[ARTStringInterner alloc] init] : nil;
+        if (options.decodeChannelMessagesConcurrently) {
+            _channelInboundQueue = dispatch_queue_create("io.ably.channels.inbound", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT, QOS_CLASS_UTILITY, 0));
+        }
         _channels = [[ARTRealtimeChannelsInternal alloc] initWithRealtime:self];
         _transport = nil;
         _transportClass = [ARTWebSocketTransport class];
         _reachabilityClass = [ARTOSReachability class];
         _msgSerial = 0;
         _queuedMessages = [NSMutableArray array];
+        _coalescedMessages = [NSMutableArray array];
         _pendingMessages = [NSMutableArray array];
         _pendingMessageStartSerial = 0;
         _pendingAuthorizations = [NSMutableArray array];
@@ -393,6 +422,10 @@
 
 - (void)close {
     dispatch_sync(_queue, ^{
+        // Publishes submitted before closing are sent before the CLOSE message.
+        for (ARTRealtimeChannelInternal *channel in self.channels.nosyncIterable) {
+            [channel flushPublishSubmissions_nosync];
+        }
         [self _close];
     });
 }
@@ -472,6 +505,52 @@
     return [self.rest stats:query callback:callback error:errorPtr];
 }
 
+- (ARTClientMemoryFootprint *)memoryFootprint {
+    __block ARTClientMemoryFootprint *footprint;
+dispatch_sync(_queue, ^{
+    footprint = [self memoryFootprint_nosync];
+});
+    return footprint;
+}
+
+static NSUInteger ARTMemoryFootprintOfQueuedMessages(NSArray<ARTQueuedMessage *> *queuedMessages) {
+    NSUInteger bytes = 0;
+    for (ARTQueuedMessage *queuedMessage in queuedMessages) {
+        bytes += ARTMemoryFootprintOfProtocolMessage(queuedMessage.msg);
+    }
+    return bytes;
+}
+
+- (ARTClientMemoryFootprint *)memoryFootprint_nosync {
+    ARTClientMemoryFootprint *footprint = [[ARTClientMemoryFootprint alloc] initWithTimestamp:[NSDate date]];
+
+    footprint.queuedMessages = self.queuedMessages.count;
+    footprint.queuedMessagesBytes = ARTMemoryFootprintOfQueuedMessages(self.queuedMessages);
+
+    NSUInteger pendingMessagesBytes = 0;
+    for (ARTPendingMessage *pendingMessage in self.pendingMessages) {
+        pendingMessagesBytes += ARTMemoryFootprintOfProtocolMessage(pendingMessage.msg);
+    }
+    footprint.pendingMessages = self.pendingMessages.count;
+    footprint.pendingMessagesBytes = pendingMessagesBytes;
+
+    [self.logger fillMemoryFootprint:footprint];
+    footprint.connectionListeners = self.connection.eventEmitter.listenerCount;
+
+    NSMutableArray<ARTChannelMemoryFootprint *> *channels = [NSMutableArray array];
+    NSUInteger retainedDeltaBases = 0;
+    for (ARTRealtimeChannelInternal *channel in self.channels.nosyncIterable) {
+        ARTChannelMemoryFootprint *channelFootprint = [channel memoryFootprint_nosync];
+        if (channelFootprint.deltaBaseBytes > 0) {
+            retainedDeltaBases++;
+        }
+        [channels addObject:channelFootprint];
+    }
+    footprint.channels = channels;
+    footprint.retainedDeltaBases = retainedDeltaBases;
+    return footprint;
+}
+
 - (void)transition:(ARTRealtimeConnectionState)state {
     [self transition:state withErrorInfo:nil];
 }
@@ -479,7 +558,15 @@
 - (void)transition:(ARTRealtimeConnectionState)state withErrorInfo:(ARTErrorInfo *)errorInfo {
     [self.logger verbose:__FILE__ line:__LINE__ message:@"R:%p realtime state transitions to %tu - %@", self, state, ARTRealtimeConnectionStateToStr(state)];
     
+    if (state != ARTRealtimeConnected) {
+        // The transport is being left, so bundled publishes wait for the next connection with the other queued messages.
+        [self queueCoalescedMessages];
+    }
+
     ARTConnectionStateChange *stateChange = [[ARTConnectionStateChange alloc] initWithCurrent:state previous:self.connection.state_nosync event:(ARTRealtimeConnectionEvent)state reason:errorInfo retryIn:0];
+    if (state == ARTRealtimeConnecting && (stateChange.previous == ARTRealtimeDisconnected || stateChange.previous == ARTRealtimeSuspended)) {
+        [self.rest.metricsRegistry increment:ARTMetricsCounterReconnects by:1];
+    }
     [self.connection setState:state];
     [self.connection setErrorReason:errorInfo];
     
@@ -1159,14 +1246,19 @@
         if (ackCallback) ackCallback([ARTStatus state:ARTStateError info:e]);
         return;
     }
+    [self.rest.publishTracer record:ARTPublishTraceStageSerialized messages:pm.messages];
     
+    ARTPendingMessage *pendingMessage = nil;
     if (pm.ackRequired) {
         self.msgSerial++;
-        ARTPendingMessage *pendingMessage = [[ARTPendingMessage alloc] initWithProtocolMessage:pm ackCallback:ackCallback];
+        pendingMessage = [[ARTPendingMessage alloc] initWithProtocolMessage:pm ackCallback:ackCallback];
         [self.pendingMessages addObject:pendingMessage];
     }
     
     [self.logger debug:__FILE__ line:__LINE__ message:@"RT:%p sending action %tu - %@", self, pm.action, ARTProtocolMessageActionToStr(pm.action)];
+    // Stamped here rather than when the message was published or queued, so that the ACK latency leaves out time spent
+    // waiting for a connection; a resent message is written again through here and stamped again.
+    pendingMessage.sentAt = ARTMetricsNow();
     if ([self.transport send:data withSource:pm]) {
         if (sentCallback) sentCallback(nil);
         // `ackCallback()` is called with ACK/NACK action
@@ -1175,19 +1267,16 @@
 
 - (void)send:(ARTProtocolMessage *)msg sentCallback:(ARTCallback)sentCallback ackCallback:(ARTStatusCallback)ackCallback {
     if ([self shouldSendEvents]) {
+        if (self.options.realtimePublishCoalescingDelay > 0 && msg.action == ARTProtocolMessageMessage) {
+            [self coalesce:msg sentCallback:sentCallback ackCallback:ackCallback];
+            return;
+        }
+        // Anything else must not overtake messages waiting to be bundled.
+        [self sendCoalescedMessages];
         [self sendImpl:msg sentCallback:sentCallback ackCallback:ackCallback];
     }
     else if ([self shouldQueueEvents]) {
-        ARTQueuedMessage *lastQueuedMessage = self.queuedMessages.lastObject; //RTL6d5
-        BOOL merged = [lastQueuedMessage mergeFrom:msg sentCallback:nil ackCallback:ackCallback];
-        if (!merged) {
-            ARTQueuedMessage *qm = [[ARTQueuedMessage alloc] initWithProtocolMessage:msg sentCallback:nil ackCallback:ackCallback];
-            [self.queuedMessages addObject:qm];
-            [self.logger debug:__FILE__ line:__LINE__ message:@"RT:%p (channel: %@) protocol message with action '%lu - %@' has been queued (%@)", self, msg.channel, (unsigned long)msg.action, ARTProtocolMessageActionToStr(msg.action), msg.messages];
-        }
-        else {
-            [self.logger verbose:__FILE__ line:__LINE__ message:@"RT:%p (channel: %@) message %@ has been bundled to %@", self, msg.channel, msg, lastQueuedMessage.msg];
-        }
+        [self enqueue:msg sentCallback:nil ackCallback:ackCallback];
     }
     else if (ackCallback) {
         ARTErrorInfo *error = self.connection.errorReason_nosync;
@@ -1196,6 +1285,118 @@
     }
 }
 
+/// The size of `messages` as `ConnectionDetails.maxMessageSize` counts it (TO3l8).
+static NSUInteger ARTMessagesSize(NSArray<ARTMessage *> *messages) {
+    NSUInteger size = 0;
+    for (ARTMessage *message in messages) {
+        size += [message messageSize];
+    }
+    return size;
+}
+
+- (void)enqueue:(ARTProtocolMessage *)msg sentCallback:(ARTCallback)sentCallback ackCallback:(ARTStatusCallback)ackCallback {
+    ARTQueuedMessage *lastQueuedMessage = self.queuedMessages.lastObject; //RTL6d5
+    // Merging adds the messages of `msg` to the last queued message, without the protocol message itself.
+    BOOL merges = self.options.maxQueuedMessagesBytes > 0 && [[lastQueuedMessage.msg copy] mergeFrom:msg];
+    if (![self reserveQueuedBytesFor:msg merging:merges]) {
+        if (ackCallback) {
+            ARTErrorInfo *error = [ARTErrorInfo createWithCode:ARTStatePublishQueueFull message:[NSString stringWithFormat:@"queued messages would exceed %lu bytes", (unsigned long)self.options.maxQueuedMessagesBytes]];
+            ackCallback([ARTStatus state:ARTStateError info:error]);
+        }
+        return;
+    }
+    BOOL merged = [lastQueuedMessage mergeFrom:msg sentCallback:sentCallback ackCallback:ackCallback];
+    if (!merged) {
+        ARTQueuedMessage *qm = [[ARTQueuedMessage alloc] initWithProtocolMessage:msg sentCallback:sentCallback ackCallback:ackCallback];
+        [self.queuedMessages addObject:qm];
+        [self.logger debug:__FILE__ line:__LINE__ message:@"RT:%p (channel: %@) protocol message with action '%lu - %@' has been queued (%@)", self, msg.channel, (unsigned long)msg.action, ARTProtocolMessageActionToStr(msg.action), msg.messages];
+    }
+    else {
+        [self.logger verbose:__FILE__ line:__LINE__ message:@"RT:%p (channel: %@) message %@ has been bundled to %@", self, msg.channel, msg, lastQueuedMessage.msg];
+    }
+}
+
+/// Accounts for `msg` against `ClientOptions.maxQueuedMessagesBytes`, returning `NO` if it carries messages that don't fit. A message `merging` into the last queued message is charged for its messages only.
+- (BOOL)reserveQueuedBytesFor:(ARTProtocolMessage *)msg merging:(BOOL)merging {
+    NSUInteger limit = self.options.maxQueuedMessagesBytes;
+    if (limit == 0) {
+        return YES;
+    }
+    NSUInteger size = ARTMemoryFootprintOfProtocolMessage(msg) - (merging ? ARTMemoryFootprintObjectOverhead : 0);
+    BOOL hasPayload = msg.messages.count > 0 || msg.presence.count > 0;
+    if (hasPayload && _queuedMessagesBytes + size > limit) {
+        [self.logger warn:@"R:%p (channel: %@) message not queued: %lu queued bytes plus %lu would exceed %lu", self, msg.channel, (unsigned long)_queuedMessagesBytes, (unsigned long)size, (unsigned long)limit];
+        return NO;
+    }
+    _queuedMessagesBytes += size;
+    return YES;
+}
+
+- (void)coalesce:(ARTProtocolMessage *)msg sentCallback:(ARTCallback)sentCallback ackCallback:(ARTStatusCallback)ackCallback {
+    // Each channel has its own bundle, so that publishes interleaved across channels are still bundled.
+    NSUInteger index = [_coalescedMessages indexOfObjectPassingTest:^BOOL(ARTQueuedMessage *bundle, NSUInteger idx, BOOL *stop) {
+        return [bundle.msg.channel isEqualToString:msg.channel];
+    }];
+    ARTQueuedMessage *bundle = index == NSNotFound ? nil : _coalescedMessages[index];
+
+    NSUInteger maxBytes = self.options.realtimePublishCoalescingMaxBytes;
+    if (bundle && maxBytes > 0 && ARTMessagesSize(bundle.msg.messages) + ARTMessagesSize(msg.messages) > maxBytes) {
+        [self sendCoalescedMessageAtIndex:index];
+        bundle = nil;
+    }
+
+    // Same rules as bundling queued messages (RTL6d)
+    if ([bundle mergeFrom:msg sentCallback:sentCallback ackCallback:ackCallback]) {
+        [self.logger verbose:__FILE__ line:__LINE__ message:@"RT:%p (channel: %@) message %@ has been bundled to %@", self, msg.channel, msg, bundle.msg];
+    }
+    else {
+        if (bundle) {
+            [self sendCoalescedMessageAtIndex:index];
+        }
+        bundle = [[ARTQueuedMessage alloc] initWithProtocolMessage:msg sentCallback:sentCallback ackCallback:ackCallback];
+        [_coalescedMessages addObject:bundle];
+        if (!_coalescingTimer) {
+            _coalescingTimer = artDispatchScheduled(self.options.realtimePublishCoalescingDelay, _queue, ^{
+                self->_coalescingTimer = nil;
+                [self sendCoalescedMessages];
+            });
+        }
+    }
+
+    if (bundle.msg.messages.count >= self.options.realtimePublishCoalescingMaxMessages ||
+        (maxBytes > 0 && ARTMessagesSize(bundle.msg.messages) >= maxBytes)) {
+        [self sendCoalescedMessageAtIndex:[_coalescedMessages indexOfObjectIdenticalTo:bundle]];
+    }
+}
+
+- (void)sendCoalescedMessageAtIndex:(NSUInteger)index {
+    ARTQueuedMessage *message = _coalescedMessages[index];
+    [_coalescedMessages removeObjectAtIndex:index];
+    [self sendImpl:message.msg sentCallback:message.sentCallback ackCallback:message.ackCallback];
+}
+
+- (void)sendCoalescedMessages {
+    artDispatchCancel(_coalescingTimer);
+    _coalescingTimer = nil;
+
+    NSArray<ARTQueuedMessage *> *messages = _coalescedMessages;
+    _coalescedMessages = [NSMutableArray array];
+    for (ARTQueuedMessage *message in messages) {
+        [self sendImpl:message.msg sentCallback:message.sentCallback ackCallback:message.ackCallback];
+    }
+}
+
+- (void)queueCoalescedMessages {
+    artDispatchCancel(_coalescingTimer);
+    _coalescingTimer = nil;
+
+    NSArray<ARTQueuedMessage *> *messages = _coalescedMessages;
+    _coalescedMessages = [NSMutableArray array];
+    for (ARTQueuedMessage *message in messages) {
+        [self enqueue:message.msg sentCallback:message.sentCallback ackCallback:message.ackCallback];
+    }
+}
+
 - (void)resendPendingMessages {
     NSArray<ARTPendingMessage *> *pms = self.pendingMessages;
     if (pms.count > 0) {
@@ -1217,6 +1418,12 @@
     }
 }
 
+- (void)setQueuedMessages:(NSMutableArray<ARTQueuedMessage *> *)queuedMessages {
+    _queuedMessages = queuedMessages;
+    // Recounted whenever the queue is replaced, so that the count can't drift from what is actually queued.
+    _queuedMessagesBytes = self.options.maxQueuedMessagesBytes > 0 ? ARTMemoryFootprintOfQueuedMessages(queuedMessages) : 0;
+}
+
 - (void)sendQueuedMessages {
     NSArray *qms = self.queuedMessages;
     self.queuedMessages = [NSMutableArray array];
@@ -1286,10 +1493,14 @@
     }
     
     for (ARTPendingMessage *msg in nackMessages) {
+        [self.rest.metricsRegistry record:ARTMetricsHistogramAckLatency sinceTime:msg.sentAt];
+        [self.rest.publishTracer record:ARTPublishTraceStageAcked messages:msg.msg.messages];
         msg.ackCallback([ARTStatus state:ARTStateError info:message.error]);
     }
     
     for (ARTPendingMessage *msg in ackMessages) {
+        [self.rest.metricsRegistry record:ARTMetricsHistogramAckLatency sinceTime:msg.sentAt];
+        [self.rest.publishTracer record:ARTPublishTraceStageAcked messages:msg.msg.messages];
         msg.ackCallback([ARTStatus state:ARTStateOk]);
     }
     
@@ -1324,6 +1535,8 @@
     self.pendingMessageStartSerial += count;
     
     for (ARTPendingMessage *msg in nackMessages) {
+        [self.rest.metricsRegistry record:ARTMetricsHistogramAckLatency sinceTime:msg.sentAt];
+        [self.rest.publishTracer record:ARTPublishTraceStageAcked messages:msg.msg.messages];
         msg.ackCallback([ARTStatus state:ARTStateError info:message.error]);
     }
     
@@ -1341,6 +1554,7 @@
             
             [self.logger debug:__FILE__ line:__LINE__ message:@"R:%p host is down; retrying realtime connection at %@", self, host];
             self.rest.prioritizedHost = host;
+            [self.rest.metricsRegistry increment:ARTMetricsCounterFallbackHostRequests by:1];
             [self transportReconnectWithHost:host];
         }];
         return true;
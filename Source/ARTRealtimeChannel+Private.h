@@ -13,6 +13,7 @@
 
 @class ARTProtocolMessage;
 @class ARTRealtimePresenceInternal;
+@class ARTChannelMemoryFootprint;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -23,8 +24,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly) ARTPushChannelInternal *push;
 #endif
 
-@property (readwrite, assign, nonatomic) ARTRealtimeChannelState state;
-@property (readonly, strong, nonatomic, nullable) ARTErrorInfo *errorReason;
+// Atomic, so that they can be read from any thread without a `dispatch_sync`; only written on the internal queue.
+@property (readwrite, assign) ARTRealtimeChannelState state;
+@property (readonly, strong, nullable) ARTErrorInfo *errorReason;
 @property (readonly, nullable, getter=getOptions_nosync) ARTRealtimeChannelOptions *options_nosync;
 
 - (ARTRealtimeChannelState)state_nosync;
@@ -54,9 +56,20 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)_attach:(nullable ARTCallback)callback;
 - (void)_detach:(nullable ARTCallback)callback;
 
+/// Posts every publish still waiting in the submission queue, so that an operation on the channel or its connection isn't sent ahead of publishes made before it (RTL6c).
+- (void)flushPublishSubmissions_nosync;
+/// As `flushPublishSubmissions_nosync`, for operations that don't otherwise go through the queue, such as history requests.
+- (void)flushPublishSubmissions;
+
 - (void)_unsubscribe;
 - (void)off_nosync;
 
+- (ARTChannelMemoryFootprint *)memoryFootprint;
+- (ARTChannelMemoryFootprint *)memoryFootprint_nosync;
+
+/// Discards the base retained for decoding the next delta, on the queue that decodes the channel's messages.
+- (void)releaseDeltaBase_nosync;
+
 @property (nonatomic, strong) dispatch_queue_t queue;
 
 @end
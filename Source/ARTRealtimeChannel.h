@@ -12,6 +12,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class ARTRealtimePresence;
 @class ARTRealtimeChannelOptions;
+@class ARTChannelMemoryFootprint;
 #if TARGET_OS_IPHONE
 @class ARTPushChannel;
 #endif
@@ -163,6 +164,13 @@ ART_EMBED_INTERFACE_EVENT_EMITTER(ARTChannelEvent, ARTChannelStateChange *)
 @property (readonly) ARTPushChannel *push;
 #endif
 
+/**
+ * Estimates the memory held by the channel, such as its presence set, the base retained for decoding deltas and its listeners.
+ *
+ * @return An `ARTChannelMemoryFootprint` object.
+ */
+- (ARTChannelMemoryFootprint *)memoryFootprint;
+
 @end
 
 #pragma mark - ARTEvent
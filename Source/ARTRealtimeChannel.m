@@ -20,9 +20,13 @@
 #import "ARTClientOptions.h"
 #import "ARTTypes.h"
 #import "ARTGCD.h"
+#import "ARTMPSCQueue.h"
+#import "ARTPublishTracer.h"
 #import "ARTConnection+Private.h"
 #import "ARTRestChannels+Private.h"
+#import "ARTRealtimeChannels+Private.h"
 #import "ARTEventEmitter+Private.h"
+#import "ARTMemoryFootprint+Private.h"
 #if TARGET_OS_IPHONE
 #import "ARTPushChannel+Private.h"
 #endif
@@ -208,6 +212,10 @@
     [_internal setOptions:options callback:cb];
 }
 
+- (ARTChannelMemoryFootprint *)memoryFootprint {
+    return [_internal memoryFootprint];
+}
+
 @end
 
 @interface ARTRealtimeChannelInternal () {
@@ -224,12 +232,83 @@
     BOOL _decodeFailureRecoveryInProgress;
 }
 
+// Written on the internal queue and read through its atomic accessor from any thread, like `state`.
+@property (readwrite, strong, nullable) ARTErrorInfo *errorReason;
+
+@end
+
+/// Number of publish submissions handled per turn of the internal queue, so that a burst doesn't starve other work.
+static const NSUInteger ARTRealtimeChannelPublishDrainBatchSize = 64;
+
+@interface ARTPublishSubmission : NSObject
+
+@property (nonatomic, readonly) NSArray<ARTMessage *> *messages;
+@property (nullable, nonatomic, readonly) ARTCallback callback;
+
+@end
+
+@implementation ARTPublishSubmission
+
+- (instancetype)initWithMessages:(NSArray<ARTMessage *> *)messages callback:(ARTCallback)callback {
+    if (self = [super init]) {
+        _messages = messages;
+        _callback = callback;
+    }
+    return self;
+}
+
+@end
+
+/// The payloads of an inbound `MESSAGE` or `PRESENCE` protocol message, decoded on a channel's inbound queue before the message is applied on the internal queue. Not used for channels requesting deltas, whose payloads must be decoded in order with the RTL18 and RTL20 checks.
+@interface ARTDecodedPayloads : NSObject
+
+- (instancetype)initWithItems:(NSArray<ARTBaseMessage *> *)items dataEncoder:(nullable ARTDataEncoder *)dataEncoder;
+
+- (id)itemAtIndex:(NSUInteger)index;
+- (nullable NSError *)errorAtIndex:(NSUInteger)index;
+
+@end
+
+@implementation ARTDecodedPayloads {
+    NSMutableArray *_items;
+    NSMutableArray *_errors;
+}
+
+- (instancetype)initWithItems:(NSArray<ARTBaseMessage *> *)items dataEncoder:(ARTDataEncoder *)dataEncoder {
+    if (self = [super init]) {
+        _items = [NSMutableArray arrayWithCapacity:items.count];
+        _errors = [NSMutableArray arrayWithCapacity:items.count];
+        for (ARTBaseMessage *item in items) {
+            NSError *decodeError = nil;
+            id decoded = item;
+            if (item.data && dataEncoder) {
+                decoded = [item decodeWithEncoder:dataEncoder error:&decodeError];
+            }
+            [_items addObject:decoded];
+            [_errors addObject:decodeError ?: [NSNull null]];
+        }
+    }
+    return self;
+}
+
+- (id)itemAtIndex:(NSUInteger)index {
+    return _items[index];
+}
+
+- (NSError *)errorAtIndex:(NSUInteger)index {
+    id error = _errors[index];
+    return error == [NSNull null] ? nil : error;
+}
+
 @end
 
 @implementation ARTRealtimeChannelInternal {
     dispatch_queue_t _queue;
     dispatch_queue_t _userQueue;
+    dispatch_queue_t _inboundQueue;
     ARTErrorInfo *_errorReason;
+    ARTMPSCQueue<ARTPublishSubmission *> *_publishSubmissions;
+    NSUInteger _publishHighWaterMark;
 }
 
 - (instancetype)initWithRealtime:(ARTRealtimeInternal *)realtime andName:(NSString *)name withOptions:(ARTRealtimeChannelOptions *)options {
@@ -241,7 +320,7 @@
         _restChannel = [_realtime.rest.channels _getChannel:self.name options:options addPrefix:true];
         _state = ARTRealtimeChannelInitialized;
         _attachSerial = nil;
-        _presenceMap = [[ARTPresenceMap alloc] initWithQueue:_queue logger:self.logger];
+        _presenceMap = [[ARTPresenceMap alloc] initWithQueue:_queue logger:self.logger stringInterner:realtime.presenceStringInterner];
         _presenceMap.delegate = self;
         _statesEventEmitter = [[ARTPublicEventEmitter alloc] initWithRest:_realtime.rest];
         _messagesEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueues:_queue userQueue:_userQueue];
@@ -249,6 +328,15 @@
         _attachedEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_queue];
         _detachedEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_queue];
         _internalEventEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_queue];
+        _publishHighWaterMark = realtime.options.realtimePublishHighWaterMark;
+        if (_publishHighWaterMark > 0) {
+            _publishSubmissions = [[ARTMPSCQueue alloc] init];
+        }
+        if (realtime.options.decodeChannelMessagesConcurrently) {
+            // Targeting one queue bounds the threads used however many channels are decoding at once.
+            _inboundQueue = dispatch_queue_create_with_target("io.ably.channel.inbound", DISPATCH_QUEUE_SERIAL, realtime.channelInboundQueue);
+        }
+        self.publishTracer = realtime.rest.publishTracer;
     }
     return self;
 }
@@ -257,22 +345,6 @@
     return [[ARTRealtimeChannelInternal alloc] initWithRealtime:realtime andName:name withOptions:options];
 }
 
-- (ARTRealtimeChannelState)state {
-    __block ARTRealtimeChannelState ret;
-dispatch_sync(_queue, ^{
-    ret = [self state_nosync];
-});
-    return ret;
-}
-
-- (ARTErrorInfo *)errorReason {
-    __block ARTErrorInfo * ret;
-dispatch_sync(_queue, ^{
-    ret = [self errorReason_nosync];
-});
-    return ret;
-}
-
 - (ARTRealtimeChannelState)state_nosync {
     return _state;
 }
@@ -326,7 +398,67 @@ dispatch_sync(_queue, ^{
         data = @[data];
     }
 
+    if (_publishSubmissions) {
+        [self submitMessages:data callback:callback];
+        return;
+    }
+
 dispatch_sync(_queue, ^{
+    [self postMessages_nosync:data callback:callback];
+});
+}
+
+- (void)submitMessages:(NSArray<ARTMessage *> *)messages callback:(ARTCallback)callback {
+    // The messages were encoded, and encrypted, by `-[ARTChannel publish:]` on the caller's thread, which spreads that
+    // work over the publishing threads rather than adding it to the queue.
+    // Backpressure is reported to the caller rather than applied by blocking it.
+    if (_publishSubmissions.count >= _publishHighWaterMark) {
+        if (callback)
+            callback([ARTErrorInfo createWithCode:ARTStatePublishQueueFull message:[NSString stringWithFormat:@"channel publish queue is full (%lu pending submissions)", (unsigned long)_publishHighWaterMark]]);
+        return;
+    }
+    if ([_publishSubmissions push:[[ARTPublishSubmission alloc] initWithMessages:messages callback:callback]] == 0) {
+        dispatch_async(_queue, ^{
+            [self drainPublishSubmissions_nosync];
+        });
+    }
+}
+
+- (void)drainPublishSubmissions_nosync {
+    for (NSUInteger i = 0; i < ARTRealtimeChannelPublishDrainBatchSize; i++) {
+        ARTPublishSubmission *submission = [_publishSubmissions pop];
+        if (!submission) {
+            break;
+        }
+        [self postMessages_nosync:submission.messages callback:submission.callback];
+    }
+    // Either the batch limit was reached or a producer is midway through a push; in both cases it's
+    // picked up on the next turn. A producer finding the queue empty schedules its own drain.
+    if (_publishSubmissions.count > 0) {
+        dispatch_async(_queue, ^{
+            [self drainPublishSubmissions_nosync];
+        });
+    }
+}
+
+- (void)flushPublishSubmissions {
+    if (_publishSubmissions.count == 0) {
+        return;
+    }
+dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
+});
+}
+
+- (void)flushPublishSubmissions_nosync {
+    ARTPublishSubmission *submission;
+    while ((submission = [_publishSubmissions pop])) {
+        [self postMessages_nosync:submission.messages callback:submission.callback];
+    }
+}
+
+- (void)postMessages_nosync:(NSArray<ARTMessage *> *)data callback:(ARTCallback)callback {
+    [self.publishTracer record:ARTPublishTraceStageQueued messages:data];
     if ([data isKindOfClass:[ARTMessage class]]) {
         ARTMessage *message = (ARTMessage *)data;
         if (message.clientId && self->_realtime.rest.auth.clientId_nosync && ![message.clientId isEqualToString:self->_realtime.rest.auth.clientId_nosync]) {
@@ -361,7 +493,6 @@ dispatch_sync(_queue, ^{
         if (callback)
             callback(status.errorInfo);
     }];
-});
 }
 
 - (void)sync {
@@ -473,6 +604,7 @@ dispatch_sync(_queue, ^{
 
     __block ARTEventListener *listener = nil;
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     if (self.state_nosync == ARTRealtimeChannelFailed) {
         if (onAttach) onAttach([ARTErrorInfo createWithCode:0 message:@"attempted to subscribe while channel is in FAILED state."]);
         [self.logger warn:@"R:%p C:%p (%@) subscribe has been ignored (attempted to subscribe while channel is in FAILED state)", self->_realtime, self, self.name];
@@ -511,6 +643,7 @@ dispatch_sync(_queue, ^{
 
     __block ARTEventListener *listener = nil;
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     if (self.state_nosync == ARTRealtimeChannelFailed) {
         if (onAttach) onAttach([ARTErrorInfo createWithCode:0 message:@"attempted to subscribe while channel is in FAILED state."]);
         [self.logger warn:@"R:%p C:%p (%@) subscribe of '%@' has been ignored (attempted to subscribe while channel is in FAILED state)", self->_realtime, self, self.name, name];
@@ -525,6 +658,7 @@ dispatch_sync(_queue, ^{
 
 - (void)unsubscribe {
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     [self _unsubscribe];
     [self.logger verbose:@"R:%p C:%p (%@) unsubscribe to all events", self->_realtime, self, self.name];
 });
@@ -536,6 +670,7 @@ dispatch_sync(_queue, ^{
 
 - (void)unsubscribe:(ARTEventListener *)listener {
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     [self.messagesEventEmitter off:listener];
     [self.logger verbose:@"RT:%p C:%p (%@) unsubscribe to all events", self->_realtime, self, self.name];
 });
@@ -543,6 +678,7 @@ dispatch_sync(_queue, ^{
 
 - (void)unsubscribe:(NSString *)name listener:(ARTEventListener *)listener {
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     [self.messagesEventEmitter off:name listener:listener];
     [self.logger verbose:@"RT:%p C:%p (%@) unsubscribe to event '%@'", self->_realtime, self, self.name, name];
 });
@@ -573,6 +709,50 @@ dispatch_sync(_queue, ^{
     [(ARTPublicEventEmitter *)self.statesEventEmitter off_nosync];
 }
 
+- (void)deltaBaseUsed {
+    if (_realtime.options.maxRetainedDeltaBases > 0 && self.dataEncoder.deltaBaseLength > 0) {
+        [_realtime.channels deltaBaseUsedByChannel_nosync:self];
+    }
+}
+
+- (void)releaseDeltaBase_nosync {
+    ARTDataEncoder *dataEncoder = self.dataEncoder;
+    if (!_inboundQueue || self.options_nosync.params[@"delta"]) {
+        [dataEncoder releaseDeltaBase];
+        return;
+    }
+    // Payloads are decoded on the inbound queue, so the base must be released there too.
+    dispatch_async(_inboundQueue, ^{
+        [dataEncoder releaseDeltaBase];
+    });
+}
+
+- (ARTChannelMemoryFootprint *)memoryFootprint {
+    __block ARTChannelMemoryFootprint *footprint;
+dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
+    footprint = [self memoryFootprint_nosync];
+});
+    return footprint;
+}
+
+- (ARTChannelMemoryFootprint *)memoryFootprint_nosync {
+    ARTChannelMemoryFootprint *footprint = [[ARTChannelMemoryFootprint alloc] initWithName:self.name];
+    footprint.presenceMembers = self.presenceMap.memberCount;
+    footprint.presenceMembersBytes = [self.presenceMap memoryFootprintOfMembers];
+    NSSet<ARTPresenceMessage *> *localMembers = self.presenceMap.localMembers;
+    footprint.localPresenceMembers = localMembers.count;
+    footprint.localPresenceMembersBytes = ARTMemoryFootprintOfMessages(localMembers);
+    footprint.deltaBaseBytes = self.dataEncoder.deltaBaseLength;
+    footprint.listeners = self.statesEventEmitter.listenerCount
+                        + self.messagesEventEmitter.listenerCount
+                        + self.presenceEventEmitter.listenerCount
+                        + self.internalEventEmitter.listenerCount
+                        + _attachedEventEmitter.listenerCount
+                        + _detachedEventEmitter.listenerCount;
+    return footprint;
+}
+
 - (void)off:(ARTChannelEvent)event listener:listener {
     [self.statesEventEmitter off:[ARTEvent newWithChannelEvent:event] listener:listener];
 }
@@ -592,7 +772,7 @@ dispatch_sync(_queue, ^{
     self.state = state;
 
     if (status.storeErrorInfo) {
-        _errorReason = status.errorInfo;
+        self.errorReason = status.errorInfo;
     }
 
     ARTEventListener *channelRetryListener = nil;
@@ -656,6 +836,38 @@ dispatch_sync(_queue, ^{
 
 - (void)onChannelMessage:(ARTProtocolMessage *)message {
     [self.logger debug:__FILE__ line:__LINE__ message:@"R:%p C:%p (%@) received channel message %tu - %@", _realtime, self, self.name, message.action, ARTProtocolMessageActionToStr(message.action)];
+    if (!_inboundQueue) {
+        [self applyChannelMessage:message decoded:nil];
+        return;
+    }
+
+    // Every protocol message for the channel takes the same hop through the inbound queue and back, so that they
+    // are applied in the order they were received even though only MESSAGE and PRESENCE payloads are decoded there.
+    // Each decode moves the delta base of the data encoder, so a channel requesting deltas decodes its payloads on
+    // the internal queue instead, once a message is known not to be skipped (RTL18, RTL20).
+    ARTDataEncoder *dataEncoder = self.dataEncoder;
+    const BOOL decodesPayloads = self.options_nosync.params[@"delta"] == nil;
+dispatch_async(_inboundQueue, ^{
+    ARTDecodedPayloads *decoded = nil;
+    if (decodesPayloads) {
+        switch (message.action) {
+            case ARTProtocolMessageMessage:
+                decoded = [[ARTDecodedPayloads alloc] initWithItems:message.messages ?: @[] dataEncoder:dataEncoder];
+                break;
+            case ARTProtocolMessagePresence:
+                decoded = [[ARTDecodedPayloads alloc] initWithItems:message.presence ?: @[] dataEncoder:dataEncoder];
+                break;
+            default:
+                break;
+        }
+    }
+    dispatch_async(self->_queue, ^{
+        [self applyChannelMessage:message decoded:decoded];
+    });
+});
+}
+
+- (void)applyChannelMessage:(ARTProtocolMessage *)message decoded:(nullable ARTDecodedPayloads *)decoded {
     switch (message.action) {
         case ARTProtocolMessageAttached:
             [self.logger debug:__FILE__ line:__LINE__ message:@"R:%p C:%p (%@) %@", _realtime, self, self.name, message.description];
@@ -670,10 +882,12 @@ dispatch_sync(_queue, ^{
                 [self.logger debug:__FILE__ line:__LINE__ message:@"R:%p C:%p (%@) message decode recovery in progress, message skipped: %@", _realtime, self, self.name, message.description];
                 break;
             }
-            [self onMessage:message];
+            [self onMessage:message decoded:decoded];
+            [self deltaBaseUsed];
             break;
         case ARTProtocolMessagePresence:
-            [self onPresence:message];
+            [self onPresence:message decoded:decoded];
+            [self deltaBaseUsed];
             break;
         case ARTProtocolMessageError:
             [self onError:message];
@@ -706,7 +920,7 @@ dispatch_sync(_queue, ^{
     if (message.hasPresence) {
         [self.presenceMap startSync];
     }
-    else if ([self.presenceMap.members count] > 0 || [self.presenceMap.localMembers count] > 0) {
+    else if (self.presenceMap.memberCount > 0 || [self.presenceMap.localMembers count] > 0) {
         if (!message.resumed) {
             // When an ATTACHED message is received without a HAS_PRESENCE flag and PresenceMap has existing members
             [self.presenceMap startSync];
@@ -717,7 +931,7 @@ dispatch_sync(_queue, ^{
 
     if (self.state_nosync == ARTRealtimeChannelAttached) {
         if (message.error != nil) {
-            _errorReason = message.error;
+            self.errorReason = message.error;
         }
         ARTChannelStateChange *stateChange = [[ARTChannelStateChange alloc] initWithCurrent:self.state_nosync previous:self.state_nosync event:ARTChannelEventUpdate reason:message.error resumed:message.resumed];
         [self emit:stateChange.event with:stateChange];
@@ -778,6 +992,10 @@ dispatch_sync(_queue, ^{
 }
 
 - (void)onMessage:(ARTProtocolMessage *)pm {
+    [self onMessage:pm decoded:nil];
+}
+
+- (void)onMessage:(ARTProtocolMessage *)pm decoded:(ARTDecodedPayloads *)decoded {
     int i = 0;
 
     ARTMessage *firstMessage = pm.messages.firstObject;
@@ -804,21 +1022,26 @@ dispatch_sync(_queue, ^{
     ARTDataEncoder *dataEncoder = self.dataEncoder;
     for (ARTMessage *m in pm.messages) {
         ARTMessage *msg = m;
+        NSError *decodeError = nil;
 
-        if (msg.data && dataEncoder) {
-            NSError *decodeError = nil;
+        if (decoded) {
+            msg = [decoded itemAtIndex:i];
+            decodeError = [decoded errorAtIndex:i];
+        }
+        else if (msg.data && dataEncoder) {
             msg = [msg decodeWithEncoder:dataEncoder error:&decodeError];
-            if (decodeError) {
-                ARTErrorInfo *errorInfo = [ARTErrorInfo wrap:[ARTErrorInfo createWithCode:ARTErrorUnableToDecodeMessage message:decodeError.localizedFailureReason] prepend:@"Failed to decode data: "];
-                [self.logger error:@"R:%p C:%p (%@) %@", _realtime, self, self.name, errorInfo.message];
-                _errorReason = errorInfo;
-                ARTChannelStateChange *stateChange = [[ARTChannelStateChange alloc] initWithCurrent:self.state_nosync previous:self.state_nosync event:ARTChannelEventUpdate reason:errorInfo];
-                [self emit:stateChange.event with:stateChange];
-
-                if (decodeError.code == ARTErrorUnableToDecodeMessage) {
-                    [self startDecodeFailureRecoveryWithChannelSerial:_lastPayloadProtocolMessageChannelSerial error:errorInfo];
-                    return;
-                }
+        }
+
+        if (decodeError) {
+            ARTErrorInfo *errorInfo = [ARTErrorInfo wrap:[ARTErrorInfo createWithCode:ARTErrorUnableToDecodeMessage message:decodeError.localizedFailureReason] prepend:@"Failed to decode data: "];
+            [self.logger error:@"R:%p C:%p (%@) %@", _realtime, self, self.name, errorInfo.message];
+            self.errorReason = errorInfo;
+            ARTChannelStateChange *stateChange = [[ARTChannelStateChange alloc] initWithCurrent:self.state_nosync previous:self.state_nosync event:ARTChannelEventUpdate reason:errorInfo];
+            [self emit:stateChange.event with:stateChange];
+
+            if (decodeError.code == ARTErrorUnableToDecodeMessage) {
+                [self startDecodeFailureRecoveryWithChannelSerial:_lastPayloadProtocolMessageChannelSerial error:errorInfo];
+                return;
             }
         }
 
@@ -840,18 +1063,26 @@ dispatch_sync(_queue, ^{
 }
 
 - (void)onPresence:(ARTProtocolMessage *)message {
+    [self onPresence:message decoded:nil];
+}
+
+- (void)onPresence:(ARTProtocolMessage *)message decoded:(ARTDecodedPayloads *)decoded {
     [self.logger debug:__FILE__ line:__LINE__ message:@"RT:%p C:%p (%@) handle PRESENCE message", _realtime, self, self.name];
     int i = 0;
     ARTDataEncoder *dataEncoder = self.dataEncoder;
     for (ARTPresenceMessage *p in message.presence) {
         ARTPresenceMessage *presence = p;
-        if (presence.data && dataEncoder) {
-            NSError *decodeError = nil;
+        NSError *decodeError = nil;
+        if (decoded) {
+            presence = [decoded itemAtIndex:i];
+            decodeError = [decoded errorAtIndex:i];
+        }
+        else if (presence.data && dataEncoder) {
             presence = [p decodeWithEncoder:dataEncoder error:&decodeError];
-            if (decodeError != nil) {
-                ARTErrorInfo *errorInfo = [ARTErrorInfo wrap:[ARTErrorInfo createWithCode:ARTErrorUnableToDecodeMessage message:decodeError.localizedFailureReason] prepend:@"Failed to decode data: "];
-                [self.logger error:@"RT:%p C:%p (%@) %@", _realtime, self, self.name, errorInfo.message];
-            }
+        }
+        if (decodeError != nil) {
+            ARTErrorInfo *errorInfo = [ARTErrorInfo wrap:[ARTErrorInfo createWithCode:ARTErrorUnableToDecodeMessage message:decodeError.localizedFailureReason] prepend:@"Failed to decode data: "];
+            [self.logger error:@"RT:%p C:%p (%@) %@", _realtime, self, self.name, errorInfo.message];
         }
 
         if (!presence.timestamp) {
@@ -918,6 +1149,7 @@ dispatch_sync(_queue, ^{
         };
     }
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     [self _attach:callback];
 });
 }
@@ -968,7 +1200,7 @@ dispatch_sync(_queue, ^{
             break;
     }
 
-    _errorReason = nil;
+    self.errorReason = nil;
 
     if (![self.realtime isActive]) {
         [self.realtime.logger debug:__FILE__ line:__LINE__ message:@"RT:%p C:%p (%@) can't attach when not in an active state", _realtime, self, self.name];
@@ -1031,6 +1263,7 @@ dispatch_sync(_queue, ^{
         };
     }
 dispatch_sync(_queue, ^{
+    [self flushPublishSubmissions_nosync];
     [self _detach:callback];
 });
 }
@@ -1136,6 +1369,7 @@ dispatch_sync(_queue, ^{
 }
 
 - (BOOL)history:(ARTRealtimeHistoryQuery *)query callback:(ARTPaginatedMessagesCallback)callback error:(NSError **)errorPtr {
+    [self flushPublishSubmissions];
     query.realtimeChannel = self;
     return [_restChannel history:query callback:callback error:errorPtr];
 }
@@ -1206,6 +1440,7 @@ dispatch_sync(_queue, ^{
         };
     }
     dispatch_sync(_queue, ^{
+        [self flushPublishSubmissions_nosync];
         [self setOptions_nosync:options callback:callback];
     });
 }
@@ -23,6 +23,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly, getter=getCollection) NSMutableDictionary<NSString *, ARTRealtimeChannelInternal *> *collection;
 - (ARTRealtimeChannelInternal *)_getChannel:(NSString *)name options:(ARTChannelOptions * _Nullable)options addPrefix:(BOOL)addPrefix;
 
+/// Records that `channel` has just set or used its delta base, and releases the bases of the least recently used channels beyond `ARTClientOptions.maxRetainedDeltaBases`.
+- (void)deltaBaseUsedByChannel_nosync:(ARTRealtimeChannelInternal *)channel;
+
 @property (nonatomic, strong) dispatch_queue_t queue;
 
 @end
@@ -59,6 +59,8 @@
 @implementation ARTRealtimeChannelsInternal {
     ARTChannels *_channels;
     dispatch_queue_t _userQueue;
+    // Names of the channels that retain a delta base, least recently used first. Only kept when a cap is set.
+    NSMutableOrderedSet<NSString *> *_deltaBaseChannels;
 }
 
 - (instancetype)initWithRealtime:(ARTRealtimeInternal *)realtime {
@@ -67,6 +69,7 @@
         _userQueue = _realtime.rest.userQueue;
         _queue = _realtime.rest.queue;
         _channels = [[ARTChannels alloc] initWithDelegate:self dispatchQueue:_queue prefix:_realtime.options.channelNamePrefix];
+        _deltaBaseChannels = [[NSMutableOrderedSet alloc] init];
     }
     return self;
 }
@@ -122,6 +125,7 @@ dispatch_sync(_queue, ^{
         // released unwillingly.
         if ([self->_channels _exists:name] && [self->_channels _get:name] == channel) {
             [self->_channels _release:name];
+            [self->_deltaBaseChannels removeObject:name];
         }
 
         if (cb) cb(errorInfo);
@@ -145,4 +149,19 @@ dispatch_sync(_queue, ^{
     return [_channels _getChannel:name options:options addPrefix:addPrefix];
 }
 
+- (void)deltaBaseUsedByChannel_nosync:(ARTRealtimeChannelInternal *)channel {
+    [_deltaBaseChannels removeObject:channel.name];
+    [_deltaBaseChannels addObject:channel.name];
+
+    NSUInteger limit = _realtime.options.maxRetainedDeltaBases;
+    while (_deltaBaseChannels.count > limit) {
+        NSString *name = _deltaBaseChannels.firstObject;
+        [_deltaBaseChannels removeObjectAtIndex:0];
+        if ([_channels _exists:name]) {
+            [_realtime.logger debug:__FILE__ line:__LINE__ message:@"RT:%p releasing delta base of channel %@, over the limit of %lu", _realtime, name, (unsigned long)limit];
+            [[_channels _get:name] releaseDeltaBase_nosync];
+        }
+    }
+}
+
 @end
@@ -4,6 +4,7 @@
 #import <Ably/ARTDataQuery.h>
 #import <Ably/ARTEventEmitter.h>
 #import <Ably/ARTRealtimeChannel.h>
+#import <Ably/ARTPresenceChanges.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -40,6 +41,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)get:(ARTRealtimePresenceQuery *)query callback:(ARTPresenceMessagesCallback)callback;
 
+/**
+ * Retrieves the changes to the members present on the channel since a version of the presence set, as an `ARTPresenceChanges` object with the latest state of each member that changed. Keeping a copy of the presence set up to date this way costs time proportional to the changes rather than to the members. Only the most recent changes are kept, so if `version` is too old the result has all the current members instead. Members may have the `ARTPresenceAction.ARTPresenceAbsent` action while a sync is in progress. Like `get:`, this implicitly attaches the channel, and fails if the channel is `DETACHED`, `FAILED` or `SUSPENDED`.
+ *
+ * @param version The `version` of the last `ARTPresenceChanges` received, or `0` to get all the current members.
+ * @param callback A callback for retrieving an `ARTPresenceChanges` object, or an `ARTErrorInfo` object if the changes can't be retrieved.
+ */
+- (void)changesSinceVersion:(NSUInteger)version callback:(ARTPresenceChangesCallback)callback;
+
 /**
  * Enters the presence set for the channel, optionally passing a `data` payload. A `clientId` is required to be present on a channel.
  *
@@ -9,7 +9,6 @@
 #import "ARTPresence+Private.h"
 #import "ARTDataQuery+Private.h"
 #import "ARTConnection+Private.h"
-#import "ARTNSArray+ARTFunctional.h"
 
 #pragma mark - ARTRealtimePresenceQuery
 
@@ -50,6 +49,10 @@
     [_internal get:query callback:callback];
 }
 
+- (void)changesSinceVersion:(NSUInteger)version callback:(ARTPresenceChangesCallback)callback {
+    [_internal changesSinceVersion:version callback:callback];
+}
+
 - (void)enter:(id _Nullable)data {
     [_internal enter:data];
 }
@@ -170,6 +173,7 @@
     }
 
 dispatch_async(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
     switch (self->_channel.state_nosync) {
         case ARTRealtimeChannelDetached:
         case ARTRealtimeChannelFailed:
@@ -177,7 +181,7 @@ dispatch_async(_queue, ^{
             return;
         case ARTRealtimeChannelSuspended:
             if (query && !query.waitForSync) {
-                if (callback) callback(self->_channel.presenceMap.members.allValues, nil);
+                if (callback) callback(self->_channel.presenceMap.memberValues, nil);
                 return;
             }
             if (callback) callback(nil, [ARTErrorInfo createWithCode:ARTErrorPresenceStateIsOutOfSync message:@"presence state is out of sync due to the channel being SUSPENDED"]);
@@ -186,11 +190,6 @@ dispatch_async(_queue, ^{
             break;
     }
 
-    BOOL (^filterMemberBlock)(ARTPresenceMessage *message) = ^BOOL(ARTPresenceMessage *message) {
-        return (query.clientId == nil || [message.clientId isEqualToString:query.clientId]) &&
-            (query.connectionId == nil || [message.connectionId isEqualToString:query.connectionId]);
-    };
-
     [self->_channel _attach:^(ARTErrorInfo *error) {
         if (error) {
             callback(nil, error);
@@ -200,18 +199,51 @@ dispatch_async(_queue, ^{
         if (syncInProgress && query.waitForSync) {
             [self->_channel.logger debug:__FILE__ line:__LINE__ message:@"R:%p C:%p (%@) sync is in progress, waiting until the presence members is synchronized", self->_channel.realtime, self->_channel, self->_channel.name];
             [self->_channel.presenceMap onceSyncEnds:^(NSArray<ARTPresenceMessage *> *members) {
-                NSArray<ARTPresenceMessage *> *filteredMembers = [members artFilter:filterMemberBlock];
-                callback(filteredMembers, nil);
+                // Emitted as soon as the sync ends, so the map still has these members.
+                callback([self->_channel.presenceMap membersWithClientId:query.clientId connectionId:query.connectionId], nil);
             }];
             [self->_channel.presenceMap onceSyncFails:^(ARTErrorInfo *error) {
                 callback(nil, error);
             }];
         } else {
             [self->_channel.logger debug:__FILE__ line:__LINE__ message:@"R:%p C:%p (%@) returning presence members (syncInProgress=%d)", self->_channel.realtime, self->_channel, self->_channel.name, syncInProgress];
-            NSArray<ARTPresenceMessage *> *members = self->_channel.presenceMap.members.allValues;
-            NSArray<ARTPresenceMessage *> *filteredMembers = [members artFilter:filterMemberBlock];
-            callback(filteredMembers, nil);
+            callback([self->_channel.presenceMap membersWithClientId:query.clientId connectionId:query.connectionId], nil);
+        }
+    }];
+});
+}
+
+- (void)changesSinceVersion:(NSUInteger)version callback:(ARTPresenceChangesCallback)callback {
+    if (callback) {
+        ARTPresenceChangesCallback userCallback = callback;
+        callback = ^(ARTPresenceChanges *changes, ARTErrorInfo *e) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(changes, e);
+            });
+        };
+    }
+
+dispatch_async(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
+    switch (self->_channel.state_nosync) {
+        case ARTRealtimeChannelDetached:
+        case ARTRealtimeChannelFailed:
+            if (callback) callback(nil, [ARTErrorInfo createWithCode:ARTErrorChannelOperationFailedInvalidState message:[NSString stringWithFormat:@"unable to return the changes to the current members (incompatible channel state: %@)", ARTRealtimeChannelStateToStr(self->_channel.state_nosync)]]);
+            return;
+        case ARTRealtimeChannelSuspended:
+            if (callback) callback(nil, [ARTErrorInfo createWithCode:ARTErrorPresenceStateIsOutOfSync message:@"presence state is out of sync due to the channel being SUSPENDED"]);
+            return;
+        default:
+            break;
+    }
+
+    [self->_channel _attach:^(ARTErrorInfo *error) {
+        if (error) {
+            if (callback) callback(nil, error);
+            return;
         }
+        ARTPresenceChanges *changes = [self->_channel.presenceMap changesSinceVersion:version];
+        if (callback) callback(changes, nil);
     }];
 });
 }
@@ -221,6 +253,7 @@ dispatch_async(_queue, ^{
 }
 
 - (BOOL)history:(ARTRealtimeHistoryQuery *)query callback:(ARTPaginatedPresenceCallback)callback error:(NSError **)errorPtr {
+    [_channel flushPublishSubmissions];
     query.realtimeChannel = _channel;
     @try {
         return [_channel.restChannel.presence history:query callback:callback error:errorPtr];
@@ -423,6 +456,7 @@ dispatch_sync(_queue, ^{
 
     __block ARTEventListener *listener = nil;
 dispatch_sync(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
     if (self->_channel.state_nosync == ARTRealtimeChannelFailed) {
         if (onAttach) onAttach([ARTErrorInfo createWithCode:ARTErrorChannelOperationFailedInvalidState message:@"attempted to subscribe while channel is in Failed state."]);
         return;
@@ -458,6 +492,7 @@ dispatch_sync(_queue, ^{
 
     __block ARTEventListener *listener = nil;
 dispatch_sync(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
     if (self->_channel.state_nosync == ARTRealtimeChannelFailed) {
         if (onAttach) onAttach([ARTErrorInfo createWithCode:ARTErrorChannelOperationFailedInvalidState message:@"attempted to subscribe while channel is in Failed state."]);
         return;
@@ -471,6 +506,7 @@ dispatch_sync(_queue, ^{
 
 - (void)unsubscribe {
 dispatch_sync(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
     [self _unsubscribe];
     [self->_channel.logger verbose:@"R:%p C:%p (%@) presence unsubscribe to all actions", self->_channel.realtime, self->_channel, self->_channel.name];
 });
@@ -482,6 +518,7 @@ dispatch_sync(_queue, ^{
 
 - (void)unsubscribe:(ARTEventListener *)listener {
 dispatch_sync(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
     [self->_channel.presenceEventEmitter off:listener];
     [self->_channel.logger verbose:@"R:%p C:%p (%@) presence unsubscribe to all actions", self->_channel.realtime, self->_channel, self->_channel.name];
 });
@@ -489,6 +526,7 @@ dispatch_sync(_queue, ^{
 
 - (void)unsubscribe:(ARTPresenceAction)action listener:(ARTEventListener *)listener {
 dispatch_sync(_queue, ^{
+    [self->_channel flushPublishSubmissions_nosync];
     [self->_channel.presenceEventEmitter off:[ARTEvent newWithPresenceAction:action] listener:listener];
     [self->_channel.logger verbose:@"R:%p C:%p (%@) presence unsubscribe to action %@", self->_channel.realtime, self->_channel, self->_channel.name, ARTPresenceActionToStr(action)];
 });
@@ -500,6 +538,8 @@ dispatch_sync(_queue, ^{
 }
 
 - (void)publishPresence:(ARTPresenceMessage *)msg callback:(ARTCallback)callback {
+    [_channel flushPublishSubmissions_nosync];
+
     if (msg.clientId == nil) {
         NSString *authClientId = _channel.realtime.auth.clientId_nosync;
         BOOL connected = _channel.realtime.connection.state_nosync == ARTRealtimeConnected;
@@ -8,6 +8,10 @@
 @protocol ARTDeviceStorage;
 @class ARTRealtimeInternal;
 @class ARTAuthInternal;
+@class ARTMetricsRegistry;
+@class ARTDecodeCache;
+@class ARTPublishTracer;
+@class ARTDeviceStorageWriter;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -19,8 +23,11 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong, readonly) ARTPushInternal *push;
 #if TARGET_OS_IOS
 @property (nonnull, nonatomic, readonly, getter=device) ARTLocalDevice *device;
-@property (nonnull, nonatomic, readonly, getter=device_nosync) ARTLocalDevice *device_nosync;
+/// The local device if it's loaded, and otherwise `nil`, starting its load. Callers on the queue that may run before the device is loaded go through `loadDevice_nosync:` instead.
+@property (nullable, nonatomic, readonly, getter=device_nosync) ARTLocalDevice *device_nosync;
 @property (nonatomic) id<ARTDeviceStorage> storage;
+// Writes to `storage` behind the client; replaced, after flushing, whenever `storage` is set.
+@property (nonatomic, readonly) ARTDeviceStorageWriter *storageWriter;
 #endif
 
 @property (nonatomic, strong, readonly) ARTClientOptions *options;
@@ -28,6 +35,11 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, strong, nonatomic) id<ARTEncoder> defaultEncoder;
 @property (readonly, strong, nonatomic) NSString *defaultEncoding; //Content-Type
 @property (readonly, strong, nonatomic) NSDictionary<NSString *, id<ARTEncoder>> *encoders;
+@property (readonly, strong, nonatomic) ARTMetricsRegistry *metricsRegistry;
+/// Shared by the data encoders of all channels; `nil` unless `ClientOptions.decodeCacheCapacity` is set.
+@property (readonly, strong, nonatomic, nullable) ARTDecodeCache *decodeCache;
+// Set only when `ClientOptions.publishTraceSampleRate` is greater than zero.
+@property (readonly, strong, nonatomic, nullable) ARTPublishTracer *publishTracer;
 
 // Must be atomic!
 @property (readwrite, strong, atomic, nullable) NSString *prioritizedHost;
@@ -50,6 +62,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable NSObject<ARTCancellable> *)_time:(ARTDateTimeCallback)callback;
 
+- (ARTClientMetrics *)metrics;
+- (ARTClientMetrics *)metrics_nosync;
+
 // MARK: ARTHTTPExecutor
 
 - (nullable NSObject<ARTCancellable> *)executeRequest:(NSURLRequest *)request completion:(nullable ARTURLRequestCallback)callback;
@@ -62,11 +77,23 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable NSObject<ARTCancellable> *)internetIsUp:(void (^)(BOOL isUp))cb;
 
+/// How long a hedged request waits for the primary host: the 95th percentile of its recent response times, or `ClientOptions.httpHedgingDelay` until enough have been observed. Only call it on the queue.
+- (NSTimeInterval)hedgingDelay;
+
 #if TARGET_OS_IOS
+/// Starts loading the local device in the background, unless it's loaded or being loaded. Called on the first access to `push`, as only push uses the device.
+- (void)startLoadingDevice;
+
+/// Calls back on the queue with the local device, once it's loaded in the background if it isn't yet.
+- (void)loadDevice_nosync:(void (^)(ARTLocalDevice *device))callback;
+
 // This is only intended to be called from test code.
 - (void)resetDeviceSingleton;
 #endif
 
+/// Runs `block` on the queue with the local device, once it's loaded in the background if it isn't yet, or with `nil` on platforms without a local device.
+- (void)dispatchWithLocalDevice:(void (^)(ARTLocalDevice *_Nullable device))block;
+
 @end
 
 @interface ARTRest ()
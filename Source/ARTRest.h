@@ -14,6 +14,9 @@
 @class ARTCancellable;
 @class ARTStatsQuery;
 @class ARTHTTPPaginatedResponse;
+@class ARTRestBatchPublisher;
+@class ARTRestBatchPublisherOptions;
+@class ARTClientMetrics;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -117,6 +120,22 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (readonly) ARTAuth *auth;
 
+/**
+ * Creates an `ARTRestBatchPublisher` which sends publishes to any number of channels together in batch requests.
+ *
+ * @param options An `ARTRestBatchPublisherOptions` object, or `nil` to use the defaults.
+ *
+ * @return An `ARTRestBatchPublisher` object.
+ */
+- (ARTRestBatchPublisher *)batchPublisherWithOptions:(nullable ARTRestBatchPublisherOptions *)options;
+
+/**
+ * Takes a snapshot of the client's metrics, such as bytes sent and received and REST requests made.
+ *
+ * @return An `ARTClientMetrics` object.
+ */
+- (ARTClientMetrics *)metrics;
+
 /// :nodoc:
 + (instancetype)createWithOptions:(ARTClientOptions *)options NS_SWIFT_UNAVAILABLE("Use instance initializer instead");
 
@@ -5,7 +5,7 @@
 #import "ARTDataQuery+Private.h"
 #import "ARTPaginatedResult+Private.h"
 #import "ARTAuth+Private.h"
-#import "ARTHttp.h"
+#import "ARTHttp+Private.h"
 #import "ARTEncoder.h"
 #import "ARTJsonLikeEncoder.h"
 #import "ARTJsonEncoder.h"
@@ -30,8 +30,14 @@
 #import "ARTRealtime+Private.h"
 #import "ARTPush.h"
 #import "ARTPush+Private.h"
+#import "ARTRestBatchPublisher+Private.h"
+#import "ARTClientMetrics.h"
+#import "ARTMetricsRegistry.h"
+#import "ARTDecodeCache.h"
+#import "ARTPublishTracer.h"
 #import "ARTLocalDevice+Private.h"
 #import "ARTLocalDeviceStorage.h"
+#import "ARTDeviceStorageWriter.h"
 #import "ARTNSMutableRequest+ARTRest.h"
 #import "ARTHTTPPaginatedResponse+Private.h"
 #import "ARTNSError+ARTUtils.h"
@@ -40,6 +46,53 @@
 #import "ARTTime.h"
 #import "ARTClientInformation.h"
 
+/// Number of primary host response times kept to compute the hedging delay.
+static const NSUInteger ARTHedgingResponseTimeSamples = 100;
+/// Until this many response times have been observed, `ARTClientOptions.httpHedgingDelay` is used as is.
+static const NSUInteger ARTHedgingMinResponseTimeSamples = 20;
+
+/// Groups the attempts of a hedged request, including their retries at fallback hosts, so that they can be cancelled together.
+@interface ARTHedgedRequestTask : NSObject<ARTCancellable>
+
+@property (nonatomic, readonly) NSMutableArray<NSObject<ARTCancellable> *> *tasks;
+@property (nullable, nonatomic) ARTScheduledBlockHandle *hedgeTimer;
+@property (nonatomic, readonly) BOOL cancelled;
+
+@end
+
+@implementation ARTHedgedRequestTask
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _tasks = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)addTask:(nullable NSObject<ARTCancellable> *)task {
+    if (!task) {
+        return;
+    }
+    if (_cancelled) {
+        // An attempt started after the request was cancelled, such as a retry whose response was already in flight.
+        [task cancel];
+        return;
+    }
+    [_tasks addObject:task];
+}
+
+- (void)cancel {
+    _cancelled = YES;
+    artDispatchCancel(_hedgeTimer);
+    _hedgeTimer = nil;
+    for (NSObject<ARTCancellable> *task in _tasks) {
+        [task cancel];
+    }
+    [_tasks removeAllObjects];
+}
+
+@end
+
 @implementation ARTRest {
     ARTQueuedDealloc *_dealloc;
 }
@@ -124,9 +177,21 @@
 }
 
 - (ARTPush *)push {
+#if TARGET_OS_IOS
+    [_internal startLoadingDevice];
+#endif
     return [[ARTPush alloc] initWithInternal:_internal.push queuedDealloc:_dealloc];
 }
 
+- (ARTRestBatchPublisher *)batchPublisherWithOptions:(ARTRestBatchPublisherOptions *)options {
+    ARTRestBatchPublisherInternal *internal = [[ARTRestBatchPublisherInternal alloc] initWithRest:_internal options:options ?: [[ARTRestBatchPublisherOptions alloc] init]];
+    return [[ARTRestBatchPublisher alloc] initWithInternal:internal queuedDealloc:_dealloc];
+}
+
+- (ARTClientMetrics *)metrics {
+    return [_internal metrics];
+}
+
 #if TARGET_OS_IOS
 
 - (ARTLocalDevice *)device {
@@ -144,6 +209,10 @@
 @implementation ARTRestInternal {
     ARTLog *_logger;
     NSUInteger _tokenErrorRetries;
+    // Ring buffer of primary host response times used for hedging. Only accessed on _queue.
+    NSTimeInterval _responseTimes[ARTHedgingResponseTimeSamples];
+    NSUInteger _responseTimesCount;
+    ARTScheduledBlockHandle *_metricsTimer;
 }
 
 @synthesize logger = _logger;
@@ -170,13 +239,17 @@
         if (options.logLevel != ARTLogLevelNone) {
             _logger.logLevel = options.logLevel;
         }
+        if (options.maxCapturedLogLines > 0) {
+            _logger.capturedLinesLimit = options.maxCapturedLogLines;
+        }
 
         _queue = options.internalDispatchQueue;
         _userQueue = options.dispatchQueue;
 #if TARGET_OS_IOS
-        _storage = [ARTLocalDeviceStorage newWithLogger:_logger];
+        self.storage = [ARTLocalDeviceStorage newWithLogger:_logger];
 #endif
         _http = [[ARTHttp alloc] init:_queue logger:_logger];
+        _http.requestCompressionThreshold = options.httpRequestCompressionThreshold;
         [_logger verbose:__FILE__ line:__LINE__ message:@"RS:%p %p alloc HTTP", self, _http];
         _httpExecutor = _http;
 
@@ -193,6 +266,16 @@
         _auth = [[ARTAuthInternal alloc] init:self withOptions:_options];
         _push = [[ARTPushInternal alloc] init:self];
         _channels = [[ARTRestChannelsInternal alloc] initWithRest:self];
+        _metricsRegistry = [[ARTMetricsRegistry alloc] init];
+        if (_options.decodeCacheCapacity > 0) {
+            _decodeCache = [[ARTDecodeCache alloc] initWithCapacity:_options.decodeCacheCapacity metricsRegistry:_metricsRegistry];
+        }
+        if (_options.publishTraceSampleRate > 0) {
+            _publishTracer = [[ARTPublishTracer alloc] initWithCapacity:_options.publishTraceCapacity sampleRate:_options.publishTraceSampleRate];
+        }
+        if (_options.metricsHandler && _options.metricsInterval > 0) {
+            [self scheduleMetricsSnapshot];
+        }
 
         [self.logger verbose:__FILE__ line:__LINE__ message:@"RS:%p initialized", self];
     }
@@ -209,6 +292,36 @@
 
 - (void)dealloc {
     [self.logger verbose:__FILE__ line:__LINE__ message:@"RS:%p dealloc", self];
+    artDispatchCancel(_metricsTimer);
+}
+
+- (ARTClientMetrics *)metrics {
+    __block ARTClientMetrics *metrics;
+dispatch_sync(_queue, ^{
+    metrics = [self metrics_nosync];
+});
+    return metrics;
+}
+
+- (ARTClientMetrics *)metrics_nosync {
+    ARTRealtimeInternal *realtime = self.realtime;
+    return [_metricsRegistry snapshotWithQueuedMessages:realtime.queuedMessages.count pendingMessages:realtime.pendingMessages.count];
+}
+
+- (void)scheduleMetricsSnapshot {
+    __weak ARTRestInternal *weakSelf = self;
+    _metricsTimer = artDispatchScheduled(_options.metricsInterval, _queue, ^{
+        ARTRestInternal *strongSelf = weakSelf;
+        if (!strongSelf) {
+            return;
+        }
+        ARTClientMetrics *metrics = [strongSelf metrics_nosync];
+        void (^handler)(ARTClientMetrics *) = strongSelf.options.metricsHandler;
+        dispatch_async(strongSelf.userQueue, ^{
+            handler(metrics);
+        });
+        [strongSelf scheduleMetricsSnapshot];
+    });
 }
 
 - (NSString *)description {
@@ -297,16 +410,151 @@
 }
 
 - (NSObject<ARTCancellable> *)executeRequest:(NSURLRequest *)request completion:(ARTURLRequestCallback)callback {
+    if ([_http shouldCompressRequest:request]) {
+        // Compressed once, ahead of any hedged attempt or retry at a fallback host, which all resend the same body.
+        return [_http compressRequest:request send:^NSObject<ARTCancellable> *(NSMutableURLRequest *compressedRequest) {
+            return [self executeRequest:compressedRequest completion:callback];
+        } callback:callback];
+    }
+    if ([self shouldHedgeRequest:request]) {
+        return [self executeHedgedRequest:(NSMutableURLRequest *)request completion:callback];
+    }
     return [self executeRequest:request fallbacks:nil retries:0 originalRequestId:nil completion:callback];
 }
 
+- (NSString *)generateRequestId {
+    NSString *randomId = [NSUUID new].UUIDString;
+    return [[randomId dataUsingEncoding:NSUTF8StringEncoding] base64EncodedStringWithOptions:0];
+}
+
+- (BOOL)shouldHedgeRequest:(NSURLRequest *)request {
+    return _options.httpHedgingDelay > 0 &&
+        [request isKindOfClass:[NSMutableURLRequest class]] &&
+        request.isIdempotent &&
+        self.currentFallbackHost == nil &&
+        ![request.URL.host isEqualToString:self.options.authUrl.host];
+}
+
+/**
+ Sends the request to the primary host and, if it hasn't completed after `hedgingDelay`, a duplicate to a fallback host.
+ Both attempts share the same `ARTFallback` (so they never target the same host) and the same request ID.
+ The first successful response wins and cancels the other attempt; an error is only reported once no attempt is left.
+ */
+- (NSObject<ARTCancellable> *)executeHedgedRequest:(NSMutableURLRequest *)request completion:(ARTURLRequestCallback)callback {
+    ARTFallback *fallbacks = [[ARTFallback alloc] initWithFallbackHosts:[ARTFallbackHosts hostsFromOptions:_options]];
+    if (!fallbacks) {
+        return [self executeRequest:request fallbacks:nil retries:0 originalRequestId:nil completion:callback];
+    }
+
+    NSString *requestId = _options.addRequestIds ? [self generateRequestId] : nil;
+    NSMutableURLRequest *hedgeTemplate = [request mutableCopy]; // `request` is modified when executed
+    ARTHedgedRequestTask *hedgedTask = [[ARTHedgedRequestTask alloc] init];
+    const CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    __block BOOL completed = NO;
+    __block NSUInteger inFlight = 1;
+
+    ARTURLRequestCallback (^attemptCallback)(NSString *) = ^ARTURLRequestCallback(NSString *fallbackHost) {
+        return ^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
+            inFlight -= 1;
+            if (completed) {
+                return;
+            }
+            if (error && inFlight > 0) {
+                [self.logger debug:__FILE__ line:__LINE__ message:@"RS:%p hedged attempt to %@ failed (%@); waiting for the other attempt", self, fallbackHost ?: @"primary host", error];
+                return;
+            }
+            completed = YES;
+            [hedgedTask cancel];
+
+            if (!error) {
+                // When the hedge wins, the primary host took at least this long, so it's recorded as a lower bound
+                // of its response time; leaving it out would lower the delay each time the primary host is slow.
+                [self recordResponseTime:CFAbsoluteTimeGetCurrent() - startTime];
+                if (fallbackHost) {
+                    [self.logger debug:__FILE__ line:__LINE__ message:@"RS:%p hedged request to fallback host %@ won", self, fallbackHost];
+                    self.currentFallbackHost = fallbackHost;
+                    self.prioritizedHost = fallbackHost;
+                }
+            }
+            if (callback) {
+                callback(response, data, error);
+            }
+        };
+    };
+
+    const NSTimeInterval delay = [self hedgingDelay];
+    hedgedTask.hedgeTimer = artDispatchScheduled(delay, _queue, ^{
+        if (completed) {
+            return;
+        }
+        NSString *host = [fallbacks popFallbackHost];
+        if (host == nil) {
+            return;
+        }
+        [self.logger debug:__FILE__ line:__LINE__ message:@"RS:%p no response from primary host after %.3fs; hedging request to %@", self, delay, host];
+        NSMutableURLRequest *hedgedRequest = [hedgeTemplate mutableCopy];
+        [hedgedRequest setValue:host forHTTPHeaderField:@"Host"];
+        hedgedRequest.URL = [NSURL copyFromURL:hedgeTemplate.URL withHost:host];
+        inFlight += 1;
+        // Counted here rather than as a retry, so that the hedge doesn't use up one of `httpMaxRetryCount`.
+        [self->_metricsRegistry increment:ARTMetricsCounterFallbackHostRequests by:1];
+        [self executeRequest:hedgedRequest
+                   fallbacks:fallbacks
+                     retries:0
+           originalRequestId:requestId
+                    attempts:hedgedTask
+                  completion:attemptCallback(host)];
+    });
+
+    [self executeRequest:request
+               fallbacks:fallbacks
+                 retries:0
+       originalRequestId:requestId
+                attempts:hedgedTask
+              completion:attemptCallback(nil)];
+    return hedgedTask;
+}
+
+- (void)recordResponseTime:(NSTimeInterval)responseTime {
+    _responseTimes[_responseTimesCount % ARTHedgingResponseTimeSamples] = responseTime;
+    _responseTimesCount += 1;
+}
+
+static int compareTimeIntervals(const void *a, const void *b) {
+    const NSTimeInterval x = *(const NSTimeInterval *)a, y = *(const NSTimeInterval *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+- (NSTimeInterval)hedgingDelay {
+    const NSUInteger count = MIN(_responseTimesCount, ARTHedgingResponseTimeSamples);
+    if (count < ARTHedgingMinResponseTimeSamples) {
+        return _options.httpHedgingDelay;
+    }
+    NSTimeInterval sorted[ARTHedgingResponseTimeSamples];
+    memcpy(sorted, _responseTimes, count * sizeof(NSTimeInterval));
+    qsort(sorted, count, sizeof(NSTimeInterval), compareTimeIntervals);
+    const NSTimeInterval p95 = sorted[(NSUInteger)ceil(count * 0.95) - 1];
+    return MIN(p95, _options.httpRequestTimeout);
+}
+
+- (NSObject<ARTCancellable> *)executeRequest:(NSURLRequest *)request
+                                   fallbacks:(ARTFallback *)fallbacks
+                                     retries:(NSUInteger)retries
+                           originalRequestId:(nullable NSString *)originalRequestId
+                                  completion:(ARTURLRequestCallback)callback {
+    return [self executeRequest:request fallbacks:fallbacks retries:retries originalRequestId:originalRequestId attempts:nil completion:callback];
+}
+
 /**
  originalRequestId is used only for fallback requests. It should never be used to execute request by yourself, it's passed from within below method.
+ Every task started for the request, including retries at fallback hosts, is added to `attempts` when given. Otherwise,
+ the response time of a request to the primary host is recorded for `hedgingDelay`; hedged requests record their own.
  */
 - (NSObject<ARTCancellable> *)executeRequest:(NSURLRequest *)request
                                    fallbacks:(ARTFallback *)fallbacks
                                      retries:(NSUInteger)retries
                            originalRequestId:(nullable NSString *)originalRequestId
+                                    attempts:(nullable ARTHedgedRequestTask *)attempts
                                   completion:(ARTURLRequestCallback)callback {
     NSString *requestId = nil;
     __block ARTFallback *blockFallbacks = fallbacks;
@@ -325,8 +573,7 @@
             if (fallbacks != nil) {
                 requestId = originalRequestId;
             } else {
-                NSString *randomId = [NSUUID new].UUIDString;
-                requestId = [[randomId dataUsingEncoding:NSUTF8StringEncoding] base64EncodedStringWithOptions:0];
+                requestId = [self generateRequestId];
             }
             
             [mutableRequest appendQueryItem:[NSURLQueryItem queryItemWithName:@"request_id" value:requestId]];
@@ -345,9 +592,22 @@
     }
 
 
+    const BOOL recordsResponseTime = attempts == nil && retries == 0 && self.currentFallbackHost == nil &&
+        [request.URL.host isEqualToString:_options.restHost];
+    const CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+
     [self.logger debug:__FILE__ line:__LINE__ message:@"RS:%p executing request %@", self, request];
+    [_metricsRegistry increment:ARTMetricsCounterHttpRequests by:1];
+    [_metricsRegistry increment:ARTMetricsCounterBytesSent by:request.HTTPBody.length];
+    if (retries > 0 || self.prioritizedHost) {
+        [_metricsRegistry increment:ARTMetricsCounterFallbackHostRequests by:1];
+    }
     __block NSObject<ARTCancellable> *task;
     task = [self.httpExecutor executeRequest:request completion:^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
+        [self->_metricsRegistry increment:ARTMetricsCounterBytesReceived by:data.length];
+        if (recordsResponseTime && response) {
+            [self recordResponseTime:CFAbsoluteTimeGetCurrent() - startTime];
+        }
         // Error messages in plaintext and HTML format (only if the URL request is different than `options.authUrl` and we don't have an error already)
         if (error == nil && data != nil && data.length != 0 && ![request.URL.host isEqualToString:[self.options.authUrl host]]) {
             NSString *contentType = [response.allHeaderFields objectForKey:@"Content-Type"];
@@ -378,6 +638,7 @@
                     // Make a single attempt to reissue the token and resend the request
                     if (self->_tokenErrorRetries < 1) {
                         task = [self executeRequest:(NSMutableURLRequest *)request withAuthOption:ARTAuthenticationTokenRetry completion:callback];
+                        [attempts addTask:task];
                         return;
                     }
                 }
@@ -423,6 +684,7 @@
                                       fallbacks:blockFallbacks
                                         retries:retries + 1
                               originalRequestId:originalRequestId
+                                       attempts:attempts
                                      completion:callback];
                     return;
                 }
@@ -440,6 +702,7 @@
             }
         }
     }];
+    [attempts addTask:task];
 
     return task;
 }
@@ -720,20 +983,82 @@ dispatch_async(_queue, ^{
 
 #if TARGET_OS_IOS
 - (ARTLocalDevice *)device {
-    __block ARTLocalDevice *ret;
-    dispatch_sync(_queue, ^{
-        ret = [self device_nosync];
+    __block ARTLocalDevice *device;
+    dispatch_sync(ARTRestInternal.deviceAccessQueue, ^{
+        device = sharedDevice_onlyAccessOnDeviceAccessQueue;
     });
-    return ret;
+    // Only waits when the device is read before its background load has finished, and then outside of the queue.
+    __block dispatch_group_t load;
+    while (!device) {
+        dispatch_sync(_queue, ^{
+            device = [self loadedDeviceOrLoad:&load];
+        });
+        if (!device) {
+            dispatch_group_wait(load, DISPATCH_TIME_FOREVER);
+        }
+    }
+    return device;
+}
+
+// The device is shared in a static variable because it's a reflection
+// of what's persisted. Having a device instance per ARTRest instance
+// could leave some instances in a stale state, if, through another
+// instance, the persisted state is changed.
+//
+// As a side effect, the first instance "wins" at setting the device's
+// client ID.
+static ARTLocalDevice *sharedDevice_onlyAccessOnDeviceAccessQueue;
+// Done when the load of the shared device is; `nil` until a load is started.
+static dispatch_group_t sharedDeviceLoad_onlyAccessOnDeviceAccessQueue;
+// The storage the shared device is loaded from, kept when the device is reset.
+static id<ARTDeviceStorage> sharedDeviceStorage_onlyAccessOnDeviceAccessQueue;
+
+- (void)setStorage:(id<ARTDeviceStorage>)storage {
+    ARTDeviceStorageWriter *const previousWriter = _storageWriter;
+    [previousWriter flush];
+    _storage = storage;
+    _storageWriter = [[ARTDeviceStorageWriter alloc] initWithStorage:storage logger:_logger];
+    if (previousWriter) {
+        // A device loaded, or being loaded, from the previous storage no longer reflects what's persisted.
+        dispatch_sync(ARTRestInternal.deviceAccessQueue, ^{
+            if (sharedDeviceStorage_onlyAccessOnDeviceAccessQueue == previousWriter) {
+                sharedDeviceLoad_onlyAccessOnDeviceAccessQueue = nil;
+                sharedDevice_onlyAccessOnDeviceAccessQueue = nil;
+            }
+        });
+    }
 }
 
 - (ARTLocalDevice *)device_nosync {
+    dispatch_group_t load;
+    return [self loadedDeviceOrLoad:&load];
+}
+
+- (void)loadDevice_nosync:(void (^)(ARTLocalDevice *))callback {
+    dispatch_group_t load;
+    ARTLocalDevice *device = [self loadedDeviceOrLoad:&load];
+    if (device) {
+        callback(device);
+        return;
+    }
+    dispatch_group_notify(load, _queue, ^{
+        // Loads again if the device was reset while loading.
+        [self loadDevice_nosync:callback];
+    });
+}
+
+// Returns the shared device if it's loaded, and otherwise the group of its load, starting it if needed.
+- (ARTLocalDevice *)loadedDeviceOrLoad:(dispatch_group_t *)loadPtr {
     NSString *clientId = self.auth.clientId_nosync;
-    __block ARTLocalDevice *ret;
+    ARTDeviceStorageWriter *storage = self.storageWriter;
+    __block ARTLocalDevice *device;
+    __block dispatch_group_t load;
     dispatch_sync(ARTRestInternal.deviceAccessQueue, ^{
-        ret = [self deviceWithClientId_onlyCallOnDeviceAccessQueue:clientId];
+        load = [self loadDeviceWithClientId_onlyCallOnDeviceAccessQueue:clientId storage:storage];
+        device = sharedDevice_onlyAccessOnDeviceAccessQueue;
     });
-    return ret;
+    *loadPtr = load;
+    return device;
 }
 
 + (dispatch_queue_t)deviceAccessQueue {
@@ -747,30 +1072,68 @@ dispatch_async(_queue, ^{
     return queue;
 }
 
-static BOOL sharedDeviceNeedsLoading_onlyAccessOnDeviceAccessQueue = YES;
++ (dispatch_queue_t)deviceLoadQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("io.ably.deviceLoad", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+    });
+
+    return queue;
+}
 
-- (ARTLocalDevice *)deviceWithClientId_onlyCallOnDeviceAccessQueue:(NSString *)clientId {
-    // The device is shared in a static variable because it's a reflection
-    // of what's persisted. Having a device instance per ARTRest instance
-    // could leave some instances in a stale state, if, through another
-    // instance, the persisted state is changed.
-    //
-    // As a side effect, the first instance "wins" at setting the device's
-    // client ID.
+- (void)startLoadingDevice {
+    dispatch_async(_queue, ^{
+        dispatch_group_t load;
+        [self loadedDeviceOrLoad:&load];
+    });
+}
 
-    static id device;
-    if (sharedDeviceNeedsLoading_onlyAccessOnDeviceAccessQueue) {
-        device = [ARTLocalDevice load:clientId storage:self.storage logger:self.logger];
-        sharedDeviceNeedsLoading_onlyAccessOnDeviceAccessQueue = NO;
+// Starts loading the shared device on the device load queue, unless it's already loaded or being loaded, so that storage isn't read on the caller's thread.
+- (dispatch_group_t)loadDeviceWithClientId_onlyCallOnDeviceAccessQueue:(NSString *)clientId storage:(ARTDeviceStorageWriter *)storage {
+    if (sharedDeviceLoad_onlyAccessOnDeviceAccessQueue) {
+        return sharedDeviceLoad_onlyAccessOnDeviceAccessQueue;
     }
-    return device;
+    dispatch_group_t load = dispatch_group_create();
+    ARTLog *logger = self.logger;
+    // A device loaded through another client may have writes that its writer hasn't made yet.
+    id<ARTDeviceStorage> previousStorage = sharedDeviceStorage_onlyAccessOnDeviceAccessQueue;
+    sharedDeviceLoad_onlyAccessOnDeviceAccessQueue = load;
+    sharedDeviceStorage_onlyAccessOnDeviceAccessQueue = storage;
+    sharedDevice_onlyAccessOnDeviceAccessQueue = nil;
+
+    dispatch_group_async(load, ARTRestInternal.deviceLoadQueue, ^{
+        if ([previousStorage isKindOfClass:[ARTDeviceStorageWriter class]]) {
+            [(ARTDeviceStorageWriter *)previousStorage flush];
+        }
+        ARTLocalDevice *device = [ARTLocalDevice load:clientId storage:storage logger:logger];
+        dispatch_sync(ARTRestInternal.deviceAccessQueue, ^{
+            // Unless the device was reset while loading.
+            if (sharedDeviceLoad_onlyAccessOnDeviceAccessQueue == load) {
+                sharedDevice_onlyAccessOnDeviceAccessQueue = device;
+            }
+        });
+    });
+    return load;
 }
 
 - (void)resetDeviceSingleton {
     dispatch_sync([ARTRestInternal deviceAccessQueue], ^{
-        sharedDeviceNeedsLoading_onlyAccessOnDeviceAccessQueue = YES;
+        sharedDeviceLoad_onlyAccessOnDeviceAccessQueue = nil;
+        sharedDevice_onlyAccessOnDeviceAccessQueue = nil;
     });
 }
 #endif
 
+- (void)dispatchWithLocalDevice:(void (^)(ARTLocalDevice *))block {
+dispatch_async(_queue, ^{
+    #if TARGET_OS_IOS
+    [self loadDevice_nosync:block];
+    #else
+    block(nil);
+    #endif
+});
+}
+
 @end
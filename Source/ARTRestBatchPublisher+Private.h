@@ -0,0 +1,27 @@
+#import <Ably/ARTRestBatchPublisher.h>
+#import "ARTQueuedDealloc.h"
+
+@class ARTRestInternal;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ARTRestBatchPublisherInternal : NSObject
+
+@property (nonatomic, readonly) ARTRestBatchPublisherOptions *options;
+
+- (instancetype)initWithRest:(ARTRestInternal *)rest options:(ARTRestBatchPublisherOptions *)options;
+
+- (void)publish:(NSString *)channelName messages:(NSArray<ARTMessage *> *)messages callback:(nullable ARTCallback)callback;
+- (void)flush;
+
+@end
+
+@interface ARTRestBatchPublisher ()
+
+@property (nonatomic, readonly) ARTRestBatchPublisherInternal *internal;
+
+- (instancetype)initWithInternal:(ARTRestBatchPublisherInternal *)internal queuedDealloc:(ARTQueuedDealloc *)dealloc;
+
+@end
+
+NS_ASSUME_NONNULL_END
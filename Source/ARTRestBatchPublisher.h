@@ -0,0 +1,65 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTTypes.h>
+
+@class ARTMessage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Limits applied by an `ARTRestBatchPublisher` before a pending batch is sent.
+ */
+@interface ARTRestBatchPublisherOptions : NSObject <NSCopying>
+
+/**
+ * The batch is sent as soon as it holds this many messages. The default is 100.
+ */
+@property (nonatomic) NSUInteger maxMessages;
+
+/**
+ * The batch is sent as soon as the combined size of its messages reaches this many bytes. The default is `ARTDefault.maxMessageSize`.
+ */
+@property (nonatomic) NSInteger maxBytes;
+
+/**
+ * The longest time, in seconds, a message waits for other messages before the batch is sent. The default is 0.1 seconds.
+ */
+@property (nonatomic) NSTimeInterval maxDelay;
+
+@end
+
+/**
+ * Coalesces REST publishes to any number of channels into a single request to the batch publish endpoint (`POST /messages`).
+ *
+ * Each `publish` call is encoded and validated as it would be by `-[ARTRestChannel publish:callback:]`, including idempotent message ids (RSL1k1), and its callback is invoked with the result reported for its channel.
+ */
+@interface ARTRestBatchPublisher : NSObject
+
+/// :nodoc:
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Adds a message to the pending batch.
+ *
+ * @param channelName The name of the channel to publish to.
+ * @param message An `ARTMessage` object.
+ * @param callback A success or failure callback function, invoked once the batch containing the message has been sent.
+ */
+- (void)publish:(NSString *)channelName message:(ARTMessage *)message callback:(nullable ARTCallback)callback;
+
+/**
+ * Adds an array of messages to the pending batch.
+ *
+ * @param channelName The name of the channel to publish to.
+ * @param messages An array of `ARTMessage` objects.
+ * @param callback A success or failure callback function, invoked once the batch containing the messages has been sent.
+ */
+- (void)publish:(NSString *)channelName messages:(NSArray<ARTMessage *> *)messages callback:(nullable ARTCallback)callback;
+
+/**
+ * Sends any pending messages immediately.
+ */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,287 @@
+#import "ARTRestBatchPublisher+Private.h"
+#import "ARTRest+Private.h"
+#import "ARTRestChannel+Private.h"
+#import "ARTRestChannels+Private.h"
+#import "ARTChannel+Private.h"
+#import "ARTAuth+Private.h"
+#import "ARTMessage.h"
+#import "ARTBaseMessage+Private.h"
+#import "ARTDefault.h"
+#import "ARTEncoder.h"
+#import "ARTGCD.h"
+#import "ARTNSArray+ARTFunctional.h"
+#import "ARTNSMutableURLRequest+ARTUtils.h"
+#import "ARTNSDictionary+ARTDictionaryUtil.h"
+
+@implementation ARTRestBatchPublisherOptions
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _maxMessages = 100;
+        _maxBytes = [ARTDefault maxMessageSize];
+        _maxDelay = 0.1;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    ARTRestBatchPublisherOptions *options = [[[self class] allocWithZone:zone] init];
+    options.maxMessages = self.maxMessages;
+    options.maxBytes = self.maxBytes;
+    options.maxDelay = self.maxDelay;
+    return options;
+}
+
+@end
+
+@implementation ARTRestBatchPublisher {
+    ARTQueuedDealloc *_dealloc;
+}
+
+- (instancetype)initWithInternal:(ARTRestBatchPublisherInternal *)internal queuedDealloc:(ARTQueuedDealloc *)dealloc {
+    self = [super init];
+    if (self) {
+        _internal = internal;
+        _dealloc = dealloc;
+    }
+    return self;
+}
+
+- (void)publish:(NSString *)channelName message:(ARTMessage *)message callback:(ARTCallback)callback {
+    [_internal publish:channelName messages:@[message] callback:callback];
+}
+
+- (void)publish:(NSString *)channelName messages:(NSArray<ARTMessage *> *)messages callback:(ARTCallback)callback {
+    [_internal publish:channelName messages:messages callback:callback];
+}
+
+- (void)flush {
+    [_internal flush];
+}
+
+@end
+
+/// The messages of a single `publish` call waiting in a batch.
+@interface ARTRestBatchPublisherEntry : NSObject
+
+@property (nonatomic, readonly) NSString *channelName;
+@property (nonatomic, readonly) NSArray<ARTMessage *> *messages;
+@property (nullable, nonatomic, readonly) ARTCallback callback;
+
+- (instancetype)initWithChannelName:(NSString *)channelName messages:(NSArray<ARTMessage *> *)messages callback:(nullable ARTCallback)callback;
+
+@end
+
+@implementation ARTRestBatchPublisherEntry
+
+- (instancetype)initWithChannelName:(NSString *)channelName messages:(NSArray<ARTMessage *> *)messages callback:(ARTCallback)callback {
+    if (self = [super init]) {
+        _channelName = channelName;
+        _messages = messages;
+        _callback = callback;
+    }
+    return self;
+}
+
+@end
+
+@implementation ARTRestBatchPublisherInternal {
+    ARTRestInternal *_rest;
+    ARTLog *_logger;
+    dispatch_queue_t _queue;
+    dispatch_queue_t _userQueue;
+    NSMutableArray<ARTRestBatchPublisherEntry *> *_pending;
+    NSUInteger _pendingMessages;
+    NSInteger _pendingBytes;
+    ARTScheduledBlockHandle *_flushTimer;
+}
+
+- (instancetype)initWithRest:(ARTRestInternal *)rest options:(ARTRestBatchPublisherOptions *)options {
+    if (self = [super init]) {
+        _rest = rest;
+        _logger = rest.logger;
+        _queue = rest.queue;
+        _userQueue = rest.userQueue;
+        _options = [options copy];
+        _pending = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)publish:(NSString *)channelName messages:(NSArray<ARTMessage *> *)messages callback:(ARTCallback)callback {
+    if (callback) {
+        ARTCallback userCallback = callback;
+        callback = ^(ARTErrorInfo *_Nullable error) {
+            dispatch_async(self->_userQueue, ^{
+                userCallback(error);
+            });
+        };
+    }
+
+dispatch_async(_queue, ^{
+    // Batched names are often one-off, so they're encoded with a channel that isn't kept in the registry.
+    ARTRestChannelInternal *channel = [self->_rest.channels _getTransientChannel:channelName];
+
+    NSError *error = nil;
+    NSMutableArray<ARTMessage *> *encodedMessages = [NSMutableArray array];
+    for (ARTMessage *message in messages) {
+        [encodedMessages addObject:[channel encodeMessageIfNeeded:message error:&error]];
+        if (error) {
+            if (callback) callback([ARTErrorInfo createFromNSError:error]);
+            return;
+        }
+    }
+
+    if ([channel exceedMaxSize:encodedMessages]) {
+        if (callback) callback([ARTErrorInfo createWithCode:ARTErrorMaxMessageLengthExceeded message:@"Maximum message length exceeded."]);
+        return;
+    }
+
+    NSString *clientId = self->_rest.auth.clientId_nosync;
+    for (ARTMessage *message in encodedMessages) {
+        if (message.clientId && clientId && ![message.clientId isEqualToString:clientId]) {
+            if (callback) callback([ARTErrorInfo createWithCode:ARTStateMismatchedClientId message:@"attempted to publish message with an invalid clientId"]);
+            return;
+        }
+    }
+
+    [channel assignIdempotentIdsIfNeeded:encodedMessages];
+
+    NSInteger size = 0;
+    for (ARTMessage *message in encodedMessages) {
+        size += [message messageSize];
+    }
+
+    // A batch that would go over the byte limit is sent before this entry is added to it.
+    if (self->_pending.count > 0 && self->_pendingBytes + size > self->_options.maxBytes) {
+        [self flush_nosync];
+    }
+
+    [self->_pending addObject:[[ARTRestBatchPublisherEntry alloc] initWithChannelName:channel.name messages:encodedMessages callback:callback]];
+    self->_pendingMessages += encodedMessages.count;
+    self->_pendingBytes += size;
+
+    if (self->_pendingMessages >= self->_options.maxMessages || self->_pendingBytes >= self->_options.maxBytes) {
+        [self flush_nosync];
+    }
+    else if (!self->_flushTimer) {
+        self->_flushTimer = artDispatchScheduled(self->_options.maxDelay, self->_queue, ^{
+            self->_flushTimer = nil;
+            [self flush_nosync];
+        });
+    }
+});
+}
+
+- (void)flush {
+dispatch_async(_queue, ^{
+    [self flush_nosync];
+});
+}
+
+- (void)flush_nosync {
+    artDispatchCancel(_flushTimer);
+    _flushTimer = nil;
+
+    if (_pending.count == 0) {
+        return;
+    }
+
+    NSArray<ARTRestBatchPublisherEntry *> *entries = _pending;
+    NSUInteger messageCount = _pendingMessages;
+    _pending = [NSMutableArray array];
+    _pendingMessages = 0;
+    _pendingBytes = 0;
+
+    // One spec per entry rather than per channel, so that each callback gets the result of its own messages.
+    NSMutableArray<NSArray<ARTMessage *> *> *messages = [NSMutableArray arrayWithCapacity:entries.count];
+    NSMutableArray<NSString *> *channelNames = [NSMutableArray arrayWithCapacity:entries.count];
+    BOOL idempotent = YES;
+    for (ARTRestBatchPublisherEntry *entry in entries) {
+        [messages addObject:entry.messages];
+        [channelNames addObject:entry.channelName];
+        idempotent = idempotent && [entry.messages artFilter:^BOOL(ARTMessage *m) { return m.isIdEmpty; }].count == 0;
+    }
+
+    NSError *encodeError = nil;
+    NSData *body = [_rest.defaultEncoder encodeBatchMessages:messages channels:channelNames error:&encodeError];
+    if (encodeError) {
+        [self completeEntries:entries results:nil error:[ARTErrorInfo createFromNSError:encodeError]];
+        return;
+    }
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"/messages"]];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = body;
+    if (idempotent) {
+        [request markAsIdempotent];
+    }
+    if (_rest.defaultEncoding) {
+        [request setValue:_rest.defaultEncoding forHTTPHeaderField:@"Content-Type"];
+    }
+
+    [_logger debug:__FILE__ line:__LINE__ message:@"RS:%p BP:%p publishing %lu message(s) in %lu spec(s)", _rest, self, (unsigned long)messageCount, (unsigned long)entries.count];
+
+    [_rest executeRequest:request withAuthOption:ARTAuthenticationOn completion:^(NSHTTPURLResponse *response, NSData *data, NSError *error) {
+        NSArray<NSDictionary *> *results = [self resultsFromResponse:response data:data count:entries.count];
+        [self completeEntries:entries results:results error:error ? [ARTErrorInfo createFromNSError:error] : nil];
+    }];
+}
+
+/**
+ Both a successful response and a 40020 partial failure carry a result per spec, in the order of the specs: either a
+ `{channel, messageId | error}` dictionary or an array of them, one per channel of the spec. Returns `nil` unless there
+ are `count` results.
+ */
+- (NSArray<NSDictionary *> *)resultsFromResponse:(NSHTTPURLResponse *)response data:(NSData *)data count:(NSUInteger)count {
+    if (!data || !response.MIMEType) {
+        return nil;
+    }
+    id decoded = [_rest.encoders[response.MIMEType] decode:data error:nil];
+    NSArray *batchResponse = nil;
+    if ([decoded isKindOfClass:[NSArray class]]) {
+        batchResponse = decoded;
+    }
+    else if ([decoded isKindOfClass:[NSDictionary class]]) {
+        batchResponse = [decoded artArray:@"batchResponse"];
+    }
+    if (batchResponse.count != count) {
+        return nil;
+    }
+
+    NSMutableArray<NSDictionary *> *results = [NSMutableArray arrayWithCapacity:count];
+    for (id result in batchResponse) {
+        if ([result isKindOfClass:[NSArray class]] && [[result firstObject] isKindOfClass:[NSDictionary class]]) {
+            // Each spec has a single channel.
+            [results addObject:[result firstObject]];
+        }
+        else if ([result isKindOfClass:[NSDictionary class]]) {
+            [results addObject:result];
+        }
+        else {
+            [results addObject:@{}];
+        }
+    }
+    return results;
+}
+
+- (void)completeEntries:(NSArray<ARTRestBatchPublisherEntry *> *)entries results:(NSArray<NSDictionary *> *)results error:(ARTErrorInfo *)error {
+    [entries enumerateObjectsUsingBlock:^(ARTRestBatchPublisherEntry *entry, NSUInteger i, BOOL *stop) {
+        if (!entry.callback) {
+            return;
+        }
+        if (!results) {
+            entry.callback(error);
+            return;
+        }
+        NSDictionary *resultError = [results[i] artDictionary:@"error"];
+        if (resultError) {
+            entry.callback([ARTErrorInfo createWithCode:[resultError artInteger:@"code"] status:[resultError artInteger:@"statusCode"] message:[resultError artString:@"message"] ?: @""]);
+        }
+        else {
+            entry.callback(nil);
+        }
+    }];
+}
+
+@end
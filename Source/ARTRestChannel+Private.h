@@ -28,6 +28,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly, getter=getBasePath) NSString *basePath;
 
+/// Assigns `<baseId>:<serial>` ids (RSL1k1) when idempotent REST publishing is enabled and none of the messages has an id.
+- (void)assignIdempotentIdsIfNeeded:(NSArray<ARTMessage *> *)messages;
+
 @end
 
 @interface ARTRestChannel ()
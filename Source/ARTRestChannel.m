@@ -16,6 +16,7 @@
 #import "ARTCrypto+Private.h"
 #import "ARTClientOptions.h"
 #import "ARTNSError+ARTUtils.h"
+#import "ARTNSMutableURLRequest+ARTUtils.h"
 
 @implementation ARTRestChannel {
     ARTQueuedDealloc *_dealloc;
@@ -279,6 +280,23 @@ dispatch_sync(_queue, ^{
     });
 }
 
+- (void)assignIdempotentIdsIfNeeded:(NSArray<ARTMessage *> *)messages {
+    if (!self.rest.options.idempotentRestPublishing) {
+        return;
+    }
+    // RSL1k1: only generate ids when none of the messages already has one
+    if ([messages artFilter:^BOOL(ARTMessage *m) { return !m.isIdEmpty; }].count > 0) {
+        return;
+    }
+    NSData *baseIdData = [ARTCrypto generateSecureRandomData:kIdempotentLibraryGeneratedIdLength];
+    NSString *baseId = [baseIdData base64EncodedStringWithOptions:0];
+    NSInteger serial = 0;
+    for (ARTMessage *message in messages) {
+        message.id = [NSString stringWithFormat:@"%@:%ld", baseId, (long)serial];
+        serial += 1;
+    }
+}
+
 - (void)internalPostMessages:(id)data callback:(ARTCallback)callback {
     if (callback) {
         ARTCallback userCallback = callback;
@@ -291,21 +309,18 @@ dispatch_sync(_queue, ^{
     
     dispatch_async(_queue, ^{
         NSData *encodedMessage = nil;
+        BOOL idempotent = NO;
         
         if ([data isKindOfClass:[ARTMessage class]]) {
             ARTMessage *message = (ARTMessage *)data;
             
-            NSString *baseId = nil;
-            if (self.rest.options.idempotentRestPublishing && message.isIdEmpty) {
-                NSData *baseIdData = [ARTCrypto generateSecureRandomData:kIdempotentLibraryGeneratedIdLength];
-                baseId = [baseIdData base64EncodedStringWithOptions:0];
-                message.id = [NSString stringWithFormat:@"%@:0", baseId];
-            }
+            [self assignIdempotentIdsIfNeeded:@[message]];
             
             if (message.clientId && self.rest.auth.clientId_nosync && ![message.clientId isEqualToString:self.rest.auth.clientId_nosync]) {
                 callback([ARTErrorInfo createWithCode:ARTStateMismatchedClientId message:@"attempted to publish message with an invalid clientId"]);
                 return;
             }
+            idempotent = !message.isIdEmpty;
             
             NSError *encodeError = nil;
             encodedMessage = [self.rest.defaultEncoder encodeMessage:message error:&encodeError];
@@ -317,26 +332,14 @@ dispatch_sync(_queue, ^{
         else if ([data isKindOfClass:[NSArray class]]) {
             NSArray<ARTMessage *> *messages = (NSArray *)data;
             
-            NSString *baseId = nil;
-            if (self.rest.options.idempotentRestPublishing) {
-                BOOL messagesHaveEmptyId = [messages artFilter:^BOOL(ARTMessage *m) { return !m.isIdEmpty; }].count <= 0;
-                if (messagesHaveEmptyId) {
-                    NSData *baseIdData = [ARTCrypto generateSecureRandomData:kIdempotentLibraryGeneratedIdLength];
-                    baseId = [baseIdData base64EncodedStringWithOptions:0];
-                }
-            }
-            
-            NSInteger serial = 0;
             for (ARTMessage *message in messages) {
                 if (message.clientId && self.rest.auth.clientId_nosync && ![message.clientId isEqualToString:self.rest.auth.clientId_nosync]) {
                     callback([ARTErrorInfo createWithCode:ARTStateMismatchedClientId message:@"attempted to publish message with an invalid clientId"]);
                     return;
                 }
-                if (baseId) {
-                    message.id = [NSString stringWithFormat:@"%@:%ld", baseId, (long)serial];
-                }
-                serial += 1;
             }
+            [self assignIdempotentIdsIfNeeded:messages];
+            idempotent = messages.count > 0 && [messages artFilter:^BOOL(ARTMessage *m) { return m.isIdEmpty; }].count == 0;
             
             NSError *encodeError = nil;
             encodedMessage = [self.rest.defaultEncoder encodeMessages:data error:&encodeError];
@@ -356,6 +359,10 @@ dispatch_sync(_queue, ^{
         NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[components URL]];
         request.HTTPMethod = @"POST";
         request.HTTPBody = encodedMessage;
+        if (idempotent) {
+            // Duplicates are discarded by Ably, so the request may be hedged or retried safely.
+            [request markAsIdempotent];
+        }
         
         if (self.rest.defaultEncoding) {
             [request setValue:self.rest.defaultEncoding forHTTPHeaderField:@"Content-Type"];
@@ -15,6 +15,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)initWithRest:(ARTRestInternal *)rest;
 - (ARTRestChannelInternal *)_getChannel:(NSString *)name options:(ARTChannelOptions * _Nullable)options addPrefix:(BOOL)addPrefix;
+/// The channel already registered under the prefixed `name`, or else a new one with default options that is not registered and lives only as long as the caller keeps it.
+- (ARTRestChannelInternal *)_getTransientChannel:(NSString *)name;
 
 @end
 
@@ -91,4 +91,13 @@
     return [_channels _getChannel:name options:options addPrefix:addPrefix];
 }
 
+- (ARTRestChannelInternal *)_getTransientChannel:(NSString *)name {
+    name = [_channels addPrefix:name];
+    ARTRestChannelInternal *channel = [_channels _get:name];
+    if (!channel) {
+        channel = [self makeChannel:name options:nil];
+    }
+    return channel;
+}
+
 @end
@@ -1,5 +1,6 @@
 #import "ARTStats.h"
 #import "ARTDataQuery+Private.h"
+#import "ARTStatsIntervalId.h"
 
 @implementation ARTStatsQuery
 
@@ -48,7 +49,12 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsMessageCount alloc] initWithCount:0 data:0];
+    static ARTStatsMessageCount *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsMessageCount alloc] initWithCount:0 data:0];
+    });
+    return empty;
 }
 
 @end
@@ -66,7 +72,12 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsMessageTypes alloc] initWithAll:[ARTStatsMessageCount empty]  messages:[ARTStatsMessageCount empty] presence:[ARTStatsMessageCount empty]];
+    static ARTStatsMessageTypes *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsMessageTypes alloc] initWithAll:[ARTStatsMessageCount empty]  messages:[ARTStatsMessageCount empty] presence:[ARTStatsMessageCount empty]];
+    });
+    return empty;
 }
 
 @end
@@ -85,7 +96,12 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsMessageTraffic alloc] initWithAll:[ARTStatsMessageTypes empty] realtime:[ARTStatsMessageTypes empty] rest:[ARTStatsMessageTypes empty] webhook:[ARTStatsMessageTypes empty]];
+    static ARTStatsMessageTraffic *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsMessageTraffic alloc] initWithAll:[ARTStatsMessageTypes empty] realtime:[ARTStatsMessageTypes empty] rest:[ARTStatsMessageTypes empty] webhook:[ARTStatsMessageTypes empty]];
+    });
+    return empty;
 }
 
 @end
@@ -105,7 +121,12 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsResourceCount alloc] initWithOpened:0 peak:0 mean:0 min:0 refused:0];
+    static ARTStatsResourceCount *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsResourceCount alloc] initWithOpened:0 peak:0 mean:0 min:0 refused:0];
+    });
+    return empty;
 }
 
 @end
@@ -123,7 +144,12 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsConnectionTypes alloc] initWithAll:[ARTStatsResourceCount empty] plain:[ARTStatsResourceCount empty] tls:[ARTStatsResourceCount empty]];
+    static ARTStatsConnectionTypes *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsConnectionTypes alloc] initWithAll:[ARTStatsResourceCount empty] plain:[ARTStatsResourceCount empty] tls:[ARTStatsResourceCount empty]];
+    });
+    return empty;
 }
 
 @end
@@ -141,7 +167,12 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsRequestCount alloc] initWithSucceeded:0 failed:0 refused:0];
+    static ARTStatsRequestCount *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsRequestCount alloc] initWithSucceeded:0 failed:0 refused:0];
+    });
+    return empty;
 }
 
 @end
@@ -167,13 +198,31 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 + (instancetype)empty {
-    return [[ARTStatsPushCount alloc] initWithSucceeded:0 invalid:0 attempted:0 failed:0 messages:0 direct:0];
+    static ARTStatsPushCount *empty;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        empty = [[ARTStatsPushCount alloc] initWithSucceeded:0 invalid:0 attempted:0 failed:0 messages:0 direct:0];
+    });
+    return empty;
 }
 
 @end
 
 @implementation ARTStats
 
+// Like the date formatters these replace, only an unknown length throws; a malformed date gives nil.
+static NSDate *dateFromIntervalId(NSString *intervalId, NSString *reason) {
+    ARTStatsGranularity granularity;
+    if (!ARTStatsIntervalIdGranularity(intervalId, &granularity)) {
+        @throw [ARTException exceptionWithName:NSInvalidArgumentException reason:reason userInfo:nil];
+    }
+    int64_t seconds;
+    if (!ARTStatsIntervalIdParse(intervalId, NULL, &seconds)) {
+        return nil;
+    }
+    return [NSDate dateWithTimeIntervalSince1970:seconds];
+}
+
 - (instancetype)initWithAll:(ARTStatsMessageTypes *)all
                     inbound:(ARTStatsMessageTraffic *)inbound
                    outbound:(ARTStatsMessageTraffic *)outbound
@@ -204,41 +253,20 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
     return self;
 }
 
-+ (NSArray *)intervalFormatString {
-    static NSArray *formats;
-    if (!formats) {
-        formats = [NSArray arrayWithObjects:@"yyyy-MM-dd:HH:mm", @"yyyy-MM-dd:HH", @"yyyy-MM-dd", @"yyyy-MM", nil];
-    }
-    return formats;
-}
-
 + (NSDate *)dateFromIntervalId:(NSString *)intervalId {
-    for (NSString *format in [ARTStats intervalFormatString]) {
-        if ([format length] == [intervalId length]) {
-            NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
-            formatter.dateFormat = format;
-            formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
-            return [formatter dateFromString:intervalId];
-        }
-    }
-    @throw [ARTException exceptionWithName:NSInvalidArgumentException reason:@"invalid intervalId" userInfo:nil];
+    return dateFromIntervalId(intervalId, @"invalid intervalId");
 }
 
 + (ARTStatsGranularity)granularityFromIntervalId:(NSString *)intervalId {
-    NSArray *formats = [ARTStats intervalFormatString];
-    for (int i = 0; i < [formats count]; i++) {
-        if ([[formats objectAtIndex:i] length] == [intervalId length]) {
-            return (ARTStatsGranularity)i;
-        }
+    ARTStatsGranularity granularity;
+    if (!ARTStatsIntervalIdGranularity(intervalId, &granularity)) {
+        @throw [ARTException exceptionWithName:NSInvalidArgumentException reason:@"invalid intervalId" userInfo:nil];
     }
-    @throw [ARTException exceptionWithName:NSInvalidArgumentException reason:@"invalid intervalId" userInfo:nil];
+    return granularity;
 }
 
 + (NSString *)toIntervalId:(NSDate *)time granularity:(ARTStatsGranularity)granularity {
-    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
-    formatter.dateFormat = [[ARTStats intervalFormatString] objectAtIndex:granularity];
-    formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
-    return [formatter stringFromDate:time];
+    return ARTStatsIntervalIdFormat((int64_t)floor(time.timeIntervalSince1970), granularity);
 }
 
 - (ARTStatsGranularity)intervalGranularity {
@@ -250,15 +278,7 @@ static NSString *statsUnitToString(ARTStatsGranularity unit) {
 }
 
 - (NSDate *)dateFromInProgress {
-    for (NSString *format in [ARTStats intervalFormatString]) {
-        if ([format length] == [_inProgress length]) {
-            NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
-            formatter.dateFormat = format;
-            formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
-            return [formatter dateFromString:_inProgress];
-        }
-    }
-    @throw [ARTException exceptionWithName:NSInvalidArgumentException reason:@"invalid inProgress" userInfo:nil];
+    return dateFromIntervalId(_inProgress, @"invalid inProgress");
 }
 
 @end
@@ -0,0 +1,103 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTStats.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A columnar store of `ARTStats` intervals of a single granularity, for aggregating stats retrieved with `-[ARTRest stats:callback:]` without fetching them again at another unit.
+ *
+ * Each field of `ARTStats` is stored as a column of integers, named by its key path, such as `inbound.realtime.messages.count` or `connections.all.peak`. A column is only allocated once one of its values isn't zero. Intervals are kept ordered by time; adding an interval that is already stored replaces it.
+ *
+ * An `ARTStatsRollup` isn't thread-safe: it must only be used from one thread at a time.
+ */
+@interface ARTStatsRollup : NSObject
+
+/**
+ * The unit of the stored intervals.
+ */
+@property (nonatomic, readonly) ARTStatsGranularity granularity;
+
+/**
+ * The number of stored intervals.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * The key paths of the `ARTStats` fields stored, in column order.
+ *
+ * When intervals are rolled up, `peak` fields take the maximum, `min` fields the minimum, `mean` fields the mean weighted by the number of intervals of the store's original unit, and all other fields the sum.
+ */
+@property (class, nonatomic, readonly) NSArray<NSString *> *fields;
+
+/// :nodoc:
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+/**
+ * Creates an empty store.
+ *
+ * @param granularity The unit of the intervals to store.
+ */
+- (instancetype)initWithGranularity:(ARTStatsGranularity)granularity;
+
+/**
+ * Stores an interval.
+ *
+ * @param stats The stats of the interval.
+ *
+ * @return `NO` if the interval was skipped because its `intervalId` isn't valid or isn't of the store's unit.
+ */
+- (BOOL)addStats:(ARTStats *)stats NS_SWIFT_NAME(add(_:));
+
+/**
+ * Stores each interval of an array, as with `-[ARTStatsRollup addStats:]`.
+ *
+ * @param stats An array of `ARTStats` objects, such as the items of an `ARTPaginatedResult`.
+ */
+- (void)addStatsFromArray:(NSArray<ARTStats *> *)stats NS_SWIFT_NAME(add(_:));
+
+/**
+ * The interval id of the interval at `index`, in the format described by `ARTStats.intervalId`.
+ */
+- (NSString *)intervalIdAtIndex:(NSUInteger)index;
+
+/**
+ * The start of the interval at `index`.
+ */
+- (NSDate *)intervalTimeAtIndex:(NSUInteger)index;
+
+/**
+ * The interval at `index`, as an `ARTStats` object.
+ */
+- (ARTStats *)statsAtIndex:(NSUInteger)index;
+
+/**
+ * The value of a field for the interval at `index`. `0` if `field` isn't one of `ARTStatsRollup.fields`.
+ */
+- (NSUInteger)valueForField:(NSString *)field atIndex:(NSUInteger)index;
+
+/**
+ * The values of a field for each interval, in order.
+ *
+ * @return `nil` if `field` isn't one of `ARTStatsRollup.fields`.
+ */
+- (nullable NSArray<NSNumber *> *)valuesForField:(NSString *)field;
+
+/**
+ * The change of a field from the interval immediately before each interval, in order. If the interval before isn't stored, its value is taken as `0`.
+ *
+ * @return `nil` if `field` isn't one of `ARTStatsRollup.fields`.
+ */
+- (nullable NSArray<NSNumber *> *)deltasForField:(NSString *)field;
+
+/**
+ * Aggregates the stored intervals into intervals of a coarser unit.
+ *
+ * @param granularity The unit of the new store. Must be the same as or coarser than `granularity`.
+ *
+ * @return A new store, or `nil` if `granularity` is finer than the store's unit.
+ */
+- (nullable ARTStatsRollup *)rollupToGranularity:(ARTStatsGranularity)granularity;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,524 @@
+#import "ARTStatsRollup.h"
+#import "ARTStatsIntervalId.h"
+
+typedef NS_ENUM(uint8_t, ARTStatsRollupAggregation) {
+    ARTStatsRollupAggregationSum,
+    ARTStatsRollupAggregationMax,
+    ARTStatsRollupAggregationMin,
+    ARTStatsRollupAggregationMean
+};
+
+enum { ARTStatsRollupColumnCount = 92 };
+
+typedef struct {
+    int64_t start;
+    NSUInteger row;
+} ARTStatsRollupRow;
+
+static int compareRows(const void *a, const void *b) {
+    const ARTStatsRollupRow *left = a, *right = b;
+    if (left->start != right->start) {
+        return left->start < right->start ? -1 : 1;
+    }
+    return left->row < right->row ? -1 : (left->row > right->row ? 1 : 0);
+}
+
+#pragma mark - Fields
+
+// The functions below each walk the fields of `ARTStats` in the same order, which is the column order.
+
+static void addMessageCountFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    [fields addObject:[prefix stringByAppendingString:@".count"]];
+    [fields addObject:[prefix stringByAppendingString:@".data"]];
+}
+
+static void addMessageTypesFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    addMessageCountFields(fields, [prefix stringByAppendingString:@".all"]);
+    addMessageCountFields(fields, [prefix stringByAppendingString:@".messages"]);
+    addMessageCountFields(fields, [prefix stringByAppendingString:@".presence"]);
+}
+
+static void addMessageTrafficFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    addMessageTypesFields(fields, [prefix stringByAppendingString:@".all"]);
+    addMessageTypesFields(fields, [prefix stringByAppendingString:@".realtime"]);
+    addMessageTypesFields(fields, [prefix stringByAppendingString:@".rest"]);
+    addMessageTypesFields(fields, [prefix stringByAppendingString:@".webhook"]);
+}
+
+static void addResourceCountFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    for (NSString *field in @[@".opened", @".peak", @".mean", @".min", @".refused"]) {
+        [fields addObject:[prefix stringByAppendingString:field]];
+    }
+}
+
+static void addConnectionTypesFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    addResourceCountFields(fields, [prefix stringByAppendingString:@".all"]);
+    addResourceCountFields(fields, [prefix stringByAppendingString:@".plain"]);
+    addResourceCountFields(fields, [prefix stringByAppendingString:@".tls"]);
+}
+
+static void addRequestCountFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    for (NSString *field in @[@".succeeded", @".failed", @".refused"]) {
+        [fields addObject:[prefix stringByAppendingString:field]];
+    }
+}
+
+static void addPushCountFields(NSMutableArray<NSString *> *fields, NSString *prefix) {
+    for (NSString *field in @[@".succeeded", @".invalid", @".attempted", @".failed", @".messages", @".direct"]) {
+        [fields addObject:[prefix stringByAppendingString:field]];
+    }
+}
+
+static uint64_t *readMessageCount(ARTStatsMessageCount *count, uint64_t *values) {
+    *values++ = count.count;
+    *values++ = count.data;
+    return values;
+}
+
+static uint64_t *readMessageTypes(ARTStatsMessageTypes *types, uint64_t *values) {
+    values = readMessageCount(types.all, values);
+    values = readMessageCount(types.messages, values);
+    return readMessageCount(types.presence, values);
+}
+
+static uint64_t *readMessageTraffic(ARTStatsMessageTraffic *traffic, uint64_t *values) {
+    values = readMessageTypes(traffic.all, values);
+    values = readMessageTypes(traffic.realtime, values);
+    values = readMessageTypes(traffic.rest, values);
+    return readMessageTypes(traffic.webhook, values);
+}
+
+static uint64_t *readResourceCount(ARTStatsResourceCount *count, uint64_t *values) {
+    *values++ = count.opened;
+    *values++ = count.peak;
+    *values++ = count.mean;
+    *values++ = count.min;
+    *values++ = count.refused;
+    return values;
+}
+
+static uint64_t *readConnectionTypes(ARTStatsConnectionTypes *types, uint64_t *values) {
+    values = readResourceCount(types.all, values);
+    values = readResourceCount(types.plain, values);
+    return readResourceCount(types.tls, values);
+}
+
+static uint64_t *readRequestCount(ARTStatsRequestCount *count, uint64_t *values) {
+    *values++ = count.succeeded;
+    *values++ = count.failed;
+    *values++ = count.refused;
+    return values;
+}
+
+static uint64_t *readPushCount(ARTStatsPushCount *count, uint64_t *values) {
+    *values++ = count.succeeded;
+    *values++ = count.invalid;
+    *values++ = count.attempted;
+    *values++ = count.failed;
+    *values++ = count.messages;
+    *values++ = count.direct;
+    return values;
+}
+
+static void readStats(ARTStats *stats, uint64_t *values) {
+    values = readMessageTypes(stats.all, values);
+    values = readMessageTraffic(stats.inbound, values);
+    values = readMessageTraffic(stats.outbound, values);
+    values = readMessageTypes(stats.persisted, values);
+    values = readConnectionTypes(stats.connections, values);
+    values = readResourceCount(stats.channels, values);
+    values = readRequestCount(stats.apiRequests, values);
+    values = readRequestCount(stats.tokenRequests, values);
+    readPushCount(stats.pushes, values);
+}
+
+static ARTStatsMessageCount *makeMessageCount(const uint64_t **values) {
+    const uint64_t *v = *values;
+    *values += 2;
+    return [[ARTStatsMessageCount alloc] initWithCount:v[0] data:v[1]];
+}
+
+static ARTStatsMessageTypes *makeMessageTypes(const uint64_t **values) {
+    ARTStatsMessageCount *all = makeMessageCount(values);
+    ARTStatsMessageCount *messages = makeMessageCount(values);
+    ARTStatsMessageCount *presence = makeMessageCount(values);
+    return [[ARTStatsMessageTypes alloc] initWithAll:all messages:messages presence:presence];
+}
+
+static ARTStatsMessageTraffic *makeMessageTraffic(const uint64_t **values) {
+    ARTStatsMessageTypes *all = makeMessageTypes(values);
+    ARTStatsMessageTypes *realtime = makeMessageTypes(values);
+    ARTStatsMessageTypes *rest = makeMessageTypes(values);
+    ARTStatsMessageTypes *webhook = makeMessageTypes(values);
+    return [[ARTStatsMessageTraffic alloc] initWithAll:all realtime:realtime rest:rest webhook:webhook];
+}
+
+static ARTStatsResourceCount *makeResourceCount(const uint64_t **values) {
+    const uint64_t *v = *values;
+    *values += 5;
+    return [[ARTStatsResourceCount alloc] initWithOpened:v[0] peak:v[1] mean:v[2] min:v[3] refused:v[4]];
+}
+
+static ARTStatsConnectionTypes *makeConnectionTypes(const uint64_t **values) {
+    ARTStatsResourceCount *all = makeResourceCount(values);
+    ARTStatsResourceCount *plain = makeResourceCount(values);
+    ARTStatsResourceCount *tls = makeResourceCount(values);
+    return [[ARTStatsConnectionTypes alloc] initWithAll:all plain:plain tls:tls];
+}
+
+static ARTStatsRequestCount *makeRequestCount(const uint64_t **values) {
+    const uint64_t *v = *values;
+    *values += 3;
+    return [[ARTStatsRequestCount alloc] initWithSucceeded:v[0] failed:v[1] refused:v[2]];
+}
+
+static ARTStatsPushCount *makePushCount(const uint64_t **values) {
+    const uint64_t *v = *values;
+    *values += 6;
+    return [[ARTStatsPushCount alloc] initWithSucceeded:v[0] invalid:v[1] attempted:v[2] failed:v[3] messages:v[4] direct:v[5]];
+}
+
+static NSArray<NSString *> *rollupFields(void) {
+    static NSArray<NSString *> *fields;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        NSMutableArray<NSString *> *names = [NSMutableArray arrayWithCapacity:ARTStatsRollupColumnCount];
+        addMessageTypesFields(names, @"all");
+        addMessageTrafficFields(names, @"inbound");
+        addMessageTrafficFields(names, @"outbound");
+        addMessageTypesFields(names, @"persisted");
+        addConnectionTypesFields(names, @"connections");
+        addResourceCountFields(names, @"channels");
+        addRequestCountFields(names, @"apiRequests");
+        addRequestCountFields(names, @"tokenRequests");
+        addPushCountFields(names, @"pushes");
+        NSCAssert(names.count == ARTStatsRollupColumnCount, @"Unexpected number of stats fields");
+        fields = [names copy];
+    });
+    return fields;
+}
+
+static NSDictionary<NSString *, NSNumber *> *rollupColumnsByField(void) {
+    static NSDictionary<NSString *, NSNumber *> *columns;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        NSArray<NSString *> *fields = rollupFields();
+        NSMutableDictionary<NSString *, NSNumber *> *byField = [NSMutableDictionary dictionaryWithCapacity:fields.count];
+        [fields enumerateObjectsUsingBlock:^(NSString *field, NSUInteger column, BOOL *stop) {
+            byField[field] = @(column);
+        }];
+        columns = [byField copy];
+    });
+    return columns;
+}
+
+static const ARTStatsRollupAggregation *rollupAggregations(void) {
+    static ARTStatsRollupAggregation aggregations[ARTStatsRollupColumnCount];
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        [rollupFields() enumerateObjectsUsingBlock:^(NSString *field, NSUInteger column, BOOL *stop) {
+            if ([field hasSuffix:@".peak"]) {
+                aggregations[column] = ARTStatsRollupAggregationMax;
+            } else if ([field hasSuffix:@".min"]) {
+                aggregations[column] = ARTStatsRollupAggregationMin;
+            } else if ([field hasSuffix:@".mean"]) {
+                aggregations[column] = ARTStatsRollupAggregationMean;
+            } else {
+                aggregations[column] = ARTStatsRollupAggregationSum;
+            }
+        }];
+    });
+    return aggregations;
+}
+
+#pragma mark - ARTStatsRollup
+
+@implementation ARTStatsRollup {
+    // A column stays `NULL` while all its values are 0.
+    uint64_t *_columns[ARTStatsRollupColumnCount];
+    int64_t *_starts;
+    // The number of intervals of the original unit aggregated into each row, for weighting means.
+    uint32_t *_weights;
+    NSUInteger _rows;
+    NSUInteger _capacity;
+    BOOL _needsSort;
+}
+
++ (NSArray<NSString *> *)fields {
+    return rollupFields();
+}
+
+- (instancetype)initWithGranularity:(ARTStatsGranularity)granularity {
+    if (self = [super init]) {
+        _granularity = granularity;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger column = 0; column < ARTStatsRollupColumnCount; column++) {
+        free(_columns[column]);
+    }
+    free(_starts);
+    free(_weights);
+}
+
+- (NSUInteger)count {
+    [self sortIfNeeded];
+    return _rows;
+}
+
+- (BOOL)addStats:(ARTStats *)stats {
+    ARTStatsGranularity granularity;
+    int64_t start;
+    if (!ARTStatsIntervalIdParse(stats.intervalId, &granularity, &start) || granularity != _granularity) {
+        return NO;
+    }
+    uint64_t values[ARTStatsRollupColumnCount];
+    readStats(stats, values);
+    [self appendRowWithStart:start weight:1 values:values];
+    return YES;
+}
+
+- (void)addStatsFromArray:(NSArray<ARTStats *> *)stats {
+    for (ARTStats *item in stats) {
+        [self addStats:item];
+    }
+}
+
+- (void)appendRowWithStart:(int64_t)start weight:(uint32_t)weight values:(const uint64_t *)values {
+    if (_rows > 0 && start <= _starts[_rows - 1]) {
+        _needsSort = YES;
+    }
+    if (_rows == _capacity) {
+        [self growCapacity];
+    }
+    const NSUInteger row = _rows++;
+    _starts[row] = start;
+    _weights[row] = weight;
+    for (NSUInteger column = 0; column < ARTStatsRollupColumnCount; column++) {
+        if (!_columns[column]) {
+            if (values[column] == 0) {
+                continue;
+            }
+            _columns[column] = calloc(_capacity, sizeof(uint64_t));
+        }
+        _columns[column][row] = values[column];
+    }
+}
+
+- (void)growCapacity {
+    _capacity = MAX(_capacity * 2, 64);
+    _starts = realloc(_starts, _capacity * sizeof(int64_t));
+    _weights = realloc(_weights, _capacity * sizeof(uint32_t));
+    for (NSUInteger column = 0; column < ARTStatsRollupColumnCount; column++) {
+        if (_columns[column]) {
+            _columns[column] = realloc(_columns[column], _capacity * sizeof(uint64_t));
+        }
+    }
+}
+
+// Orders the rows by time, keeping only the last row added for each interval.
+- (void)sortIfNeeded {
+    if (!_needsSort) {
+        return;
+    }
+    _needsSort = NO;
+
+    ARTStatsRollupRow *order = malloc(_rows * sizeof(ARTStatsRollupRow));
+    for (NSUInteger row = 0; row < _rows; row++) {
+        order[row] = (ARTStatsRollupRow){ .start = _starts[row], .row = row };
+    }
+    qsort(order, _rows, sizeof(ARTStatsRollupRow), compareRows);
+    NSUInteger kept = 0;
+    for (NSUInteger i = 0; i < _rows; i++) {
+        if (i + 1 < _rows && order[i + 1].start == order[i].start) {
+            continue;
+        }
+        order[kept++] = order[i];
+    }
+
+    int64_t *starts = malloc(_capacity * sizeof(int64_t));
+    uint32_t *weights = malloc(_capacity * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < kept; i++) {
+        starts[i] = order[i].start;
+        weights[i] = _weights[order[i].row];
+    }
+    free(_starts);
+    free(_weights);
+    _starts = starts;
+    _weights = weights;
+    for (NSUInteger column = 0; column < ARTStatsRollupColumnCount; column++) {
+        const uint64_t *values = _columns[column];
+        if (!values) {
+            continue;
+        }
+        uint64_t *sorted = malloc(_capacity * sizeof(uint64_t));
+        for (NSUInteger i = 0; i < kept; i++) {
+            sorted[i] = values[order[i].row];
+        }
+        free(_columns[column]);
+        _columns[column] = sorted;
+    }
+    _rows = kept;
+    free(order);
+}
+
+- (void)checkIndex:(NSUInteger)index {
+    [self sortIfNeeded];
+    if (index >= _rows) {
+        @throw [NSException exceptionWithName:NSRangeException reason:[NSString stringWithFormat:@"index %lu beyond bounds [0 .. %lu]", (unsigned long)index, (unsigned long)_rows - 1] userInfo:nil];
+    }
+}
+
+- (NSString *)intervalIdAtIndex:(NSUInteger)index {
+    [self checkIndex:index];
+    return ARTStatsIntervalIdFormat(_starts[index], _granularity);
+}
+
+- (NSDate *)intervalTimeAtIndex:(NSUInteger)index {
+    [self checkIndex:index];
+    return [NSDate dateWithTimeIntervalSince1970:_starts[index]];
+}
+
+- (ARTStats *)statsAtIndex:(NSUInteger)index {
+    [self checkIndex:index];
+    uint64_t row[ARTStatsRollupColumnCount];
+    for (NSUInteger column = 0; column < ARTStatsRollupColumnCount; column++) {
+        row[column] = _columns[column] ? _columns[column][index] : 0;
+    }
+    const uint64_t *values = row;
+    ARTStatsMessageTypes *all = makeMessageTypes(&values);
+    ARTStatsMessageTraffic *inbound = makeMessageTraffic(&values);
+    ARTStatsMessageTraffic *outbound = makeMessageTraffic(&values);
+    ARTStatsMessageTypes *persisted = makeMessageTypes(&values);
+    ARTStatsConnectionTypes *connections = makeConnectionTypes(&values);
+    ARTStatsResourceCount *channels = makeResourceCount(&values);
+    ARTStatsRequestCount *apiRequests = makeRequestCount(&values);
+    ARTStatsRequestCount *tokenRequests = makeRequestCount(&values);
+    ARTStatsPushCount *pushes = makePushCount(&values);
+    // Stored intervals are taken as complete.
+    NSString *inProgress = nil;
+    return [[ARTStats alloc] initWithAll:all
+                                 inbound:inbound
+                                outbound:outbound
+                               persisted:persisted
+                             connections:connections
+                                channels:channels
+                             apiRequests:apiRequests
+                           tokenRequests:tokenRequests
+                                  pushes:pushes
+                              inProgress:inProgress
+                                   count:0
+                              intervalId:ARTStatsIntervalIdFormat(_starts[index], _granularity)];
+}
+
+- (NSUInteger)valueForField:(NSString *)field atIndex:(NSUInteger)index {
+    [self checkIndex:index];
+    NSNumber *column = rollupColumnsByField()[field];
+    if (!column || !_columns[column.unsignedIntegerValue]) {
+        return 0;
+    }
+    return _columns[column.unsignedIntegerValue][index];
+}
+
+- (NSArray<NSNumber *> *)valuesForField:(NSString *)field {
+    NSNumber *column = rollupColumnsByField()[field];
+    if (!column) {
+        return nil;
+    }
+    [self sortIfNeeded];
+    const uint64_t *values = _columns[column.unsignedIntegerValue];
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:_rows];
+    for (NSUInteger row = 0; row < _rows; row++) {
+        [result addObject:@(values ? values[row] : 0)];
+    }
+    return result;
+}
+
+- (NSArray<NSNumber *> *)deltasForField:(NSString *)field {
+    NSNumber *column = rollupColumnsByField()[field];
+    if (!column) {
+        return nil;
+    }
+    [self sortIfNeeded];
+    const uint64_t *values = _columns[column.unsignedIntegerValue];
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:_rows];
+    for (NSUInteger row = 0; row < _rows; row++) {
+        if (!values) {
+            [result addObject:@0];
+            continue;
+        }
+        int64_t previous = 0;
+        // Rows are ordered and unique, so the interval before, if stored, is the row before.
+        if (row > 0 && _starts[row - 1] == ARTStatsIntervalStart(_starts[row] - 1, _granularity)) {
+            previous = (int64_t)values[row - 1];
+        }
+        [result addObject:@((int64_t)values[row] - previous)];
+    }
+    return result;
+}
+
+- (ARTStatsRollup *)rollupToGranularity:(ARTStatsGranularity)granularity {
+    if (granularity < _granularity) {
+        return nil;
+    }
+    [self sortIfNeeded];
+    const ARTStatsRollupAggregation *aggregations = rollupAggregations();
+    ARTStatsRollup *rollup = [[ARTStatsRollup alloc] initWithGranularity:granularity];
+    uint64_t values[ARTStatsRollupColumnCount];
+
+    NSUInteger first = 0;
+    while (first < _rows) {
+        const int64_t start = ARTStatsIntervalStart(_starts[first], granularity);
+        NSUInteger end = first + 1;
+        while (end < _rows && ARTStatsIntervalStart(_starts[end], granularity) == start) {
+            end++;
+        }
+        uint64_t weight = 0;
+        for (NSUInteger row = first; row < end; row++) {
+            weight += _weights[row];
+        }
+
+        for (NSUInteger column = 0; column < ARTStatsRollupColumnCount; column++) {
+            const uint64_t *columnValues = _columns[column];
+            if (!columnValues) {
+                values[column] = 0;
+                continue;
+            }
+            uint64_t value = columnValues[first];
+            switch (aggregations[column]) {
+                case ARTStatsRollupAggregationSum:
+                    for (NSUInteger row = first + 1; row < end; row++) {
+                        value += columnValues[row];
+                    }
+                    break;
+                case ARTStatsRollupAggregationMax:
+                    for (NSUInteger row = first + 1; row < end; row++) {
+                        value = MAX(value, columnValues[row]);
+                    }
+                    break;
+                case ARTStatsRollupAggregationMin:
+                    for (NSUInteger row = first + 1; row < end; row++) {
+                        value = MIN(value, columnValues[row]);
+                    }
+                    break;
+                case ARTStatsRollupAggregationMean: {
+                    double total = 0;
+                    for (NSUInteger row = first; row < end; row++) {
+                        total += (double)columnValues[row] * _weights[row];
+                    }
+                    value = (uint64_t)llround(total / weight);
+                    break;
+                }
+            }
+            values[column] = value;
+        }
+
+        [rollup appendRowWithStart:start weight:(uint32_t)MIN(weight, UINT32_MAX) values:values];
+        first = end;
+    }
+    return rollup;
+}
+
+@end
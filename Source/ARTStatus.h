@@ -21,6 +21,7 @@ typedef NS_ENUM(NSUInteger, ARTState) {
     ARTStateAuthorizationFailed,
     ARTStateAuthUrlIncompatibleContent,
     ARTStateBadConnectionState,
+    ARTStatePublishQueueFull,
     ARTStateError = 99999
 };
 
@@ -0,0 +1,51 @@
+#import <Foundation/Foundation.h>
+
+@class ARTLog;
+@class ARTClientOptions;
+@class ARTTokenDetails;
+@protocol ARTDeviceStorage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Tokens that expire within this interval are not restored from the cache.
+extern const NSTimeInterval ARTTokenDetailsCacheExpiryMargin;
+
+/// A cached clock offset saved longer ago than this is not restored, as the local clock may have drifted since.
+extern const NSTimeInterval ARTTokenDetailsCacheTimeOffsetMaxAge;
+
+/// Returns the storage to use for each read or write, so that a client's storage can be replaced after the cache is created.
+typedef id<ARTDeviceStorage> _Nullable (^ARTTokenDetailsCacheStorageProvider)(void);
+
+/**
+ Persists the last obtained `ARTTokenDetails` and local clock offset (RSA10k) so that a new client
+ can make its first request without going through `authUrl`, `authCallback` or `/time` again.
+
+ The entry is kept through the storage's cached token details accessors (Keychain-backed in `ARTLocalDeviceStorage`),
+ so it is encrypted at rest. Entries are scoped by host, key name/auth URL and client ID.
+ */
+@interface ARTTokenDetailsCache : NSObject
+
+@property (nonatomic, readonly) NSString *cacheKey;
+
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+- (instancetype)initWithStorageProvider:(ARTTokenDetailsCacheStorageProvider)storageProvider options:(ARTClientOptions *)options logger:(nullable ARTLog *)logger;
+- (instancetype)initWithStorage:(id<ARTDeviceStorage>)storage options:(ARTClientOptions *)options logger:(nullable ARTLog *)logger;
+
++ (NSString *)cacheKeyForOptions:(ARTClientOptions *)options;
+
+/**
+ Returns the cached token if it has not expired (taking the cached clock offset into account)
+ and its `clientId` is compatible with `clientId`. An invalid entry is removed from storage.
+ */
+- (nullable ARTTokenDetails *)loadTokenDetailsForClientId:(nullable NSString *)clientId timeOffset:(NSNumber *_Nullable *_Nullable)timeOffset NS_SWIFT_NAME(loadTokenDetails(forClientId:timeOffset:));
+
+- (void)storeTokenDetails:(ARTTokenDetails *)tokenDetails timeOffset:(nullable NSNumber *)timeOffset NS_SWIFT_NAME(store(_:timeOffset:));
+
+- (void)clear;
+
+/// Writes the stored entry before returning, if the storage writes behind its callers.
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,147 @@
+#import "ARTTokenDetailsCache.h"
+#import "ARTDeviceStorage.h"
+#import "ARTClientOptions.h"
+#import "ARTTokenDetails.h"
+#import "ARTLog.h"
+#import "ARTDeviceStorageWriter.h"
+
+const NSTimeInterval ARTTokenDetailsCacheExpiryMargin = 15.0; //Seconds
+const NSTimeInterval ARTTokenDetailsCacheTimeOffsetMaxAge = 24 * 60 * 60; //Seconds
+
+static NSString *const ARTTokenDetailsCacheKeyPrefix = @"ARTTokenDetailsCache";
+
+@implementation ARTTokenDetailsCache {
+    ARTTokenDetailsCacheStorageProvider _storageProvider;
+    ARTLog *_logger;
+}
+
+- (instancetype)initWithStorageProvider:(ARTTokenDetailsCacheStorageProvider)storageProvider options:(ARTClientOptions *)options logger:(ARTLog *)logger {
+    if (self = [super init]) {
+        _storageProvider = storageProvider;
+        _logger = logger;
+        _cacheKey = [self.class cacheKeyForOptions:options];
+    }
+    return self;
+}
+
+- (instancetype)initWithStorage:(id<ARTDeviceStorage>)storage options:(ARTClientOptions *)options logger:(ARTLog *)logger {
+    return [self initWithStorageProvider:^{ return storage; } options:options logger:logger];
+}
+
+- (id<ARTDeviceStorage>)storage {
+    id<ARTDeviceStorage> storage = _storageProvider();
+    if (![storage respondsToSelector:@selector(cachedTokenDetailsForKey:)] || ![storage respondsToSelector:@selector(setCachedTokenDetails:forKey:)]) {
+        return nil;
+    }
+    return storage;
+}
+
++ (NSString *)cacheKeyForOptions:(ARTClientOptions *)options {
+    NSString *identity;
+    if (options.key) {
+        // Only the key name; the secret must never be part of a storage key.
+        identity = [options.key componentsSeparatedByString:@":"].firstObject;
+    }
+    else if (options.authUrl) {
+        identity = options.authUrl.absoluteString;
+    }
+    else {
+        identity = @"authCallback";
+    }
+    return [NSString stringWithFormat:@"%@:%@:%@:%@", ARTTokenDetailsCacheKeyPrefix, options.restHost, identity, options.clientId ?: @"*"];
+}
+
+- (ARTTokenDetails *)loadTokenDetailsForClientId:(NSString *)clientId timeOffset:(NSNumber **)timeOffset {
+    NSString *serialized = [[self storage] cachedTokenDetailsForKey:_cacheKey];
+    if (!serialized) {
+        return nil;
+    }
+
+    NSDictionary *entry = [NSJSONSerialization JSONObjectWithData:[serialized dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+    if (![entry isKindOfClass:[NSDictionary class]] || ![entry[@"token"] isKindOfClass:[NSString class]]) {
+        [_logger warn:@"ARTTokenDetailsCache: discarding unreadable entry"];
+        [self clear];
+        return nil;
+    }
+
+    NSNumber *expires = entry[@"expires"];
+    NSNumber *issued = entry[@"issued"];
+    NSNumber *savedAt = entry[@"savedAt"];
+    NSNumber *offset = entry[@"timeOffset"];
+
+    if (expires == nil) {
+        // Without an expiry there is no way to validate the token client-side.
+        [self clear];
+        return nil;
+    }
+
+    // The offset is only meaningful if the local clock hasn't gone backwards since it was computed, nor had long to drift.
+    if (offset != nil) {
+        const NSTimeInterval age = [[NSDate date] timeIntervalSince1970] - savedAt.doubleValue;
+        if (savedAt == nil || age < 0 || age > ARTTokenDetailsCacheTimeOffsetMaxAge) {
+            offset = nil;
+        }
+    }
+
+    NSDate *now = [[NSDate date] dateByAddingTimeInterval:offset.doubleValue];
+    NSDate *expiresDate = [NSDate dateWithTimeIntervalSince1970:millisecondsToTimeInterval(expires.unsignedLongLongValue)];
+    if ([expiresDate timeIntervalSinceDate:now] <= ARTTokenDetailsCacheExpiryMargin) {
+        [_logger debug:__FILE__ line:__LINE__ message:@"ARTTokenDetailsCache: cached token has expired"];
+        [self clear];
+        return nil;
+    }
+
+    NSString *tokenClientId = entry[@"clientId"];
+    if (clientId && tokenClientId && ![tokenClientId isEqualToString:@"*"] && ![tokenClientId isEqualToString:clientId]) {
+        [_logger debug:__FILE__ line:__LINE__ message:@"ARTTokenDetailsCache: cached token clientId \"%@\" is incompatible with \"%@\"", tokenClientId, clientId];
+        [self clear];
+        return nil;
+    }
+
+    if (timeOffset) {
+        *timeOffset = offset;
+    }
+
+    return [[ARTTokenDetails alloc] initWithToken:entry[@"token"]
+                                          expires:expiresDate
+                                           issued:issued ? [NSDate dateWithTimeIntervalSince1970:millisecondsToTimeInterval(issued.unsignedLongLongValue)] : nil
+                                       capability:entry[@"capability"]
+                                         clientId:tokenClientId];
+}
+
+- (void)storeTokenDetails:(ARTTokenDetails *)tokenDetails timeOffset:(NSNumber *)timeOffset {
+    if (!tokenDetails.token || !tokenDetails.expires) {
+        [self clear];
+        return;
+    }
+
+    NSMutableDictionary *entry = [NSMutableDictionary dictionary];
+    entry[@"token"] = tokenDetails.token;
+    entry[@"expires"] = @(dateToMilliseconds(tokenDetails.expires));
+    if (tokenDetails.issued) entry[@"issued"] = @(dateToMilliseconds(tokenDetails.issued));
+    if (tokenDetails.capability) entry[@"capability"] = tokenDetails.capability;
+    if (tokenDetails.clientId) entry[@"clientId"] = tokenDetails.clientId;
+    if (timeOffset != nil) entry[@"timeOffset"] = timeOffset;
+    entry[@"savedAt"] = @([[NSDate date] timeIntervalSince1970]);
+
+    NSError *error = nil;
+    NSData *data = [NSJSONSerialization dataWithJSONObject:entry options:0 error:&error];
+    if (error) {
+        [_logger error:@"ARTTokenDetailsCache: couldn't serialize token details (%@)", error];
+        return;
+    }
+    [[self storage] setCachedTokenDetails:[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] forKey:_cacheKey];
+}
+
+- (void)clear {
+    [[self storage] setCachedTokenDetails:nil forKey:_cacheKey];
+}
+
+- (void)flush {
+    id<ARTDeviceStorage> storage = _storageProvider();
+    if ([storage isKindOfClass:[ARTDeviceStorageWriter class]]) {
+        [(ARTDeviceStorageWriter *)storage flush];
+    }
+}
+
+@end
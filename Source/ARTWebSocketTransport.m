@@ -18,6 +18,12 @@
 #import "ARTNSMutableDictionary+ARTDictionaryUtil.h"
 #import "ARTStringifiable.h"
 #import "ARTClientInformation.h"
+#import "ARTMetricsRegistry.h"
+#import "ARTPublishTracer.h"
+#import "ARTMessage.h"
+#import "ARTBaseMessage+Private.h"
+#import "ARTJsonLikeEncoder.h"
+#import "ARTMsgPackArena.h"
 
 enum {
     ARTWsNeverConnected = -1,
@@ -48,6 +54,14 @@ Class configuredWebsocketClass = nil;
       The dispatch queue for firing the events. Must be the same for the whole library.
      */
     _Nonnull dispatch_queue_t _workQueue;
+    ARTMetricsRegistry *_metrics;
+    ARTPublishTracer *_tracer;
+    // Only messages carrying sampled publishes are numbered and handed to the websocket for tracing; they are
+    // kept here until written.
+    uint64_t _tracedMessageCount;
+    NSMutableDictionary<NSNumber *, NSArray<ARTMessage *> *> *_tracedMessages;
+    // Set only when `ClientOptions.decodeFramesInPlace` and `useBinaryProtocol` are; reused for every inbound frame.
+    ARTMsgPackArena *_frameArena;
 }
 
 @synthesize delegate = _delegate;
@@ -61,6 +75,8 @@ Class configuredWebsocketClass = nil;
     self = [super init];
     if (self) {
         _workQueue = rest.queue;
+        _metrics = rest.metricsRegistry;
+        _tracer = rest.publishTracer;
         _websocket = nil;
         _state = ARTRealtimeTransportStateClosed;
         _encoder = rest.defaultEncoder;
@@ -69,6 +85,9 @@ Class configuredWebsocketClass = nil;
         _resumeKey = resumeKey;
         _connectionSerial = connectionSerial;
         _stateEmitter = [[ARTInternalEventEmitter alloc] initWithQueue:_workQueue];
+        if (options.decodeFramesInPlace && options.useBinaryProtocol) {
+            _frameArena = [[ARTMsgPackArena alloc] init];
+        }
 
         [self.logger verbose:__FILE__ line:__LINE__ message:@"R:%p WS:%p alloc", _delegate, self];
     }
@@ -84,7 +103,15 @@ Class configuredWebsocketClass = nil;
 
 - (BOOL)send:(NSData *)data withSource:(id)decodedObject {
     if (self.websocket.readyState == ARTSR_OPEN) {
-        [self.websocket send:data];
+        [_metrics increment:ARTMetricsCounterFramesSent by:1];
+        [_metrics increment:ARTMetricsCounterBytesSent by:data.length];
+        const uint64_t traceNumber = _tracer ? [self traceNumberForMessage:decodedObject] : 0;
+        if (traceNumber != 0) {
+            [(ARTSRWebSocket *)self.websocket send:data traceNumber:traceNumber];
+        }
+        else {
+            [self.websocket send:data];
+        }
         return true;
     }
     else {
@@ -109,7 +136,20 @@ Class configuredWebsocketClass = nil;
 }
 
 - (ARTProtocolMessage *)receiveWithData:(NSData *)data {
-    ARTProtocolMessage *pm = [self.encoder decodeProtocolMessage:data error:nil];
+    [_metrics increment:ARTMetricsCounterFramesReceived by:1];
+    [_metrics increment:ARTMetricsCounterBytesReceived by:data.length];
+    const uint64_t decodeStart = ARTMetricsNow();
+    ARTProtocolMessage *pm = nil;
+    id<ARTEncoder> encoder = self.encoder;
+    if (_frameArena && [encoder format] == ARTEncoderFormatMsgPack && [(id)encoder isKindOfClass:[ARTJsonLikeEncoder class]] && [_frameArena parse:data]) {
+        pm = [(ARTJsonLikeEncoder *)encoder protocolMessageFromArena:_frameArena];
+        // The protocol message holds its own copies, so the frame can go.
+        [_frameArena reset];
+    }
+    else {
+        pm = [encoder decodeProtocolMessage:data error:nil];
+    }
+    [_metrics record:ARTMetricsHistogramDecodeTime sinceTime:decodeStart];
     [self receive:pm];
     return pm;
 }
@@ -195,10 +235,64 @@ Class configuredWebsocketClass = nil;
     self.websocket = [[websocketClass alloc] initWithURLRequest:request logger:self.logger];
     [self.websocket setDelegateDispatchQueue:_workQueue];
     self.websocket.delegate = self;
+    if (_tracer) {
+        [self setupMessageTracing];
+    }
     self.websocketURL = url;
     return url;
 }
 
+- (void)setupMessageTracing {
+    _tracedMessageCount = 0;
+    _tracedMessages = [NSMutableDictionary dictionary];
+    if (![self.websocket respondsToSelector:@selector(setMessageTraceHandler:)]) {
+        return;
+    }
+    __weak ARTWebSocketTransport *weakSelf = self;
+    dispatch_queue_t workQueue = _workQueue;
+    ((ARTSRWebSocket *)self.websocket).messageTraceHandler = ^(ARTSRMessageTraceEvent event, uint64_t messageNumber) {
+        // Timestamped on the websocket's queue, where it happened.
+        uint64_t time = ARTMetricsNow();
+        dispatch_async(workQueue, ^{
+            [weakSelf traceMessage:messageNumber event:event time:time];
+        });
+    };
+}
+
+/// Returns the number to trace the message under if it carries sampled publishes, 0 otherwise. Nothing is allocated for messages that aren't sampled.
+- (uint64_t)traceNumberForMessage:(id)decodedObject {
+    if (![decodedObject isKindOfClass:[ARTProtocolMessage class]] || ![self.websocket respondsToSelector:@selector(send:traceNumber:)]) {
+        return 0;
+    }
+    NSArray<ARTMessage *> *messages = ((ARTProtocolMessage *)decodedObject).messages;
+    for (ARTMessage *message in messages) {
+        if (message.traceId != 0) {
+            const uint64_t traceNumber = ++_tracedMessageCount;
+            _tracedMessages[@(traceNumber)] = messages;
+            return traceNumber;
+        }
+    }
+    return 0;
+}
+
+- (void)traceMessage:(uint64_t)messageNumber event:(ARTSRMessageTraceEvent)event time:(uint64_t)time {
+    NSArray<ARTMessage *> *messages = _tracedMessages[@(messageNumber)];
+    if (!messages) {
+        return;
+    }
+    const ARTPublishTraceStage stage = event == ARTSRMessageTraceEventWritten ? ARTPublishTraceStageWritten : ARTPublishTraceStageFramed;
+    uint64_t previous = 0;
+    for (ARTMessage *message in messages) {
+        if (message.traceId != previous) {
+            [_tracer record:stage traceId:message.traceId time:time];
+        }
+        previous = message.traceId;
+    }
+    if (event == ARTSRMessageTraceEventWritten) {
+        [_tracedMessages removeObjectForKey:@(messageNumber)];
+    }
+}
+
 - (void)sendClose {
     _state = ARTRealtimeTransportStateClosing;
     ARTProtocolMessage *closeMessage = [[ARTProtocolMessage alloc] init];
@@ -35,26 +35,34 @@ FOUNDATION_EXPORT const unsigned char ablyVersionString[];
 #import <Ably/ARTMessage.h>
 #import <Ably/ARTDataEncoder.h>
 #import <Ably/ARTPresence.h>
+#import <Ably/ARTPresenceChanges.h>
 #import <Ably/ARTPresenceMap.h>
 #import <Ably/ARTPresenceMessage.h>
 #import <Ably/ARTProtocolMessage.h>
 #import <Ably/ARTQueuedMessage.h>
 #import <Ably/ARTRest.h>
 #import <Ably/ARTRestChannel.h>
+#import <Ably/ARTRestBatchPublisher.h>
 #import <Ably/ARTRestPresence.h>
 #import <Ably/ARTRealtime.h>
 #import <Ably/ARTRealtimeChannel.h>
 #import <Ably/ARTRealtimeChannelOptions.h>
 #import <Ably/ARTRealtimePresence.h>
+#import <Ably/ARTClientMetrics.h>
+#import <Ably/ARTMemoryFootprint.h>
 #import <Ably/ARTStats.h>
+#import <Ably/ARTStatsRollup.h>
 #import <Ably/ARTEncoder.h>
 #import <Ably/ARTPaginatedResult.h>
+#import <Ably/ARTPaginatedResultIterator.h>
 #import <Ably/ARTHTTPPaginatedResponse.h>
 #import <Ably/ARTPush.h>
 #import <Ably/ARTPushChannel.h>
 #import <Ably/ARTPushChannelSubscription.h>
 #import <Ably/ARTPushAdmin.h>
 #import <Ably/ARTPushChannelSubscriptions.h>
+#import <Ably/ARTPushBatch.h>
+#import <Ably/ARTPushListOptions.h>
 #import <Ably/ARTPushDeviceRegistrations.h>
 #import <Ably/ARTDeviceDetails.h>
 #import <Ably/ARTDevicePushDetails.h>
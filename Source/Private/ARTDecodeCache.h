@@ -0,0 +1,44 @@
+#import <Foundation/Foundation.h>
+
+@class ARTDataEncoderOutput;
+@class ARTMetricsRegistry;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The outcome of decoding a payload, as kept by `ARTDecodeCache`.
+@interface ARTDecodeCacheEntry : NSObject
+
+@property (readonly, nonatomic) ARTDataEncoderOutput *output;
+
+/// The last string or data the payload went through while being decoded, which the encoder retains as the base for the next delta.
+@property (readonly, nonatomic, nullable) id deltaBase;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithOutput:(ARTDataEncoderOutput *)output deltaBase:(nullable id)deltaBase;
+
+@end
+
+/**
+ Keeps the decoded data of recently seen payloads by their content and encoding, so that the channels of a client
+ receiving identical payloads decode them once and share the same immutable objects.
+
+ Bounded to `capacity` payloads, and may drop some sooner under memory pressure. Thread-safe.
+ */
+@interface ARTDecodeCache : NSObject
+
+@property (readonly, nonatomic) NSUInteger capacity;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithCapacity:(NSUInteger)capacity metricsRegistry:(nullable ARTMetricsRegistry *)metricsRegistry;
+
+/// Whether payloads of this type and encoding can be cached: strings or data whose encoding only has `json`, `utf-8` and `base64` steps, which decode the same way on every channel.
++ (BOOL)canCachePayload:(id)payload encoding:(NSString *)encoding;
+
+/// The entry of a payload equal to `payload` with the same encoding, counted as a hit, or `nil`, counted as a miss.
+- (nullable ARTDecodeCacheEntry *)entryForPayload:(id)payload encoding:(NSString *)encoding;
+
+- (void)setEntry:(ARTDecodeCacheEntry *)entry forPayload:(id)payload encoding:(NSString *)encoding;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,118 @@
+#import "ARTDecodeCache.h"
+#import "ARTDataEncoder.h"
+#import "ARTMetricsRegistry.h"
+
+@implementation ARTDecodeCacheEntry
+
+- (instancetype)initWithOutput:(ARTDataEncoderOutput *)output deltaBase:(id)deltaBase {
+    if (self = [super init]) {
+        _output = output;
+        _deltaBase = deltaBase;
+    }
+    return self;
+}
+
+@end
+
+/// A payload and its encoding, with the hash of its content computed once.
+@interface ARTDecodeCacheKey : NSObject <NSCopying>
+
+- (instancetype)initWithPayload:(id)payload encoding:(NSString *)encoding;
+
+@end
+
+@implementation ARTDecodeCacheKey {
+    id _payload;
+    NSString *_encoding;
+    NSUInteger _hash;
+}
+
+// FNV-1a, which is cheap next to decoding the payload and, unlike -[NSData hash], covers all of its bytes.
+static NSUInteger ARTDecodeCacheHashBytes(const uint8_t *bytes, NSUInteger length, uint64_t hash) {
+    for (NSUInteger i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return (NSUInteger)hash;
+}
+
+- (instancetype)initWithPayload:(id)payload encoding:(NSString *)encoding {
+    if (self = [super init]) {
+        _payload = payload;
+        _encoding = encoding;
+        uint64_t hash = 0xcbf29ce484222325ULL ^ encoding.hash;
+        if ([payload isKindOfClass:[NSData class]]) {
+            NSData *data = payload;
+            _hash = ARTDecodeCacheHashBytes(data.bytes, data.length, hash);
+        }
+        else {
+            // Strings compare by characters, so equal strings of different internal representations must hash the same.
+            NSString *string = payload;
+            _hash = (NSUInteger)(hash ^ string.hash ^ ((uint64_t)string.length << 32));
+        }
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    return self;
+}
+
+- (NSUInteger)hash {
+    return _hash;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (object == self) {
+        return YES;
+    }
+    if (![object isKindOfClass:[ARTDecodeCacheKey class]]) {
+        return NO;
+    }
+    ARTDecodeCacheKey *other = object;
+    return _hash == other->_hash && [_encoding isEqualToString:other->_encoding] && [_payload isEqual:other->_payload];
+}
+
+@end
+
+@implementation ARTDecodeCache {
+    NSCache<ARTDecodeCacheKey *, ARTDecodeCacheEntry *> *_entries;
+    ARTMetricsRegistry *_metricsRegistry;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity metricsRegistry:(ARTMetricsRegistry *)metricsRegistry {
+    if (self = [super init]) {
+        _capacity = capacity;
+        _metricsRegistry = metricsRegistry;
+        _entries = [[NSCache alloc] init];
+        _entries.name = @"io.ably.decodeCache";
+        _entries.countLimit = capacity;
+    }
+    return self;
+}
+
++ (BOOL)canCachePayload:(id)payload encoding:(NSString *)encoding {
+    if (![payload isKindOfClass:[NSString class]] && ![payload isKindOfClass:[NSData class]]) {
+        return NO;
+    }
+    for (NSString *step in [encoding componentsSeparatedByString:@"/"]) {
+        if (!([step isEqualToString:@"json"] || [step isEqualToString:@"utf-8"] || [step isEqualToString:@"base64"] || [step isEqualToString:@""])) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (ARTDecodeCacheEntry *)entryForPayload:(id)payload encoding:(NSString *)encoding {
+    ARTDecodeCacheEntry *entry = [_entries objectForKey:[[ARTDecodeCacheKey alloc] initWithPayload:payload encoding:encoding]];
+    [_metricsRegistry increment:(entry ? ARTMetricsCounterDecodeCacheHits : ARTMetricsCounterDecodeCacheMisses) by:1];
+    return entry;
+}
+
+- (void)setEntry:(ARTDecodeCacheEntry *)entry forPayload:(id)payload encoding:(NSString *)encoding {
+    // A mutable payload could change while it's a key.
+    ARTDecodeCacheKey *key = [[ARTDecodeCacheKey alloc] initWithPayload:[payload copy] encoding:[encoding copy]];
+    [_entries setObject:entry forKey:key];
+}
+
+@end
@@ -0,0 +1,24 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A lock-free, unbounded multi-producer/single-consumer FIFO queue.
+
+ Any thread may call `push:`; `pop` must only ever be called from one consumer at a time
+ (in practice, from the client's serial internal queue).
+ */
+@interface ARTMPSCQueue<ObjectType> : NSObject
+
+/// The number of pushed objects not yet popped. May be momentarily ahead of what `pop` can return.
+@property (readonly) NSUInteger count;
+
+/// Appends an object and returns the count before it was added.
+- (NSUInteger)push:(ObjectType)object;
+
+/// Removes the oldest object. Returns `nil` when empty, or when a producer is midway through a `push:`.
+- (nullable ObjectType)pop;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,85 @@
+#import "ARTMPSCQueue.h"
+#import <stdatomic.h>
+
+// Intrusive node-based queue after Dmitry Vyukov's MPSC design: producers swap themselves in
+// as the head with a single atomic exchange; the consumer follows `next` links from the tail.
+typedef struct ARTMPSCNode {
+    _Atomic(struct ARTMPSCNode *) next;
+    void *object;
+} ARTMPSCNode;
+
+@implementation ARTMPSCQueue {
+    _Atomic(ARTMPSCNode *) _head;
+    ARTMPSCNode *_tail;
+    ARTMPSCNode _stub;
+    _Atomic(NSUInteger) _count;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        atomic_init(&_stub.next, NULL);
+        _stub.object = NULL;
+        atomic_init(&_head, &_stub);
+        _tail = &_stub;
+        atomic_init(&_count, 0);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    while ([self pop]) {}
+}
+
+- (NSUInteger)count {
+    return atomic_load_explicit(&_count, memory_order_acquire);
+}
+
+- (NSUInteger)push:(id)object {
+    NSUInteger previousCount = atomic_fetch_add_explicit(&_count, 1, memory_order_acq_rel);
+    ARTMPSCNode *node = malloc(sizeof(ARTMPSCNode));
+    atomic_init(&node->next, NULL);
+    node->object = (__bridge_retained void *)object;
+    [self pushNode:node];
+    return previousCount;
+}
+
+- (void)pushNode:(ARTMPSCNode *)node {
+    ARTMPSCNode *previous = atomic_exchange_explicit(&_head, node, memory_order_acq_rel);
+    atomic_store_explicit(&previous->next, node, memory_order_release);
+}
+
+- (id)pop {
+    ARTMPSCNode *tail = _tail;
+    ARTMPSCNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    if (tail == &_stub) {
+        if (next == NULL) {
+            return nil;
+        }
+        _tail = next;
+        tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
+
+    if (next == NULL) {
+        if (tail != atomic_load_explicit(&_head, memory_order_acquire)) {
+            // A producer has swapped in a new head but not linked it yet.
+            return nil;
+        }
+        // Re-insert the stub so that the last real node can be released.
+        atomic_store_explicit(&_stub.next, NULL, memory_order_relaxed);
+        [self pushNode:&_stub];
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+        if (next == NULL) {
+            return nil;
+        }
+    }
+
+    _tail = next;
+    id object = (__bridge_transfer id)tail->object;
+    free(tail);
+    atomic_fetch_sub_explicit(&_count, 1, memory_order_acq_rel);
+    return object;
+}
+
+@end
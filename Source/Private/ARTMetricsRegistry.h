@@ -0,0 +1,46 @@
+#import <Foundation/Foundation.h>
+
+@class ARTClientMetrics;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, ARTMetricsCounter) {
+    ARTMetricsCounterFramesReceived,
+    ARTMetricsCounterFramesSent,
+    ARTMetricsCounterBytesReceived,
+    ARTMetricsCounterBytesSent,
+    ARTMetricsCounterHttpRequests,
+    ARTMetricsCounterFallbackHostRequests,
+    ARTMetricsCounterReconnects,
+    ARTMetricsCounterDecodeCacheHits,
+    ARTMetricsCounterDecodeCacheMisses,
+    ARTMetricsCounterCount
+};
+
+typedef NS_ENUM(NSUInteger, ARTMetricsHistogram) {
+    ARTMetricsHistogramDecodeTime,
+    ARTMetricsHistogramAckLatency,
+    ARTMetricsHistogramCount
+};
+
+/// A monotonic timestamp in nanoseconds, for measuring the durations passed to `record:sinceTime:`.
+uint64_t ARTMetricsNow(void);
+
+/**
+ Counters and latency histograms shared by a client's REST and realtime layers.
+
+ Recording is a relaxed atomic add, so it is safe from any thread and cheap enough for per-frame paths.
+ Snapshots read each value independently, so they are not a consistent cut across counters.
+ */
+@interface ARTMetricsRegistry : NSObject
+
+- (void)increment:(ARTMetricsCounter)counter by:(NSUInteger)amount;
+
+/// Records the time elapsed since `start`, a value previously returned by `ARTMetricsNow()`.
+- (void)record:(ARTMetricsHistogram)histogram sinceTime:(uint64_t)start;
+
+- (ARTClientMetrics *)snapshotWithQueuedMessages:(NSUInteger)queuedMessages pendingMessages:(NSUInteger)pendingMessages;
+
+@end
+
+NS_ASSUME_NONNULL_END
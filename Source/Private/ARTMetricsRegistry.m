@@ -0,0 +1,108 @@
+#import "ARTMetricsRegistry.h"
+#import "ARTClientMetrics+Private.h"
+#import <mach/mach_time.h>
+#import <stdatomic.h>
+
+// Upper bounds in microseconds, roughly 1-2.5-5 per decade from 50µs to 10s.
+static const uint64_t ARTMetricsBucketBounds[] = {
+    50, 100, 250, 500,
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000
+};
+#define ARTMetricsBucketCount (sizeof(ARTMetricsBucketBounds) / sizeof(ARTMetricsBucketBounds[0]) + 1)
+
+uint64_t ARTMetricsNow(void) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        mach_timebase_info(&timebase);
+    });
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+}
+
+typedef struct {
+    _Atomic(uint64_t) buckets[ARTMetricsBucketCount];
+    _Atomic(uint64_t) count;
+    _Atomic(uint64_t) sumMicroseconds;
+} ARTMetricsHistogramStorage;
+
+@implementation ARTMetricsRegistry {
+    _Atomic(uint64_t) _counters[ARTMetricsCounterCount];
+    ARTMetricsHistogramStorage _histograms[ARTMetricsHistogramCount];
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        for (NSUInteger i = 0; i < ARTMetricsCounterCount; i++) {
+            atomic_init(&_counters[i], 0);
+        }
+        for (NSUInteger h = 0; h < ARTMetricsHistogramCount; h++) {
+            for (NSUInteger i = 0; i < ARTMetricsBucketCount; i++) {
+                atomic_init(&_histograms[h].buckets[i], 0);
+            }
+            atomic_init(&_histograms[h].count, 0);
+            atomic_init(&_histograms[h].sumMicroseconds, 0);
+        }
+    }
+    return self;
+}
+
+- (void)increment:(ARTMetricsCounter)counter by:(NSUInteger)amount {
+    atomic_fetch_add_explicit(&_counters[counter], amount, memory_order_relaxed);
+}
+
+- (void)record:(ARTMetricsHistogram)histogram sinceTime:(uint64_t)start {
+    uint64_t now = ARTMetricsNow();
+    uint64_t microseconds = now > start ? (now - start) / 1000 : 0;
+
+    NSUInteger bucket = 0;
+    while (bucket < ARTMetricsBucketCount - 1 && microseconds > ARTMetricsBucketBounds[bucket]) {
+        bucket++;
+    }
+
+    ARTMetricsHistogramStorage *storage = &_histograms[histogram];
+    atomic_fetch_add_explicit(&storage->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&storage->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&storage->sumMicroseconds, microseconds, memory_order_relaxed);
+}
+
+- (NSUInteger)valueOf:(ARTMetricsCounter)counter {
+    return (NSUInteger)atomic_load_explicit(&_counters[counter], memory_order_relaxed);
+}
+
+- (ARTLatencyHistogram *)snapshotOf:(ARTMetricsHistogram)histogram {
+    ARTMetricsHistogramStorage *storage = &_histograms[histogram];
+    NSMutableArray<NSNumber *> *bounds = [NSMutableArray arrayWithCapacity:ARTMetricsBucketCount - 1];
+    NSMutableArray<NSNumber *> *counts = [NSMutableArray arrayWithCapacity:ARTMetricsBucketCount];
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < ARTMetricsBucketCount; i++) {
+        if (i < ARTMetricsBucketCount - 1) {
+            [bounds addObject:@(ARTMetricsBucketBounds[i] / 1e6)];
+        }
+        uint64_t bucketCount = atomic_load_explicit(&storage->buckets[i], memory_order_relaxed);
+        [counts addObject:@(bucketCount)];
+        count += bucketCount;
+    }
+    NSTimeInterval sum = atomic_load_explicit(&storage->sumMicroseconds, memory_order_relaxed) / 1e6;
+    return [[ARTLatencyHistogram alloc] initWithBucketUpperBounds:bounds bucketCounts:counts count:count sum:sum];
+}
+
+- (ARTClientMetrics *)snapshotWithQueuedMessages:(NSUInteger)queuedMessages pendingMessages:(NSUInteger)pendingMessages {
+    ARTClientMetrics *metrics = [[ARTClientMetrics alloc] initWithTimestamp:[NSDate date]];
+    metrics.framesReceived = [self valueOf:ARTMetricsCounterFramesReceived];
+    metrics.framesSent = [self valueOf:ARTMetricsCounterFramesSent];
+    metrics.bytesReceived = [self valueOf:ARTMetricsCounterBytesReceived];
+    metrics.bytesSent = [self valueOf:ARTMetricsCounterBytesSent];
+    metrics.httpRequests = [self valueOf:ARTMetricsCounterHttpRequests];
+    metrics.fallbackHostRequests = [self valueOf:ARTMetricsCounterFallbackHostRequests];
+    metrics.reconnects = [self valueOf:ARTMetricsCounterReconnects];
+    metrics.decodeCacheHits = [self valueOf:ARTMetricsCounterDecodeCacheHits];
+    metrics.decodeCacheMisses = [self valueOf:ARTMetricsCounterDecodeCacheMisses];
+    metrics.queuedMessages = queuedMessages;
+    metrics.pendingMessages = pendingMessages;
+    metrics.decodeTime = [self snapshotOf:ARTMetricsHistogramDecodeTime];
+    metrics.ackLatency = [self snapshotOf:ARTMetricsHistogramAckLatency];
+    return metrics;
+}
+
+@end
@@ -0,0 +1,93 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(uint8_t, ARTMsgPackType) {
+    ARTMsgPackTypeNil,
+    ARTMsgPackTypeBool,
+    ARTMsgPackTypeInt,
+    ARTMsgPackTypeUInt,
+    ARTMsgPackTypeFloat,
+    ARTMsgPackTypeString,
+    ARTMsgPackTypeBinary,
+    ARTMsgPackTypeArray,
+    ARTMsgPackTypeMap
+};
+
+/**
+ A msgpack value parsed in place. Nodes are laid out in document order: an array's items follow it, and a map's keys
+ and values follow it alternately, each one followed by its own contents.
+ */
+typedef struct {
+    ARTMsgPackType type;
+    /// The number of items of an array, or of key-value pairs of a map.
+    uint32_t count;
+    /// The index of the node after this one and its contents.
+    uint32_t next;
+    union {
+        BOOL boolValue;
+        int64_t intValue;
+        uint64_t uintValue;
+        double floatValue;
+        /// The bytes of a string or binary, in the parsed buffer.
+        struct {
+            uint32_t offset;
+            uint32_t length;
+        } slice;
+    };
+} ARTMsgPackNode;
+
+/**
+ Parses a msgpack frame into plain C nodes that refer to its bytes, so that only the values that are read become
+ Foundation objects.
+
+ An arena is meant to be reused for frame after frame: `reset` drops the frame but keeps the memory of its nodes. Not
+ thread-safe; a transport's arena is only used on its internal queue.
+ */
+@interface ARTMsgPackArena : NSObject
+
+/// The number of nodes of the parsed frame, the first of which is its root value.
+@property (nonatomic, readonly) NSUInteger count;
+
+/// Parses `data`, replacing the previous frame. Returns `NO` if it isn't a single well-formed msgpack value or uses extension types, leaving the arena empty.
+- (BOOL)parse:(NSData *)data;
+
+/// Releases the parsed frame and the strings created from it, keeping the nodes' memory for the next frame unless it grew unusually large.
+- (void)reset;
+
+- (const ARTMsgPackNode *)nodeAtIndex:(NSUInteger)index;
+
+/// Whether the node at `index` is a string equal to the UTF-8 `string`.
+- (BOOL)isString:(NSUInteger)index equalTo:(const char *)string;
+
+/// The string at `index`, or `nil` if it isn't one. Short strings repeated within a frame, such as client and connection ids, share one instance.
+- (nullable NSString *)stringAtIndex:(NSUInteger)index;
+
+/// The number at `index`, or `nil` if it isn't one.
+- (nullable NSNumber *)numberAtIndex:(NSUInteger)index;
+
+/// The value at `index` as the Foundation objects the msgpack decoder would create for it, with `NSNull` for nil.
+- (nullable id)objectAtIndex:(NSUInteger)index;
+
+@end
+
+/// Whether the node is an integer or a float.
+static inline BOOL ARTMsgPackNodeIsNumber(const ARTMsgPackNode *node) {
+    return node->type == ARTMsgPackTypeInt || node->type == ARTMsgPackTypeUInt || node->type == ARTMsgPackTypeFloat;
+}
+
+/// The node's number truncated to an integer, or `0` if it isn't a number.
+static inline int64_t ARTMsgPackNodeInt64Value(const ARTMsgPackNode *node) {
+    switch (node->type) {
+        case ARTMsgPackTypeInt:
+            return node->intValue;
+        case ARTMsgPackTypeUInt:
+            return (int64_t)node->uintValue;
+        case ARTMsgPackTypeFloat:
+            return (int64_t)node->floatValue;
+        default:
+            return 0;
+    }
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,319 @@
+#import "ARTMsgPackArena.h"
+
+// Deeper frames are rejected and left to the msgpack decoder; protocol messages nest a few levels plus the payloads'.
+static const NSUInteger ARTMsgPackArenaMaxDepth = 64;
+// Beyond this, `reset` frees the nodes instead of keeping them for the next frame.
+static const NSUInteger ARTMsgPackArenaRetainedNodes = 4096;
+#define ARTMsgPackArenaRecentStringCount 8
+static const uint32_t ARTMsgPackArenaRecentStringMaxLength = 64;
+
+static inline uint16_t ARTMsgPackRead16(const uint8_t *p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static inline uint32_t ARTMsgPackRead32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint64_t ARTMsgPackRead64(const uint8_t *p) {
+    return ((uint64_t)ARTMsgPackRead32(p) << 32) | ARTMsgPackRead32(p + 4);
+}
+
+@implementation ARTMsgPackArena {
+    NSData *_data;
+    const uint8_t *_bytes;
+    NSUInteger _length;
+    ARTMsgPackNode *_nodes;
+    NSUInteger _capacity;
+    // The last short strings created from the frame, by their slice, so that repeated ones are created once.
+    NSString *_recentStrings[ARTMsgPackArenaRecentStringCount];
+    uint32_t _recentOffsets[ARTMsgPackArenaRecentStringCount];
+    uint32_t _recentLengths[ARTMsgPackArenaRecentStringCount];
+    NSUInteger _nextRecentString;
+}
+
+- (void)dealloc {
+    free(_nodes);
+}
+
+- (BOOL)parse:(NSData *)data {
+    [self reset];
+    if (data.length == 0 || data.length > UINT32_MAX) {
+        return NO;
+    }
+    _data = data;
+    _bytes = data.bytes;
+    _length = data.length;
+
+    NSUInteger position = 0;
+    if (![self parseValueAt:&position depth:0] || position != _length) {
+        [self reset];
+        return NO;
+    }
+    return YES;
+}
+
+- (void)reset {
+    _data = nil;
+    _bytes = NULL;
+    _length = 0;
+    _count = 0;
+    for (NSUInteger i = 0; i < ARTMsgPackArenaRecentStringCount; i++) {
+        _recentStrings[i] = nil;
+    }
+    _nextRecentString = 0;
+    if (_capacity > ARTMsgPackArenaRetainedNodes) {
+        free(_nodes);
+        _nodes = NULL;
+        _capacity = 0;
+    }
+}
+
+- (NSUInteger)addNodeOfType:(ARTMsgPackType)type {
+    if (_count == _capacity) {
+        NSUInteger capacity = MAX(_capacity * 2, 64);
+        ARTMsgPackNode *nodes = realloc(_nodes, capacity * sizeof(ARTMsgPackNode));
+        if (!nodes) {
+            return NSNotFound;
+        }
+        _nodes = nodes;
+        _capacity = capacity;
+    }
+    ARTMsgPackNode *node = &_nodes[_count];
+    memset(node, 0, sizeof(ARTMsgPackNode));
+    node->type = type;
+    return _count++;
+}
+
+// Whether `length` more bytes are available at `position`.
+- (BOOL)has:(NSUInteger)length at:(NSUInteger)position {
+    return length <= _length - position;
+}
+
+- (BOOL)parseValueAt:(NSUInteger *)position depth:(NSUInteger)depth {
+    if (depth > ARTMsgPackArenaMaxDepth || ![self has:1 at:*position]) {
+        return NO;
+    }
+    const uint8_t *p = _bytes + *position;
+    const uint8_t byte = *p++;
+    NSUInteger headerLength = 1;
+    ARTMsgPackType type;
+    uint64_t size = 0; // Bytes of a string or binary, or items of an array or map.
+    NSUInteger index;
+
+    if (byte <= 0x7f || byte >= 0xe0) {
+        index = [self addNodeOfType:(byte <= 0x7f ? ARTMsgPackTypeUInt : ARTMsgPackTypeInt)];
+        if (index == NSNotFound) {
+            return NO;
+        }
+        if (byte <= 0x7f) {
+            _nodes[index].uintValue = byte;
+        }
+        else {
+            _nodes[index].intValue = (int8_t)byte;
+        }
+        _nodes[index].next = (uint32_t)index + 1;
+        *position += 1;
+        return YES;
+    }
+    else if (byte <= 0x8f) {
+        type = ARTMsgPackTypeMap;
+        size = byte & 0x0f;
+    }
+    else if (byte <= 0x9f) {
+        type = ARTMsgPackTypeArray;
+        size = byte & 0x0f;
+    }
+    else if (byte <= 0xbf) {
+        type = ARTMsgPackTypeString;
+        size = byte & 0x1f;
+    }
+    else {
+        // Scalars are complete after their header; the other types read their size from it.
+        NSUInteger sizeLength = 0;
+        switch (byte) {
+            case 0xc0: type = ARTMsgPackTypeNil; break;
+            case 0xc2: case 0xc3: type = ARTMsgPackTypeBool; break;
+            case 0xc4: type = ARTMsgPackTypeBinary; sizeLength = 1; break;
+            case 0xc5: type = ARTMsgPackTypeBinary; sizeLength = 2; break;
+            case 0xc6: type = ARTMsgPackTypeBinary; sizeLength = 4; break;
+            case 0xca: type = ARTMsgPackTypeFloat; headerLength += 4; break;
+            case 0xcb: type = ARTMsgPackTypeFloat; headerLength += 8; break;
+            case 0xcc: type = ARTMsgPackTypeUInt; headerLength += 1; break;
+            case 0xcd: type = ARTMsgPackTypeUInt; headerLength += 2; break;
+            case 0xce: type = ARTMsgPackTypeUInt; headerLength += 4; break;
+            case 0xcf: type = ARTMsgPackTypeUInt; headerLength += 8; break;
+            case 0xd0: type = ARTMsgPackTypeInt; headerLength += 1; break;
+            case 0xd1: type = ARTMsgPackTypeInt; headerLength += 2; break;
+            case 0xd2: type = ARTMsgPackTypeInt; headerLength += 4; break;
+            case 0xd3: type = ARTMsgPackTypeInt; headerLength += 8; break;
+            case 0xd9: type = ARTMsgPackTypeString; sizeLength = 1; break;
+            case 0xda: type = ARTMsgPackTypeString; sizeLength = 2; break;
+            case 0xdb: type = ARTMsgPackTypeString; sizeLength = 4; break;
+            case 0xdc: type = ARTMsgPackTypeArray; sizeLength = 2; break;
+            case 0xdd: type = ARTMsgPackTypeArray; sizeLength = 4; break;
+            case 0xde: type = ARTMsgPackTypeMap; sizeLength = 2; break;
+            case 0xdf: type = ARTMsgPackTypeMap; sizeLength = 4; break;
+            default:
+                // 0xc1 is unused; extension types have no Foundation equivalent.
+                return NO;
+        }
+        headerLength += sizeLength;
+        if (![self has:headerLength at:*position]) {
+            return NO;
+        }
+        switch (sizeLength) {
+            case 1: size = *p; break;
+            case 2: size = ARTMsgPackRead16(p); break;
+            case 4: size = ARTMsgPackRead32(p); break;
+        }
+    }
+
+    index = [self addNodeOfType:type];
+    if (index == NSNotFound) {
+        return NO;
+    }
+    ARTMsgPackNode *node = &_nodes[index];
+    switch (byte) {
+        case 0xc2: node->boolValue = NO; break;
+        case 0xc3: node->boolValue = YES; break;
+        case 0xca: {
+            const uint32_t bits = ARTMsgPackRead32(p);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            node->floatValue = value;
+            break;
+        }
+        case 0xcb: {
+            const uint64_t bits = ARTMsgPackRead64(p);
+            memcpy(&node->floatValue, &bits, sizeof(node->floatValue));
+            break;
+        }
+        case 0xcc: node->uintValue = *p; break;
+        case 0xcd: node->uintValue = ARTMsgPackRead16(p); break;
+        case 0xce: node->uintValue = ARTMsgPackRead32(p); break;
+        case 0xcf: node->uintValue = ARTMsgPackRead64(p); break;
+        case 0xd0: node->intValue = (int8_t)*p; break;
+        case 0xd1: node->intValue = (int16_t)ARTMsgPackRead16(p); break;
+        case 0xd2: node->intValue = (int32_t)ARTMsgPackRead32(p); break;
+        case 0xd3: node->intValue = (int64_t)ARTMsgPackRead64(p); break;
+    }
+    *position += headerLength;
+
+    if (type == ARTMsgPackTypeString || type == ARTMsgPackTypeBinary) {
+        if (![self has:size at:*position]) {
+            return NO;
+        }
+        node->slice.offset = (uint32_t)*position;
+        node->slice.length = (uint32_t)size;
+        *position += size;
+    }
+    else if (type == ARTMsgPackTypeArray || type == ARTMsgPackTypeMap) {
+        const uint64_t items = type == ARTMsgPackTypeMap ? size * 2 : size;
+        // Every item takes at least a byte, which bounds the work done for a forged size.
+        if (![self has:items at:*position]) {
+            return NO;
+        }
+        node->count = (uint32_t)size;
+        for (uint64_t i = 0; i < items; i++) {
+            if (![self parseValueAt:position depth:depth + 1]) {
+                return NO;
+            }
+        }
+    }
+    // Parsing the contents may have moved the nodes.
+    _nodes[index].next = (uint32_t)_count;
+    return YES;
+}
+
+- (const ARTMsgPackNode *)nodeAtIndex:(NSUInteger)index {
+    NSAssert(index < _count, @"Node index %lu out of %lu", (unsigned long)index, (unsigned long)_count);
+    return &_nodes[index];
+}
+
+- (BOOL)isString:(NSUInteger)index equalTo:(const char *)string {
+    const ARTMsgPackNode *node = [self nodeAtIndex:index];
+    if (node->type != ARTMsgPackTypeString) {
+        return NO;
+    }
+    const size_t length = strlen(string);
+    return node->slice.length == length && memcmp(_bytes + node->slice.offset, string, length) == 0;
+}
+
+- (NSString *)stringAtIndex:(NSUInteger)index {
+    const ARTMsgPackNode *node = [self nodeAtIndex:index];
+    if (node->type != ARTMsgPackTypeString) {
+        return nil;
+    }
+    const uint32_t offset = node->slice.offset;
+    const uint32_t length = node->slice.length;
+    if (length > ARTMsgPackArenaRecentStringMaxLength) {
+        return [[NSString alloc] initWithBytes:_bytes + offset length:length encoding:NSUTF8StringEncoding];
+    }
+    for (NSUInteger i = 0; i < ARTMsgPackArenaRecentStringCount; i++) {
+        if (_recentStrings[i] && _recentLengths[i] == length && memcmp(_bytes + _recentOffsets[i], _bytes + offset, length) == 0) {
+            return _recentStrings[i];
+        }
+    }
+    NSString *string = [[NSString alloc] initWithBytes:_bytes + offset length:length encoding:NSUTF8StringEncoding];
+    if (string) {
+        const NSUInteger slot = _nextRecentString++ % ARTMsgPackArenaRecentStringCount;
+        _recentStrings[slot] = string;
+        _recentOffsets[slot] = offset;
+        _recentLengths[slot] = length;
+    }
+    return string;
+}
+
+- (NSNumber *)numberAtIndex:(NSUInteger)index {
+    const ARTMsgPackNode *node = [self nodeAtIndex:index];
+    switch (node->type) {
+        case ARTMsgPackTypeBool:
+            return @(node->boolValue);
+        case ARTMsgPackTypeInt:
+            return @(node->intValue);
+        case ARTMsgPackTypeUInt:
+            return @(node->uintValue);
+        case ARTMsgPackTypeFloat:
+            return @(node->floatValue);
+        default:
+            return nil;
+    }
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    const ARTMsgPackNode *node = [self nodeAtIndex:index];
+    switch (node->type) {
+        case ARTMsgPackTypeNil:
+            return [NSNull null];
+        case ARTMsgPackTypeBool:
+        case ARTMsgPackTypeInt:
+        case ARTMsgPackTypeUInt:
+        case ARTMsgPackTypeFloat:
+            return [self numberAtIndex:index];
+        case ARTMsgPackTypeString:
+            return [self stringAtIndex:index];
+        case ARTMsgPackTypeBinary:
+            return [NSData dataWithBytes:_bytes + node->slice.offset length:node->slice.length];
+        case ARTMsgPackTypeArray: {
+            NSMutableArray *array = [NSMutableArray arrayWithCapacity:node->count];
+            for (NSUInteger item = index + 1; item < node->next; item = _nodes[item].next) {
+                [array addObject:[self objectAtIndex:item] ?: [NSNull null]];
+            }
+            return array;
+        }
+        case ARTMsgPackTypeMap: {
+            NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:node->count];
+            for (NSUInteger key = index + 1; key < node->next; key = _nodes[_nodes[key].next].next) {
+                id keyObject = [self objectAtIndex:key];
+                if (keyObject) {
+                    dictionary[keyObject] = [self objectAtIndex:_nodes[key].next] ?: [NSNull null];
+                }
+            }
+            return dictionary;
+        }
+    }
+    return nil;
+}
+
+@end
@@ -0,0 +1,12 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface NSData (ARTCompression)
+
+/// Returns the data compressed in the gzip format (RFC 1952), or `nil` if compression failed.
+- (nullable NSData *)artGzipCompressed;
+
+@end
+
+NS_ASSUME_NONNULL_END
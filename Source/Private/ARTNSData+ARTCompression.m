@@ -0,0 +1,34 @@
+#import "ARTNSData+ARTCompression.h"
+#import <zlib.h>
+
+@implementation NSData (ARTCompression)
+
+- (NSData *)artGzipCompressed {
+    if (self.length == 0 || self.length > UINT_MAX) {
+        return nil;
+    }
+
+    z_stream stream = {0};
+    // 15 window bits + 16 selects the gzip wrapper instead of zlib's.
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nil;
+    }
+
+    stream.next_in = (Bytef *)self.bytes;
+    stream.avail_in = (uInt)self.length;
+
+    NSMutableData *output = [NSMutableData dataWithLength:deflateBound(&stream, stream.avail_in)];
+    stream.next_out = (Bytef *)output.mutableBytes;
+    stream.avail_out = (uInt)output.length;
+
+    int status = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        return nil;
+    }
+
+    output.length = stream.total_out;
+    return output;
+}
+
+@end
@@ -0,0 +1,43 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTPresenceMessage.h>
+
+@class ARTStringInterner;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// What `ARTPresenceMap` stores for each member: either the `ARTPresenceMessage` itself or an `ARTPresenceMember`.
+@protocol ARTPresenceMapEntry <NSObject>
+
+- (nullable NSString *)clientId;
+- (NSString *)connectionId;
+- (ARTPresenceAction)action;
+- (NSUInteger)syncSessionId;
+- (void)setSyncSessionId:(NSUInteger)syncSessionId;
+- (NSInteger)messageSize;
+
+/// Whether `message` should replace this entry, as in `-[ARTPresenceMessage isNewerThan:]`.
+- (BOOL)isOlderThan:(ARTPresenceMessage *)message;
+
+/// The member as handed to the application.
+- (ARTPresenceMessage *)presenceMessage;
+
+@end
+
+@interface ARTPresenceMessage (ARTPresenceMapEntry) <ARTPresenceMapEntry>
+@end
+
+/**
+ A presence member stored compactly, for `ClientOptions.compactPresenceMembers`.
+
+ Its clientId, connectionId and encoding are interned, so members of the same connection, or present on several channels, share them.
+ Its id is kept as the message serial and index it's compared by, and its timestamp as milliseconds. Its data is kept as decoded.
+ The `ARTPresenceMessage` is only created when the member is handed to the application.
+ */
+@interface ARTPresenceMember : NSObject <ARTPresenceMapEntry>
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithMessage:(ARTPresenceMessage *)message stringInterner:(ARTStringInterner *)stringInterner;
+
+@end
+
+NS_ASSUME_NONNULL_END
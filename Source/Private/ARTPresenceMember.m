@@ -0,0 +1,148 @@
+#import "ARTPresenceMember.h"
+#import "ARTPresenceMessage+Private.h"
+#import "ARTBaseMessage+Private.h"
+#import "ARTStringInterner.h"
+
+/// `_timestamp` of a member without a timestamp.
+static const int64_t ARTPresenceMemberNoTimestamp = INT64_MIN;
+
+/// Parses the decimal digits of `range`, only if it's written the way `%lld` writes the result, so that it can be written back as is.
+static BOOL ARTPresenceMemberParseInteger(NSString *string, NSRange range, int64_t *value) {
+    if (range.length == 0 || range.length > 18 || (range.length > 1 && [string characterAtIndex:range.location] == '0')) {
+        return NO;
+    }
+    int64_t result = 0;
+    for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+        const unichar c = [string characterAtIndex:i];
+        if (c < '0' || c > '9') {
+            return NO;
+        }
+        result = result * 10 + (c - '0');
+    }
+    *value = result;
+    return YES;
+}
+
+@implementation ARTPresenceMessage (ARTPresenceMapEntry)
+
+- (BOOL)isOlderThan:(ARTPresenceMessage *)message {
+    return [message isNewerThan:self];
+}
+
+- (ARTPresenceMessage *)presenceMessage {
+    return self;
+}
+
+@end
+
+@implementation ARTPresenceMember {
+    NSString *_clientId;
+    NSString *_connectionId;
+    // The parts of the id, when it has the `connectionId:msgSerial:index` form; otherwise `_idConnectionId` is nil and `_id` holds it as is.
+    NSString *_idConnectionId;
+    int64_t _msgSerial;
+    int64_t _index;
+    NSString *_id;
+    // Milliseconds since 1970.
+    int64_t _timestamp;
+    NSString *_encoding;
+    id _data;
+    id<ARTJsonCompatible> _extras;
+    NSUInteger _syncSessionId;
+    uint8_t _action;
+}
+
+- (instancetype)initWithMessage:(ARTPresenceMessage *)message stringInterner:(ARTStringInterner *)stringInterner {
+    if (self = [super init]) {
+        _clientId = [stringInterner intern:message.clientId];
+        _connectionId = [stringInterner intern:message.connectionId];
+        _encoding = [stringInterner intern:message.encoding];
+        _data = message.data;
+        _extras = message.extras;
+        _timestamp = message.timestamp ? (int64_t)llround(message.timestamp.timeIntervalSince1970 * 1000) : ARTPresenceMemberNoTimestamp;
+        _syncSessionId = message.syncSessionId;
+        _action = (uint8_t)message.action;
+
+        NSString *messageId = message.id;
+        const NSRange indexSeparator = messageId ? [messageId rangeOfString:@":" options:NSBackwardsSearch] : NSMakeRange(NSNotFound, 0);
+        const NSRange serialSeparator = indexSeparator.location != NSNotFound ? [messageId rangeOfString:@":" options:NSBackwardsSearch range:NSMakeRange(0, indexSeparator.location)] : NSMakeRange(NSNotFound, 0);
+        if (serialSeparator.location != NSNotFound &&
+            [messageId rangeOfString:@":" options:0 range:NSMakeRange(0, serialSeparator.location)].location == NSNotFound &&
+            ARTPresenceMemberParseInteger(messageId, NSMakeRange(NSMaxRange(serialSeparator), indexSeparator.location - NSMaxRange(serialSeparator)), &_msgSerial) &&
+            ARTPresenceMemberParseInteger(messageId, NSMakeRange(NSMaxRange(indexSeparator), messageId.length - NSMaxRange(indexSeparator)), &_index)) {
+            _idConnectionId = [stringInterner intern:[messageId substringToIndex:serialSeparator.location]];
+        }
+        else {
+            _id = messageId;
+        }
+    }
+    return self;
+}
+
+- (NSString *)clientId {
+    return _clientId;
+}
+
+- (NSString *)connectionId {
+    return _connectionId;
+}
+
+- (ARTPresenceAction)action {
+    return (ARTPresenceAction)_action;
+}
+
+- (NSUInteger)syncSessionId {
+    return _syncSessionId;
+}
+
+- (void)setSyncSessionId:(NSUInteger)syncSessionId {
+    _syncSessionId = syncSessionId;
+}
+
+- (NSInteger)messageSize {
+    return ARTMessageSize(_clientId, _data, _extras);
+}
+
+- (BOOL)isSynthesized {
+    return _idConnectionId != _connectionId && ![_idConnectionId isEqualToString:_connectionId];
+}
+
+- (BOOL)isOlderThan:(ARTPresenceMessage *)message {
+    if (!_idConnectionId) {
+        return [message isNewerThan:self.presenceMessage];
+    }
+
+    if ([message isSynthesized] || [self isSynthesized]) {
+        const NSTimeInterval timestamp = _timestamp == ARTPresenceMemberNoTimestamp ? 0 : _timestamp / 1000.0;
+        return !message.timestamp || timestamp <= [message.timestamp timeIntervalSince1970];
+    }
+
+    const NSInteger msgSerial = [message msgSerialFromId];
+    const NSInteger index = [message indexFromId];
+    if (msgSerial == _msgSerial) {
+        return index > _index;
+    }
+    else {
+        return msgSerial > _msgSerial;
+    }
+}
+
+- (ARTPresenceMessage *)presenceMessage {
+    ARTPresenceMessage *message = [[ARTPresenceMessage alloc] init];
+    message.id = _idConnectionId ? [NSString stringWithFormat:@"%@:%lld:%lld", _idConnectionId, _msgSerial, _index] : _id;
+    message.clientId = _clientId;
+    message.connectionId = _connectionId;
+    message.timestamp = _timestamp == ARTPresenceMemberNoTimestamp ? nil : [NSDate dateWithTimeIntervalSince1970:_timestamp / 1000.0];
+    message.encoding = _encoding;
+    message.data = _data;
+    message.extras = _extras;
+    message.action = (ARTPresenceAction)_action;
+    message.syncSessionId = _syncSessionId;
+    return message;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p clientId: %@, connectionId: %@, action: %@>", self.class, self, _clientId, _connectionId, ARTPresenceActionToStr(self.action)];
+}
+
+@end
@@ -0,0 +1,52 @@
+#import <Foundation/Foundation.h>
+
+@class ARTMessage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(uint8_t, ARTPublishTraceStage) {
+    /// The caller invoked `publish`.
+    ARTPublishTraceStagePublish,
+    /// `encodeMessageIfNeeded:` finished encoding the message payloads.
+    ARTPublishTraceStageEncoded,
+    /// `internalPostMessages:` reached the internal queue.
+    ARTPublishTraceStageQueued,
+    /// `sendImpl:` encoded the `ProtocolMessage` carrying the messages.
+    ARTPublishTraceStageSerialized,
+    /// The websocket built the frame for it.
+    ARTPublishTraceStageFramed,
+    /// The websocket wrote the last byte of the frame to the socket.
+    ARTPublishTraceStageWritten,
+    /// `ack:` or `nack:` processed the acknowledgement.
+    ARTPublishTraceStageAcked,
+};
+
+/**
+ Records timestamps of sampled publishes as they pass through the realtime pipeline.
+
+ Trace points go into a ring buffer allocated up front: recording takes no locks and allocates nothing, and
+ once the buffer is full the oldest points are overwritten. Safe to use from any thread.
+ */
+@interface ARTPublishTracer : NSObject
+
+- (instancetype)init UNAVAILABLE_ATTRIBUTE;
+
+/// @param sampleRate The fraction of publishes to trace, between 0 and 1.
+- (instancetype)initWithCapacity:(NSUInteger)capacity sampleRate:(double)sampleRate;
+
+/// Decides whether to sample a publish; if so, records its `ARTPublishTraceStagePublish` point and returns a non-zero trace ID.
+- (uint64_t)startTrace;
+
+/// Does nothing for a zero trace ID.
+- (void)record:(ARTPublishTraceStage)stage traceId:(uint64_t)traceId;
+- (void)record:(ARTPublishTraceStage)stage traceId:(uint64_t)traceId time:(uint64_t)time;
+
+/// Records a point for each distinct trace ID carried by the messages.
+- (void)record:(ARTPublishTraceStage)stage messages:(NSArray<ARTMessage *> *)messages;
+
+/// The buffered trace points as a Chrome trace-event JSON object, with one row per publish and a span per stage.
+- (NSData *)chromeTraceEventJSON;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,143 @@
+#import "ARTPublishTracer.h"
+#import "ARTMetricsRegistry.h"
+#import "ARTMessage.h"
+#import "ARTBaseMessage+Private.h"
+#import <stdatomic.h>
+
+// A slot is valid while `sequence` is non-zero and unchanged across reading its fields.
+typedef struct {
+    _Atomic(uint64_t) sequence;
+    _Atomic(uint64_t) traceId;
+    _Atomic(uint64_t) time;
+    _Atomic(uint8_t) stage;
+} ARTPublishTracePoint;
+
+static NSString *ARTPublishTraceStageToStr(ARTPublishTraceStage stage) {
+    switch (stage) {
+        case ARTPublishTraceStagePublish:
+            return @"publish";
+        case ARTPublishTraceStageEncoded:
+            return @"encode";
+        case ARTPublishTraceStageQueued:
+            return @"queue hop";
+        case ARTPublishTraceStageSerialized:
+            return @"serialize";
+        case ARTPublishTraceStageFramed:
+            return @"frame";
+        case ARTPublishTraceStageWritten:
+            return @"socket write";
+        case ARTPublishTraceStageAcked:
+            return @"ack";
+    }
+    return @"unknown";
+}
+
+@implementation ARTPublishTracer {
+    ARTPublishTracePoint *_points;
+    NSUInteger _capacity;
+    uint32_t _sampleThreshold;
+    _Atomic(uint64_t) _nextPoint;
+    _Atomic(uint64_t) _nextTraceId;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity sampleRate:(double)sampleRate {
+    if (self = [super init]) {
+        _capacity = MAX(capacity, 1);
+        _points = calloc(_capacity, sizeof(ARTPublishTracePoint));
+        _sampleThreshold = (uint32_t)(MIN(MAX(sampleRate, 0.0), 1.0) * UINT32_MAX);
+        atomic_init(&_nextPoint, 0);
+        atomic_init(&_nextTraceId, 1);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_points);
+}
+
+- (uint64_t)startTrace {
+    if (_sampleThreshold == 0 || arc4random() > _sampleThreshold) {
+        return 0;
+    }
+    uint64_t traceId = atomic_fetch_add_explicit(&_nextTraceId, 1, memory_order_relaxed);
+    [self record:ARTPublishTraceStagePublish traceId:traceId];
+    return traceId;
+}
+
+- (void)record:(ARTPublishTraceStage)stage traceId:(uint64_t)traceId {
+    if (traceId == 0) {
+        return;
+    }
+    [self record:stage traceId:traceId time:ARTMetricsNow()];
+}
+
+- (void)record:(ARTPublishTraceStage)stage traceId:(uint64_t)traceId time:(uint64_t)time {
+    if (traceId == 0) {
+        return;
+    }
+    uint64_t index = atomic_fetch_add_explicit(&_nextPoint, 1, memory_order_relaxed);
+    ARTPublishTracePoint *point = &_points[index % _capacity];
+    atomic_store_explicit(&point->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&point->traceId, traceId, memory_order_relaxed);
+    atomic_store_explicit(&point->time, time, memory_order_relaxed);
+    atomic_store_explicit(&point->stage, stage, memory_order_relaxed);
+    atomic_store_explicit(&point->sequence, index + 1, memory_order_release);
+}
+
+- (void)record:(ARTPublishTraceStage)stage messages:(NSArray<ARTMessage *> *)messages {
+    uint64_t previous = 0;
+    for (ARTMessage *message in messages) {
+        uint64_t traceId = message.traceId;
+        if (traceId != 0 && traceId != previous) {
+            [self record:stage traceId:traceId];
+        }
+        previous = traceId;
+    }
+}
+
+- (NSData *)chromeTraceEventJSON {
+    NSMutableDictionary<NSNumber *, NSMutableArray<NSArray<NSNumber *> *> *> *pointsByTrace = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < _capacity; i++) {
+        ARTPublishTracePoint *point = &_points[i];
+        uint64_t sequence = atomic_load_explicit(&point->sequence, memory_order_acquire);
+        uint64_t traceId = atomic_load_explicit(&point->traceId, memory_order_relaxed);
+        uint64_t time = atomic_load_explicit(&point->time, memory_order_relaxed);
+        uint8_t stage = atomic_load_explicit(&point->stage, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (sequence == 0 || sequence != atomic_load_explicit(&point->sequence, memory_order_relaxed)) {
+            continue; // Never written, or being overwritten.
+        }
+        NSMutableArray *points = pointsByTrace[@(traceId)];
+        if (!points) {
+            points = [NSMutableArray array];
+            pointsByTrace[@(traceId)] = points;
+        }
+        [points addObject:@[@(time), @(stage)]];
+    }
+
+    // Each stage is drawn as a span from the previous point of the same publish.
+    NSMutableArray<NSDictionary *> *events = [NSMutableArray array];
+    [pointsByTrace enumerateKeysAndObjectsUsingBlock:^(NSNumber *traceId, NSMutableArray<NSArray<NSNumber *> *> *points, BOOL *stop) {
+        [points sortUsingComparator:^NSComparisonResult(NSArray<NSNumber *> *a, NSArray<NSNumber *> *b) {
+            return [a[0] compare:b[0]];
+        }];
+        for (NSUInteger i = 1; i < points.count; i++) {
+            uint64_t start = points[i - 1][0].unsignedLongLongValue;
+            uint64_t end = points[i][0].unsignedLongLongValue;
+            [events addObject:@{
+                @"name": ARTPublishTraceStageToStr((ARTPublishTraceStage)points[i][1].unsignedCharValue),
+                @"cat": @"publish",
+                @"ph": @"X",
+                @"ts": @(start / 1000.0),
+                @"dur": @((end - start) / 1000.0),
+                @"pid": @1,
+                @"tid": traceId,
+            }];
+        }
+    }];
+
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents": events, @"displayTimeUnit": @"ms"} options:0 error:nil];
+}
+
+@end
@@ -0,0 +1,24 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTStats.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Interval ids in the fixed UTC formats used by the stats API: `yyyy-MM-dd:HH:mm`, `yyyy-MM-dd:HH`, `yyyy-MM-dd` and `yyyy-MM`, for minutes, hours, days and months.
+
+ These are parsed and formatted by hand, without `NSDateFormatter`, so that they can be used on every interval of a large stats range. Times are whole seconds since 1970.
+ */
+
+/// The granularity given by the length of `intervalId`. Returns `NO` if it has none of the four lengths, without checking its contents.
+BOOL ARTStatsIntervalIdGranularity(NSString *intervalId, ARTStatsGranularity *granularity);
+
+/// Parses `intervalId`, whose length gives its granularity. Returns `NO` if it has none of the four lengths or isn't a valid date.
+BOOL ARTStatsIntervalIdParse(NSString *intervalId, ARTStatsGranularity *_Nullable granularity, int64_t *_Nullable seconds);
+
+/// Formats the interval of `granularity` that contains `seconds`.
+NSString *ARTStatsIntervalIdFormat(int64_t seconds, ARTStatsGranularity granularity);
+
+/// The start of the interval of `granularity` that contains `seconds`.
+int64_t ARTStatsIntervalStart(int64_t seconds, ARTStatsGranularity granularity);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,136 @@
+#import "ARTStatsIntervalId.h"
+
+// `yyyy-MM-dd:HH:mm` and its prefixes, indexed by `ARTStatsGranularity`.
+static const NSUInteger ARTStatsIntervalIdLengths[] = { 16, 13, 10, 7 };
+
+static const int64_t ARTSecondsPerDay = 86400;
+
+static int64_t floorDivide(int64_t a, int64_t b) {
+    int64_t quotient = a / b;
+    if (a % b != 0 && (a < 0) != (b < 0)) {
+        quotient--;
+    }
+    return quotient;
+}
+
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar, and back.
+// See http://howardhinnant.github.io/date_algorithms.html
+static int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = floorDivide(year, 400);
+    const unsigned yearOfEra = (unsigned)(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+static void civilFromDays(int64_t days, int64_t *year, unsigned *month, unsigned *day) {
+    days += 719468;
+    const int64_t era = floorDivide(days, 146097);
+    const unsigned dayOfEra = (unsigned)(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+    *day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    *month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    *year = (int64_t)yearOfEra + era * 400 + (*month <= 2);
+}
+
+static unsigned daysInMonth(int64_t year, unsigned month) {
+    static const unsigned days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+        return 29;
+    }
+    return days[month - 1];
+}
+
+static BOOL readDigits(const unichar *characters, NSUInteger count, unsigned *value) {
+    unsigned result = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (characters[i] < '0' || characters[i] > '9') {
+            return NO;
+        }
+        result = result * 10 + (characters[i] - '0');
+    }
+    *value = result;
+    return YES;
+}
+
+BOOL ARTStatsIntervalIdGranularity(NSString *intervalId, ARTStatsGranularity *granularity) {
+    const NSUInteger length = intervalId.length;
+    for (NSUInteger i = 0; i <= ARTStatsGranularityMonth; i++) {
+        if (ARTStatsIntervalIdLengths[i] == length) {
+            *granularity = (ARTStatsGranularity)i;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+BOOL ARTStatsIntervalIdParse(NSString *intervalId, ARTStatsGranularity *granularity, int64_t *seconds) {
+    ARTStatsGranularity parsedGranularity;
+    if (!ARTStatsIntervalIdGranularity(intervalId, &parsedGranularity)) {
+        return NO;
+    }
+    const NSUInteger length = intervalId.length;
+
+    unichar c[16];
+    [intervalId getCharacters:c range:NSMakeRange(0, length)];
+
+    unsigned year, month, day = 1, hour = 0, minute = 0;
+    if (!readDigits(c, 4, &year) || c[4] != '-' || !readDigits(c + 5, 2, &month)) {
+        return NO;
+    }
+    if (length >= 10 && (c[7] != '-' || !readDigits(c + 8, 2, &day))) {
+        return NO;
+    }
+    if (length >= 13 && (c[10] != ':' || !readDigits(c + 11, 2, &hour))) {
+        return NO;
+    }
+    if (length >= 16 && (c[13] != ':' || !readDigits(c + 14, 2, &minute))) {
+        return NO;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59) {
+        return NO;
+    }
+
+    if (granularity) {
+        *granularity = parsedGranularity;
+    }
+    if (seconds) {
+        *seconds = daysFromCivil(year, month, day) * ARTSecondsPerDay + hour * 3600 + minute * 60;
+    }
+    return YES;
+}
+
+NSString *ARTStatsIntervalIdFormat(int64_t seconds, ARTStatsGranularity granularity) {
+    const int64_t days = floorDivide(seconds, ARTSecondsPerDay);
+    const int64_t secondOfDay = seconds - days * ARTSecondsPerDay;
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, &year, &month, &day);
+
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u:%02u:%02u", (long long)year, month, day, (unsigned)(secondOfDay / 3600), (unsigned)(secondOfDay % 3600 / 60));
+    // Years beyond four digits only lengthen the leading field.
+    length -= (int)(ARTStatsIntervalIdLengths[ARTStatsGranularityMinute] - ARTStatsIntervalIdLengths[granularity]);
+    return [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding];
+}
+
+int64_t ARTStatsIntervalStart(int64_t seconds, ARTStatsGranularity granularity) {
+    switch (granularity) {
+        case ARTStatsGranularityMinute:
+            return floorDivide(seconds, 60) * 60;
+        case ARTStatsGranularityHour:
+            return floorDivide(seconds, 3600) * 3600;
+        case ARTStatsGranularityDay:
+            return floorDivide(seconds, ARTSecondsPerDay) * ARTSecondsPerDay;
+        case ARTStatsGranularityMonth: {
+            int64_t year;
+            unsigned month, day;
+            civilFromDays(floorDivide(seconds, ARTSecondsPerDay), &year, &month, &day);
+            return daysFromCivil(year, month, 1) * ARTSecondsPerDay;
+        }
+    }
+    return seconds;
+}
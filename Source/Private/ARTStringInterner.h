@@ -0,0 +1,21 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Hands out one shared instance for each distinct string, so that objects holding equal strings hold the same one.
+
+ Strings are held weakly: once nothing else uses one, it's released and its entry goes away. Not thread-safe; a client's
+ interner is only used on its internal queue.
+ */
+@interface ARTStringInterner : NSObject
+
+/// The number of distinct strings currently interned.
+@property (nonatomic, readonly) NSUInteger count;
+
+/// The shared instance equal to `string`, which becomes it if there's none yet.
+- (nullable NSString *)intern:(nullable NSString *)string;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,31 @@
+#import "ARTStringInterner.h"
+
+@implementation ARTStringInterner {
+    NSHashTable<NSString *> *_strings;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _strings = [[NSHashTable alloc] initWithOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPersonality capacity:0];
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    return _strings.allObjects.count;
+}
+
+- (NSString *)intern:(NSString *)string {
+    if (!string) {
+        return nil;
+    }
+    NSString *interned = [_strings member:string];
+    if (!interned) {
+        // A mutable string could change under the table.
+        interned = [string copy];
+        [_strings addObject:interned];
+    }
+    return interned;
+}
+
+@end
@@ -0,0 +1 @@
+../../.././Source/ARTClientMetrics+Private.h
\ No newline at end of file
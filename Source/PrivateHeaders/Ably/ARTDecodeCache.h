@@ -0,0 +1 @@
+../../.././Source/Private/ARTDecodeCache.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/ARTDeviceStorageWriter.h
\ No newline at end of file
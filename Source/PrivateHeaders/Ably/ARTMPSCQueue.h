@@ -0,0 +1 @@
+../../.././Source/Private/ARTMPSCQueue.h
\ No newline at end of file
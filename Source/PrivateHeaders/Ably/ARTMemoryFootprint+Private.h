@@ -0,0 +1 @@
+../../.././Source/ARTMemoryFootprint+Private.h
\ No newline at end of file
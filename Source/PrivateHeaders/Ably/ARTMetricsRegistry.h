@@ -0,0 +1 @@
+../../.././Source/Private/ARTMetricsRegistry.h
\ No newline at end of file
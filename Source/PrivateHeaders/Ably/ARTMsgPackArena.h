@@ -0,0 +1 @@
+../../.././Source/Private/ARTMsgPackArena.h
\ No newline at end of file
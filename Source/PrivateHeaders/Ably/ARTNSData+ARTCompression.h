@@ -0,0 +1 @@
+../../.././Source/Private/ARTNSData+ARTCompression.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/ARTPaginatedResultIterator+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/ARTPendingMessage+Private.h
\ No newline at end of file
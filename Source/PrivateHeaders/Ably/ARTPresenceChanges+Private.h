@@ -0,0 +1 @@
+../../.././Source/ARTPresenceChanges+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/Private/ARTPresenceMember.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/Private/ARTPublishTracer.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/ARTPushBatch+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/ARTRestBatchPublisher+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/Private/ARTStatsIntervalId.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/Private/ARTStringInterner.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../.././Source/ARTTokenDetailsCache.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Source/ARTClientMetrics.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Source/ARTMemoryFootprint.h
\ No newline at end of file
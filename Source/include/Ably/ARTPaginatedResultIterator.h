@@ -0,0 +1 @@
+../../../Source/ARTPaginatedResultIterator.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Source/ARTPresenceChanges.h
\ No newline at end of file
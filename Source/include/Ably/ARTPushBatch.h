@@ -0,0 +1 @@
+../../../Source/ARTPushBatch.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Source/ARTPushListOptions.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Source/ARTRestBatchPublisher.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Source/ARTStatsRollup.h
\ No newline at end of file
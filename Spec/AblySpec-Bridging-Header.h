@@ -1,3 +1,7 @@
 #include <asl.h>
 #include "NSObject+TestSuite.h"
 #include "ARTGCD.h"
+#include "LoopbackTransport.h"
+#include "AllocationCounter.h"
+#include "NSData+Gzip.h"
+#include "ARTSRSIMDHelpers.h"
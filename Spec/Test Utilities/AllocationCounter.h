@@ -0,0 +1,18 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Counts heap allocations made by the whole process, through the `malloc_logger` hook that malloc stack logging uses.
+ Only one count can be running at a time.
+ */
+@interface AllocationCounter : NSObject
+
++ (void)start;
+
+/// Stops counting and returns the number of `malloc`, `calloc`, `realloc` and `valloc` calls since `start`.
++ (uint64_t)stop;
+
+@end
+
+NS_ASSUME_NONNULL_END
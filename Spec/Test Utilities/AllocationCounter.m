@@ -0,0 +1,32 @@
+#import "AllocationCounter.h"
+#import <stdatomic.h>
+
+// Declared in libmalloc's private headers; called by every malloc zone function while it is set.
+typedef void (malloc_logger_t)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t num_hot_frames_to_skip);
+extern malloc_logger_t *malloc_logger;
+
+// From libmalloc's stack_logging.h.
+static const uint32_t AllocationCounterLogTypeAllocate = 2;
+
+static _Atomic(uint64_t) allocationCount;
+
+static void AllocationCounterLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t num_hot_frames_to_skip) {
+    if (type & AllocationCounterLogTypeAllocate) {
+        atomic_fetch_add_explicit(&allocationCount, 1, memory_order_relaxed);
+    }
+}
+
+@implementation AllocationCounter
+
++ (void)start {
+    NSAssert(malloc_logger == NULL, @"Another malloc logger is installed; disable malloc stack logging to count allocations.");
+    atomic_store_explicit(&allocationCount, 0, memory_order_relaxed);
+    malloc_logger = AllocationCounterLogger;
+}
+
++ (uint64_t)stop {
+    malloc_logger = NULL;
+    return atomic_load_explicit(&allocationCount, memory_order_relaxed);
+}
+
+@end
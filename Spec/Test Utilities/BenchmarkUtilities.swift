@@ -0,0 +1,328 @@
+import Ably
+import Ably.Private
+import Foundation
+import SwiftyJSON
+import XCTest
+import Nimble
+
+/// Benchmarks are skipped unless `ABLY_BENCHMARK_OUTPUT` is set to the path of the JSON report to write.
+/// `xcodebuild test` passes it to the test runner as `TEST_RUNNER_ABLY_BENCHMARK_OUTPUT`; see `make benchmark_macOS`.
+enum Benchmark {
+
+    static var outputPath: String? {
+        return ProcessInfo.processInfo.environment["ABLY_BENCHMARK_OUTPUT"]
+    }
+
+    static func skipUnlessEnabled() throws {
+        try XCTSkipUnless(outputPath != nil, "Set ABLY_BENCHMARK_OUTPUT to run benchmarks")
+    }
+
+    /// Monotonic time in nanoseconds, on the same clock as `LoopbackTransport` delivery times.
+    static func now() -> UInt64 {
+        return DispatchTime.now().uptimeNanoseconds
+    }
+
+    static func seconds(since start: UInt64, until end: UInt64 = now()) -> Double {
+        return Double(end - start) / Double(NSEC_PER_SEC)
+    }
+
+    /// Times `operations` calls of `body` in each of `rounds` rounds, after `warmup` untimed calls.
+    ///
+    /// Rounds are timed as a whole, so that the clock isn't read around calls that take less than a microsecond.
+    /// The result has the time per call of the median and fastest rounds, and the heap allocations per call over all rounds.
+    static func measure(operations: Int, rounds: Int = 10, warmup: Int = 10, _ body: () -> Void) -> [String: Any] {
+        for _ in 0..<warmup {
+            body()
+        }
+
+        var roundTimes: [Double] = []
+        roundTimes.reserveCapacity(rounds)
+        AllocationCounter.start()
+        for _ in 0..<rounds {
+            let start = now()
+            for _ in 0..<operations {
+                body()
+            }
+            roundTimes.append(Double(now() - start) / Double(operations))
+        }
+        let allocations = AllocationCounter.stop()
+
+        roundTimes.sort()
+        let median = roundTimes[roundTimes.count / 2]
+        return [
+            "operations": operations * rounds,
+            "nsPerOperation": median,
+            "minNsPerOperation": roundTimes[0],
+            "operationsPerSecond": Double(NSEC_PER_SEC) / median,
+            "allocationsPerOperation": Double(allocations) / Double(operations * rounds),
+        ]
+    }
+
+}
+
+/// Accumulates benchmark results and rewrites the report after each one, so an interrupted run keeps what it measured.
+class BenchmarkReport {
+
+    static let shared = BenchmarkReport()
+
+    private var results: [[String: Any]] = []
+
+    func record(_ name: String, _ values: [String: Any]) {
+        var result = values
+        result["name"] = name
+        results.append(result)
+        print("Benchmark \(name): \(values)")
+
+        guard let path = Benchmark.outputPath else {
+            return
+        }
+        let report: [String: Any] = [
+            "libraryVersion": ARTDefault.libraryVersion(),
+            "platform": ProcessInfo.processInfo.operatingSystemVersionString,
+            "date": ISO8601DateFormatter().string(from: Date()),
+            "results": results,
+        ]
+        let data = try! JSONSerialization.data(withJSONObject: report, options: [.prettyPrinted, .sortedKeys])
+        try! data.write(to: URL(fileURLWithPath: path), options: .atomic)
+    }
+
+}
+
+/// Durations in nanoseconds, summarized as percentiles in microseconds.
+struct LatencySamples {
+
+    private(set) var nanoseconds: [UInt64] = []
+
+    init(capacity: Int = 0) {
+        nanoseconds.reserveCapacity(capacity)
+    }
+
+    mutating func append(_ duration: UInt64) {
+        nanoseconds.append(duration)
+    }
+
+    mutating func append(contentsOf other: LatencySamples) {
+        nanoseconds.append(contentsOf: other.nanoseconds)
+    }
+
+    var summary: [String: Any] {
+        let sorted = nanoseconds.sorted()
+        func percentile(_ p: Double) -> Double {
+            guard !sorted.isEmpty else { return 0 }
+            let index = min(sorted.count - 1, Int((p / 100 * Double(sorted.count)).rounded(.up)) - 1)
+            return Double(sorted[max(index, 0)]) / 1000
+        }
+        let mean = sorted.isEmpty ? 0 : Double(sorted.reduce(0, +)) / Double(sorted.count) / 1000
+        return [
+            "count": sorted.count,
+            "meanUs": mean,
+            "p50Us": percentile(50),
+            "p90Us": percentile(90),
+            "p99Us": percentile(99),
+            "maxUs": Double(sorted.last ?? 0) / 1000,
+        ]
+    }
+
+}
+
+/// Fixed slots for timestamps written from callbacks on other queues, one slot per index, without locking or copying.
+class TimestampBuffer {
+
+    let count: Int
+    private let pointer: UnsafeMutablePointer<UInt64>
+
+    init(count: Int) {
+        self.count = count
+        pointer = UnsafeMutablePointer<UInt64>.allocate(capacity: max(count, 1))
+        pointer.initialize(repeating: 0, count: max(count, 1))
+    }
+
+    deinit {
+        pointer.deallocate()
+    }
+
+    subscript(index: Int) -> UInt64 {
+        get { return pointer[index] }
+        set { pointer[index] = newValue }
+    }
+
+}
+
+/// Encoded ProtocolMessage frames for `LoopbackTransport` to replay, either synthesized or recorded from a real connection.
+struct ProtocolMessageStream {
+
+    enum Format: String {
+        case json
+        case msgpack
+    }
+
+    let format: Format
+    let frames: [Data]
+
+    init(format: Format, frames: [Data]) {
+        self.format = format
+        self.frames = frames
+    }
+
+    /// The frames received by a `TestProxyTransport` connected with the given format.
+    init(recordedBy transport: TestProxyTransport, format: Format) {
+        self.init(format: format, frames: transport.rawDataReceived)
+    }
+
+    /// Reads a stream saved with `write(to:)`.
+    init(contentsOf url: URL) throws {
+        let object = try JSONSerialization.jsonObject(with: Data(contentsOf: url)) as? [String: Any]
+        guard let format = (object?["format"] as? String).flatMap(Format.init(rawValue:)),
+              let frames = object?["frames"] as? [String] else {
+            throw NSError(domain: AblyTestsErrorDomain, code: 0, userInfo: [NSLocalizedDescriptionKey: "\(url.path) is not a ProtocolMessage stream"])
+        }
+        self.init(format: format, frames: frames.compactMap { Data(base64Encoded: $0) })
+    }
+
+    /// Saves the stream as `{"format": "json" | "msgpack", "frames": [<base64 frame>, ...]}`.
+    func write(to url: URL) throws {
+        let object: [String: Any] = ["format": format.rawValue, "frames": frames.map { $0.base64EncodedString() }]
+        try JSONSerialization.data(withJSONObject: object).write(to: url, options: .atomic)
+    }
+
+    /// `frames` MESSAGE frames for `channel`, each carrying `messagesPerFrame` messages with a `payloadSize`-character string.
+    static func messages(channel: String, format: Format, frames: Int, messagesPerFrame: Int = 1, payloadSize: Int = 256) -> ProtocolMessageStream {
+        let encoder = format.encoder
+        let payload = String(repeating: "x", count: payloadSize)
+        let timestamp = Date()
+        return ProtocolMessageStream(format: format, frames: (0..<frames).map { i in
+            let protocolMessage = ARTProtocolMessage()
+            protocolMessage.action = .message
+            protocolMessage.channel = channel
+            protocolMessage.id = "loopback:\(i)"
+            protocolMessage.connectionId = "publisher"
+            protocolMessage.timestamp = timestamp
+            protocolMessage.messages = (0..<messagesPerFrame).map { j in
+                let message = ARTMessage(name: "event", data: payload)
+                message.id = "loopback:\(i):\(j)"
+                message.timestamp = timestamp
+                return message
+            }
+            return try! encoder.encode(protocolMessage)
+        })
+    }
+
+    /// For each channel, the index of the frame that carries each of its messages, in delivery order.
+    func messageFramesByChannel() -> [String: [Int]] {
+        let encoder = format.encoder
+        var framesByChannel: [String: [Int]] = [:]
+        for (index, frame) in frames.enumerated() {
+            guard let protocolMessage = try? encoder.decodeProtocolMessage(frame),
+                  protocolMessage.action == .message,
+                  let channel = protocolMessage.channel else {
+                continue
+            }
+            framesByChannel[channel, default: []].append(contentsOf: repeatElement(index, count: protocolMessage.messages?.count ?? 0))
+        }
+        return framesByChannel
+    }
+
+}
+
+extension ProtocolMessageStream.Format {
+
+    var encoder: ARTEncoder {
+        switch self {
+        case .json:
+            return ARTJsonLikeEncoder(delegate: ARTJsonEncoder())
+        case .msgpack:
+            return ARTJsonLikeEncoder(delegate: ARTMsgPackEncoder())
+        }
+    }
+
+}
+
+extension AblyTests {
+
+    /// A realtime client connected through a `LoopbackTransport`, with its own internal and callback queues.
+    class func newLoopbackRealtime(format: ProtocolMessageStream.Format, configure: (ARTClientOptions) -> Void = { _ in }) -> ARTRealtime {
+        let options = ARTClientOptions(key: "loopback.key:secret")
+        options.autoConnect = false
+        options.useBinaryProtocol = format == .msgpack
+        options.logExceptionReportingUrl = nil
+        options.internalDispatchQueue = DispatchQueue(label: "io.ably.benchmarks", qos: .userInitiated)
+        options.dispatchQueue = DispatchQueue(label: "io.ably.benchmarks.callbacks", qos: .userInitiated)
+        configure(options)
+
+        let client = ARTRealtime(options: options)
+        client.internal.setTransport(LoopbackTransport.self)
+        client.internal.setReachabilityClass(TestReachability.self)
+        waitUntil(timeout: testTimeout) { done in
+            client.connection.once(.connected) { _ in
+                done()
+            }
+            client.connect()
+        }
+        return client
+    }
+
+}
+
+extension ARTRealtime {
+
+    var loopbackTransport: LoopbackTransport {
+        return internal.transport as! LoopbackTransport
+    }
+
+}
+
+/// The inputs of `CodecBenchmarks`, read from `CodecBenchmarkCorpus.json` so that every run measures the same bytes.
+///
+/// Strings and binary payloads are built to each size by repeating a seed; the VCDIFF cases are deltas between two
+/// versions of a document, with the expected result so that a broken decoder doesn't go unnoticed.
+struct CodecBenchmarkCorpus {
+
+    struct DeltaCase {
+        let name: String
+        let base: String
+        let delta: Data
+        let expected: String
+    }
+
+    let protocolMessageCounts: [Int]
+    let protocolMessagePayloadSizes: [Int]
+    let strings: [String]
+    let binaries: [Data]
+    let json: [String: Any]
+    let deltas: [DeltaCase]
+    let maskSizes: [Int]
+
+    static let shared = CodecBenchmarkCorpus()
+
+    private init() {
+        let path = Bundle(for: AblyTests.self).path(forResource: "CodecBenchmarkCorpus", ofType: "json")!
+        let corpus = JSON(parseJSON: try! String(contentsOfFile: path))
+
+        protocolMessageCounts = corpus["protocolMessages"]["messageCounts"].arrayValue.map { $0.intValue }
+        protocolMessagePayloadSizes = corpus["protocolMessages"]["payloadSizes"].arrayValue.map { $0.intValue }
+
+        let stringSeed = corpus["strings"]["seed"].stringValue
+        strings = corpus["strings"]["sizes"].arrayValue.map { size in
+            String(String(repeating: stringSeed, count: size.intValue / stringSeed.count + 1).prefix(size.intValue))
+        }
+
+        let binarySeed = Data(base64Encoded: corpus["binary"]["seed"].stringValue)!
+        binaries = corpus["binary"]["sizes"].arrayValue.map { size in
+            var data = Data(capacity: size.intValue)
+            while data.count < size.intValue {
+                data.append(binarySeed.prefix(size.intValue - data.count))
+            }
+            return data
+        }
+
+        json = corpus["json"].dictionaryObject!
+        deltas = corpus["vcdiff"].arrayValue.map { item in
+            DeltaCase(name: item["name"].stringValue,
+                      base: item["base"].stringValue,
+                      delta: Data(base64Encoded: item["delta"].stringValue)!,
+                      expected: item["expected"].stringValue)
+        }
+        maskSizes = corpus["mask"]["sizes"].arrayValue.map { $0.intValue }
+    }
+
+}
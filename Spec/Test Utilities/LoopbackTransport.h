@@ -0,0 +1,46 @@
+#import <Foundation/Foundation.h>
+#import <Ably/ARTWebSocketTransport+Private.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An in-process stand-in for the realtime endpoint, used by `LoopbackTransport` in place of `ARTSRWebSocket`.
+
+ It answers the connection handshake, ATTACH, DETACH and CLOSE, and acknowledges every ProtocolMessage that requires it,
+ encoding its replies with the client's own format so that they go through the same decode path as real frames.
+ Frames sent by the client are counted but never decoded, so no work is charged to the client's queues apart from
+ building and encoding the replies.
+ */
+@interface LoopbackWebSocket : NSObject <ARTWebSocket>
+
+/// Set by `LoopbackTransport`; used for the replies.
+@property (nonatomic, strong) id<ARTEncoder> encoder;
+
+/// Frames and bytes received from the client. Only read them once the client is idle.
+@property (nonatomic, readonly) NSUInteger framesSent;
+@property (nonatomic, readonly) NSUInteger bytesSent;
+
+@end
+
+/**
+ An `ARTWebSocketTransport` connected to a `LoopbackWebSocket` instead of the network. Install it with
+ `-[ARTRealtimeInternal setTransportClass:]` before connecting.
+ */
+@interface LoopbackTransport : ARTWebSocketTransport
+
+@property (nonatomic, readonly, nullable) LoopbackWebSocket *loopback;
+
+/**
+ Delivers encoded ProtocolMessage frames to the client as if they had been received from the network, on the client's
+ internal queue.
+
+ @param frames Frames encoded in the client's format, e.g. with `-[ARTEncoder encodeProtocolMessage:error:]`.
+ @param framesPerSecond The delivery rate; `0` delivers each frame as soon as the previous one has been processed.
+ @param completion Called on the internal queue after the last frame has been processed, with the monotonic time
+ (`mach_absolute_time`, in nanoseconds) at which each frame was handed to the transport.
+ */
+- (void)replayFrames:(NSArray<NSData *> *)frames framesPerSecond:(double)framesPerSecond completion:(void (^)(NSData *deliveryTimes))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
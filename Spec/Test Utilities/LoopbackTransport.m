@@ -0,0 +1,190 @@
+#import "LoopbackTransport.h"
+#import <Ably/ARTProtocolMessage.h>
+#import <Ably/ARTProtocolMessage+Private.h>
+#import <Ably/ARTConnectionDetails.h>
+#import <Ably/ARTEncoder.h>
+#import <time.h>
+
+static uint64_t LoopbackNow(void) {
+    // Same clock as `DispatchTime.now().uptimeNanoseconds`.
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+@implementation LoopbackWebSocket
+
+@synthesize delegate = _delegate;
+@synthesize delegateDispatchQueue = _delegateDispatchQueue;
+@synthesize readyState = _readyState;
+
+- (instancetype)initWithURLRequest:(NSURLRequest *)request logger:(ARTLog *)logger {
+    if (self = [super init]) {
+        _readyState = ARTSR_CONNECTING;
+    }
+    return self;
+}
+
+- (void)setDelegateDispatchQueue:(dispatch_queue_t)queue {
+    _delegateDispatchQueue = queue;
+}
+
+- (void)open {
+    dispatch_async(_delegateDispatchQueue, ^{
+        self->_readyState = ARTSR_OPEN;
+        [self.delegate webSocketDidOpen:self];
+
+        ARTProtocolMessage *connected = [[ARTProtocolMessage alloc] init];
+        connected.action = ARTProtocolMessageConnected;
+        connected.connectionId = @"loopback";
+        connected.connectionKey = @"loopback-key";
+        connected.connectionSerial = -1;
+        connected.connectionDetails = [[ARTConnectionDetails alloc] initWithClientId:nil
+                                                                       connectionKey:@"loopback-key"
+                                                                      maxMessageSize:65536
+                                                                        maxFrameSize:524288
+                                                                      maxInboundRate:0
+                                                                  connectionStateTtl:120
+                                                                            serverId:@"loopback"
+                                                                     maxIdleInterval:0];
+        [self deliver:connected];
+    });
+}
+
+- (void)closeWithCode:(NSInteger)code reason:(NSString *)reason {
+    if (_readyState == ARTSR_CLOSED) {
+        return;
+    }
+    _readyState = ARTSR_CLOSED;
+    dispatch_async(_delegateDispatchQueue, ^{
+        [self.delegate webSocket:self didCloseWithCode:code reason:reason wasClean:YES];
+    });
+}
+
+- (void)send:(id)message {
+    _framesSent++;
+    _bytesSent += [message isKindOfClass:[NSData class]] ? [(NSData *)message length] : [(NSString *)message lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)replyTo:(ARTProtocolMessage *)message {
+    ARTProtocolMessage *reply = nil;
+    switch (message.action) {
+        case ARTProtocolMessageAttach:
+            reply = [[ARTProtocolMessage alloc] init];
+            reply.action = ARTProtocolMessageAttached;
+            reply.channel = message.channel;
+            break;
+        case ARTProtocolMessageDetach:
+            reply = [[ARTProtocolMessage alloc] init];
+            reply.action = ARTProtocolMessageDetached;
+            reply.channel = message.channel;
+            break;
+        case ARTProtocolMessageClose:
+            reply = [[ARTProtocolMessage alloc] init];
+            reply.action = ARTProtocolMessageClosed;
+            break;
+        default:
+            if (message.ackRequired) {
+                reply = [[ARTProtocolMessage alloc] init];
+                reply.action = ARTProtocolMessageAck;
+                reply.msgSerial = message.msgSerial;
+                reply.count = 1;
+            }
+            break;
+    }
+    if (!reply) {
+        return;
+    }
+    dispatch_async(_delegateDispatchQueue, ^{
+        [self deliver:reply];
+    });
+}
+
+- (void)deliver:(ARTProtocolMessage *)message {
+    if (_readyState != ARTSR_OPEN) {
+        return;
+    }
+    NSData *data = [_encoder encodeProtocolMessage:message error:nil];
+    [self deliverFrame:data];
+}
+
+- (void)deliverFrame:(NSData *)data {
+    // Text frames reach the transport as strings, as they do from `ARTSRWebSocket`.
+    if (_encoder.format == ARTEncoderFormatJson) {
+        [self.delegate webSocket:self didReceiveMessage:[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding]];
+    }
+    else {
+        [self.delegate webSocket:self didReceiveMessage:data];
+    }
+}
+
+@end
+
+@implementation LoopbackTransport
+
+- (LoopbackWebSocket *)loopback {
+    return (LoopbackWebSocket *)self.websocket;
+}
+
+- (NSURL *)setupWebSocket:(NSDictionary<NSString *,NSURLQueryItem *> *)params withOptions:(ARTClientOptions *)options resumeKey:(NSString *)resumeKey connectionSerial:(NSNumber *)connectionSerial {
+    NSURL *url = [super setupWebSocket:params withOptions:options resumeKey:resumeKey connectionSerial:connectionSerial];
+    LoopbackWebSocket *loopback = [[LoopbackWebSocket alloc] initWithURLRequest:[NSURLRequest requestWithURL:url] logger:self.logger];
+    loopback.encoder = self.encoder;
+    [loopback setDelegateDispatchQueue:self.websocket.delegateDispatchQueue];
+    loopback.delegate = self;
+    self.websocket = loopback;
+    return url;
+}
+
+- (BOOL)send:(NSData *)data withSource:(id)decodedObject {
+    BOOL sent = [super send:data withSource:decodedObject];
+    if (sent && [decodedObject isKindOfClass:[ARTProtocolMessage class]]) {
+        [self.loopback replyTo:(ARTProtocolMessage *)decodedObject];
+    }
+    return sent;
+}
+
+- (void)replayFrames:(NSArray<NSData *> *)frames framesPerSecond:(double)framesPerSecond completion:(void (^)(NSData *))completion {
+    NSMutableData *deliveryTimes = [NSMutableData dataWithLength:frames.count * sizeof(uint64_t)];
+    dispatch_async(self.websocket.delegateDispatchQueue, ^{
+        [self replayFrames:frames fromIndex:0 startTime:LoopbackNow() framesPerSecond:framesPerSecond deliveryTimes:deliveryTimes completion:completion];
+    });
+}
+
+- (void)replayFrames:(NSArray<NSData *> *)frames fromIndex:(NSUInteger)index startTime:(uint64_t)startTime framesPerSecond:(double)framesPerSecond deliveryTimes:(NSMutableData *)deliveryTimes completion:(void (^)(NSData *))completion {
+    uint64_t *times = deliveryTimes.mutableBytes;
+    if (index < frames.count) {
+        LoopbackWebSocket *loopback = self.loopback;
+        if (framesPerSecond <= 0) {
+            times[index] = LoopbackNow();
+            [loopback deliverFrame:frames[index]];
+            index++;
+        }
+        else {
+            // Deliver every frame that is due, so the rate holds even when the queue falls behind.
+            const uint64_t now = LoopbackNow();
+            while (index < frames.count && startTime + (uint64_t)(index * NSEC_PER_SEC / framesPerSecond) <= now) {
+                times[index] = LoopbackNow();
+                [loopback deliverFrame:frames[index]];
+                index++;
+            }
+        }
+    }
+    if (index >= frames.count) {
+        completion(deliveryTimes);
+        return;
+    }
+
+    // Yield between frames so that other work on the queue, such as publishes, interleaves with the replay.
+    dispatch_block_t next = ^{
+        [self replayFrames:frames fromIndex:index startTime:startTime framesPerSecond:framesPerSecond deliveryTimes:deliveryTimes completion:completion];
+    };
+    if (framesPerSecond <= 0) {
+        dispatch_async(self.websocket.delegateDispatchQueue, next);
+    }
+    else {
+        const uint64_t due = startTime + (uint64_t)(index * NSEC_PER_SEC / framesPerSecond);
+        const uint64_t now = LoopbackNow();
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, due > now ? (int64_t)(due - now) : 0), self.websocket.delegateDispatchQueue, next);
+    }
+}
+
+@end
@@ -6,6 +6,7 @@ class MockDeviceStorage: NSObject, ARTDeviceStorage {
 
     var keysRead: [String] = []
     var keysWritten: [String: Any?] = [:]
+    var writeCount = 0
 
     private var simulateData: [String: Data] = [:]
     private var simulateString: [String: String] = [:]
@@ -35,6 +36,7 @@ class MockDeviceStorage: NSObject, ARTDeviceStorage {
     func setObject(_ value: Any?, forKey key: String) {
         accessQueue.sync {
             _ = keysWritten.updateValue(value, forKey: key)
+            writeCount += 1
         }
     }
 
@@ -52,6 +54,25 @@ class MockDeviceStorage: NSObject, ARTDeviceStorage {
     func setSecret(_ value: String?, forDevice deviceId: ARTDeviceId) {
         accessQueue.sync {
             _ = keysWritten.updateValue(value, forKey: ARTDeviceSecretKey)
+            writeCount += 1
+        }
+    }
+
+    func cachedTokenDetails(forKey key: String) -> String? {
+        return accessQueue.sync {
+            keysRead.append(key)
+            if let value = simulateString[key] {
+                defer { simulateString.removeValue(forKey: key) }
+                return value
+            }
+            return nil
+        }
+    }
+
+    func setCachedTokenDetails(_ value: String?, forKey key: String) {
+        accessQueue.sync {
+            _ = keysWritten.updateValue(value, forKey: key)
+            writeCount += 1
         }
     }
 
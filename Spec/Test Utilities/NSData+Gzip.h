@@ -0,0 +1,12 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface NSData (Gzip)
+
+/// Returns the data decompressed from either the gzip (RFC 1952) or zlib "deflate" (RFC 1950) format, or `nil` if it isn't valid compressed data.
+- (nullable NSData *)gzipDecompressed;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,38 @@
+#import "NSData+Gzip.h"
+#import <zlib.h>
+
+static const NSUInteger GzipChunkSize = 16384;
+
+@implementation NSData (Gzip)
+
+- (NSData *)gzipDecompressed {
+    if (self.length == 0 || self.length > UINT_MAX) {
+        return nil;
+    }
+
+    z_stream stream = {0};
+    // 15 window bits + 32 detects either the gzip or the zlib wrapper.
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        return nil;
+    }
+
+    stream.next_in = (Bytef *)self.bytes;
+    stream.avail_in = (uInt)self.length;
+
+    NSMutableData *output = [NSMutableData dataWithCapacity:self.length * 2];
+    uint8_t chunk[GzipChunkSize];
+    int status = Z_OK;
+    while (status == Z_OK) {
+        stream.next_out = chunk;
+        stream.avail_out = sizeof(chunk);
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status == Z_OK || status == Z_STREAM_END) {
+            [output appendBytes:chunk length:sizeof(chunk) - stream.avail_out];
+        }
+    }
+    inflateEnd(&stream);
+
+    return status == Z_STREAM_END ? output : nil;
+}
+
+@end
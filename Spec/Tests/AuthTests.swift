@@ -4368,4 +4368,111 @@ class AuthTests: XCTestCase {
         expect(tokenDetails.clientId).to(equal(originalTokenRequest.clientId))
         expect(tokenDetails.token).toNot(beNil())
     }
+
+    func test__003__persistTokenDetails__restores_a_cached_token_and_time_offset() throws {
+        let options = AblyTests.clientOptions()
+        options.key = "xxxxxx.yyyyyy:zzzzzz"
+        options.clientId = "john"
+        let storage = MockDeviceStorage()
+        let cache = ARTTokenDetailsCache(storage: storage, options: options, logger: nil)
+
+        let tokenDetails = ARTTokenDetails(token: "xxxxxx.token", expires: Date().addingTimeInterval(3600), issued: Date(), capability: nil, clientId: "john")
+        cache.store(tokenDetails, timeOffset: 5)
+
+        let serialized = try XCTUnwrap(storage.keysWritten[cache.cacheKey] as? String)
+        expect(serialized).toNot(contain("zzzzzz"))
+        expect(storage.keysWritten[ARTDeviceSecretKey]).to(beNil())
+        storage.simulateOnNextRead(string: serialized, for: cache.cacheKey)
+
+        var timeOffset: NSNumber?
+        let restored = try XCTUnwrap(cache.loadTokenDetails(forClientId: "john", timeOffset: &timeOffset))
+        expect(restored.token).to(equal(tokenDetails.token))
+        expect(restored.clientId).to(equal("john"))
+        expect(timeOffset).to(equal(5))
+    }
+
+    func test__004__persistTokenDetails__discards_an_expired_or_incompatible_cached_token() throws {
+        let options = AblyTests.clientOptions()
+        options.key = "xxxxxx.yyyyyy:zzzzzz"
+        let storage = MockDeviceStorage()
+        let cache = ARTTokenDetailsCache(storage: storage, options: options, logger: nil)
+
+        cache.store(ARTTokenDetails(token: "xxxxxx.expired", expires: Date().addingTimeInterval(ARTTokenDetailsCacheExpiryMargin / 2), issued: Date(), capability: nil, clientId: nil), timeOffset: nil)
+        storage.simulateOnNextRead(string: try XCTUnwrap(storage.keysWritten[cache.cacheKey] as? String), for: cache.cacheKey)
+        expect(cache.loadTokenDetails(forClientId: nil, timeOffset: nil)).to(beNil())
+        expect(storage.keysWritten[cache.cacheKey]!).to(beNil())
+
+        cache.store(ARTTokenDetails(token: "xxxxxx.mary", expires: Date().addingTimeInterval(3600), issued: Date(), capability: nil, clientId: "mary"), timeOffset: nil)
+        storage.simulateOnNextRead(string: try XCTUnwrap(storage.keysWritten[cache.cacheKey] as? String), for: cache.cacheKey)
+        expect(cache.loadTokenDetails(forClientId: "john", timeOffset: nil)).to(beNil())
+    }
+
+    func test__005__persistTokenDetails__a_new_client_uses_the_cached_token_without_requesting_one() throws {
+        let options = AblyTests.commonAppSetup()
+        options.persistTokenDetails = true
+        var authCallbackCalls = 0
+        options.authCallback = { _, completion in
+            authCallbackCalls += 1
+            getTestTokenDetails(ttl: 3600) { tokenDetails, error in
+                completion(tokenDetails, error)
+            }
+        }
+        let channelName = uniqueChannelName()
+
+        let first = ARTRest(options: options)
+        let cache = try XCTUnwrap(first.internal.auth.tokenDetailsCache)
+        cache.clear()
+        waitUntil(timeout: testTimeout) { done in
+            first.channels.get(channelName).history { _, error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+        expect(authCallbackCalls) == 1
+        let token = try XCTUnwrap(first.auth.tokenDetails?.token)
+        cache.flush()
+        defer {
+            cache.clear()
+            cache.flush()
+        }
+
+        let second = ARTRest(options: options)
+        // Not read on the thread that creates the client, only on the internal queue before the first request.
+        expect(second.auth.tokenDetails).to(beNil())
+        waitUntil(timeout: testTimeout) { done in
+            second.channels.get(channelName).history { _, error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+        expect(second.auth.tokenDetails?.token) == token
+        expect(authCallbackCalls) == 1
+    }
+
+    func test__006__persistTokenDetails__discards_a_time_offset_saved_too_long_ago() throws {
+        let options = AblyTests.clientOptions()
+        options.key = "xxxxxx.yyyyyy:zzzzzz"
+        let storage = MockDeviceStorage()
+        let cache = ARTTokenDetailsCache(storage: storage, options: options, logger: nil)
+
+        func entry(savedAt: Date) -> String {
+            let expires = dateToMilliseconds(Date().addingTimeInterval(3600))
+            return "{\"token\":\"xxxxxx.token\",\"expires\":\(expires),\"timeOffset\":5,\"savedAt\":\(savedAt.timeIntervalSince1970)}"
+        }
+
+        var timeOffset: NSNumber?
+        storage.simulateOnNextRead(string: entry(savedAt: Date().addingTimeInterval(-60)), for: cache.cacheKey)
+        expect(cache.loadTokenDetails(forClientId: nil, timeOffset: &timeOffset)).toNot(beNil())
+        expect(timeOffset).to(equal(5))
+
+        storage.simulateOnNextRead(string: entry(savedAt: Date().addingTimeInterval(-ARTTokenDetailsCacheTimeOffsetMaxAge - 60)), for: cache.cacheKey)
+        expect(cache.loadTokenDetails(forClientId: nil, timeOffset: &timeOffset)).toNot(beNil())
+        expect(timeOffset).to(beNil())
+
+        // The clock has gone backwards.
+        timeOffset = 1
+        storage.simulateOnNextRead(string: entry(savedAt: Date().addingTimeInterval(60)), for: cache.cacheKey)
+        expect(cache.loadTokenDetails(forClientId: nil, timeOffset: &timeOffset)).toNot(beNil())
+        expect(timeOffset).to(beNil())
+    }
 }
@@ -0,0 +1,208 @@
+import Ably
+import Ably.Private
+import Nimble
+import XCTest
+
+/// Enough calls per round for a round to process about 4 MB, so that small inputs aren't dominated by the clock.
+private func operationsPerRound(forBytes bytes: Int) -> Int {
+    return min(10_000, max(10, 4_000_000 / max(bytes, 1)))
+}
+
+/// Time, throughput and allocations of each codec on the hot path, run in-process on the inputs in `CodecBenchmarkCorpus.json`
+/// and the `ably-common` test vectors, as the baseline for changes to any of them.
+///
+/// Skipped unless `ABLY_BENCHMARK_OUTPUT` is set; run them with `make benchmark_macOS`.
+class CodecBenchmarks: XCTestCase {
+
+    private let corpus = CodecBenchmarkCorpus.shared
+
+    override func setUpWithError() throws {
+        try Benchmark.skipUnlessEnabled()
+    }
+
+    // MARK: ProtocolMessage
+
+    private func measureProtocolMessages(format: ProtocolMessageStream.Format) {
+        let encoder = format.encoder
+        for count in corpus.protocolMessageCounts {
+            for payloadSize in corpus.protocolMessagePayloadSizes {
+                let frame = ProtocolMessageStream.messages(channel: "benchmark", format: format, frames: 1, messagesPerFrame: count, payloadSize: payloadSize).frames[0]
+                let protocolMessage = try! encoder.decodeProtocolMessage(frame)
+                let operations = operationsPerRound(forBytes: frame.count)
+                let values: [String: Any] = [
+                    "format": format.rawValue,
+                    "messages": count,
+                    "payloadSize": payloadSize,
+                    "frameSize": frame.count,
+                ]
+
+                var encoded = Data()
+                var result = Benchmark.measure(operations: operations) {
+                    encoded = try! encoder.encode(protocolMessage)
+                }
+                expect(encoded.count) == frame.count
+                result.merge(values) { $1 }
+                result["megabytesPerSecond"] = Double(frame.count) * (result["operationsPerSecond"] as! Double) / 1_000_000
+                BenchmarkReport.shared.record("codec.protocolMessage.\(format.rawValue).encode.\(count)x\(payloadSize)", result)
+
+                var decoded: ARTProtocolMessage?
+                result = Benchmark.measure(operations: operations) {
+                    decoded = try! encoder.decodeProtocolMessage(frame)
+                }
+                expect(decoded?.messages?.count) == count
+                result.merge(values) { $1 }
+                result["megabytesPerSecond"] = Double(frame.count) * (result["operationsPerSecond"] as! Double) / 1_000_000
+                BenchmarkReport.shared.record("codec.protocolMessage.\(format.rawValue).decode.\(count)x\(payloadSize)", result)
+            }
+        }
+    }
+
+    func test__001__protocolMessage__json() {
+        measureProtocolMessages(format: .json)
+    }
+
+    func test__002__protocolMessage__msgpack() {
+        measureProtocolMessages(format: .msgpack)
+    }
+
+    // MARK: Data encodings
+
+    private func measureDataEncoding(_ name: String, data: Any, size: Int, cipherParams: ARTCipherParams? = nil, expectedEncoding: String) {
+        let dataEncoder = ARTDataEncoder(cipherParams: cipherParams, error: nil)
+        let operations = operationsPerRound(forBytes: size)
+
+        var output = dataEncoder.encode(data)
+        var result = Benchmark.measure(operations: operations) {
+            output = dataEncoder.encode(data)
+        }
+        expect(output.errorInfo).to(beNil())
+        expect(output.encoding ?? "") == expectedEncoding
+        result["size"] = size
+        result["encoding"] = expectedEncoding
+        BenchmarkReport.shared.record("codec.data.\(name).encode.\(size)", result)
+
+        let encoded = output.data
+        result = Benchmark.measure(operations: operations) {
+            output = dataEncoder.decode(encoded, encoding: expectedEncoding)
+        }
+        expect(output.errorInfo).to(beNil())
+        expect(output.encoding).to(beNil())
+        result["size"] = size
+        result["encoding"] = expectedEncoding
+        BenchmarkReport.shared.record("codec.data.\(name).decode.\(size)", result)
+    }
+
+    func test__003__dataEncoder__utf8() {
+        for string in corpus.strings {
+            measureDataEncoding("utf8", data: string, size: string.utf8.count, expectedEncoding: "")
+        }
+    }
+
+    func test__004__dataEncoder__json() {
+        let size = try! JSONSerialization.data(withJSONObject: corpus.json).count
+        measureDataEncoding("json", data: corpus.json, size: size, expectedEncoding: "json")
+    }
+
+    func test__005__dataEncoder__base64() {
+        for binary in corpus.binaries {
+            measureDataEncoding("base64", data: binary, size: binary.count, expectedEncoding: "base64")
+        }
+    }
+
+    func test__006__dataEncoder__cipher() {
+        for (fileName, keyLength) in [("crypto-data-128", 128), ("crypto-data-256", 256)] {
+            let (key, iv, _) = AblyTests.loadCryptoTestData(fileName)
+            let cipherParams = ARTCipherParams(algorithm: "aes", key: key as ARTCipherKeyCompatible, iv: iv)
+            for string in corpus.strings {
+                measureDataEncoding("aes\(keyLength).utf8", data: string, size: string.utf8.count, cipherParams: cipherParams, expectedEncoding: "utf-8/cipher+aes-\(keyLength)-cbc/base64")
+            }
+            for binary in corpus.binaries {
+                measureDataEncoding("aes\(keyLength).binary", data: binary, size: binary.count, cipherParams: cipherParams, expectedEncoding: "cipher+aes-\(keyLength)-cbc/base64")
+            }
+        }
+    }
+
+    func test__007__dataEncoder__decode_ably_common_crypto_vectors() {
+        for (fileName, keyLength) in [("crypto-data-128", 128), ("crypto-data-256", 256)] {
+            let (key, iv, items) = AblyTests.loadCryptoTestData(fileName)
+            let dataEncoder = ARTDataEncoder(cipherParams: ARTCipherParams(algorithm: "aes", key: key as ARTCipherKeyCompatible, iv: iv), error: nil)
+            let size = items.reduce(0) { $0 + $1.encrypted.data.utf8.count }
+
+            var errors = 0
+            var result = Benchmark.measure(operations: operationsPerRound(forBytes: size)) {
+                for item in items where dataEncoder.decode(item.encrypted.data, encoding: item.encrypted.encoding).errorInfo != nil {
+                    errors += 1
+                }
+            }
+            expect(errors) == 0
+            result["vectors"] = items.count
+            result["size"] = size
+            BenchmarkReport.shared.record("codec.data.aes\(keyLength).decode.ablyCommonVectors", result)
+        }
+    }
+
+    func test__008__dataEncoder__vcdiff() {
+        for deltaCase in corpus.deltas {
+            let dataEncoder = ARTDataEncoder(cipherParams: nil, error: nil)
+
+            // Each delta replaces the base, so every call restores it first. Setting the base doesn't decode anything.
+            var output: ARTDataEncoderOutput?
+            var result = Benchmark.measure(operations: operationsPerRound(forBytes: deltaCase.expected.utf8.count)) {
+                _ = dataEncoder.decode(deltaCase.base, identifier: "base", encoding: nil)
+                output = dataEncoder.decode(deltaCase.delta, identifier: "delta", encoding: "utf-8/vcdiff")
+            }
+            expect(output?.errorInfo).to(beNil())
+            expect(output?.data as? String) == deltaCase.expected
+            result["baseSize"] = deltaCase.base.utf8.count
+            result["deltaSize"] = deltaCase.delta.count
+            result["size"] = deltaCase.expected.utf8.count
+            BenchmarkReport.shared.record("codec.data.vcdiff.decode.\(deltaCase.name)", result)
+        }
+    }
+
+    // MARK: Cipher
+
+    func test__009__cipher__encrypt_and_decrypt() {
+        for (fileName, keyLength) in [("crypto-data-128", 128), ("crypto-data-256", 256)] {
+            let (key, iv, _) = AblyTests.loadCryptoTestData(fileName)
+            let cipher = ARTCrypto.cipher(with: ARTCipherParams(algorithm: "aes", key: key as ARTCipherKeyCompatible, iv: iv))
+            for plaintext in corpus.binaries {
+                let operations = operationsPerRound(forBytes: plaintext.count)
+
+                var ciphertext: NSData?
+                var result = Benchmark.measure(operations: operations) {
+                    cipher.encrypt(plaintext, output: &ciphertext)
+                }
+                result["size"] = plaintext.count
+                result["megabytesPerSecond"] = Double(plaintext.count) * (result["operationsPerSecond"] as! Double) / 1_000_000
+                BenchmarkReport.shared.record("codec.cipher.aes\(keyLength).encrypt.\(plaintext.count)", result)
+
+                let encrypted = ciphertext! as Data
+                var decrypted: NSData?
+                result = Benchmark.measure(operations: operations) {
+                    cipher.decrypt(encrypted, output: &decrypted)
+                }
+                expect(decrypted as Data?) == plaintext
+                result["size"] = plaintext.count
+                result["megabytesPerSecond"] = Double(plaintext.count) * (result["operationsPerSecond"] as! Double) / 1_000_000
+                BenchmarkReport.shared.record("codec.cipher.aes\(keyLength).decrypt.\(plaintext.count)", result)
+            }
+        }
+    }
+
+    // MARK: WebSocket masking
+
+    func test__010__websocket__mask_bytes() {
+        var maskKey: [UInt8] = [0x37, 0xfa, 0x21, 0x3d]
+        for size in corpus.maskSizes {
+            var bytes = [UInt8](repeating: 0x61, count: size)
+            var result = Benchmark.measure(operations: operationsPerRound(forBytes: size)) {
+                ARTSRMaskBytesSIMD(&bytes, size, &maskKey)
+            }
+            result["size"] = size
+            result["megabytesPerSecond"] = Double(size) * (result["operationsPerSecond"] as! Double) / 1_000_000
+            BenchmarkReport.shared.record("codec.websocket.mask.\(size)", result)
+        }
+    }
+
+}
@@ -187,4 +187,57 @@ class DeltaCodecTests: XCTestCase {
 
         expect(receivedMessages).toEventually(haveCount(testData.count))
     }
+
+    // RTL18
+    func test__004__DeltaCodec__decoding__should_recover_once_when_deltas_are_skipped_with_concurrent_channel_decoding() {
+        let options = AblyTests.commonAppSetup()
+        options.decodeChannelMessagesConcurrently = true
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channelOptions = ARTRealtimeChannelOptions()
+        channelOptions.params = ["delta": "vcdiff"]
+        let channel = client.channels.get(uniqueChannelName(), options: channelOptions)
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        guard let transport = client.internal.transport as? TestProxyTransport else {
+            fail("TestProxyTransport is not be assigned"); return
+        }
+
+        transport.setBeforeIncomingMessageModifier { protocolMessage in
+            if protocolMessage.action == .message,
+               let thirdMessage = protocolMessage.messages?.filter({ $0.name == "2" }).first
+            {
+                thirdMessage.data = Data() // invalid delta
+                transport.setBeforeIncomingMessageModifier(nil)
+            }
+            return protocolMessage
+        }
+
+        var receivedMessages: [ARTMessage] = []
+        channel.subscribe { message in
+            receivedMessages.append(message)
+        }
+
+        var attachingCount = 0
+        channel.on(.attaching) { _ in
+            attachingCount += 1
+        }
+
+        // The deltas after the invalid one arrive while recovery is in progress and are skipped, so they must not
+        // move the delta base that the replayed messages are decoded against.
+        for (i, data) in testData.enumerated() {
+            channel.publish(String(i), data: data)
+        }
+
+        expect(receivedMessages).toEventually(haveCount(testData.count), timeout: testTimeout)
+        expect(receivedMessages.map { $0.data as? String }).to(equal(testData))
+        expect(attachingCount).to(equal(1))
+        expect(channel.state).to(equal(.attached))
+    }
 }
@@ -0,0 +1,61 @@
+import Ably
+import Ably.Private
+import Foundation
+import Nimble
+import XCTest
+
+/// Time to construct a client and to first access its local device, which is loaded from storage and the keychain.
+///
+/// Skipped unless `ABLY_BENCHMARK_OUTPUT` is set, and on platforms without push; run them with `make benchmark_iOS`.
+class DeviceBenchmarks: XCTestCase {
+
+    override func setUpWithError() throws {
+        try Benchmark.skipUnlessEnabled()
+        #if !os(iOS)
+        throw XCTSkip("The local device is only available on iOS")
+        #endif
+    }
+
+    #if os(iOS)
+
+    private func options() -> ARTClientOptions {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.autoConnect = false
+        return options
+    }
+
+    /// Each round constructs a client with the device not loaded yet, as at app launch.
+    func test__001__client_construction() {
+        var rest: ARTRest?
+        let result = Benchmark.measure(operations: 1, rounds: 50, warmup: 5) {
+            rest?.internal.resetDeviceSingleton()
+            rest = ARTRest(options: options())
+        }
+        expect(rest).toNot(beNil())
+        BenchmarkReport.shared.record("device.clientConstruction", result)
+    }
+
+    func test__002__first_device_access() {
+        var device: ARTLocalDevice?
+        var rest = ARTRest(options: options())
+        // Right after the first access to push, so the access waits for the rest of the load started by it.
+        var result = Benchmark.measure(operations: 1, rounds: 50, warmup: 5) {
+            rest.internal.resetDeviceSingleton()
+            rest = ARTRest(options: options())
+            _ = rest.push
+            device = rest.device
+        }
+        expect(device).toNot(beNil())
+        BenchmarkReport.shared.record("device.firstAccess", result)
+
+        // Through another client once the device is loaded, as the realtime client of a REST client does.
+        result = Benchmark.measure(operations: 1, rounds: 50, warmup: 5) {
+            device = ARTRest(options: options()).device
+        }
+        expect(device).toNot(beNil())
+        BenchmarkReport.shared.record("device.firstAccess.loaded", result)
+    }
+
+    #endif
+
+}
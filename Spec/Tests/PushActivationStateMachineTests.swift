@@ -54,7 +54,9 @@ class PushActivationStateMachineTests: XCTestCase {
         rest.internal.storage = storage
         let stateMachine = ARTPushActivationStateMachine(rest: rest.internal, delegate: StateMachineDelegate())
         expect(stateMachine.current).to(beAKindOf(ARTPushActivationStateWaitingForDeviceRegistration.self))
-        expect(storage.keysRead).to(haveCount(2))
+        // Without a state record, the keyed archives of earlier versions are read.
+        expect(storage.keysRead).to(haveCount(3))
+        expect(storage.keysRead.first) == ARTPushActivationStateRecordKey
         expect(storage.keysRead.filter { $0.hasSuffix("CurrentState") }).to(haveCount(1))
         expect(storage.keysWritten).to(beEmpty())
     }
@@ -499,7 +501,7 @@ class PushActivationStateMachineTests: XCTestCase {
         expect(stateMachine.current).to(beAKindOf(ARTPushActivationStateWaitingForNewPushDeviceDetails.self))
         expect(activatedCallbackCalled).to(beTrue())
         expect(setAndPersistIdentityTokenDetailsCalled).to(beTrue())
-        expect(storage.keysWritten.keys).to(contain(["ARTDeviceId", "ARTDeviceSecret", "ARTDeviceIdentityToken"]))
+        expect(storage.keysWritten.keys).toEventually(contain(["ARTDeviceId", "ARTDeviceSecret", "ARTDeviceIdentityToken"]), timeout: testTimeout)
     }
 
     // RSH3c3
@@ -917,6 +919,83 @@ class PushActivationStateMachineTests: XCTestCase {
         expect(storage.object(forKey: ARTDeviceIdentityTokenKey)).to(beNil())
     }
 
+    func test__056__Activation_state_machine__should_persist_the_state_and_pending_events_as_one_record() throws {
+        let testIdentityTokenDetails = ARTDeviceIdentityTokenDetails(token: "123456", issued: Date(timeIntervalSince1970: 1_600_000_000), expires: Date.distantFuture, capability: "", clientId: "client")
+        let expectedError = ARTErrorInfo.create(withCode: 1234, status: 400, message: "failed")
+
+        // Pending events that NotActivated has no transition for stay pending after CalledDeactivate.
+        initialStateMachine.pendingEvents.add(ARTPushActivationEventGotDeviceRegistration(identityTokenDetails: testIdentityTokenDetails))
+        initialStateMachine.pendingEvents.add(ARTPushActivationEventSyncRegistrationFailed(error: expectedError))
+        initialStateMachine.send(ARTPushActivationEventCalledDeactivate())
+        expect(initialStateMachine.current).to(beAKindOf(ARTPushActivationStateNotActivated.self))
+        rest.internal.storageWriter.flush()
+
+        let record = try XCTUnwrap(storage.keysWritten[ARTPushActivationStateRecordKey] as? Data)
+        expect(record.prefix(4)) == Data("ARTP".utf8)
+
+        // The keyed archives of earlier versions are no longer written.
+        expect(storage.keysWritten.keys).toNot(contain(ARTPushActivationCurrentStateKey))
+        expect(storage.keysWritten.keys).toNot(contain(ARTPushActivationPendingEventsKey))
+
+        let restoredStorage = MockDeviceStorage()
+        restoredStorage.simulateOnNextRead(data: record, for: ARTPushActivationStateRecordKey)
+        rest.internal.storage = restoredStorage
+        let stateMachine = ARTPushActivationStateMachine(rest: rest.internal, delegate: StateMachineDelegate())
+
+        expect(stateMachine.current).to(beAKindOf(ARTPushActivationStateNotActivated.self))
+        expect(stateMachine.pendingEvents).to(haveCount(2))
+        let registration = try XCTUnwrap(stateMachine.pendingEvents.firstObject as? ARTPushActivationEventGotDeviceRegistration)
+        expect(registration.identityTokenDetails?.token) == "123456"
+        expect(registration.identityTokenDetails?.issued) == testIdentityTokenDetails.issued
+        expect(registration.identityTokenDetails?.clientId) == "client"
+        let failure = try XCTUnwrap(stateMachine.pendingEvents.lastObject as? ARTPushActivationEventSyncRegistrationFailed)
+        expect(failure.error.code) == 1234
+        expect(failure.error.statusCode) == 400
+        expect(failure.error.message) == "failed"
+    }
+
+    func test__057__Activation_state_machine__storage_writer_coalesces_writes_and_reads_unwritten_values() {
+        let storage = MockDeviceStorage()
+        let writer = ARTDeviceStorageWriter(storage: storage, delay: 0.1, logger: nil)
+
+        writer.setObject("first", forKey: "key")
+        writer.setObject("second", forKey: "key")
+        writer.setSecret("secret", forDevice: "device")
+        expect(writer.object(forKey: "key") as? String) == "second"
+        expect(writer.secret(forDevice: "device")) == "secret"
+        expect(storage.keysWritten).to(beEmpty())
+        expect(storage.keysRead).to(beEmpty())
+
+        expect(storage.keysWritten["key"] as? String).toEventually(equal("second"), timeout: testTimeout)
+        expect(storage.writeCount) == 2
+        expect(writer.isDirty).toEventually(beFalse(), timeout: testTimeout)
+
+        writer.setObject(nil, forKey: "key")
+        writer.flush()
+        expect(storage.keysWritten.keys).to(contain("key"))
+        expect(storage.keysWritten["key"] ?? nil).to(beNil())
+        expect(storage.writeCount) == 3
+    }
+
+    func test__058__Activation_state_machine__should_remove_the_keyed_archives_of_earlier_versions_when_the_first_record_is_written() throws {
+        let legacyStorage = MockDeviceStorage(startWith: ARTPushActivationStateNotActivated(machine: initialStateMachine))
+        rest.internal.storage = legacyStorage
+        let stateMachine = ARTPushActivationStateMachine(rest: rest.internal, delegate: StateMachineDelegate())
+        expect(stateMachine.current).to(beAKindOf(ARTPushActivationStateNotActivated.self))
+        expect(legacyStorage.keysWritten).to(beEmpty())
+
+        stateMachine.send(ARTPushActivationEventCalledDeactivate())
+        expect(stateMachine.current).to(beAKindOf(ARTPushActivationStateNotActivated.self))
+        rest.internal.storageWriter.flush()
+
+        let record = try XCTUnwrap(legacyStorage.keysWritten[ARTPushActivationStateRecordKey] as? Data)
+        expect(record.prefix(4)) == Data("ARTP".utf8)
+        expect(legacyStorage.keysWritten.keys).to(contain(ARTPushActivationCurrentStateKey))
+        expect(legacyStorage.keysWritten[ARTPushActivationCurrentStateKey] ?? nil).to(beNil())
+        expect(legacyStorage.keysWritten.keys).to(contain(ARTPushActivationPendingEventsKey))
+        expect(legacyStorage.keysWritten[ARTPushActivationPendingEventsKey] ?? nil).to(beNil())
+    }
+
     enum TestCase_ReusableTestsRsh3a2a {
         case the_local_device_has_id_and_deviceIdentityToken__emits_a_SyncRegistrationFailed_event_with_code_61002_if_client_IDs_don_t_match
         case the_local_device_has_id_and_deviceIdentityToken__the_local_DeviceDetails_matches_the_instance_s_client_ID__calls_registerCallback__transitions_to_WaitingForRegistrationSync
@@ -21,6 +21,44 @@ private let quxChannelName = "pushenabled:qux"
 
 private let subscription = ARTPushChannelSubscription(clientId: "newClient", channel: quxChannelName)
 
+/// Answers each request after `latency` with the status code and body `respond` returns, counting the requests in progress at the same time.
+private class PushAdminHTTPStub: NSObject, ARTHTTPExecutor {
+
+    private let queue: DispatchQueue
+    private let latency: TimeInterval
+    private let respond: (URLRequest) -> (Int, Data?)
+    private let _logger = ARTLog()
+    private var requestsInProgress = 0
+    private(set) var requests: [URLRequest] = []
+    private(set) var maxRequestsInProgress = 0
+    /// Headers added to each response, such as pagination links.
+    var headers: (URLRequest) -> [String: String] = { _ in [:] }
+
+    init(queue: DispatchQueue, latency: TimeInterval = 0.01, respond: @escaping (URLRequest) -> (Int, Data?)) {
+        self.queue = queue
+        self.latency = latency
+        self.respond = respond
+    }
+
+    func logger() -> ARTLog {
+        return _logger
+    }
+
+    func execute(_ request: URLRequest, completion callback: ((HTTPURLResponse?, Data?, Error?) -> Void)? = nil) -> (ARTCancellable & NSObjectProtocol)? {
+        requests.append(request)
+        requestsInProgress += 1
+        maxRequestsInProgress = max(maxRequestsInProgress, requestsInProgress)
+        let (statusCode, body) = respond(request)
+        let response = HTTPURLResponse(url: request.url!, statusCode: statusCode, httpVersion: "HTTP/1.1", headerFields: headers(request).merging(["Content-Type": "application/json"]) { $1 })
+        queue.asyncAfter(deadline: .now() + latency) {
+            self.requestsInProgress -= 1
+            callback?(response, body, nil)
+        }
+        return nil
+    }
+
+}
+
 class PushAdminTests: XCTestCase {
     private static let deviceDetails: ARTDeviceDetails = {
         let deviceDetails = ARTDeviceDetails(id: "testDeviceDetails")
@@ -1046,4 +1084,279 @@ class PushAdminTests: XCTestCase {
         expect(localDevice.secret).toNot(beNil())
         expect(localDevice.identityTokenDetails).to(beNil())
     }
+
+    // MARK: Batches
+
+    private func batchClient(respond: @escaping (URLRequest) -> (Int, Data?)) -> (ARTRest, PushAdminHTTPStub) {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.useBinaryProtocol = false
+        let rest = ARTRest(options: options)
+        let stub = PushAdminHTTPStub(queue: rest.internal.queue, respond: respond)
+        rest.internal.httpExecutor = stub
+        rest.internal.storage = MockDeviceStorage()
+        return (rest, stub)
+    }
+
+    private func errorBody(_ code: Int, statusCode: Int) -> Data {
+        return try! JSONSerialization.data(withJSONObject: ["error": ["code": code, "statusCode": statusCode, "message": "rejected"]])
+    }
+
+    func test__034__publishBatch__should_send_recipients_in_bounded_requests_and_report_each_one() throws {
+        let (rest, stub) = batchClient { request in
+            let items = try! JSONSerialization.jsonObject(with: request.httpBody!) as! [[String: Any]]
+            let results = items.map { item -> [String: Any] in
+                let recipient = item["recipient"] as! [String: String]
+                return recipient["clientId"] == "rejected" ? ["error": ["code": 40000, "statusCode": 400, "message": "rejected"]] : [:]
+            }
+            return (200, try! JSONSerialization.data(withJSONObject: results))
+        }
+        var recipients: [[String: String]] = (0..<250).map { ["clientId": "client\($0)"] }
+        recipients[10] = [:]
+        recipients[200] = ["clientId": "rejected"]
+
+        let options = ARTPushBatchOptions()
+        options.maxItemsPerRequest = 100
+        options.maxConcurrentRequests = 2
+        var result: ARTPushBatchResult?
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.publishBatch(recipients, data: payload, options: options) {
+                result = $0
+                done()
+            }
+        }
+
+        expect(result?.count) == 250
+        expect(result?.successCount) == 248
+        expect(result?.error(at: 10)?.message).to(contain("Recipient is missing"))
+        expect(result?.error(at: 200)?.code) == 40000
+        expect(result?.error(at: 0)).to(beNil())
+
+        expect(stub.requests).to(haveCount(3))
+        expect(stub.maxRequestsInProgress) == 2
+        var sentCounts: [Int] = []
+        for request in stub.requests {
+            expect(request.url?.path) == "/push/batch/publish"
+            expect(request.httpMethod) == "POST"
+            let items = try XCTUnwrap(JSONSerialization.jsonObject(with: XCTUnwrap(request.httpBody)) as? [[String: Any]])
+            expect(items.first?["payload"] as? NSDictionary) == payload as NSDictionary
+            sentCounts.append(items.count)
+        }
+        // The recipient without details isn't sent.
+        expect(sentCounts) == [99, 100, 50]
+    }
+
+    func test__035__publishBatch__should_fail_every_recipient_of_a_failed_request() {
+        let (rest, stub) = batchClient { [unowned self] request in
+            return (400, self.errorBody(40000, statusCode: 400))
+        }
+        let options = ARTPushBatchOptions()
+        options.maxItemsPerRequest = 2
+        var result: ARTPushBatchResult?
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.publishBatch([recipient, recipient, recipient], data: payload, options: options) {
+                result = $0
+                done()
+            }
+        }
+
+        expect(stub.requests).to(haveCount(2))
+        expect(result?.successCount) == 0
+        expect(result?.errors.keys.map { $0.intValue }.sorted()) == [0, 1, 2]
+    }
+
+    func test__036__deviceRegistrations__saveBatch_and_removeBatch__should_report_each_device() {
+        let (rest, stub) = batchClient { [unowned self] request in
+            if request.url!.lastPathComponent == "rejected" {
+                return (400, self.errorBody(40000, statusCode: 400))
+            }
+            return request.httpMethod == "PUT" ? (200, request.httpBody) : (204, nil)
+        }
+        let devices = (0..<10).map { i -> ARTDeviceDetails in
+            let device = ARTDeviceDetails(id: i == 4 ? "rejected" : "device\(i)")
+            device.platform = "ios"
+            device.formFactor = "phone"
+            device.push.recipient = ["transportType": "apns", "deviceToken": "foo"]
+            return device
+        }
+        let options = ARTPushBatchOptions()
+        options.maxConcurrentRequests = 3
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.deviceRegistrations.saveBatch(devices, options: options) { result in
+                expect(result.count) == 10
+                expect(result.errors.keys.map { $0.intValue }.sorted()) == [4]
+                done()
+            }
+        }
+        expect(stub.requests).to(haveCount(10))
+        expect(stub.requests.map { $0.httpMethod }) == Array(repeating: "PUT", count: 10)
+        expect(stub.maxRequestsInProgress) == 3
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.deviceRegistrations.removeBatch(devices.map { $0.id }, options: options) { result in
+                expect(result.count) == 10
+                expect(result.errors.keys.map { $0.intValue }.sorted()) == [4]
+                done()
+            }
+        }
+        expect(stub.requests.suffix(10).map { $0.httpMethod }) == Array(repeating: "DELETE", count: 10)
+    }
+
+    func test__037__channelSubscriptions__saveBatch_and_removeBatch__should_report_each_subscription() {
+        let (rest, stub) = batchClient { [unowned self] request in
+            let body = request.httpBody.flatMap { try? JSONSerialization.jsonObject(with: $0) as? [String: Any] }
+            if body?["clientId"] as? String == "rejected" || request.url?.query?.contains("clientId=rejected") == true {
+                return (400, self.errorBody(40000, statusCode: 400))
+            }
+            return request.httpMethod == "POST" ? (201, nil) : (204, nil)
+        }
+        let subscriptions = ["a", "rejected", "b"].map { ARTPushChannelSubscription(clientId: $0, channel: quxChannelName) }
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.channelSubscriptions.saveBatch(subscriptions, options: nil) { result in
+                expect(result.successCount) == 2
+                expect(result.error(at: 1)).toNot(beNil())
+                done()
+            }
+        }
+        expect(stub.requests.map { $0.httpMethod }) == ["POST", "POST", "POST"]
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.channelSubscriptions.removeBatch(subscriptions, options: nil) { result in
+                expect(result.successCount) == 2
+                expect(result.error(at: 1)).toNot(beNil())
+                done()
+            }
+        }
+        expect(stub.requests.suffix(3).map { $0.httpMethod }) == ["DELETE", "DELETE", "DELETE"]
+    }
+
+    // MARK: Iterators
+
+    /// Serves `pages` as consecutive pages linked by a `page` query parameter.
+    private func pagedClient(path: String, pages: [[Any]]) -> (ARTRest, PushAdminHTTPStub) {
+        func page(of request: URLRequest) -> Int {
+            return Int(extractURLQueryValue(request.url, key: "page") ?? "") ?? 1
+        }
+        let (rest, stub) = batchClient { request in
+            return (200, try! JSONSerialization.data(withJSONObject: pages[page(of: request) - 1]))
+        }
+        stub.headers = { request in
+            let next = page(of: request) + 1
+            return next <= pages.count ? ["Link": "<./\(path)?page=\(next)>; rel=\"next\""] : [:]
+        }
+        return (rest, stub)
+    }
+
+    private func consume<ItemType: AnyObject>(_ iterator: ARTPaginatedResultIterator<ItemType>) -> [[ItemType]] {
+        var pages: [[ItemType]] = []
+        func next(_ done: @escaping () -> Void) {
+            iterator.next { items, error in
+                expect(error).to(beNil())
+                guard let items = items else {
+                    done(); return
+                }
+                pages.append(items)
+                next(done)
+            }
+        }
+        waitUntil(timeout: testTimeout) { done in
+            next(done)
+        }
+        return pages
+    }
+
+    func test__038__Device_Registrations__iterate__should_skip_invalid_devices_and_decode_only_the_requested_fields() throws {
+        let device = { (id: String) -> [String: Any] in
+            ["id": id, "clientId": "client-\(id)", "platform": "ios", "formFactor": "phone", "push": ["recipient": ["transportType": "apns"]]]
+        }
+        let (rest, stub) = pagedClient(path: "deviceRegistrations", pages: [
+            [device("a"), device("b")],
+            [["clientId": "no-id"], "not a device", device("c")],
+            [device("d")],
+        ])
+
+        let options = ARTPushListOptions()
+        options.prefetchLimit = 1
+        options.fields = ["clientId"]
+        var iterator: ARTPaginatedResultIterator<ARTDeviceDetails>?
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.deviceRegistrations.iterate([:], options: options) { result, error in
+                expect(error).to(beNil())
+                iterator = result
+                done()
+            }
+        }
+
+        let pages = consume(try XCTUnwrap(iterator))
+        expect(pages.map { $0.map { $0.id } }) == [["a", "b"], ["c"], ["d"]]
+        expect(pages.flatMap { $0.map { $0.clientId } }) == ["client-a", "client-b", "client-c", "client-d"]
+        expect(pages[0][0].platform).to(beNil())
+        expect(pages[0][0].push.recipient).to(beEmpty())
+        expect(stub.requests).to(haveCount(3))
+    }
+
+    func test__039__Channel_Subscriptions__iterate__should_skip_invalid_subscriptions_and_channels() throws {
+        let (rest, _) = pagedClient(path: "channelSubscriptions", pages: [
+            [["channel": "a", "clientId": "client"], ["channel": "b", "clientId": "client", "deviceId": "device"]],
+            [["channel": "c", "deviceId": "device"]],
+        ])
+        var subscriptions: ARTPaginatedResultIterator<ARTPushChannelSubscription>?
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.channelSubscriptions.iterate([:], options: nil) { result, error in
+                expect(error).to(beNil())
+                subscriptions = result
+                done()
+            }
+        }
+        expect(self.consume(try XCTUnwrap(subscriptions)).map { $0.map { $0.channel } }) == [["a"], ["c"]]
+
+        let (channelsRest, _) = pagedClient(path: "channels", pages: [["a", 1, "b"], ["c"]])
+        var channels: ARTPaginatedResultIterator<NSString>?
+        waitUntil(timeout: testTimeout) { done in
+            channelsRest.push.admin.channelSubscriptions.iterateChannels(nil) { result, error in
+                expect(error).to(beNil())
+                channels = result
+                done()
+            }
+        }
+        expect(self.consume(try XCTUnwrap(channels)).map { $0.map { $0 as String } }) == [["a", "b"], ["c"]]
+    }
+
+    func test__040__Channel_Subscriptions__iterateChannels__should_fail_when_a_page_is_not_an_array() {
+        let (rest, _) = batchClient { _ in
+            return (200, try! JSONSerialization.data(withJSONObject: ["channels": ["a"]]))
+        }
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.channelSubscriptions.iterateChannels(nil) { result, error in
+                expect(result).to(beNil())
+                expect(error?.code) == ARTErrorCode.unableToDecodeMessage.intValue
+                done()
+            }
+        }
+    }
+
+    func test__041__publishBatch__should_not_throw_on_malformed_item_errors() {
+        let (rest, _) = batchClient { request in
+            let results: [Any] = [
+                ["error": ["code": "40000", "statusCode": NSNull(), "message": 5]],
+                ["error": "rejected"],
+                "not a result",
+            ]
+            return (400, try! JSONSerialization.data(withJSONObject: ["error": ["code": 40020, "statusCode": 400, "message": "partial failure"], "batchResponse": results]))
+        }
+        var result: ARTPushBatchResult?
+        waitUntil(timeout: testTimeout) { done in
+            rest.push.admin.publishBatch([recipient, recipient, recipient], data: payload, options: ARTPushBatchOptions()) {
+                result = $0
+                done()
+            }
+        }
+
+        expect(result?.successCount) == 2
+        expect(result?.error(at: 0)?.code) == 40000
+        expect(result?.error(at: 0)?.message) == ""
+        expect(result?.error(at: 1)).to(beNil())
+        expect(result?.error(at: 2)).to(beNil())
+    }
 }
@@ -7,6 +7,19 @@ private var mockHttpExecutor: MockHTTPExecutor!
 private var storage: MockDeviceStorage!
 private var stateMachineDelegate: StateMachineDelegate!
 
+/// Holds back the read of the device id, so that loading the local device doesn't finish until `released` is signalled.
+private class DeviceLoadHoldingStorage: MockDeviceStorage {
+    let released = DispatchSemaphore(value: 0)
+
+    override func object(forKey key: String) -> Any? {
+        if key == ARTDeviceIdKey {
+            released.wait()
+            released.signal()
+        }
+        return super.object(forKey: key)
+    }
+}
+
 class PushTests: XCTestCase {
     enum TestDeviceToken {
         static let tokenBase64 = "HYRXxPSQdt1pnxqtDAvc6PTTLH7N6okiBhYyLClJdmQ="
@@ -192,7 +205,7 @@ class PushTests: XCTestCase {
             }
             ARTPush.didRegisterForRemoteNotifications(withDeviceToken: TestDeviceToken.tokenData, rest: rest)
         }
-        expect(storage.keysWritten.keys).to(contain(["ARTAPNSDeviceToken"]))
+        expect(storage.keysWritten.keys).toEventually(contain(["ARTAPNSDeviceToken"]), timeout: testTimeout)
         expect(storage.keysWritten.at("ARTAPNSDeviceToken")?.value as? String).to(equal(expectedDeviceToken))
     }
 
@@ -429,4 +442,51 @@ class PushTests: XCTestCase {
         }
         expect(registerForAPNSMethodWasCalled).to(beTrue())
     }
+
+    func test__017__LocalDevice__is_loaded_once_and_shared_by_clients_until_their_storage_changes() {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.autoConnect = false
+        let realtime = ARTRealtime(options: options)
+        let device = rest.device
+        expect(realtime.device).to(beIdenticalTo(device))
+        expect(storage.keysRead).to(contain(ARTDeviceIdKey))
+
+        let newStorage = MockDeviceStorage()
+        rest.internal.storage = newStorage
+        let reloadedDevice = rest.device
+        expect(reloadedDevice).toNot(beIdenticalTo(device))
+        expect(newStorage.keysRead).to(contain(ARTDeviceIdKey))
+        expect(realtime.device).to(beIdenticalTo(reloadedDevice))
+    }
+
+    func test__018__LocalDevice__is_not_loaded_until_push_is_used() {
+        let client = ARTRest(key: "xxxx:xxxx")
+        client.internal.resetDeviceSingleton()
+        let newStorage = MockDeviceStorage()
+        client.internal.storage = newStorage
+        client.internal.queue.sync {}
+        expect(newStorage.keysRead).toNot(contain(ARTDeviceIdKey))
+
+        _ = client.push
+        expect(newStorage.keysRead).toEventually(contain(ARTDeviceIdKey), timeout: testTimeout)
+    }
+
+    func test__019__LocalDevice__activation_state_machine_doesn_t_block_the_queue_while_the_device_loads() {
+        let client = ARTRest(key: "xxxx:xxxx")
+        client.internal.resetDeviceSingleton()
+        let newStorage = DeviceLoadHoldingStorage()
+        client.internal.storage = newStorage
+        DispatchQueue.global().asyncAfter(deadline: .now() + 2.0) {
+            newStorage.released.signal()
+        }
+
+        let stateMachine = ARTPushActivationStateMachine(rest: client.internal, delegate: StateMachineDelegate())
+        stateMachine.send(ARTPushActivationEventCalledActivate())
+        let start = Date()
+        client.internal.queue.sync {}
+        expect(Date().timeIntervalSince(start)) < 1.0
+
+        // The event is handled once the device is loaded.
+        expect(stateMachine.current).to(beAKindOf(ARTPushActivationStateWaitingForPushDeviceDetails.self))
+    }
 }
@@ -0,0 +1,540 @@
+import Ably
+import Ably.Private
+import Nimble
+import XCTest
+
+private let benchmarkTimeout = DispatchTimeInterval.seconds(600)
+private let benchmarkChannelName = "benchmark"
+
+/// Serves `pages` pages of channel history after `latency`, each linking to the next, on the client's internal queue.
+private class PagedHistoryHTTPExecutor: NSObject, ARTHTTPExecutor {
+
+    let pages: Int
+    let latency: TimeInterval
+    private let queue: DispatchQueue
+    private let body: Data
+    private let _logger = ARTLog()
+
+    init(pages: Int, itemsPerPage: Int, latency: TimeInterval, queue: DispatchQueue) {
+        self.pages = pages
+        self.latency = latency
+        self.queue = queue
+        let items = (0..<itemsPerPage).map { i in
+            ["id": "history:\(i)", "name": "event", "data": String(repeating: "x", count: 256), "timestamp": 1_600_000_000_000 + i]
+        }
+        self.body = try! JSONSerialization.data(withJSONObject: items)
+    }
+
+    func logger() -> ARTLog {
+        return _logger
+    }
+
+    func execute(_ request: URLRequest, completion callback: ((HTTPURLResponse?, Data?, Error?) -> Void)? = nil) -> (ARTCancellable & NSObjectProtocol)? {
+        let url = request.url!
+        let page = Int(extractURLQueryValue(url, key: "page") ?? "") ?? 1
+        var headers = ["Content-Type": "application/json"]
+        if page < pages {
+            headers["Link"] = "<./messages?page=\(page + 1)>; rel=\"next\""
+        }
+        let response = HTTPURLResponse(url: url, statusCode: 200, httpVersion: "HTTP/1.1", headerFields: headers)
+        let body = self.body
+        queue.asyncAfter(deadline: .now() + latency) {
+            callback?(response, body, nil)
+        }
+        return nil
+    }
+
+}
+
+/// Stands in for an `authUrl` server: answers each request with a new token after `latency`, on the client's internal queue.
+private class TokenHTTPExecutor: NSObject, ARTHTTPExecutor {
+
+    let latency: TimeInterval
+    private let queue: DispatchQueue
+    private let _logger = ARTLog()
+    private(set) var requests = 0 // Only touched on `queue`.
+
+    init(latency: TimeInterval, queue: DispatchQueue) {
+        self.latency = latency
+        self.queue = queue
+    }
+
+    func logger() -> ARTLog {
+        return _logger
+    }
+
+    func execute(_ request: URLRequest, completion callback: ((HTTPURLResponse?, Data?, Error?) -> Void)? = nil) -> (ARTCancellable & NSObjectProtocol)? {
+        requests += 1
+        let now = dateToMilliseconds(Date())
+        let token: [String: Any] = ["token": "loopback.token:\(requests)", "issued": now, "expires": now + 3_600_000]
+        let body = try! JSONSerialization.data(withJSONObject: token)
+        let response = HTTPURLResponse(url: request.url!, statusCode: 200, httpVersion: "HTTP/1.1", headerFields: ["Content-Type": "application/json"])
+        queue.asyncAfter(deadline: .now() + latency) {
+            callback?(response, body, nil)
+        }
+        return nil
+    }
+
+}
+
+/// Throughput, latency and allocation benchmarks of the realtime pipeline, run without any network through `LoopbackTransport`.
+///
+/// Skipped unless `ABLY_BENCHMARK_OUTPUT` is set; run them with `make benchmark_macOS`.
+class RealtimeBenchmarks: XCTestCase {
+
+    override func setUpWithError() throws {
+        try Benchmark.skipUnlessEnabled()
+    }
+
+    // MARK: Receive
+
+    private func measureReceive(_ name: String, stream: ProtocolMessageStream, framesPerSecond: Double = 0, configure: (ARTClientOptions) -> Void = { _ in }) {
+        let client = AblyTests.newLoopbackRealtime(format: stream.format, configure: configure)
+        defer { client.dispose(); client.close() }
+
+        let framesByChannel = stream.messageFramesByChannel()
+        let total = framesByChannel.values.reduce(0) { $0 + $1.count }
+        let receiveTimes = TimestampBuffer(count: total)
+        let group = DispatchGroup()
+        group.enter() // all messages received
+        group.enter() // all frames delivered
+
+        var remaining = total // Only touched on the callback queue.
+        var offsets: [String: Int] = [:]
+        var offset = 0
+        for (name, frames) in framesByChannel {
+            let channel = client.channels.get(name)
+            let base = offset
+            offsets[name] = base
+            offset += frames.count
+            var index = 0
+            waitUntil(timeout: testTimeout) { done in
+                channel.subscribe(attachCallback: { error in
+                    expect(error).to(beNil())
+                    done()
+                }) { _ in
+                    receiveTimes[base + index] = Benchmark.now()
+                    index += 1
+                    remaining -= 1
+                    if remaining == 0 {
+                        group.leave()
+                    }
+                }
+            }
+        }
+
+        var deliveryTimes: [UInt64] = []
+        AllocationCounter.start()
+        let start = Benchmark.now()
+        client.loopbackTransport.replayFrames(stream.frames, framesPerSecond: framesPerSecond) { times in
+            deliveryTimes = times.withUnsafeBytes { Array($0.bindMemory(to: UInt64.self)) }
+            group.leave()
+        }
+        waitUntil(timeout: benchmarkTimeout) { done in
+            group.notify(queue: .main, execute: done)
+        }
+        let allocations = AllocationCounter.stop()
+
+        var latency = LatencySamples(capacity: total)
+        var end = start
+        for (name, frames) in framesByChannel {
+            let base = offsets[name]!
+            for (index, frame) in frames.enumerated() {
+                latency.append(receiveTimes[base + index] - deliveryTimes[frame])
+                end = max(end, receiveTimes[base + index])
+            }
+        }
+        let seconds = Benchmark.seconds(since: start, until: end)
+        let metrics = client.metrics()
+
+        BenchmarkReport.shared.record(name, [
+            "format": stream.format.rawValue,
+            "channels": framesByChannel.count,
+            "frames": stream.frames.count,
+            "messages": total,
+            "targetFramesPerSecond": framesPerSecond,
+            "framesPerSecond": Double(stream.frames.count) / seconds,
+            "messagesPerSecond": Double(total) / seconds,
+            "allocationsPerMessage": Double(allocations) / Double(max(total, 1)),
+            "latency": latency.summary,
+            "decodeTimeP50Us": metrics.decodeTime.value(atPercentile: 50) * 1_000_000,
+        ])
+    }
+
+    func test__001__receive__json_as_fast_as_possible() {
+        measureReceive("receive.json.unthrottled", stream: .messages(channel: benchmarkChannelName, format: .json, frames: 20_000))
+    }
+
+    func test__002__receive__msgpack_as_fast_as_possible() {
+        measureReceive("receive.msgpack.unthrottled", stream: .messages(channel: benchmarkChannelName, format: .msgpack, frames: 20_000))
+    }
+
+    func test__003__receive__json_at_2000_frames_per_second() {
+        measureReceive("receive.json.2000fps", stream: .messages(channel: benchmarkChannelName, format: .json, frames: 10_000), framesPerSecond: 2000)
+    }
+
+    func test__004__receive__msgpack_at_2000_frames_per_second() {
+        measureReceive("receive.msgpack.2000fps", stream: .messages(channel: benchmarkChannelName, format: .msgpack, frames: 10_000), framesPerSecond: 2000)
+    }
+
+    func test__005__receive__msgpack_bundles_of_20_messages() {
+        measureReceive("receive.msgpack.bundled", stream: .messages(channel: benchmarkChannelName, format: .msgpack, frames: 2_000, messagesPerFrame: 20))
+    }
+
+    func test__006__receive__recorded_stream() throws {
+        // A stream saved with `ProtocolMessageStream.write(to:)`, e.g. from a `TestProxyTransport` connected to a real app.
+        guard let path = ProcessInfo.processInfo.environment["ABLY_BENCHMARK_STREAM"] else {
+            throw XCTSkip("Set ABLY_BENCHMARK_STREAM to replay a recorded stream")
+        }
+        measureReceive("receive.recorded", stream: try ProtocolMessageStream(contentsOf: URL(fileURLWithPath: path)))
+    }
+
+    func test__007__receive__msgpack_over_8_channels_decoded_concurrently() {
+        let streams = (0..<8).map { ProtocolMessageStream.messages(channel: "\(benchmarkChannelName)-\($0)", format: .msgpack, frames: 2_500) }
+        // Interleave the channels frame by frame.
+        let frames = (0..<2_500).flatMap { i in streams.map { $0.frames[i] } }
+        let stream = ProtocolMessageStream(format: .msgpack, frames: frames)
+        measureReceive("receive.msgpack.8channels.serial", stream: stream)
+        measureReceive("receive.msgpack.8channels.concurrent", stream: stream) { options in
+            options.decodeChannelMessagesConcurrently = true
+        }
+    }
+
+    // MARK: Publish
+
+    private func measurePublish(_ name: String, format: ProtocolMessageStream.Format, messages count: Int, payloadSize: Int = 256, configure: (ARTClientOptions) -> Void = { _ in }) {
+        let client = AblyTests.newLoopbackRealtime(format: format, configure: configure)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(benchmarkChannelName)
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let payload = String(repeating: "x", count: payloadSize)
+        let publishTimes = TimestampBuffer(count: count)
+        let callDurations = TimestampBuffer(count: count)
+        let ackTimes = TimestampBuffer(count: count)
+        let framesBefore = client.internal.queue.sync { client.loopbackTransport.loopback!.framesSent }
+        var errors = 0
+
+        AllocationCounter.start()
+        let start = Benchmark.now()
+        waitUntil(timeout: benchmarkTimeout) { done in
+            var remaining = count // Only touched on the callback queue.
+            for i in 0..<count {
+                let publishTime = Benchmark.now()
+                publishTimes[i] = publishTime
+                channel.publish(nil, data: payload) { error in
+                    ackTimes[i] = Benchmark.now()
+                    if error != nil {
+                        errors += 1
+                    }
+                    remaining -= 1
+                    if remaining == 0 {
+                        done()
+                    }
+                }
+                callDurations[i] = Benchmark.now() - publishTime
+            }
+        }
+        let allocations = AllocationCounter.stop()
+        expect(errors) == 0
+
+        var calls = LatencySamples(capacity: count)
+        var acks = LatencySamples(capacity: count)
+        var end = start
+        for i in 0..<count {
+            calls.append(callDurations[i])
+            acks.append(ackTimes[i] - publishTimes[i])
+            end = max(end, ackTimes[i])
+        }
+        let seconds = Benchmark.seconds(since: start, until: end)
+        let frames = client.internal.queue.sync { client.loopbackTransport.loopback!.framesSent } - framesBefore
+
+        BenchmarkReport.shared.record(name, [
+            "format": format.rawValue,
+            "messages": count,
+            "messagesPerSecond": Double(count) / seconds,
+            "frames": frames,
+            "framesPerSecond": Double(frames) / seconds,
+            "allocationsPerMessage": Double(allocations) / Double(count),
+            "publishCall": calls.summary,
+            "ackLatency": acks.summary,
+        ])
+    }
+
+    func test__008__publish__json() {
+        measurePublish("publish.json", format: .json, messages: 10_000)
+    }
+
+    func test__009__publish__msgpack() {
+        measurePublish("publish.msgpack", format: .msgpack, messages: 10_000)
+    }
+
+    func test__010__publish__msgpack_through_the_submission_queue() {
+        measurePublish("publish.msgpack.submissionQueue", format: .msgpack, messages: 10_000) { options in
+            options.realtimePublishHighWaterMark = 20_000
+        }
+    }
+
+    func test__011__publish__msgpack_with_coalescing() {
+        for delay in [0.001, 0.005] {
+            measurePublish("publish.msgpack.coalescing.\(Int(delay * 1000))ms", format: .msgpack, messages: 10_000) { options in
+                options.realtimePublishCoalescingDelay = delay
+            }
+        }
+    }
+
+    func test__012__publish__call_duration_while_the_internal_queue_is_busy() {
+        // With the internal queue kept busy in 2ms slices, a publish that waits for the queue takes up to 2ms,
+        // while one handed to the submission queue returns at once.
+        for highWaterMark in [0, 10_000] {
+            let client = AblyTests.newLoopbackRealtime(format: .msgpack) { options in
+                options.realtimePublishHighWaterMark = UInt(highWaterMark)
+            }
+            defer { client.dispose(); client.close() }
+            let channel = client.channels.get(benchmarkChannelName)
+            waitUntil(timeout: testTimeout) { done in
+                channel.attach { _ in
+                    done()
+                }
+            }
+
+            let queue = client.internal.queue
+            var busy = true
+            func occupy() {
+                queue.async {
+                    usleep(2000)
+                    if busy {
+                        occupy()
+                    }
+                }
+            }
+            occupy()
+
+            let count = 2_000
+            var calls = LatencySamples(capacity: count)
+            for _ in 0..<count {
+                let start = Benchmark.now()
+                channel.publish(nil, data: "x")
+                calls.append(Benchmark.now() - start)
+                usleep(200)
+            }
+            queue.sync {
+                busy = false
+            }
+
+            BenchmarkReport.shared.record("publish.busyQueue.highWaterMark\(highWaterMark)", [
+                "messages": count,
+                "publishCall": calls.summary,
+            ])
+        }
+    }
+
+    // MARK: Getters
+
+    func test__013__getters__8_readers_while_the_internal_queue_processes_inbound_traffic() {
+        let client = AblyTests.newLoopbackRealtime(format: .msgpack)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(benchmarkChannelName)
+        waitUntil(timeout: testTimeout) { done in
+            channel.subscribe(attachCallback: { _ in
+                done()
+            }) { _ in }
+        }
+
+        let readers = 8
+        let lock = NSLock()
+        func locked<T>(_ body: () -> T) -> T {
+            lock.lock()
+            defer { lock.unlock() }
+            return body()
+        }
+        var running = true
+        var reads = LatencySamples()
+        let finished = DispatchGroup()
+        for _ in 0..<readers {
+            finished.enter()
+            Thread.detachNewThread {
+                var samples = LatencySamples(capacity: 100_000)
+                while locked({ running }) {
+                    let start = Benchmark.now()
+                    _ = channel.state
+                    _ = channel.errorReason
+                    _ = client.connection.id
+                    _ = client.connection.state
+                    _ = client.connection.serial
+                    _ = client.channels.exists(benchmarkChannelName)
+                    _ = client.auth.clientId
+                    samples.append(Benchmark.now() - start)
+                }
+                locked {
+                    reads.append(contentsOf: samples)
+                }
+                finished.leave()
+            }
+        }
+
+        let stream = ProtocolMessageStream.messages(channel: benchmarkChannelName, format: .msgpack, frames: 20_000)
+        let start = Benchmark.now()
+        waitUntil(timeout: benchmarkTimeout) { done in
+            client.loopbackTransport.replayFrames(stream.frames, framesPerSecond: 0) { _ in
+                done()
+            }
+        }
+        let seconds = Benchmark.seconds(since: start)
+        locked {
+            running = false
+        }
+        finished.wait()
+
+        BenchmarkReport.shared.record("getters.8readers", [
+            "readers": readers,
+            "readsPerSecond": Double(reads.nanoseconds.count) / seconds,
+            "read": reads.summary,
+        ])
+    }
+
+    // MARK: History
+
+    func test__014__history__100_page_backfill_with_and_without_prefetching() {
+        for prefetchLimit: UInt in [0, 4] {
+            let options = ARTClientOptions(key: "loopback.key:secret")
+            options.logExceptionReportingUrl = nil
+            options.internalDispatchQueue = DispatchQueue(label: "io.ably.benchmarks", qos: .userInitiated)
+            options.dispatchQueue = DispatchQueue(label: "io.ably.benchmarks.callbacks", qos: .userInitiated)
+            let client = ARTRest(options: options)
+            client.internal.httpExecutor = PagedHistoryHTTPExecutor(pages: 100, itemsPerPage: 100, latency: 0.01, queue: options.internalDispatchQueue)
+            let channel = client.channels.get(benchmarkChannelName)
+
+            let start = Benchmark.now()
+            var pages = 0
+            var items = 0
+            waitUntil(timeout: benchmarkTimeout) { done in
+                try! channel.history(ARTDataQuery()) { result, error in
+                    expect(error).to(beNil())
+                    guard let iterator = result?.iterator(withPrefetchLimit: prefetchLimit) else {
+                        done(); return
+                    }
+                    func consume() {
+                        iterator.next { page, error in
+                            expect(error).to(beNil())
+                            guard let page = page else {
+                                done(); return
+                            }
+                            pages += 1
+                            items += page.count
+                            // Stands in for the caller processing the page.
+                            usleep(10_000)
+                            consume()
+                        }
+                    }
+                    consume()
+                }
+            }
+            expect(pages) == 100
+
+            BenchmarkReport.shared.record("history.backfill.prefetch\(prefetchLimit)", [
+                "pages": pages,
+                "items": items,
+                "seconds": Benchmark.seconds(since: start),
+            ])
+        }
+    }
+
+    // MARK: Presence
+
+    /// Bytes in use in the default malloc zone, which the library's objects are allocated from.
+    private func heapBytesInUse() -> Int {
+        var stats = malloc_statistics_t()
+        malloc_zone_statistics(nil, &stats)
+        return Int(stats.size_in_use)
+    }
+
+    func test__015__presence__heap_bytes_per_member_of_50k_members() {
+        let count = 50_000
+        for compact in [false, true] {
+            let before = heapBytesInUse()
+            let map = ARTPresenceMap(queue: AblyTests.queue, logger: ARTLog(), stringInterner: compact ? ARTStringInterner() : nil)
+            autoreleasepool {
+                for i in 0..<count {
+                    // Four members per connection, as when a connection enters several clients.
+                    let connectionId = "connection-\(i / 4)"
+                    let message = ARTPresenceMessage(clientId: "client-\(i)", action: .enter, connectionId: connectionId, id: "\(connectionId):\(i):0", timestamp: Date(timeIntervalSince1970: 1_600_000_000 + Double(i) / 1000))
+                    message.data = "online"
+                    _ = map.add(message)
+                }
+            }
+            let bytes = heapBytesInUse() - before
+            expect(map.memberCount) == UInt(count)
+
+            BenchmarkReport.shared.record(compact ? "presence.memberBytes.compact" : "presence.memberBytes", [
+                "members": count,
+                "bytesPerMember": Double(bytes) / Double(count),
+            ])
+        }
+    }
+
+    func test__016__receive__msgpack_decoded_in_place() {
+        measureReceive("receive.msgpack.inPlace", stream: .messages(channel: benchmarkChannelName, format: .msgpack, frames: 20_000)) { options in
+            options.decodeFramesInPlace = true
+        }
+        measureReceive("receive.msgpack.bundled.inPlace", stream: .messages(channel: benchmarkChannelName, format: .msgpack, frames: 2_000, messagesPerFrame: 20)) { options in
+            options.decodeFramesInPlace = true
+        }
+    }
+
+    // MARK: Auth
+
+    func test__017__auth__time_to_first_publish_with_and_without_a_cached_token() {
+        let rounds = 20
+        let storage = MockDeviceStorage()
+
+        for cached in [false, true] {
+            var samples = LatencySamples(capacity: rounds)
+            var authRequests = 0
+            for _ in 0..<rounds {
+                let options = ARTClientOptions()
+                options.authUrl = URL(string: "http://auth.loopback")
+                options.persistTokenDetails = true
+                options.autoConnect = false
+                options.logExceptionReportingUrl = nil
+                options.internalDispatchQueue = DispatchQueue(label: "io.ably.benchmarks", qos: .userInitiated)
+                options.dispatchQueue = DispatchQueue(label: "io.ably.benchmarks.callbacks", qos: .userInitiated)
+
+                let client = ARTRealtime(options: options)
+                defer { client.dispose(); client.close() }
+                client.internal.setTransport(LoopbackTransport.self)
+                client.internal.setReachabilityClass(TestReachability.self)
+                // 50ms stands in for the round trip to the application's auth server.
+                let executor = TokenHTTPExecutor(latency: 0.05, queue: options.internalDispatchQueue)
+                client.internal.rest.httpExecutor = executor
+                let cache = ARTTokenDetailsCache(storage: storage, options: options, logger: nil)
+                client.internal.auth.tokenDetailsCache = cache
+                if cached, let entry = storage.keysWritten[cache.cacheKey] as? String {
+                    storage.simulateOnNextRead(string: entry, for: cache.cacheKey)
+                }
+
+                let start = Benchmark.now()
+                waitUntil(timeout: testTimeout) { done in
+                    client.channels.get(benchmarkChannelName).publish(nil, data: "first") { error in
+                        expect(error).to(beNil())
+                        done()
+                    }
+                    client.connect()
+                }
+                samples.append(Benchmark.now() - start)
+                authRequests += options.internalDispatchQueue.sync { executor.requests }
+            }
+            expect(authRequests) == (cached ? 0 : rounds)
+
+            BenchmarkReport.shared.record(cached ? "auth.timeToFirstPublish.cachedToken" : "auth.timeToFirstPublish", [
+                "authRequests": authRequests,
+                "timeToFirstPublish": samples.summary,
+            ])
+        }
+    }
+}
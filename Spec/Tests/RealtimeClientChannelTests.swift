@@ -4491,4 +4491,314 @@ class RealtimeClientChannelTests: XCTestCase {
             }
         }
     }
+
+    func test__140__publish__with_a_high_water_mark__should_return_without_waiting_for_a_busy_internal_queue() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        options.realtimePublishHighWaterMark = 2
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        let internalQueueReleased = DispatchSemaphore(value: 0)
+        AblyTests.queue.async {
+            internalQueueReleased.wait()
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            let start = Date()
+            channel.publish(nil, data: "first")
+            channel.publish(nil, data: "second")
+            channel.publish(nil, data: "third") { error in
+                expect(error?.code) == Int(ARTState.publishQueueFull.rawValue)
+                done()
+            }
+            expect(Date().timeIntervalSince(start)) < 0.5
+            internalQueueReleased.signal()
+        }
+
+        AblyTests.queue.sync {
+            // Both accepted submissions reached the connection and were merged (RTL6d)
+            let queuedData = client.internal.queuedMessages.flatMap { $0.msg.messages ?? [] }.compactMap { $0.data as? String }
+            expect(queuedData) == ["first", "second"]
+        }
+    }
+
+    func test__141__publish__with_a_coalescing_delay__should_bundle_publishes_made_while_connected() {
+        let options = AblyTests.commonAppSetup()
+        options.realtimePublishCoalescingDelay = 0.5
+        options.realtimePublishCoalescingMaxMessages = 3
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(4, done: done)
+            for i in 0..<4 {
+                channel.publish(nil, data: "message\(i)") { error in
+                    expect(error).to(beNil())
+                    partialDone()
+                }
+            }
+        }
+
+        let transport = client.internal.transport as! TestProxyTransport
+        let protocolMessages = transport.protocolMessagesSent.filter { $0.action == .message }
+        // The first bundle is sent when full, the second when the delay expires
+        expect(protocolMessages.map { $0.messages?.count ?? 0 }) == [3, 1]
+    }
+
+    func test__142__state_getters__should_not_wait_for_the_internal_queue() {
+        let options = AblyTests.commonAppSetup()
+        options.clientId = "tester"
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let internalQueueReleased = DispatchSemaphore(value: 0)
+        AblyTests.queue.async {
+            _ = internalQueueReleased.wait(timeout: .now() + 2.0)
+        }
+
+        let start = Date()
+        expect(channel.state) == .attached
+        expect(channel.errorReason).to(beNil())
+        expect(client.connection.state) == .connected
+        expect(client.connection.id).toNot(beNil())
+        expect(client.connection.serial) >= -1
+        expect(client.channels.exists(channel.name)).to(beTrue())
+        expect(client.channels.exists("not-" + channel.name)).to(beFalse())
+        expect(client.auth.clientId) == "tester"
+        expect(Date().timeIntervalSince(start)) < 1.0
+        internalQueueReleased.signal()
+    }
+
+    func test__143__subscribe__with_concurrent_channel_decoding__should_deliver_each_channel_s_messages_in_order() {
+        let options = AblyTests.commonAppSetup()
+        options.decodeChannelMessagesConcurrently = true
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channels = [client.channels.get(uniqueChannelName(prefix: "a")), client.channels.get(uniqueChannelName(prefix: "b"))]
+        let messageCount = 20
+
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(channels.count, done: done)
+            for channel in channels {
+                var received: [String] = []
+                channel.subscribe { message in
+                    received.append(message.data as! String)
+                    if received.count == messageCount {
+                        expect(received) == (0..<messageCount).map { "\(channel.name)-\($0)" }
+                        partialDone()
+                    }
+                }
+                channel.attach { error in
+                    expect(error).to(beNil())
+                    channel.publish((0..<messageCount).map { ARTMessage(name: nil, data: "\(channel.name)-\($0)") })
+                }
+            }
+        }
+    }
+
+    // RTL6c
+    func test__144__publish__with_a_high_water_mark__should_send_earlier_publishes_before_a_presence_operation() {
+        let options = AblyTests.commonAppSetup()
+        options.clientId = "tester"
+        options.realtimePublishHighWaterMark = 200
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+        let transport = client.internal.transport as! TestProxyTransport
+
+        // More submissions than one drain handles, so that some are still waiting when the presence operation runs.
+        let internalQueueReleased = DispatchSemaphore(value: 0)
+        AblyTests.queue.async {
+            internalQueueReleased.wait()
+        }
+        for i in 0..<100 {
+            channel.publish(nil, data: "\(i)")
+        }
+        internalQueueReleased.signal()
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.presence.enter(nil) { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let sent = transport.protocolMessagesSent.filter { $0.action == .message || $0.action == .presence }
+        let presenceIndex = sent.firstIndex { $0.action == .presence }
+        expect(presenceIndex) == sent.count - 1
+        expect(sent.flatMap { $0.messages ?? [] }.compactMap { $0.data as? String }) == (0..<100).map { "\($0)" }
+    }
+
+    func test__145__publish__with_a_coalescing_delay__should_bundle_publishes_interleaved_across_channels() {
+        let options = AblyTests.commonAppSetup()
+        options.realtimePublishCoalescingDelay = 0.5
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channels = [client.channels.get(uniqueChannelName(prefix: "a")), client.channels.get(uniqueChannelName(prefix: "b"))]
+
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(channels.count, done: done)
+            for channel in channels {
+                channel.attach { error in
+                    expect(error).to(beNil())
+                    partialDone()
+                }
+            }
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(6, done: done)
+            for i in 0..<3 {
+                for channel in channels {
+                    channel.publish(nil, data: "message\(i)") { error in
+                        expect(error).to(beNil())
+                        partialDone()
+                    }
+                }
+            }
+        }
+
+        let transport = client.internal.transport as! TestProxyTransport
+        let protocolMessages = transport.protocolMessagesSent.filter { $0.action == .message }
+        expect(protocolMessages.map { $0.channel }) == channels.map { $0.name }
+        expect(protocolMessages.map { $0.messages?.count ?? 0 }) == [3, 3]
+    }
+
+    func test__146__publish__with_a_coalescing_delay__should_queue_bundled_publishes_when_the_connection_is_lost() {
+        let options = AblyTests.commonAppSetup()
+        options.realtimePublishCoalescingDelay = 60
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+        let transport = client.internal.transport as! TestProxyTransport
+
+        channel.publish(nil, data: "first")
+        channel.publish(nil, data: "second")
+        AblyTests.queue.sync {
+            client.internal.onDisconnected()
+            // Nothing is written to the transport being left
+            expect(transport.protocolMessagesSent.filter { $0.action == .message }).to(beEmpty())
+            let queuedData = client.internal.queuedMessages.flatMap { $0.msg.messages ?? [] }.compactMap { $0.data as? String }
+            expect(queuedData) == ["first", "second"]
+        }
+    }
+
+    // RTL6c
+    func test__147__publish__with_a_high_water_mark__should_send_earlier_publishes_before_setOptions_and_close() {
+        let options = AblyTests.commonAppSetup()
+        options.realtimePublishHighWaterMark = 200
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+        let transport = client.internal.transport as! TestProxyTransport
+
+        // More submissions than one drain handles, so that some are still waiting when the operation runs.
+        func publishWhileTheInternalQueueIsBusy(_ range: Range<Int>) {
+            let internalQueueReleased = DispatchSemaphore(value: 0)
+            AblyTests.queue.async {
+                internalQueueReleased.wait()
+            }
+            for i in range {
+                channel.publish(nil, data: "\(i)")
+            }
+            internalQueueReleased.signal()
+        }
+
+        publishWhileTheInternalQueueIsBusy(0..<100)
+        let channelOptions = ARTRealtimeChannelOptions()
+        channelOptions.params = ["rewind": "1"]
+        waitUntil(timeout: testTimeout) { done in
+            channel.setOptions(channelOptions) { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        publishWhileTheInternalQueueIsBusy(100..<200)
+        waitUntil(timeout: testTimeout) { done in
+            client.connection.once(.closed) { _ in
+                done()
+            }
+            client.connection.close()
+        }
+
+        let sent = transport.protocolMessagesSent.filter { [.message, .attach, .close].contains($0.action) }
+        let reattachIndex = sent.lastIndex { $0.action == .attach }
+        let closeIndex = sent.firstIndex { $0.action == .close }
+        let messagesBeforeReattach = sent[..<(reattachIndex ?? 0)].flatMap { $0.messages ?? [] }
+        expect(messagesBeforeReattach.compactMap { $0.data as? String }) == (0..<100).map { "\($0)" }
+        expect(closeIndex) == sent.count - 1
+        expect(sent.flatMap { $0.messages ?? [] }.compactMap { $0.data as? String }) == (0..<200).map { "\($0)" }
+    }
+
+    func test__148__publish__with_a_coalescing_delay__should_send_a_bundle_when_it_reaches_the_maximum_size() {
+        let options = AblyTests.commonAppSetup()
+        options.realtimePublishCoalescingDelay = 0.5
+        options.realtimePublishCoalescingMaxBytes = 250
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let data = String(repeating: "x", count: 100)
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(5, done: done)
+            for _ in 0..<5 {
+                channel.publish(nil, data: data) { error in
+                    expect(error).to(beNil())
+                    partialDone()
+                }
+            }
+        }
+
+        let transport = client.internal.transport as! TestProxyTransport
+        let protocolMessages = transport.protocolMessagesSent.filter { $0.action == .message }
+        // A third message would take a bundle over 250 bytes, so it starts the next one; the last is sent when the delay expires
+        expect(protocolMessages.map { $0.messages?.count ?? 0 }) == [2, 2, 1]
+    }
 }
@@ -4,6 +4,21 @@ import Foundation
 import Nimble
 import XCTest
 
+private class PresenceMapDelegateRecorder: NSObject, ARTPresenceMapDelegate {
+    let connectionId: String
+    var reenteredMembers: [ARTPresenceMessage] = []
+
+    init(connectionId: String) {
+        self.connectionId = connectionId
+    }
+
+    func map(_ map: ARTPresenceMap, didRemovedMemberNoLongerPresent presence: ARTPresenceMessage) {}
+
+    func map(_ map: ARTPresenceMap, shouldReenterLocalMember presence: ARTPresenceMessage) {
+        reenteredMembers.append(presence)
+    }
+}
+
 // RTP16c
 private func testResultsInErrorWithConnectionState(_ connectionState: ARTRealtimeConnectionState, channelName: String, performMethod: @escaping (ARTRealtime) -> Void) {
     let client = ARTRealtime(options: AblyTests.commonAppSetup())
@@ -3857,4 +3872,189 @@ class RealtimeClientPresenceTests: XCTestCase {
             client.connect()
         }
     }
+
+    func test__119__Presence__PresenceMap__should_look_up_members_by_clientId_and_connectionId() {
+        let map = ARTPresenceMap(queue: AblyTests.queue, logger: ARTLog())
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .enter, connectionId: "one", id: "one:0:0"))).to(beTrue())
+        expect(map.add(ARTPresenceMessage(clientId: "b", action: .enter, connectionId: "one", id: "one:0:1"))).to(beTrue())
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .enter, connectionId: "two", id: "two:0:0"))).to(beTrue())
+
+        let members = map.memberValues
+        expect(members).to(haveCount(3))
+        // Not copied again until the map changes.
+        expect(map.memberValues).to(beIdenticalTo(members))
+
+        expect(map.members(withClientId: "a", connectionId: nil).map { $0.connectionId }.sorted()).to(equal(["one", "two"]))
+        expect(map.members(withClientId: nil, connectionId: "one").map { $0.clientId! }.sorted()).to(equal(["a", "b"]))
+        expect(map.members(withClientId: "a", connectionId: "two").map { $0.memberKey() }).to(equal(["two:a"]))
+        expect(map.members(withClientId: "b", connectionId: "two")).to(beEmpty())
+        expect(map.members(withClientId: "c", connectionId: nil)).to(beEmpty())
+
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .leave, connectionId: "one", id: "one:1:0"))).to(beTrue())
+        expect(map.memberValues).toNot(beIdenticalTo(members))
+        expect(map.memberValues).to(haveCount(2))
+        expect(map.members(withClientId: "a", connectionId: nil).map { $0.connectionId }).to(equal(["two"]))
+        expect(map.members(withClientId: "a", connectionId: "one")).to(beEmpty())
+
+        map.reset()
+        expect(map.memberValues).to(beEmpty())
+        expect(map.members(withClientId: "b", connectionId: nil)).to(beEmpty())
+    }
+
+    func test__120__Presence__PresenceMap__should_return_the_changes_since_a_version() {
+        let map = ARTPresenceMap(queue: AblyTests.queue, logger: ARTLog())
+        map.maxChangeLogLength = 3
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .enter, connectionId: "one", id: "one:0:0"))).to(beTrue())
+        expect(map.add(ARTPresenceMessage(clientId: "b", action: .enter, connectionId: "one", id: "one:0:1"))).to(beTrue())
+
+        let snapshot = map.changes(sinceVersion: 0)
+        expect(snapshot.isSnapshot).to(beTrue())
+        expect(snapshot.version).to(equal(map.version))
+        expect(snapshot.updated.map { $0.clientId! }.sorted()).to(equal(["a", "b"]))
+        expect(snapshot.removed).to(beEmpty())
+
+        expect(map.changes(sinceVersion: snapshot.version).updated).to(beEmpty())
+
+        // Coalesced into one change per member.
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .update, connectionId: "one", id: "one:1:0"))).to(beTrue())
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .update, connectionId: "one", id: "one:2:0"))).to(beTrue())
+        expect(map.add(ARTPresenceMessage(clientId: "b", action: .leave, connectionId: "one", id: "one:2:1"))).to(beTrue())
+        let changes = map.changes(sinceVersion: snapshot.version)
+        expect(changes.isSnapshot).to(beFalse())
+        expect(changes.version).to(equal(snapshot.version + 3))
+        expect(changes.updated.map { $0.id }).to(equal(["one:2:0"]))
+        expect(changes.removed.map { $0.id }).to(equal(["one:2:1"]))
+
+        // Older than the changes kept.
+        expect(map.add(ARTPresenceMessage(clientId: "c", action: .enter, connectionId: "one", id: "one:3:0"))).to(beTrue())
+        let agedOut = map.changes(sinceVersion: snapshot.version)
+        expect(agedOut.isSnapshot).to(beTrue())
+        expect(agedOut.updated.map { $0.clientId! }.sorted()).to(equal(["a", "c"]))
+
+        let beforeReset = map.version
+        map.reset()
+        expect(map.changes(sinceVersion: beforeReset).isSnapshot).to(beTrue())
+        expect(map.changes(sinceVersion: beforeReset).updated).to(beEmpty())
+    }
+
+    func test__121__Presence__PresenceMap__should_store_members_compactly_when_given_a_string_interner() {
+        let interner = ARTStringInterner()
+        let map = ARTPresenceMap(queue: AblyTests.queue, logger: ARTLog(), stringInterner: interner)
+        expect(map.compactMembers).to(beTrue())
+
+        let timestamp = Date(timeIntervalSince1970: 1_600_000_000.123)
+        let enter = ARTPresenceMessage(clientId: "a", action: .enter, connectionId: "one", id: "one:5:2", timestamp: timestamp)
+        enter.data = ["status": "online"]
+        expect(map.add(enter)).to(beTrue())
+        expect(map.add(ARTPresenceMessage(clientId: "b", action: .enter, connectionId: "one", id: "irregular-id", timestamp: timestamp))).to(beTrue())
+        expect(map.memberCount).to(equal(2))
+
+        // Created from the compact member when handed out.
+        guard let member = map.members(withClientId: "a", connectionId: nil).first else {
+            fail("Member is nil"); return
+        }
+        expect(member.id).to(equal("one:5:2"))
+        expect(member.connectionId).to(equal("one"))
+        expect(member.action).to(equal(ARTPresenceAction.present))
+        expect(member.timestamp).to(equal(timestamp))
+        expect(member.data as? [String: String]).to(equal(["status": "online"]))
+        expect(map.members["one:b"]?.id).to(equal("irregular-id"))
+
+        // Compared by the serial and index of the id, as full messages are.
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .update, connectionId: "one", id: "one:5:1"))).to(beFalse())
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .update, connectionId: "one", id: "one:5:3"))).to(beTrue())
+        expect(map.members["one:a"]?.id).to(equal("one:5:3"))
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .leave, connectionId: "one", id: "one:6:0"))).to(beTrue())
+        expect(map.memberCount).to(equal(1))
+
+        // Each distinct clientId and connectionId is held once, including the one shared by both members.
+        expect(interner.count).to(equal(3))
+    }
+
+    // RTP11
+    func test__122__Presence__changesSinceVersion__should_result_in_an_error_if_the_channel_is_DETACHED_or_FAILED() {
+        let options = AblyTests.commonAppSetup()
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.presence.changes(sinceVersion: 0) { changes, error in
+                expect(error).to(beNil())
+                expect(changes?.isSnapshot).to(beTrue())
+                expect(channel.state).to(equal(ARTRealtimeChannelState.attached))
+                done()
+            }
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.detach { _ in done() }
+        }
+        waitUntil(timeout: testTimeout) { done in
+            channel.presence.changes(sinceVersion: 0) { changes, error in
+                expect(changes).to(beNil())
+                expect(error?.code).to(equal(ARTErrorCode.channelOperationFailedInvalidState.intValue))
+                done()
+            }
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            AblyTests.queue.async {
+                channel.internal.onError(AblyTests.newErrorProtocolMessage())
+                done()
+            }
+        }
+        expect(channel.state).to(equal(ARTRealtimeChannelState.failed))
+        waitUntil(timeout: testTimeout) { done in
+            channel.presence.changes(sinceVersion: 0) { changes, error in
+                expect(changes).to(beNil())
+                expect(error?.code).to(equal(ARTErrorCode.channelOperationFailedInvalidState.intValue))
+                done()
+            }
+        }
+    }
+
+    func test__123__Presence__PresenceMap__should_reuse_compact_members_until_the_map_changes() {
+        let map = ARTPresenceMap(queue: AblyTests.queue, logger: ARTLog(), stringInterner: ARTStringInterner())
+        let enter = ARTPresenceMessage(clientId: "a", action: .enter, connectionId: "one", id: "one:5:2", timestamp: Date())
+        enter.data = ["status": "online"]
+        enter.extras = ["headers": ["key": "value"]] as NSDictionary
+        expect(map.add(enter)).to(beTrue())
+
+        // Sized from the compact fields, as the message would be.
+        let member = ARTPresenceMember(message: enter, stringInterner: ARTStringInterner())
+        expect(member.messageSize()).to(equal(enter.messageSize()))
+
+        let members = map.members
+        expect(map.members as NSDictionary).to(beIdenticalTo(members as NSDictionary))
+        let memberValues = map.memberValues
+        expect(map.memberValues as NSArray).to(beIdenticalTo(memberValues as NSArray))
+
+        expect(map.add(ARTPresenceMessage(clientId: "b", action: .enter, connectionId: "one", id: "one:5:3"))).to(beTrue())
+        expect(map.members as NSDictionary).toNot(beIdenticalTo(members as NSDictionary))
+        expect(map.members.count).to(equal(2))
+        expect(map.memberValues.count).to(equal(2))
+    }
+
+    // RTP17
+    func test__124__Presence__PresenceMap__should_not_reenter_compact_local_members_present_in_the_sync() {
+        let map = ARTPresenceMap(queue: AblyTests.queue, logger: ARTLog(), stringInterner: ARTStringInterner())
+        let delegate = PresenceMapDelegateRecorder(connectionId: "local")
+        map.delegate = delegate
+        let timestamp = Date()
+        expect(map.add(ARTPresenceMessage(clientId: "a", action: .enter, connectionId: "local", id: "local:1:0", timestamp: timestamp))).to(beTrue())
+        expect(map.localMembers).to(haveCount(1))
+
+        for _ in 0..<2 {
+            map.startSync()
+            // The PRESENT of the sync is no newer than the ENTER, so it's ignored.
+            let present = ARTPresenceMessage(clientId: "a", action: .present, connectionId: "local", id: "local:1:0", timestamp: timestamp)
+            expect(map.add(present)).to(beFalse())
+            map.endSync()
+        }
+
+        expect(delegate.reenteredMembers).to(beEmpty())
+        expect(map.members).to(haveCount(1))
+        expect(map.localMembers).to(haveCount(1))
+    }
 }
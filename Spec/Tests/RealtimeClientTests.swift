@@ -1579,4 +1579,227 @@ class RealtimeClientTests: XCTestCase {
             }
         })
     }
+
+    func test__047__metrics__should_count_frames_and_acknowledgement_latency_of_published_messages() {
+        let options = AblyTests.commonAppSetup()
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish(nil, data: "message") { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let metrics = client.metrics()
+        expect(metrics.framesSent) >= 1 // MESSAGE
+        expect(metrics.framesReceived) >= 2 // CONNECTED and ACK
+        expect(metrics.bytesSent) > 0
+        expect(metrics.bytesReceived) > 0
+        expect(metrics.decodeTime.count) == metrics.framesReceived
+        expect(metrics.ackLatency.count) == 1
+        expect(metrics.ackLatency.valueAtPercentile(50)) > 0
+        expect(metrics.pendingMessages) == 0
+    }
+
+    func test__048__metrics__should_deliver_periodic_snapshots_to_the_metrics_handler() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        options.metricsInterval = 0.1
+        var snapshots: [ARTClientMetrics] = []
+        options.metricsHandler = { metrics in
+            snapshots.append(metrics)
+        }
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+
+        expect(snapshots.count).toEventually(beGreaterThanOrEqualTo(2), timeout: testTimeout)
+        expect(snapshots.last?.framesSent) == 0
+    }
+
+    func test__049__publishTraceEvents__should_export_a_span_per_stage_of_a_sampled_publish() throws {
+        let options = AblyTests.commonAppSetup()
+        options.publishTraceSampleRate = 1
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish(nil, data: "message") { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let data = try XCTUnwrap(client.publishTraceEvents())
+        let json = try XCTUnwrap(JSONSerialization.jsonObject(with: data) as? [String: Any])
+        let events = try XCTUnwrap(json["traceEvents"] as? [[String: Any]])
+        let names = events.compactMap { $0["name"] as? String }
+        expect(names).to(equal(["encode", "queue hop", "serialize", "frame", "socket write", "ack"]))
+        expect(Set(events.compactMap { $0["tid"] as? Int }).count) == 1
+    }
+
+    func test__050__publishTraceEvents__should_be_nil_when_tracing_is_disabled() {
+        let client = ARTRealtime(options: AblyTests.commonAppSetup())
+        defer { client.dispose(); client.close() }
+        expect(client.publishTraceEvents()).to(beNil())
+    }
+
+    func test__051__memoryFootprint__should_estimate_queued_messages_and_channel_state() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+        channel.subscribe { _ in }
+        channel.publish(nil, data: String(repeating: "x", count: 1000))
+
+        let footprint = client.memoryFootprint()
+        expect(footprint.queuedMessages) == 1
+        expect(footprint.queuedMessagesBytes) >= 1000
+        expect(footprint.pendingMessages) == 0
+        expect(footprint.channels.map { $0.name }) == [channel.name]
+
+        let channelFootprint = channel.memoryFootprint()
+        expect(channelFootprint.listeners) >= 1
+        expect(channelFootprint.presenceMembers) == 0
+        expect(channelFootprint.deltaBaseBytes) == 0
+        expect(footprint.totalBytes) >= footprint.queuedMessagesBytes + channelFootprint.totalBytes
+    }
+
+    func test__052__maxQueuedMessagesBytes__should_reject_messages_that_would_exceed_it() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        options.maxQueuedMessagesBytes = 1500
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+        let payload = String(repeating: "x", count: 1000)
+
+        channel.publish(nil, data: payload)
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish(nil, data: payload) { error in
+                expect(error?.code) == Int(ARTState.publishQueueFull.rawValue)
+                done()
+            }
+        }
+        expect(client.memoryFootprint().queuedMessages) == 1
+    }
+
+    func test__053__maxQueuedMessagesBytes__should_recount_the_queued_bytes_when_the_queue_is_replaced() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        options.maxQueuedMessagesBytes = 1500
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+        let payload = String(repeating: "x", count: 1000)
+
+        channel.publish(nil, data: payload)
+        AblyTests.queue.sync {
+            client.internal.queuedMessages = NSMutableArray()
+        }
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish(nil, data: payload) { error in
+                expect(error).to(beNil())
+                done()
+            }
+            client.connect()
+        }
+    }
+
+    func test__054__maxRetainedDeltaBases__should_release_the_bases_of_the_least_recently_used_channels() {
+        let options = AblyTests.commonAppSetup()
+        options.maxRetainedDeltaBases = 1
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channels = (0..<3).map { client.channels.get(uniqueChannelName(prefix: "\($0)")) }
+
+        for channel in channels {
+            waitUntil(timeout: testTimeout) { done in
+                let partialDone = AblyTests.splitDone(2, done: done)
+                channel.subscribe { _ in
+                    partialDone()
+                }
+                channel.publish(nil, data: "base") { error in
+                    expect(error).to(beNil())
+                    partialDone()
+                }
+            }
+        }
+
+        let footprint = client.memoryFootprint()
+        expect(footprint.retainedDeltaBases) == 1
+        expect(channels.map { $0.memoryFootprint().deltaBaseBytes > 0 }) == [false, false, true]
+    }
+
+    func test__055__maxCapturedLogLines__should_discard_the_oldest_captured_lines() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        options.logHandler = ARTLog(capturingOutput: true)
+        options.maxCapturedLogLines = 5
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+
+        for i in 0..<20 {
+            client.internal.logger.log("line \(i)", with: .warn)
+        }
+
+        expect(options.logHandler.captured.map { $0.message }) == (15..<20).map { "line \($0)" }
+        expect(client.memoryFootprint().logCapturedLines) == 5
+    }
+
+    func test__056__maxQueuedMessagesBytes__should_charge_a_merged_message_for_its_messages_only() {
+        let options = AblyTests.commonAppSetup()
+        options.autoConnect = false
+        // One queued 1000 byte message is charged 1128 bytes; merging a second adds 1064, not another 1128
+        options.maxQueuedMessagesBytes = 2200
+        let client = ARTRealtime(options: options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+        let payload = String(repeating: "x", count: 1000)
+
+        channel.publish(nil, data: payload)
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish(nil, data: payload) { error in
+                expect(error).to(beNil())
+                done()
+            }
+            client.connect()
+        }
+    }
+
+    func test__057__maxQueuedMessagesBytes__should_apply_to_coalesced_publishes_queued_when_the_connection_is_lost() {
+        let options = AblyTests.commonAppSetup()
+        options.realtimePublishCoalescingDelay = 60
+        options.maxQueuedMessagesBytes = 2200
+        let client = AblyTests.newRealtime(options)
+        defer { client.dispose(); client.close() }
+        let channel = client.channels.get(uniqueChannelName())
+        let payload = String(repeating: "x", count: 1000)
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.attach { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(3, done: done)
+            for _ in 0..<3 {
+                channel.publish(nil, data: payload) { error in
+                    expect(error?.code) == Int(ARTState.publishQueueFull.rawValue)
+                    partialDone()
+                }
+            }
+            AblyTests.queue.async {
+                // The bundle of three messages is queued as the connection is left, and doesn't fit
+                client.internal.onDisconnected()
+            }
+        }
+        expect(client.memoryFootprint().queuedMessages) == 0
+    }
 }
@@ -38,6 +38,31 @@ private let dictionary = ["number": 3, "name": "John"] as [String: Any]
 private let array = ["John", "Mary"]
 private let binaryData = "123456".data(using: .utf8)!
 
+/// Answers each request at once with the status code and JSON body `respond` returns.
+private class BatchPublishHTTPStub: NSObject, ARTHTTPExecutor {
+
+    private let respond: (URLRequest) -> (Int, Any)
+    private let _logger = ARTLog()
+    private(set) var requests: [URLRequest] = []
+
+    init(respond: @escaping (URLRequest) -> (Int, Any)) {
+        self.respond = respond
+    }
+
+    func logger() -> ARTLog {
+        return _logger
+    }
+
+    func execute(_ request: URLRequest, completion callback: ((HTTPURLResponse?, Data?, Error?) -> Void)? = nil) -> (ARTCancellable & NSObjectProtocol)? {
+        requests.append(request)
+        let (statusCode, body) = respond(request)
+        let response = HTTPURLResponse(url: request.url!, statusCode: statusCode, httpVersion: "HTTP/1.1", headerFields: ["Content-Type": "application/json"])
+        callback?(response, try! JSONSerialization.data(withJSONObject: body), nil)
+        return nil
+    }
+
+}
+
 private func testSupportsAESEncryptionWithKeyLength(_ encryptionKeyLength: UInt, channelName: String) {
     let options = AblyTests.commonAppSetup()
     let client = ARTRest(options: options)
@@ -1536,4 +1561,176 @@ class RestClientChannelTests: XCTestCase {
         XCTAssertFalse(urlEncodedChannelName.contains("/"))
         XCTAssert(url.absoluteString.contains(urlEncodedChannelName))
     }
+
+    func test__049__batch_publisher__should_send_publishes_to_several_channels_in_a_single_batch_request() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        let rest = ARTRest(options: options)
+        let mockHTTPExecutor = MockHTTPExecutor()
+        rest.internal.httpExecutor = mockHTTPExecutor
+
+        let batchOptions = ARTRestBatchPublisherOptions()
+        batchOptions.maxMessages = 3
+        batchOptions.maxDelay = 60
+        let publisher = rest.batchPublisher(with: batchOptions)
+
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(2, done: done)
+            publisher.publish("foo", message: ARTMessage(name: "a", data: "1")) { error in
+                expect(error).to(beNil())
+                partialDone()
+            }
+            publisher.publish("bar", messages: [ARTMessage(name: "b", data: "2"), ARTMessage(name: "c", data: "3")]) { error in
+                expect(error).to(beNil())
+                partialDone()
+            }
+        }
+
+        expect(mockHTTPExecutor.requests).to(haveCount(1))
+        let request = try XCTUnwrap(mockHTTPExecutor.requests.first)
+        expect(request.url?.path) == "/messages"
+        expect(request.httpMethod) == "POST"
+
+        let specs = try XCTUnwrap(JSONSerialization.jsonObject(with: XCTUnwrap(request.httpBody)) as? [[String: Any]])
+        expect(specs).to(haveCount(2))
+        let barSpec = try XCTUnwrap(specs.first { ($0["channels"] as? [String]) == ["bar"] })
+        let barMessages = try XCTUnwrap(barSpec["messages"] as? [[String: Any]])
+        expect(barMessages).to(haveCount(2))
+        // RSL1k1
+        assertMessagePayloadId(id: barMessages[0]["id"] as? String, expectedSerial: "0")
+        assertMessagePayloadId(id: barMessages[1]["id"] as? String, expectedSerial: "1")
+    }
+
+    func test__050__history__iterator_should_yield_every_page_in_order_while_prefetching() throws {
+        let client = ARTRest(options: AblyTests.commonAppSetup())
+        let channel = client.channels.get(uniqueChannelName())
+
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish((1...5).map { ARTMessage(name: nil, data: "m\($0)") }) { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let query = ARTDataQuery()
+        query.direction = .forwards
+        query.limit = 2
+
+        var iterator: ARTPaginatedResultIterator<ARTMessage>?
+        waitUntil(timeout: testTimeout) { done in
+            try! channel.history(query) { result, error in
+                expect(error).to(beNil())
+                iterator = result?.iterator(withPrefetchLimit: 1)
+                done()
+            }
+        }
+
+        var pages: [[String]] = []
+        func consume(_ done: @escaping () -> Void) {
+            iterator?.next { items, error in
+                expect(error).to(beNil())
+                guard let items = items else {
+                    done(); return
+                }
+                pages.append(items.compactMap { $0.data as? String })
+                consume(done)
+            }
+        }
+        waitUntil(timeout: testTimeout) { done in
+            consume(done)
+        }
+
+        expect(pages) == [["m1", "m2"], ["m3", "m4"], ["m5"]]
+    }
+
+    func test__051__decodeCacheCapacity__channels_should_share_the_decoded_data_of_identical_payloads() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.decodeCacheCapacity = 10
+        let client = ARTRest(options: options)
+        let channelA = client.channels.get(uniqueChannelName(prefix: "a"))
+        let channelB = client.channels.get(uniqueChannelName(prefix: "b"))
+        let payload = "{\"price\":42,\"symbol\":\"ABLY\"}"
+
+        let decodedA = channelA.internal.dataEncoder.decode(payload, encoding: "json")
+        let decodedB = channelB.internal.dataEncoder.decode(String(payload), encoding: "json")
+        let decodedOther = channelB.internal.dataEncoder.decode("[1,2]", encoding: "json")
+        let decodedEncrypted = channelB.internal.dataEncoder.decode(payload, encoding: "json/cipher+aes-128-cbc")
+
+        expect(decodedA.errorInfo).to(beNil())
+        let dataA = try XCTUnwrap(decodedA.data as? NSDictionary)
+        let dataB = try XCTUnwrap(decodedB.data as? NSDictionary)
+        expect(dataA).to(beIdenticalTo(dataB))
+        expect(dataA["symbol"] as? String) == "ABLY"
+        expect(decodedOther.data as? [Int]) == [1, 2]
+        expect(decodedEncrypted.errorInfo).toNot(beNil())
+
+        let metrics = client.metrics()
+        expect(metrics.decodeCacheHits) == 1
+        expect(metrics.decodeCacheMisses) == 2
+    }
+
+    func test__052__batch_publisher__should_not_register_the_channels_it_publishes_to() {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        let rest = ARTRest(options: options)
+        rest.internal.httpExecutor = MockHTTPExecutor()
+
+        let batchOptions = ARTRestBatchPublisherOptions()
+        batchOptions.maxMessages = 1
+        let publisher = rest.batchPublisher(with: batchOptions)
+
+        waitUntil(timeout: testTimeout) { done in
+            publisher.publish("foo", message: ARTMessage(name: "a", data: "1")) { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        expect(rest.channels.exists("foo")).to(beFalse())
+    }
+
+    func test__053__batch_publisher__should_call_back_each_publish_with_the_result_of_its_own_messages() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.useBinaryProtocol = false
+        let rest = ARTRest(options: options)
+        let stub = BatchPublishHTTPStub { request in
+            let specs = try! JSONSerialization.jsonObject(with: request.httpBody!) as! [[String: Any]]
+            let results: [Any] = specs.map { spec -> Any in
+                let channel = (spec["channels"] as! [String])[0]
+                let name = (spec["messages"] as! [[String: Any]])[0]["name"] as! String
+                switch name {
+                case "rejected":
+                    return [["channel": channel, "error": ["code": 40160, "statusCode": 401, "message": "not permitted"]]]
+                case "malformed":
+                    return ["channel": channel, "error": ["code": "40000", "statusCode": NSNull(), "message": 5]]
+                default:
+                    return [["channel": channel, "messageId": "id"]]
+                }
+            }
+            return (400, ["error": ["code": 40020, "statusCode": 400, "message": "partial failure"], "batchResponse": results])
+        }
+        rest.internal.httpExecutor = stub
+
+        let batchOptions = ARTRestBatchPublisherOptions()
+        batchOptions.maxMessages = 3
+        batchOptions.maxDelay = 60
+        let publisher = rest.batchPublisher(with: batchOptions)
+
+        var errors: [String: ARTErrorInfo?] = [:]
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(3, done: done)
+            for name in ["accepted", "rejected", "malformed"] {
+                // All to the same channel, which only the messages' own results tell apart.
+                publisher.publish("foo", message: ARTMessage(name: name, data: "1")) { error in
+                    errors[name] = error
+                    partialDone()
+                }
+            }
+        }
+
+        expect(stub.requests).to(haveCount(1))
+        expect(errors["accepted"]!).to(beNil())
+        expect(errors["rejected"]??.code) == 40160
+        expect(errors["rejected"]??.statusCode) == 401
+        expect(errors["malformed"]??.code) == 40000
+        expect(errors["malformed"]??.message) == ""
+    }
 }
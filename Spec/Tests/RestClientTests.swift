@@ -1,4 +1,5 @@
 import Ably
+import Ably.Private
 import Nimble
  import XCTest
 
@@ -19,6 +20,52 @@ private let originalARTFallback_shuffleArray = ARTFallback_shuffleArray
 
 private let _fallbackHosts = ["f.ably-realtime.com", "g.ably-realtime.com", "h.ably-realtime.com", "i.ably-realtime.com", "j.ably-realtime.com"]
 
+/// Fake URL session that answers every request with a 201 after a per-host delay.
+private class DelayedURLSession: NSObject, ARTURLSession {
+    static var delayForHost: [String: TimeInterval] = [:]
+    static var defaultDelay: TimeInterval = 0
+    static var statusCodeForHost: [String: Int] = [:]
+    static weak var lastCreated: DelayedURLSession?
+
+    let queue: DispatchQueue
+    private(set) var requests: [URLRequest] = []
+    private(set) var cancelledHosts: [String] = []
+
+    required init(_ queue: DispatchQueue) {
+        self.queue = queue
+        super.init()
+        DelayedURLSession.lastCreated = self
+    }
+
+    func get(_ request: URLRequest, completion callback: @escaping (HTTPURLResponse?, Data?, Error?) -> Void) -> ARTCancellable & NSObjectProtocol {
+        requests.append(request)
+        let host = request.url!.host!
+        let work = DispatchWorkItem {
+            let response = HTTPURLResponse(url: request.url!, statusCode: DelayedURLSession.statusCodeForHost[host] ?? 201, httpVersion: nil, headerFields: ["Content-Type": "application/json"])
+            callback(response, "{}".data(using: .utf8), nil)
+        }
+        queue.asyncAfter(deadline: .now() + (DelayedURLSession.delayForHost[host] ?? DelayedURLSession.defaultDelay), execute: work)
+        return DelayedURLSessionTask { [weak self] in
+            work.cancel()
+            self?.cancelledHosts.append(host)
+        }
+    }
+
+    func finishTasksAndInvalidate() {}
+}
+
+private class DelayedURLSessionTask: NSObject, ARTCancellable {
+    private let onCancel: () -> Void
+
+    init(_ onCancel: @escaping () -> Void) {
+        self.onCancel = onCancel
+    }
+
+    func cancel() {
+        onCancel()
+    }
+}
+
 private func testUsesAlternativeHost(_ caseTest: FakeNetworkResponse, channelName: String) {
     let options = ARTClientOptions(key: "xxxx:xxxx")
     let client = ARTRest(options: options)
@@ -2090,4 +2137,207 @@ class RestClientTests: XCTestCase {
             }
         }
     }
+
+    func test__098__RestClient__hedging__should_send_a_duplicate_of_an_idempotent_publish_to_a_fallback_host_when_the_primary_host_is_slow() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.httpHedgingDelay = 0.2
+        options.dispatchQueue = AblyTests.userQueue
+        options.internalDispatchQueue = AblyTests.queue
+        let rest = ARTRest(options: options)
+
+        ARTHttp.setURLSessionClass(DelayedURLSession.self)
+        defer { ARTHttp.setURLSessionClass(ARTURLSessionServerTrust.self) }
+        let http = ARTHttp(AblyTests.queue, logger: options.logHandler)
+        let urlSession = try XCTUnwrap(DelayedURLSession.lastCreated)
+        rest.internal.httpExecutor = http
+        DelayedURLSession.defaultDelay = 0.05
+        DelayedURLSession.delayForHost = [ARTDefault.restHost(): 5.0]
+        defer { DelayedURLSession.delayForHost = [:] }
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.channels.get(uniqueChannelName()).publish(nil, data: "hedged") { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let publishRequests = urlSession.requests.filter { $0.httpMethod == "POST" }
+        expect(publishRequests).to(haveCount(2))
+        expect(publishRequests.first?.url?.host).to(equal(ARTDefault.restHost()))
+        expect(publishRequests.last?.url?.host).toNot(equal(ARTDefault.restHost()))
+        // Both attempts carry the same idempotent message id
+        expect(publishRequests.first?.httpBody).to(equal(publishRequests.last?.httpBody))
+        AblyTests.queue.sync {
+            expect(urlSession.cancelledHosts).to(contain(ARTDefault.restHost()))
+        }
+    }
+
+    func test__099__RestClient__hedging__should_not_hedge_a_publish_without_idempotent_ids() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.httpHedgingDelay = 0.1
+        options.idempotentRestPublishing = false
+        options.dispatchQueue = AblyTests.userQueue
+        options.internalDispatchQueue = AblyTests.queue
+        let rest = ARTRest(options: options)
+
+        ARTHttp.setURLSessionClass(DelayedURLSession.self)
+        defer { ARTHttp.setURLSessionClass(ARTURLSessionServerTrust.self) }
+        let http = ARTHttp(AblyTests.queue, logger: options.logHandler)
+        let urlSession = try XCTUnwrap(DelayedURLSession.lastCreated)
+        rest.internal.httpExecutor = http
+        DelayedURLSession.defaultDelay = 0
+        DelayedURLSession.delayForHost = [ARTDefault.restHost(): 0.5]
+        defer { DelayedURLSession.delayForHost = [:] }
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.channels.get(uniqueChannelName()).publish(nil, data: "not hedged") { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        expect(urlSession.requests.filter { $0.httpMethod == "POST" }).to(haveCount(1))
+    }
+
+    func test__100__RestClient__compression__should_gzip_request_bodies_above_the_threshold() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.httpRequestCompressionThreshold = 256
+        options.useBinaryProtocol = false
+        options.dispatchQueue = AblyTests.userQueue
+        options.internalDispatchQueue = AblyTests.queue
+        let rest = ARTRest(options: options)
+
+        ARTHttp.setURLSessionClass(DelayedURLSession.self)
+        defer { ARTHttp.setURLSessionClass(ARTURLSessionServerTrust.self) }
+        let http = ARTHttp(AblyTests.queue, logger: options.logHandler)
+        http.requestCompressionThreshold = options.httpRequestCompressionThreshold
+        let urlSession = try XCTUnwrap(DelayedURLSession.lastCreated)
+        rest.internal.httpExecutor = http
+        DelayedURLSession.defaultDelay = 0
+
+        let channel = rest.channels.get(uniqueChannelName())
+        let largeData = String(repeating: "a", count: 4096)
+        waitUntil(timeout: testTimeout) { done in
+            let partialDone = AblyTests.splitDone(2, done: done)
+            channel.publish(nil, data: largeData) { error in
+                expect(error).to(beNil())
+                partialDone()
+            }
+            channel.publish(nil, data: "small") { error in
+                expect(error).to(beNil())
+                partialDone()
+            }
+        }
+
+        let publishRequests = urlSession.requests.filter { $0.httpMethod == "POST" }
+        expect(publishRequests).to(haveCount(2))
+
+        let compressedRequest = try XCTUnwrap(publishRequests.first { $0.value(forHTTPHeaderField: "Content-Encoding") != nil })
+        expect(compressedRequest.value(forHTTPHeaderField: "Content-Encoding")) == "gzip"
+        let compressedBody = try XCTUnwrap(compressedRequest.httpBody)
+        expect(compressedBody.count) < largeData.count
+        let body = try XCTUnwrap((compressedBody as NSData).gzipDecompressed())
+        expect(String(data: body, encoding: .utf8)).to(contain(largeData))
+
+        let uncompressedRequest = try XCTUnwrap(publishRequests.first { $0.value(forHTTPHeaderField: "Content-Encoding") == nil })
+        expect(String(data: try XCTUnwrap(uncompressedRequest.httpBody), encoding: .utf8)).to(contain("small"))
+
+        AblyTests.queue.sync {
+            expect(http.requestLogicalBytes) > http.requestWireBytes
+        }
+    }
+
+    func test__101__RestClient__compression__should_resend_the_compressed_body_to_fallback_hosts() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.httpRequestCompressionThreshold = 256
+        options.useBinaryProtocol = false
+        options.dispatchQueue = AblyTests.userQueue
+        options.internalDispatchQueue = AblyTests.queue
+
+        ARTHttp.setURLSessionClass(DelayedURLSession.self)
+        defer { ARTHttp.setURLSessionClass(ARTURLSessionServerTrust.self) }
+        let rest = ARTRest(options: options)
+        let urlSession = try XCTUnwrap(DelayedURLSession.lastCreated)
+        DelayedURLSession.defaultDelay = 0
+        DelayedURLSession.statusCodeForHost = [options.restHost: 500]
+        defer { DelayedURLSession.statusCodeForHost = [:] }
+
+        let channel = rest.channels.get(uniqueChannelName())
+        waitUntil(timeout: testTimeout) { done in
+            channel.publish(nil, data: String(repeating: "a", count: 4096)) { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        let publishRequests = urlSession.requests.filter { $0.httpMethod == "POST" }
+        expect(publishRequests).to(haveCount(2))
+        expect(publishRequests[0].url?.host) == options.restHost
+        expect(publishRequests[1].url?.host) != options.restHost
+        for request in publishRequests {
+            expect(request.value(forHTTPHeaderField: "Content-Encoding")) == "gzip"
+        }
+        expect(publishRequests[1].httpBody) == publishRequests[0].httpBody
+    }
+
+    func test__102__RestClient__hedging__should_not_use_up_a_retry_of_the_hedged_attempt() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.httpHedgingDelay = 0.1
+        options.httpMaxRetryCount = 1
+        options.dispatchQueue = AblyTests.userQueue
+        options.internalDispatchQueue = AblyTests.queue
+
+        ARTHttp.setURLSessionClass(DelayedURLSession.self)
+        defer { ARTHttp.setURLSessionClass(ARTURLSessionServerTrust.self) }
+        let rest = ARTRest(options: options)
+        let urlSession = try XCTUnwrap(DelayedURLSession.lastCreated)
+        DelayedURLSession.defaultDelay = 0
+        DelayedURLSession.delayForHost = [options.restHost: 1.0]
+        DelayedURLSession.statusCodeForHost = Dictionary(uniqueKeysWithValues: ARTDefault.fallbackHosts().map { ($0, 503) })
+        defer {
+            DelayedURLSession.delayForHost = [:]
+            DelayedURLSession.statusCodeForHost = [:]
+        }
+
+        waitUntil(timeout: testTimeout) { done in
+            rest.channels.get(uniqueChannelName()).publish(nil, data: "hedged") { error in
+                expect(error).to(beNil())
+                done()
+            }
+        }
+
+        // The primary attempt, the hedge, and the one retry of the hedge at another fallback host.
+        let publishRequests = urlSession.requests.filter { $0.httpMethod == "POST" }
+        expect(publishRequests).to(haveCount(3))
+        expect(publishRequests[0].url?.host) == options.restHost
+        expect(publishRequests[1].url?.host) != options.restHost
+        expect(publishRequests[2].url?.host) != publishRequests[1].url?.host
+    }
+
+    func test__103__RestClient__hedging__should_learn_the_hedging_delay_from_requests_that_are_not_hedged() throws {
+        let options = ARTClientOptions(key: "xxxx:xxxx")
+        options.httpHedgingDelay = 2.0
+        options.idempotentRestPublishing = false
+        options.dispatchQueue = AblyTests.userQueue
+        options.internalDispatchQueue = AblyTests.queue
+
+        ARTHttp.setURLSessionClass(DelayedURLSession.self)
+        defer { ARTHttp.setURLSessionClass(ARTURLSessionServerTrust.self) }
+        let rest = ARTRest(options: options)
+        DelayedURLSession.defaultDelay = 0.01
+
+        let channel = rest.channels.get(uniqueChannelName())
+        for _ in 0..<20 {
+            waitUntil(timeout: testTimeout) { done in
+                channel.publish(nil, data: "not hedged") { error in
+                    expect(error).to(beNil())
+                    done()
+                }
+            }
+        }
+
+        AblyTests.queue.sync {
+            expect(rest.internal.hedgingDelay()) < 1.0
+        }
+    }
 }
@@ -0,0 +1,177 @@
+import Ably
+import Ably.Private
+import Foundation
+import Nimble
+import XCTest
+
+/// About a year of minute stats, as pulled by dashboards that roll them up client-side.
+private let intervalCount = 500_000
+
+/// 2023-01-01, so that the intervals span month and year ends and a leap day.
+private let firstIntervalStart: TimeInterval = 1_672_531_200
+
+/// Minute intervals with a few message, connection and request fields set, sharing the empty objects for the rest as decoded stats do.
+private let minuteStats: [ARTStats] = {
+    var stats: [ARTStats] = []
+    stats.reserveCapacity(intervalCount)
+    for i in 0..<intervalCount {
+        let messages = ARTStatsMessageCount(count: UInt(i % 100), data: UInt(i % 100 * 256))
+        let types = ARTStatsMessageTypes(all: messages, messages: messages, presence: .empty())
+        let traffic = ARTStatsMessageTraffic(all: types, realtime: types, rest: .empty(), webhook: .empty())
+        let connections = ARTStatsResourceCount(opened: UInt(i % 7), peak: UInt(i % 50), mean: UInt(i % 30), min: UInt(i % 10), refused: 0)
+        let intervalId = ARTStats.toIntervalId(Date(timeIntervalSince1970: firstIntervalStart + Double(i) * 60), granularity: .minute)
+        stats.append(ARTStats(all: types,
+                              inbound: traffic,
+                              outbound: .empty(),
+                              persisted: .empty(),
+                              connections: ARTStatsConnectionTypes(all: connections, plain: .empty(), tls: connections),
+                              channels: .empty(),
+                              apiRequests: ARTStatsRequestCount(succeeded: UInt(i % 3), failed: 0, refused: 0),
+                              tokenRequests: .empty(),
+                              pushes: .empty(),
+                              inProgress: "",
+                              count: 1,
+                              intervalId: intervalId))
+    }
+    return stats
+}()
+
+private let minuteRollup: ARTStatsRollup = {
+    let rollup = ARTStatsRollup(granularity: .minute)
+    rollup.add(minuteStats)
+    return rollup
+}()
+
+/// Time and allocations of the interval id codec and of `ARTStatsRollup` over 500k minute intervals.
+///
+/// Skipped unless `ABLY_BENCHMARK_OUTPUT` is set; run them with `make benchmark_macOS`.
+class StatsBenchmarks: XCTestCase {
+
+    override func setUpWithError() throws {
+        try Benchmark.skipUnlessEnabled()
+    }
+
+    private func dateFormatter() -> DateFormatter {
+        let formatter = DateFormatter()
+        formatter.locale = Locale(identifier: "en_US_POSIX")
+        formatter.timeZone = TimeZone(identifier: "UTC")
+        formatter.dateFormat = "yyyy-MM-dd:HH:mm"
+        return formatter
+    }
+
+    private func recordWhole(_ name: String, intervals: Int, _ result: [String: Any]) {
+        var result = result
+        result["intervals"] = intervals
+        result["nsPerInterval"] = (result["nsPerOperation"] as! Double) / Double(intervals)
+        BenchmarkReport.shared.record(name, result)
+    }
+
+    // MARK: Interval ids
+
+    func test__001__intervalId__format() {
+        var i = 0
+        var intervalId = ""
+        var result = Benchmark.measure(operations: 100_000) {
+            intervalId = ARTStats.toIntervalId(Date(timeIntervalSince1970: firstIntervalStart + Double(i % intervalCount) * 60), granularity: .minute)
+            i += 1
+        }
+        expect(intervalId.count) == 16
+        BenchmarkReport.shared.record("stats.intervalId.format", result)
+
+        // `NSDateFormatter`, as used before, for comparison. Reusing one formatter is already faster than creating one per call.
+        let formatter = dateFormatter()
+        result = Benchmark.measure(operations: 100_000) {
+            intervalId = formatter.string(from: Date(timeIntervalSince1970: firstIntervalStart + Double(i % intervalCount) * 60))
+            i += 1
+        }
+        expect(intervalId.count) == 16
+        BenchmarkReport.shared.record("stats.intervalId.format.dateFormatter", result)
+    }
+
+    func test__002__intervalId__parse() {
+        let intervalIds = minuteStats.prefix(100_000).map { $0.intervalId }
+        var i = 0
+        var date: Date?
+        var result = Benchmark.measure(operations: intervalIds.count) {
+            date = ARTStats.date(fromIntervalId: intervalIds[i % intervalIds.count])
+            i += 1
+        }
+        expect(date).toNot(beNil())
+        BenchmarkReport.shared.record("stats.intervalId.parse", result)
+
+        let formatter = dateFormatter()
+        result = Benchmark.measure(operations: intervalIds.count) {
+            date = formatter.date(from: intervalIds[i % intervalIds.count])
+            i += 1
+        }
+        expect(date).toNot(beNil())
+        BenchmarkReport.shared.record("stats.intervalId.parse.dateFormatter", result)
+    }
+
+    // MARK: Rollup
+
+    func test__003__rollup__add() {
+        var rollup: ARTStatsRollup?
+        let result = Benchmark.measure(operations: 1, rounds: 5, warmup: 1) {
+            rollup = ARTStatsRollup(granularity: .minute)
+            rollup!.add(minuteStats)
+        }
+        expect(rollup?.count) == UInt(intervalCount)
+        recordWhole("stats.rollup.add", intervals: intervalCount, result)
+    }
+
+    func test__004__rollup__unordered_add() {
+        let shuffled = minuteStats.shuffled()
+        var rollup: ARTStatsRollup?
+        let result = Benchmark.measure(operations: 1, rounds: 5, warmup: 1) {
+            rollup = ARTStatsRollup(granularity: .minute)
+            rollup!.add(shuffled)
+            _ = rollup!.count
+        }
+        expect(rollup?.count) == UInt(intervalCount)
+        recordWhole("stats.rollup.add.unordered", intervals: intervalCount, result)
+    }
+
+    func test__005__rollup__to_coarser_units() {
+        let source = minuteRollup
+        for (name, granularity) in [("hour", ARTStatsGranularity.hour), ("day", .day), ("month", .month)] {
+            var rollup: ARTStatsRollup?
+            let result = Benchmark.measure(operations: 1, rounds: 5, warmup: 1) {
+                rollup = source.rollup(to: granularity)
+            }
+            expect(rollup?.count).to(beGreaterThan(0))
+            recordWhole("stats.rollup.\(name)", intervals: intervalCount, result)
+        }
+    }
+
+    func test__006__rollup__deltas() {
+        let source = minuteRollup
+        var deltas: [NSNumber]?
+        let result = Benchmark.measure(operations: 1, rounds: 5, warmup: 1) {
+            deltas = source.deltas(forField: "inbound.all.messages.count")
+        }
+        expect(deltas?.count) == intervalCount
+        recordWhole("stats.rollup.deltas", intervals: intervalCount, result)
+    }
+
+    // MARK: Decoding
+
+    func test__007__decode_stats() {
+        let items = (0..<1_000).map { i -> [String: Any] in
+            return [
+                "intervalId": minuteStats[i].intervalId,
+                "inbound": ["all": ["messages": ["count": i, "data": i * 256]]],
+                "connections": ["all": ["peak": i % 50, "opened": i % 7]],
+            ]
+        }
+        let data = try! JSONSerialization.data(withJSONObject: items)
+        let encoder = ARTJsonLikeEncoder()
+        var decoded: [Any]?
+        let result = Benchmark.measure(operations: 1, rounds: 10, warmup: 2) {
+            decoded = try! encoder.decodeStats(data)
+        }
+        expect(decoded?.count) == items.count
+        recordWhole("stats.decode", intervals: items.count, result)
+    }
+
+}
@@ -1,4 +1,5 @@
 import Ably
+import Ably.Private
 import Foundation
 import Nimble
 import XCTest
@@ -50,6 +51,13 @@ private let inProgressTestsStats: ARTStats? = {
     return try! encoder.decodeStats(rawData)[0] as? ARTStats
 }()
 
+private func rollupTestStats(_ intervalId: String, _ fields: JSON) -> ARTStats {
+    var item = fields
+    item["intervalId"].string = intervalId
+    let rawData = try! JSON([item]).rawData()
+    return try! encoder.decodeStats(rawData)[0] as! ARTStats
+}
+
 private let countTestStats: ARTStats? = {
     let data: JSON = [
         ["count": 55],
@@ -444,4 +452,92 @@ class StatsTests: XCTestCase {
     func test__038__Stats__count__should_return_value_for_number_of_lower_level_stats() {
         expect(countTestStats?.count).to(equal(55))
     }
+
+    func test__039__Stats__intervalId__should_format_and_parse_like_a_date_formatter() {
+        let formats: [(ARTStatsGranularity, String)] = [
+            (.minute, "yyyy-MM-dd:HH:mm"),
+            (.hour, "yyyy-MM-dd:HH"),
+            (.day, "yyyy-MM-dd"),
+            (.month, "yyyy-MM"),
+        ]
+        let formatter = DateFormatter()
+        formatter.locale = Locale(identifier: "en_US_POSIX")
+        formatter.timeZone = TimeZone(identifier: "UTC")
+
+        for (granularity, format) in formats {
+            formatter.dateFormat = format
+            // Leap days, month and year ends, and times before 1970.
+            for seconds in [0, 59, 951_782_400, 951_868_799, 1_709_251_199, 4_102_444_799, -86_401, -2_208_988_800] as [TimeInterval] {
+                let date = Date(timeIntervalSince1970: seconds)
+                let intervalId = ARTStats.toIntervalId(date, granularity: granularity)
+                expect(intervalId).to(equal(formatter.string(from: date)))
+                expect(ARTStats.granularity(fromIntervalId: intervalId)).to(equal(granularity))
+                expect(ARTStats.date(fromIntervalId: intervalId)).to(equal(formatter.date(from: intervalId)))
+            }
+        }
+    }
+
+    func test__040__Stats__intervalId__should_not_parse_invalid_dates() {
+        for intervalId in ["2024-13-01", "2023-02-29", "2024-01-01:24", "2024-01-01:00:60", "2024/01/01", "2024-1-01:0"] {
+            expect(ARTStatsIntervalIdParse(intervalId, nil, nil)).to(beFalse(), description: intervalId)
+        }
+        expect(ARTStatsIntervalIdParse("2024-02-29:23:59", nil, nil)).to(beTrue())
+    }
+
+    func test__041__StatsRollup__should_aggregate_intervals_into_coarser_units() {
+        let rollup = ARTStatsRollup(granularity: .minute)
+        rollup.add([
+            rollupTestStats("2024-01-31:23:58", ["inbound": ["all": ["messages": ["count": 1, "data": 100]]], "connections": ["all": ["peak": 4, "min": 1, "mean": 2]]]),
+            rollupTestStats("2024-01-31:23:59", ["inbound": ["all": ["messages": ["count": 2, "data": 200]]], "connections": ["all": ["peak": 9, "min": 3, "mean": 6]]]),
+            rollupTestStats("2024-02-01:00:00", ["inbound": ["all": ["messages": ["count": 4, "data": 400]]], "connections": ["all": ["peak": 7, "min": 2, "mean": 5]]]),
+        ])
+
+        let hours = rollup.rollup(to: .hour)!
+        expect(hours.count).to(equal(2))
+        expect(hours.intervalId(at: 0)).to(equal("2024-01-31:23"))
+        expect(hours.value(forField: "inbound.all.messages.count", at: 0)).to(equal(3))
+        expect(hours.value(forField: "inbound.all.messages.data", at: 0)).to(equal(300))
+        expect(hours.value(forField: "connections.all.peak", at: 0)).to(equal(9))
+        expect(hours.value(forField: "connections.all.min", at: 0)).to(equal(1))
+        expect(hours.value(forField: "connections.all.mean", at: 0)).to(equal(4))
+
+        // Means stay weighted by the number of minutes after a second rollup.
+        let months = hours.rollup(to: .month)!
+        expect(months.values(forField: "connections.all.mean")).to(equal([4, 5]))
+        expect(rollup.rollup(to: .month)!.values(forField: "inbound.all.messages.count")).to(equal([3, 4]))
+
+        let stats = months.stats(at: 1)
+        expect(stats.intervalId).to(equal("2024-02"))
+        expect(stats.intervalGranularity()).to(equal(ARTStatsGranularity.month))
+        expect(stats.inbound.all.messages.data).to(equal(400))
+
+        expect(hours.rollup(to: .minute)).to(beNil())
+        expect(rollup.values(forField: "unknown")).to(beNil())
+    }
+
+    func test__042__StatsRollup__should_order_intervals_and_keep_the_last_one_added() {
+        let rollup = ARTStatsRollup(granularity: .hour)
+        expect(rollup.add(rollupTestStats("2024-01-01:02", ["apiRequests": ["succeeded": 1]]))).to(beTrue())
+        expect(rollup.add(rollupTestStats("2024-01-01:00", ["apiRequests": ["succeeded": 2]]))).to(beTrue())
+        expect(rollup.add(rollupTestStats("2024-01-01:02", ["apiRequests": ["succeeded": 3]]))).to(beTrue())
+        expect(rollup.add(rollupTestStats("2024-01-01:03:00", ["apiRequests": ["succeeded": 4]]))).to(beFalse())
+
+        expect(rollup.count).to(equal(2))
+        expect(rollup.intervalId(at: 0)).to(equal("2024-01-01:00"))
+        expect(rollup.intervalTime(at: 1)).to(equal(Date(timeIntervalSince1970: 1_704_074_400)))
+        expect(rollup.values(forField: "apiRequests.succeeded")).to(equal([2, 3]))
+        expect(rollup.values(forField: "apiRequests.failed")).to(equal([0, 0]))
+    }
+
+    func test__043__StatsRollup__should_compute_deltas_from_the_interval_before() {
+        let rollup = ARTStatsRollup(granularity: .day)
+        rollup.add([
+            rollupTestStats("2024-02-28", ["channels": ["opened": 10]]),
+            rollupTestStats("2024-02-29", ["channels": ["opened": 4]]),
+            rollupTestStats("2024-03-02", ["channels": ["opened": 7]]),
+        ])
+
+        expect(rollup.deltas(forField: "channels.opened")).to(equal([10, -6, 7]))
+        expect(rollup.deltas(forField: "channels.refused")).to(equal([0, 0, 0]))
+    }
 }
@@ -477,4 +477,84 @@ class UtilitiesTests: XCTestCase {
         let expectedSize = "{\"test\":\"test\"}".count + "{\"push\":{\"key\":\"value\"}}".count + clientId.count + message.name!.count
         expect(message.messageSize()).to(equal(expectedSize))
     }
+
+    func test__025__Utilities__MsgPack_Arena__should_decode_a_protocol_message_like_the_MsgPack_encoder() throws {
+        let msgPackEncoder = ARTJsonLikeEncoder(delegate: ARTMsgPackEncoder())
+        let frame: NSDictionary = [
+            "action": ARTProtocolMessageAction.message.rawValue,
+            "channel": "channel",
+            "channelSerial": "serial:1",
+            "connectionId": "connection",
+            "id": "connection:1:0",
+            "timestamp": 1_600_000_000_123,
+            "messages": [
+                ["name": "a", "clientId": "client", "data": ["nested": [1, 2.5, true, NSNull()]], "encoding": "json", "connectionId": "connection"],
+                ["name": "b", "clientId": "client", "data": Data([0x01, 0x02]), "extras": ["headers": ["key": "value"]]],
+            ],
+            "error": ["code": 40142, "statusCode": 401, "message": "expired"],
+        ]
+        let data = try ARTMsgPackEncoder().encode(frame)
+
+        let arena = ARTMsgPackArena()
+        expect(arena.parse(data)) == true
+        let decoded = try XCTUnwrap(msgPackEncoder.protocolMessage(from: arena))
+        let expected = try XCTUnwrap(msgPackEncoder.decodeProtocolMessage(data))
+
+        expect(decoded.action) == expected.action
+        expect(decoded.channel) == expected.channel
+        expect(decoded.channelSerial) == expected.channelSerial
+        expect(decoded.connectionId) == expected.connectionId
+        expect(decoded.id) == expected.id
+        expect(decoded.timestamp) == expected.timestamp
+        expect(decoded.error?.code) == expected.error?.code
+        expect(decoded.error?.message) == expected.error?.message
+        expect(decoded.messages?.count) == 2
+        for (message, expectedMessage) in zip(decoded.messages ?? [], expected.messages ?? []) {
+            expect(message.name) == expectedMessage.name
+            expect(message.clientId) == expectedMessage.clientId
+            expect(message.encoding) == expectedMessage.encoding
+            expect(message.connectionId) == expectedMessage.connectionId
+            expect(message.data as? NSObject) == expectedMessage.data as? NSObject
+            expect(message.extras as? NSDictionary) == expectedMessage.extras as? NSDictionary
+        }
+
+        arena.reset()
+        expect(arena.count) == 0
+        expect(arena.parse(data.subdata(in: 0..<(data.count - 1)))) == false
+        expect(arena.parse("{}".data(using: .utf8)!)) == false
+    }
+
+    func test__026__Utilities__MsgPack_Arena__should_skip_messages_that_are_not_maps() throws {
+        let msgPackEncoder = ARTJsonLikeEncoder(delegate: ARTMsgPackEncoder())
+        let frame: NSDictionary = [
+            "action": ARTProtocolMessageAction.message.rawValue,
+            "channel": "channel",
+            "messages": [
+                ["name": "a"],
+                "not a message",
+                ["name": "b"],
+            ],
+            "presence": [
+                ["clientId": "a", "action": 2, "connectionId": "connection", "timestamp": 1_600_000_000_123],
+                42,
+                ["clientId": "b", "action": 3, "data": "bye"],
+            ],
+        ]
+        let data = try ARTMsgPackEncoder().encode(frame)
+
+        let arena = ARTMsgPackArena()
+        expect(arena.parse(data)) == true
+        let decoded = try XCTUnwrap(msgPackEncoder.protocolMessage(from: arena))
+        expect(decoded.messages?.map { $0.name }) == ["a", "b"]
+        expect(decoded.presence?.map { $0.clientId }) == ["a", "b"]
+        expect(decoded.presence?.map { $0.action }) == [.enter, .leave]
+        expect(decoded.presence?.first?.connectionId) == "connection"
+        expect(decoded.presence?.first?.timestamp) == Date(timeIntervalSince1970: 1_600_000_000.123)
+        expect(decoded.presence?.last?.data as? String) == "bye"
+
+        // Decoded dictionaries still drop the whole array.
+        let expected = try XCTUnwrap(msgPackEncoder.decodeProtocolMessage(data))
+        expect(expected.messages).to(beNil())
+        expect(expected.presence).to(beNil())
+    }
 }